@@ -44,6 +44,8 @@
 import m5
 from m5.objects import *
 from Caches import *
+import MemConfig
+from NVMainCosts import replacement_policy
 
 def config_cache(options, system):
     if options.external_memory_system and (options.caches or options.l2cache):
@@ -93,13 +95,34 @@ def config_cache(options, system):
 #        system.l2.mem_side = system.tol3bus.slave
 #        system.l3.mem_side = system.membus.slave
 
+    # Shared DRAM/NVM classification used by the technology-aware
+    # replacement policies of every cache in the system.
+    system.tech_map = MemoryTechnologyMap(
+        nvm_ranges=[AddrRange(*r.split(':'))
+                    for r in options.nvm_ranges.split(',') if r])
+    MemConfig.connect_tech_map(system)
+
     if options.l2cache:
         # Provide a clock for the L2 and the L1-to-L2 bus here as they
         # are not connected using addTwoLevelCacheHierarchy. Use the
         # same clock as the CPUs.
         system.l2 = l2_cache_class(clk_domain=system.cpu_clk_domain,
                                    size=options.l2_size,
-                                   assoc=options.l2_assoc)
+                                   assoc=options.l2_assoc,
+                                   packed_tags=options.packed_tags)
+        if options.l2_repl:
+            system.l2.replacement_policy = \
+                replacement_policy(options.l2_repl, options)
+        system.l2.tech_map = system.tech_map
+        if options.utility_monitor or options.partitioning == 'ucp':
+            system.l2.utility_monitor = UtilityMonitor()
+        if options.partitioning:
+            system.l2.partitioner = WayPartitioner(
+                mode=options.partitioning,
+                partitions=["system.cpu%d" % i
+                            for i in xrange(options.num_cpus)],
+                way_masks=[int(m, 0) for m in
+                           options.partition_masks.split(',') if m])
 
         system.tol2bus = L2XBar(clk_domain = system.cpu_clk_domain)
         system.l2.cpu_side = system.tol2bus.master
@@ -111,9 +134,11 @@ def config_cache(options, system):
     for i in xrange(options.num_cpus):
         if options.caches:
             icache = icache_class(size=options.l1i_size,
-                                  assoc=options.l1i_assoc)
+                                  assoc=options.l1i_assoc,
+                                  packed_tags=options.packed_tags)
             dcache = dcache_class(size=options.l1d_size,
-                                  assoc=options.l1d_assoc)
+                                  assoc=options.l1d_assoc,
+                                  packed_tags=options.packed_tags)
 
             # If we have a walker cache specified, instantiate two
             # instances here
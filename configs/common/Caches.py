@@ -68,7 +68,7 @@ class L2Cache(Cache):
     mshrs = 20
     tgts_per_mshr = 12
     write_buffers = 8
-    tags = TRRIP()
+    replacement_policy = TRRIPRP()
 
 class L3Cache(Cache):
     assoc = 16
@@ -77,8 +77,7 @@ class L3Cache(Cache):
     mshrs = 32
     tgts_per_mshr = 20
     write_buffers = 16
-    tags = LRU()
-#    tags = LRU()
+    replacement_policy = LRURP()
 
 
 class IOCache(Cache):
@@ -220,6 +220,7 @@ def config_mem(options, system):
             mem_ctrls.append(mem_ctrl)
 
     subsystem.mem_ctrls = mem_ctrls
+    connect_tech_map(system)
 
     # Connect the controllers to the membus
     for i in xrange(len(subsystem.mem_ctrls)):
@@ -227,3 +228,17 @@ def config_mem(options, system):
             subsystem.mem_ctrls[i].port = xbar[i/4].master
         else:
             subsystem.mem_ctrls[i].port = xbar.master
+
+def connect_tech_map(system):
+    """
+    Hand the system's DRAM/NVM technology map to NVMain memories, which
+    classify it from their channel configs and keep it up to date as
+    pages migrate. Both the map and the memories may not exist yet.
+    """
+
+    if not hasattr(system, 'tech_map') or not hasattr(system, 'mem_ctrls'):
+        return
+
+    for ctrl in system.mem_ctrls:
+        if ctrl.type == 'NVMainMemory':
+            ctrl.tech_map = system.tech_map
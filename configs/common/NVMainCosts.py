@@ -0,0 +1,92 @@
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+""" Memory cost model for the cost-aware cache replacement policy
+
+The costs CostAwareRP charges for refetching and writing back blocks are
+derived here from the NVMain channel configurations, so that the policy sees
+the same latencies and energies as the simulated memory. A miss is modelled
+as a closed-page access: precharge, activate, column command and burst, plus
+the write recovery or write pulse for writes. Costs are latencies in ns, to
+which the access energy in nJ is added scaled by the energy weight.
+"""
+
+import os
+
+import m5
+from m5.objects import *
+
+config_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+nvmain_configs = os.path.join(os.path.dirname(config_root), 'nvmain', 'Config')
+
+default_dram_config = os.path.join(nvmain_configs,
+                                   'Hybrid_DRAM_channel.config')
+default_nvm_config = os.path.join(nvmain_configs, 'Hybrid_NVM_channel.config')
+
+def read_config(path):
+    """Parse an NVMain configuration file into a dict of strings."""
+    values = {}
+    with open(path) as f:
+        for line in f:
+            line = line.split(';', 1)[0].split()
+            if len(line) >= 2:
+                values[line[0]] = line[1]
+    return values
+
+def access_costs(path, energy_weight=0.0):
+    """Return the (read, write) miss costs of an NVMain channel."""
+    config = read_config(path)
+
+    def cycles(*keys):
+        return sum(int(config.get(k, 0)) for k in keys)
+
+    # CLK is in MHz
+    period = 1000.0 / float(config['CLK'])
+    read_cycles = cycles('tRP', 'tRCD', 'tCAS', 'tBURST')
+    write_cycles = cycles('tRP', 'tRCD', 'tCWD', 'tBURST') + \
+                   max(cycles('tWR'), cycles('tWP'))
+
+    read = read_cycles * period
+    write = write_cycles * period
+    if energy_weight:
+        read += energy_weight * float(config.get('Erd', 0))
+        write += energy_weight * float(config.get('Ewr', 0))
+    return read, write
+
+def cost_aware_policy(dram_config=default_dram_config,
+                      nvm_config=default_nvm_config, energy_weight=0.0):
+    """Create a CostAwareRP whose costs match the given channels."""
+    dram_read, dram_write = access_costs(dram_config, energy_weight)
+    nvm_read, nvm_write = access_costs(nvm_config, energy_weight)
+    return CostAwareRP(dram_read_cost=dram_read, dram_write_cost=dram_write,
+                       nvm_read_cost=nvm_read, nvm_write_cost=nvm_write)
+
+def replacement_policy(name, options):
+    """Create the replacement policy selected on the command line."""
+    if name == 'CostAwareRP':
+        return cost_aware_policy(options.repl_dram_config,
+                                 options.repl_nvm_config,
+                                 options.repl_energy_weight)
+    return getattr(m5.objects, name)()
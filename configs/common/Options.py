@@ -45,6 +45,7 @@ from common.Benchmarks import *
 
 from common import CpuConfig
 from common import MemConfig
+from common import NVMainCosts
 from common import PlatformConfig
 
 def _listCpuTypes(option, opt, value, parser):
@@ -117,6 +118,39 @@ def addNoISAOptions(parser):
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
     parser.add_option("--cacheline_size", type="int", default=64)
+    parser.add_option("--l2_repl", type="string", default=None,
+                      help="Replacement policy of the L2 cache, "
+                      "e.g. LRURP, TRRIPRP, WBARRP")
+    parser.add_option("--l3_repl", type="string", default=None,
+                      help="Replacement policy of the L3 cache")
+    parser.add_option("--packed_tags", action="store_true", default=False,
+                      help="Look cache tags up in packed per-set arrays")
+    parser.add_option("--nvm-ranges", type="string", default="1GB",
+                      help="Comma-separated physical ranges backed by NVM, "
+                      "as 'size' or 'start:end', used by technology-aware "
+                      "replacement policies")
+    parser.add_option("--utility-monitor", action="store_true",
+                      default=False,
+                      help="Attach a sampled utility monitor to the shared "
+                      "cache to report per-master miss-ratio curves")
+    parser.add_option("--partitioning", type="choice", default=None,
+                      choices=["static_masks", "ucp"],
+                      help="Partition the ways of the shared cache between "
+                      "the cpus, with fixed masks or with UCP")
+    parser.add_option("--partition-masks", type="string", default="",
+                      help="Comma-separated way mask of each cpu for "
+                      "static partitioning, even split if empty")
+    parser.add_option("--repl-dram-config", type="string",
+                      default=NVMainCosts.default_dram_config,
+                      help="NVMain channel configuration CostAwareRP "
+                      "derives its DRAM costs from")
+    parser.add_option("--repl-nvm-config", type="string",
+                      default=NVMainCosts.default_nvm_config,
+                      help="NVMain channel configuration CostAwareRP "
+                      "derives its NVM costs from")
+    parser.add_option("--repl-energy-weight", type="float", default=0.0,
+                      help="Cost, in ns, CostAwareRP charges per nJ of "
+                      "access energy")
 
     # Enable Ruby
     parser.add_option("--ruby", action="store_true")
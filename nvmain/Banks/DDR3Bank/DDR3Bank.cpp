@@ -1004,17 +1004,27 @@ void DDR3Bank::CalculateStats( )
     bankEnergy = activeEnergy = burstEnergy = refreshEnergy 
                = 0.0f;
 
+    if( subArrayStats.empty( ) )
+    {
+        subArrayStats.resize( GetChildCount( ) );
+
+        for( ncounter_t i = 0; i < GetChildCount( ); i++ )
+        {
+            subArrayStats[i].subArrayEnergy = GetStat( GetChild(i), "subArrayEnergy" );
+            subArrayStats[i].activeEnergy = GetStat( GetChild(i), "activeEnergy" );
+            subArrayStats[i].burstEnergy = GetStat( GetChild(i), "burstEnergy" );
+            subArrayStats[i].refreshEnergy = GetStat( GetChild(i), "refreshEnergy" );
+            subArrayStats[i].worstCaseEndurance = GetStat( GetChild(i), "worstCaseEndurance" );
+            subArrayStats[i].averageEndurance = GetStat( GetChild(i), "averageEndurance" );
+        }
+    }
+
     for( unsigned saIdx = 0; saIdx < subArrayNum; saIdx++ )
     {
-        StatType saEstat  = GetStat( GetChild(saIdx), "subArrayEnergy" );
-        StatType actEstat = GetStat( GetChild(saIdx), "activeEnergy" );
-        StatType bstEstat = GetStat( GetChild(saIdx), "burstEnergy" );
-        StatType refEstat = GetStat( GetChild(saIdx), "refreshEnergy" );
-
-        bankEnergy += CastStat( saEstat, double );
-        activeEnergy += CastStat( actEstat, double );
-        burstEnergy += CastStat( bstEstat, double );
-        refreshEnergy += CastStat( refEstat, double );
+        bankEnergy += CastStat( subArrayStats[saIdx].subArrayEnergy, double );
+        activeEnergy += CastStat( subArrayStats[saIdx].activeEnergy, double );
+        burstEnergy += CastStat( subArrayStats[saIdx].burstEnergy, double );
+        refreshEnergy += CastStat( subArrayStats[saIdx].refreshEnergy, double );
     }
 
     CalculatePower( );
@@ -1028,12 +1038,9 @@ void DDR3Bank::CalculateStats( )
     averageEndurance = 0;
     for( ncounter_t i = 0; i < GetChildCount( ); i++ )
     {
-        StatType subArrayWorstEndr = GetStat( GetChild(i), "worstCaseEndurance" );
-        StatType subArrayAverageEndr = GetStat( GetChild(i), "averageEndurance" );
-
-        uint64_t subArrayEndurance = CastStat( subArrayWorstEndr, uint64_t );
+        uint64_t subArrayEndurance = CastStat( subArrayStats[i].worstCaseEndurance, uint64_t );
         worstCaseEndurance = (subArrayEndurance < worstCaseEndurance) ? subArrayEndurance : worstCaseEndurance;
-        averageEndurance += CastStat( subArrayAverageEndr, uint64_t );
+        averageEndurance += CastStat( subArrayStats[i].averageEndurance, uint64_t );
     }
     averageEndurance /= GetChildCount( );
 }
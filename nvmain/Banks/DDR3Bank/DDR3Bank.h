@@ -38,6 +38,7 @@
 
 #include <stdint.h>
 #include <map>
+#include <vector>
 
 #include "src/Bank.h"
 #include "src/Config.h"
@@ -158,6 +159,14 @@ class DDR3Bank : public Bank
 
     uint64_t averageEndurance, worstCaseEndurance;
 
+    /* Subarray stats summed by CalculateStats, looked up once. */
+    struct SubArrayStats
+    {
+        StatType subArrayEnergy, activeEnergy, burstEnergy, refreshEnergy;
+        StatType worstCaseEndurance, averageEndurance;
+    };
+    std::vector<SubArrayStats> subArrayStats;
+
     ncounter_t reads, writes, activates, precharges, refreshes;
     ncounter_t idleTimer;
 
@@ -32,7 +32,9 @@
 *******************************************************************************/
 
 #include "DataEncoders/FlipNWrite/FlipNWrite.h"
+#include "include/NVMHelpers.h"
 
+#include <fstream>
 #include <iostream>
 
 using namespace NVM;
@@ -75,27 +77,45 @@ void FlipNWrite::RegisterStats( )
     AddUnitStat(flipNWriteReduction, "%");
 }
 
+/*
+ *  Inverting a whole byte writes ~bit j into bit 7-j, i.e. the complement
+ *  of the byte with its bit order reversed. Bits of a partially covered
+ *  byte that fall outside the partition are written as zero.
+ */
+static inline uint8_t InvertByte( uint8_t byte )
+{
+    byte = static_cast<uint8_t>(~byte);
+    byte = static_cast<uint8_t>(((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4));
+    byte = static_cast<uint8_t>(((byte & 0xCC) >> 2) | ((byte & 0x33) << 2));
+    byte = static_cast<uint8_t>(((byte & 0xAA) >> 1) | ((byte & 0x55) << 1));
+
+    return byte;
+}
+
 void FlipNWrite::InvertData( NVMDataBlock& data, uint64_t startBit, uint64_t endBit )
 {
-    uint64_t wordSize;
     int startByte, endByte;
 
-    wordSize = p->BusWidth;
-    wordSize *= p->tBURST * p->RATE;
-    wordSize /= 8;
-
     startByte = (int)(startBit / 8);
     endByte = (int)((endBit - 1) / 8);
 
     for( int i = startByte; i <= endByte; i++ )
     {
         uint8_t originalByte = data.GetByte( i );
+        uint64_t firstBit = static_cast<uint64_t>(i) * 8;
+
+        if( firstBit >= startBit && firstBit + 8 <= endBit )
+        {
+            data.SetByte( i, InvertByte( originalByte ) );
+            continue;
+        }
+
         uint8_t shiftByte = originalByte;
         uint8_t newByte = 0;
 
         for( int j = 0; j < 8; j++ )
         {
-            uint64_t currentBit = i * 8 + j;
+            uint64_t currentBit = firstBit + j;
            
             if( currentBit < startBit || currentBit >= endBit )
             {
@@ -115,6 +135,74 @@ void FlipNWrite::InvertData( NVMDataBlock& data, uint64_t startBit, uint64_t end
     }
 }
 
+void FlipNWrite::CountModifiedBits( NVMDataBlock& oldData, NVMDataBlock& newData,
+                                    uint64_t wordSize, std::vector<int>& modifyCount )
+{
+    uint64_t flipPartitions = modifyCount.size( );
+
+    /*
+     *  Byte-aligned partitions over fully valid data can be counted a
+     *  word at a time. GetByte reads invalid or short blocks as zero, so
+     *  anything else goes bit by bit.
+     */
+    if( fpSize % 8 == 0 && oldData.IsValid( ) && newData.IsValid( )
+        && oldData.GetSize( ) >= wordSize && newData.GetSize( ) >= wordSize )
+    {
+        uint64_t partitionBytes = fpSize / 8;
+
+        for( uint64_t i = 0; i < flipPartitions; i++ )
+        {
+            uint64_t offset = i * partitionBytes;
+
+            modifyCount[i] = static_cast<int>( CountChangedBits( 
+                        newData.rawData + offset, oldData.rawData + offset,
+                        partitionBytes ) );
+        }
+
+        return;
+    }
+
+    uint64_t currentBit = 0;
+
+    /* Check each byte to see if it was modified */
+    for( uint64_t i = 0; i < wordSize; ++i )
+    {
+        /*
+         *  If no bytes have changed we can just continue. Yes, I know this
+         *  will check the byte 8 times, but i'd rather not change the iter.
+         */
+        uint8_t oldByte, newByte;
+
+        oldByte = oldData.GetByte( i );
+        newByte = newData.GetByte( i );
+
+        if( oldByte == newByte )
+        {
+            currentBit += 8;
+            continue;
+        }
+
+        /*
+         *  If the bytes are different, then at least one bit has changed.
+         *  check each bit individually.
+         */
+        for( int j = 0; j < 8; j++ )
+        {
+            uint8_t oldBit, newBit;
+
+            oldBit = ( oldByte >> j ) & 0x1;
+            newBit = ( newByte >> j ) & 0x1;
+
+            if( oldBit != newBit && currentBit / fpSize < flipPartitions )
+            {
+                modifyCount[(int)(currentBit/fpSize)]++;
+            }
+
+            currentBit++;
+        }
+    }
+}
+
 ncycle_t FlipNWrite::Read( NVMainRequest* /*request*/ )
 {
     ncycle_t rv = 0;
@@ -131,8 +219,9 @@ ncycle_t FlipNWrite::Write( NVMainRequest *request )
     NVMAddress address = request->address;
 
     /*
-     *  The default life map is an stl map< uint64_t, uint64_t >. 
-     *  You may map row and col to this map_key however you want.
+     *  The default life map is a sparse table of uint64_t, where keys
+     *  close together share storage. You may map row and col to this
+     *  map_key however you want.
      *  It is up to you to ensure there are no collisions here.
      */
     uint64_t row;
@@ -149,10 +238,8 @@ ncycle_t FlipNWrite::Write( NVMainRequest *request )
      */
     uint64_t rowSize;
     uint64_t wordSize;
-    uint64_t currentBit;
     uint64_t flipPartitions;
     uint64_t rowPartitions;
-    int *modifyCount;
 
     wordSize = p->BusWidth;
     wordSize *= p->tBURST * p->RATE;
@@ -163,65 +250,24 @@ ncycle_t FlipNWrite::Write( NVMainRequest *request )
     
     flipPartitions = ( wordSize * 8 ) / fpSize; 
 
-    modifyCount = new int[ flipPartitions ];
-
     /*
      *  Count the number of bits that are modified. If it is more than
      *  half, then we will invert the data then write.
      */
-    for( uint64_t i = 0; i < flipPartitions; i++ )
-        modifyCount[i] = 0;
-
-    currentBit = 0;
+    std::vector<int> modifyCount( flipPartitions, 0 );
 
     /* Get what is currently in the memory (i.e., if it was previously flipped, get the flipped data. */
     for( uint64_t i = 0; i < flipPartitions; i++ )
     {
         uint64_t curAddr = row * rowPartitions + col * flipPartitions + i;
 
-        if( flippedAddresses.count( curAddr ) )
+        if( flippedAddresses.Contains( curAddr ) )
         {
             InvertData( oldData, i*fpSize, (i+1)*fpSize );
         }
     }
 
-    /* Check each byte to see if it was modified */
-    for( uint64_t i = 0; i < wordSize; ++i )
-    {
-        /*
-         *  If no bytes have changed we can just continue. Yes, I know this
-         *  will check the byte 8 times, but i'd rather not change the iter.
-         */
-        uint8_t oldByte, newByte;
-
-        oldByte = oldData.GetByte( i );
-        newByte = newData.GetByte( i );
-
-        if( oldByte == newByte )
-        {
-            currentBit += 8;
-            continue;
-        }
-
-        /*
-         *  If the bytes are different, then at least one bit has changed.
-         *  check each bit individually.
-         */
-        for( int j = 0; j < 8; j++ )
-        {
-            uint8_t oldBit, newBit;
-
-            oldBit = ( oldByte >> j ) & 0x1;
-            newBit = ( newByte >> j ) & 0x1;
-
-            if( oldBit != newBit )
-            {
-                modifyCount[(int)(currentBit/fpSize)]++;
-            }
-
-            currentBit++;
-        }
-    }
+    CountModifiedBits( oldData, newData, wordSize, modifyCount );
 
     /*
      *  Flip any partitions as needed and mark them as inverted or not.
@@ -243,27 +289,19 @@ ncycle_t FlipNWrite::Write( NVMainRequest *request )
              *  Mark this address as flipped. If the data was already inverted, it
              *  should remain as inverted for the new data.
              */
-            if( !flippedAddresses.count( curAddr ) )
-            {
-                flippedAddresses.insert( curAddr );
-            }
+            flippedAddresses.Insert( curAddr );
         }
         else
         {
             /*
              *  This data is not inverted and should not be marked as such.
              */
-            if( flippedAddresses.count( curAddr ) )
-            {
-                flippedAddresses.erase( curAddr );
-            }
+            flippedAddresses.Erase( curAddr );
 
             bitsFlipped += modifyCount[i];
         }
     }
 
-    delete modifyCount;
-    
     return rv;
 }
 
@@ -274,3 +312,52 @@ void FlipNWrite::CalculateStats( )
     else
         flipNWriteReduction = 100.0;
 }
+
+/* Saves which partitions are stored inverted, with the partition size. */
+void FlipNWrite::WriteCheckpoint( std::string file )
+{
+    if( flippedAddresses.empty( ) )
+        return;
+
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+    {
+        std::cout << "FlipNWrite: Warning: Could not open checkpoint file: " 
+                  << file << "!" << std::endl;
+        return;
+    }
+
+    uint64_t cpt_fpSize = static_cast<uint64_t>(fpSize);
+
+    cpt_handle.write( (const char *)&cpt_fpSize, sizeof(cpt_fpSize) );
+    flippedAddresses.WriteCheckpoint( cpt_handle );
+
+    cpt_handle.close( );
+}
+
+void FlipNWrite::ReadCheckpoint( std::string file )
+{
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+        return;
+
+    uint64_t cpt_fpSize = 0;
+
+    cpt_handle.read( (char *)&cpt_fpSize, sizeof(cpt_fpSize) );
+
+    if( cpt_fpSize != static_cast<uint64_t>(fpSize) 
+        || !flippedAddresses.ReadCheckpoint( cpt_handle ) )
+    {
+        std::cout << "FlipNWrite: Warning: Checkpoint " << file 
+                  << " has a different FlipNWriteGranularity. Skipping restore." << std::endl;
+        flippedAddresses.clear( );
+    }
+
+    cpt_handle.close( );
+}
@@ -35,7 +35,9 @@
 #define __NVMAIN_FLIPNWRITE_H__
 
 #include "src/DataEncoder.h"
-#include <set>
+#include "include/SparseStore.h"
+
+#include <vector>
 
 namespace NVM {
 
@@ -53,8 +55,11 @@ class FlipNWrite : public DataEncoder
     void RegisterStats( );
     void CalculateStats( );
 
+    void WriteCheckpoint( std::string file );
+    void ReadCheckpoint( std::string file );
+
   private:
-    std::set< uint64_t > flippedAddresses;
+    SparseStore flippedAddresses;
   
     uint64_t bitsFlipped;
     uint64_t bitCompareSwapWrites;
@@ -62,6 +67,8 @@ class FlipNWrite : public DataEncoder
     int fpSize;
 
     void InvertData( NVMDataBlock &data, uint64_t startBit, uint64_t endBit );
+    void CountModifiedBits( NVMDataBlock& oldData, NVMDataBlock& newData,
+                            uint64_t wordSize, std::vector<int>& modifyCount );
 };
 
 };
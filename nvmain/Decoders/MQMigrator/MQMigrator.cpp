@@ -18,11 +18,10 @@ MQMigrator::MQMigrator( )
     migrating = false;
     inputPage = 0;
     outputPage = 0;
+    inputAddress = outputAddress = 0;
+    inputChannel = outputChannel = 0;
     
     migratedAccesses = 0;
-
-    migrationMap.clear( );
-    migrationState.clear( );
 	//file.open("MQ-migration-traces.txt");
 }
 
@@ -44,6 +43,9 @@ void MQMigrator::SetConfig( Config *config, bool /*createChildren*/ )
     numBanks = config->GetValue( "BANKS" );
     numRanks = config->GetValue( "RANKS" );
     numSubarrays = config->GetValue( "ROWS" ) / config->GetValue( "MATHeight" );
+
+    access_times.assign( numChannels, 0 );
+    migrate_access_times.assign( numChannels, 0 );
 }
 
 
@@ -97,10 +99,13 @@ void MQMigrator::StartMigration( NVMAddress& promotee, NVMAddress& demotee )
      *  Set the new channel decodings immediately, but mark the migration
      *  as being in progress.
      */
-    migrationMap[promokey] = promoChannel;
-    migrationMap[demokey] = demoChannel;
-    migrationState[promokey] = MQ_MIGRATION_READING;
-    migrationState[demokey] = MQ_MIGRATION_READING;
+    MigrationEntry& promoEntry = migrationMap[promokey];
+    promoEntry.channel = promoChannel;
+    promoEntry.state = MQ_MIGRATION_READING;
+
+    MigrationEntry& demoEntry = migrationMap[demokey];
+    demoEntry.channel = demoChannel;
+    demoEntry.state = MQ_MIGRATION_READING;
 
     /*
      *  Only one migration is allowed at a time; These values hold the
@@ -110,6 +115,10 @@ void MQMigrator::StartMigration( NVMAddress& promotee, NVMAddress& demotee )
     migrating = true;
     inputPage = promokey;
     outputPage = demokey;
+    inputAddress = promotee.GetPhysicalAddress( );
+    outputAddress = demotee.GetPhysicalAddress( );
+    inputChannel = promoChannel;
+    outputChannel = demoChannel;
 }
 
 void MQMigrator::SetMigrationState( NVMAddress& address, MQMigratorState newState )
@@ -117,17 +126,25 @@ void MQMigrator::SetMigrationState( NVMAddress& address, MQMigratorState newStat
 	
     /* Get the key and set the new state; Ensure the state is really new. */
     uint64_t key = GetAddressKey( address );
+    MigrationEntry *entry = migrationMap.Find( key );
 
-    assert( migrationState.count( key ) != 0 );
-    assert( migrationState[key] != newState );
+    assert( entry != NULL );
+    assert( entry->state != newState );
 
-    migrationState[key] = newState;
+    entry->state = newState;
 
     /* If migration is done we can handle another migration */
-    if( migrationState[inputPage] == MQ_MIGRATION_DONE &&
-        migrationState[outputPage] == MQ_MIGRATION_DONE )
+    MigrationEntry *inputEntry = migrationMap.Find( inputPage );
+    MigrationEntry *outputEntry = migrationMap.Find( outputPage );
+
+    if( migrating &&
+        inputEntry != NULL && inputEntry->state == MQ_MIGRATION_DONE &&
+        outputEntry != NULL && outputEntry->state == MQ_MIGRATION_DONE )
     {
         migrating = false;
+
+        NotifyMigrated( inputAddress, inputChannel );
+        NotifyMigrated( outputAddress, outputChannel );
     }
 }
 
@@ -144,16 +161,9 @@ bool MQMigrator::Migrating( )
  */
 bool MQMigrator::IsMigrated( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && migrationState[key] == MQ_MIGRATION_DONE )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && entry->state == MQ_MIGRATION_DONE);
 }
 
 
@@ -164,16 +174,10 @@ bool MQMigrator::IsMigrated( NVMAddress& address )
  */
 bool MQMigrator::IsBuffered( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && (migrationState[key] == MQ_MIGRATION_BUFFERED || migrationState[key] == MQ_MIGRATION_WRITING ) )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && (entry->state == MQ_MIGRATION_BUFFERED 
+                              || entry->state == MQ_MIGRATION_WRITING));
 }
 
 
@@ -197,34 +201,38 @@ void MQMigrator::Translate( uint64_t address, uint64_t *row, uint64_t *col, uint
     NVMAddress keyAddress;
     keyAddress.SetTranslatedAddress( *row, *col, *bank, *rank, *channel, *subarray );
     keyAddress.SetPhysicalAddress( address );
-    uint64_t key = GetAddressKey( keyAddress );
-	ncounter_t r_channel = *channel;
-	if( access_times.count( r_channel)==0)
-	{
-		access_times[ r_channel]= 1;
-	}   
-	else
-		access_times[r_channel]++;
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( keyAddress ) );
+
+	access_times[*channel]++;
 
     /* Check if the page was migrated and migration is complete. */
-    if( migrationMap.count( key ) != 0 )
+    if( entry != NULL && entry->state == MQ_MIGRATION_DONE )
     {
-        if( migrationState[key] == MQ_MIGRATION_DONE )
-        {
-            *channel = migrationMap[key];
-  			
-//			std::cout << "\n------new channel " << std::hex << *channel <<std::endl;
+        *channel = entry->channel;
 
-            migratedAccesses++;
-        }
+        migratedAccesses++;
     }
-	ncounter_t m_channel = *channel;
-	if( migrate_access_times.count( m_channel)==0)
-	{
-		migrate_access_times[ m_channel]= 1;
-	}   
-	else
-		migrate_access_times[m_channel]++;
+
+	migrate_access_times[*channel]++;
+}
+
+
+/* The channel Translate would pick, leaving the access counters alone. */
+uint64_t MQMigrator::GetChannel( uint64_t address )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+
+    AddressTranslator::Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+
+    NVMAddress keyAddress;
+    keyAddress.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    keyAddress.SetPhysicalAddress( address );
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( keyAddress ) );
+
+    if( entry != NULL && entry->state == MQ_MIGRATION_DONE )
+        channel = entry->channel;
+
+    return channel;
 }
 
 
@@ -249,12 +257,16 @@ void MQMigrator::CreateCheckpoint( std::string dir )
          *  In-flight requests are not checkpointed (i.e., migrations). 
          *  Therefore, we assume requests have completed (i.e., there is some 
          *  draining process) and only checkpoint addresses and not state.
+         *  Pages that are still moving keep their original channel.
          */
-        std::map<uint64_t, uint64_t>::iterator it;
-        for( it = migrationMap.begin(); it != migrationMap.end(); it++ )
+        PageHashMap<MigrationEntry>::iterator it;
+        for( it = migrationMap.begin(); it != migrationMap.end(); ++it )
         {
-            cpt_handle.write( (const char*)&(it->first), sizeof(uint64_t) );
-            cpt_handle.write( (const char*)&(it->second), sizeof(uint64_t) );
+            if( it->value.state != MQ_MIGRATION_DONE )
+                continue;
+
+            cpt_handle.write( (const char*)&(it->key), sizeof(uint64_t) );
+            cpt_handle.write( (const char*)&(it->value.channel), sizeof(uint64_t) );
         }
 
         cpt_handle.close( );
@@ -321,8 +333,13 @@ void MQMigrator::RestoreCheckpoint( std::string dir )
             cpt_handle.read( (char*)(&address), sizeof(uint64_t) );
             cpt_handle.read( (char*)(&channel), sizeof(uint64_t) );
 
-            std::pair<uint64_t, uint64_t> migration( address, channel );
-            migrationMap.insert( migration );
+            /* Keep the first mapping if a page appears twice. */
+            if( !migrationMap.Contains( address ) )
+            {
+                MigrationEntry& entry = migrationMap[address];
+                entry.channel = channel;
+                entry.state = MQ_MIGRATION_DONE;
+            }
         }
 
         cpt_handle.close( );
@@ -331,7 +348,8 @@ void MQMigrator::RestoreCheckpoint( std::string dir )
 
 uint64_t MQMigrator::GetNewChannel( NVMAddress& address )
 {
-	uint64_t key = GetAddressKey(address);
-	return migrationMap[key];
+	MigrationEntry *entry = migrationMap.Find( GetAddressKey( address ) );
+
+	return (entry != NULL) ? entry->channel : 0;
 }
 
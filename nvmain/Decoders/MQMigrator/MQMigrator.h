@@ -9,7 +9,9 @@ Modified by dliu, based on Migrator.h
 
 #include "src/AddressTranslator.h"
 #include "src/Config.h"
+#include "include/MigrationListener.h"
 #include "include/NVMAddress.h"
+#include "include/PageHashMap.h"
 #include "src/NVMObject.h"
 #include "src/EventQueue.h"
 namespace NVM
@@ -26,7 +28,7 @@ enum MQMigratorState
 };
 
 
-class MQMigrator : public AddressTranslator
+class MQMigrator : public AddressTranslator, public MigrationNotifier
 {
   public:
     MQMigrator();
@@ -37,6 +39,7 @@ class MQMigrator : public AddressTranslator
     virtual void Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank, 
                             uint64_t *rank, uint64_t *channel, uint64_t *subarray );
     using AddressTranslator::Translate;
+    uint64_t GetChannel( uint64_t address );
 
     void StartMigration( NVMAddress& promotee, NVMAddress& demotee );
     void SetMigrationState( NVMAddress& address, MQMigratorState newState );
@@ -52,11 +55,19 @@ class MQMigrator : public AddressTranslator
     uint64_t GetAddressKey( NVMAddress& address );
 	uint64_t GetNewChannel( NVMAddress& address );
   
-	std::map<uint64_t , uint64_t> access_times;
-	std::map<uint64_t , uint64_t> migrate_access_times;
+	/* Accesses per channel before and after migrations are applied. */
+	std::vector<uint64_t> access_times;
+	std::vector<uint64_t> migrate_access_times;
   private:
-    std::map<uint64_t, uint64_t> migrationMap;
-    std::map<uint64_t, MQMigratorState> migrationState;
+    struct MigrationEntry
+    {
+        MigrationEntry( ) : channel(0), state(MQ_MIGRATION_UNKNOWN) { }
+
+        uint64_t channel;
+        MQMigratorState state;
+    };
+
+    PageHashMap<MigrationEntry> migrationMap;
 
     uint64_t numChannels, numBanks, numRanks, numSubarrays;
 
@@ -64,6 +75,10 @@ class MQMigrator : public AddressTranslator
     bool migrating;
     uint64_t inputPage, outputPage;
 
+    /* Where the swapped pages go, for the listener once both are done. */
+    uint64_t inputAddress, outputAddress;
+    uint64_t inputChannel, outputChannel;
+
     ncounter_t migratedAccesses;
 	//std::ofstream file;
 
@@ -41,14 +41,7 @@ using namespace NVM;
 
 Migrator::Migrator( )
 {
-    migrating = false;
-    inputPage = 0;
-    outputPage = 0;
-    
     migratedAccesses = 0;
-
-    migrationMap.clear( );
-    migrationState.clear( );
 }
 
 
@@ -115,50 +108,92 @@ void Migrator::StartMigration( NVMAddress& promotee, NVMAddress& demotee )
     uint64_t promokey = GetAddressKey( promotee );
     uint64_t demokey = GetAddressKey( demotee );
 
-    /* Ensure we are not already migrating a page. */
-    assert( migrating == false );
+    /* Ensure neither page is already being migrated. */
+    assert( !PageInFlight( promokey ) && !PageInFlight( demokey ) );
 
     /*
      *  Set the new channel decodings immediately, but mark the migration
      *  as being in progress.
      */
-    migrationMap[promokey] = promoChannel;
-    migrationMap[demokey] = demoChannel;
-    migrationState[promokey] = MIGRATION_READING;
-    migrationState[demokey] = MIGRATION_READING;
+    MigrationEntry& promoEntry = migrationMap[promokey];
+    promoEntry.channel = promoChannel;
+    promoEntry.state = MIGRATION_READING;
+
+    MigrationEntry& demoEntry = migrationMap[demokey];
+    demoEntry.channel = demoChannel;
+    demoEntry.state = MIGRATION_READING;
 
     /*
-     *  Only one migration is allowed at a time; These values hold the
-     *  key values for each migration page and marks a migration in
-     *  progress.
+     *  Several migrations may be in progress at once. Remember the keys of
+     *  each pair, and where the pages go so listeners can be told once done.
      */
-    migrating = true;
-    inputPage = promokey;
-    outputPage = demokey;
+    MigrationPair pair;
+
+    pair.inputPage = promokey;
+    pair.outputPage = demokey;
+    pair.inputAddress = promotee.GetPhysicalAddress( );
+    pair.outputAddress = demotee.GetPhysicalAddress( );
+    pair.inputChannel = promoChannel;
+    pair.outputChannel = demoChannel;
+
+    inFlight.push_back( pair );
 }
 
 void Migrator::SetMigrationState( NVMAddress& address, MigratorState newState )
 {
     /* Get the key and set the new state; Ensure the state is really new. */
     uint64_t key = GetAddressKey( address );
+    MigrationEntry *entry = migrationMap.Find( key );
 
-    assert( migrationState.count( key ) != 0 );
-    assert( migrationState[key] != newState );
+    assert( entry != NULL );
+    assert( entry->state != newState );
 
-    migrationState[key] = newState;
+    entry->state = newState;
 
-    /* If migration is done we can handle another migration */
-    if( migrationState[inputPage] == MIGRATION_DONE &&
-        migrationState[outputPage] == MIGRATION_DONE )
+    /* Retire the pair this page belongs to once both pages are done. */
+    for( size_t idx = 0; idx < inFlight.size( ); idx++ )
     {
-        migrating = false;
+        MigrationPair pair = inFlight[idx];
+
+        if( pair.inputPage != key && pair.outputPage != key )
+            continue;
+
+        MigrationEntry *inputEntry = migrationMap.Find( pair.inputPage );
+        MigrationEntry *outputEntry = migrationMap.Find( pair.outputPage );
+
+        if( inputEntry->state == MIGRATION_DONE 
+            && outputEntry->state == MIGRATION_DONE )
+        {
+            inFlight.erase( inFlight.begin( ) + idx );
+
+            NotifyMigrated( pair.inputAddress, pair.inputChannel );
+            NotifyMigrated( pair.outputAddress, pair.outputChannel );
+        }
+
+        break;
     }
 }
 
 
 bool Migrator::Migrating( )
 {
-    return migrating;
+    return !inFlight.empty( );
+}
+
+
+ncounter_t Migrator::MigrationsInFlight( )
+{
+    return inFlight.size( );
+}
+
+
+bool Migrator::PageInFlight( uint64_t key )
+{
+    MigrationEntry *entry = migrationMap.Find( key );
+
+    return (entry != NULL && (entry->state == MIGRATION_READING
+                              || entry->state == MIGRATION_BUFFERED
+                              || entry->state == MIGRATION_WRITING));
 }
 
 
@@ -168,16 +203,9 @@ bool Migrator::Migrating( )
  */
 bool Migrator::IsMigrated( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && migrationState[key] == MIGRATION_DONE )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && entry->state == MIGRATION_DONE);
 }
 
 
@@ -188,16 +216,10 @@ bool Migrator::IsMigrated( NVMAddress& address )
  */
 bool Migrator::IsBuffered( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && (migrationState[key] == MIGRATION_BUFFERED || migrationState[key] == MIGRATION_WRITING ) )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && (entry->state == MIGRATION_BUFFERED 
+                              || entry->state == MIGRATION_WRITING));
 }
 
 
@@ -212,21 +234,40 @@ void Migrator::Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64
     NVMAddress keyAddress;
     keyAddress.SetTranslatedAddress( *row, *col, *bank, *rank, *channel, *subarray );
     keyAddress.SetPhysicalAddress( address );
-    uint64_t key = GetAddressKey( keyAddress );
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( keyAddress ) );
 
     /* Check if the page was migrated and migration is complete. */
-    if( migrationMap.count( key ) != 0 )
+    if( entry != NULL && entry->state == MIGRATION_DONE )
     {
-        if( migrationState[key] == MIGRATION_DONE )
-        {
-            *channel = migrationMap[key];
+        *channel = entry->channel;
 
-            migratedAccesses++;
-        }
+        migratedAccesses++;
     }
 }
 
 
+/*
+ *  Same as Translate, but without counting the lookup as an access, e.g.
+ *  when the simulator classifies pages.
+ */
+uint64_t Migrator::GetChannel( uint64_t address )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+
+    AddressTranslator::Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+
+    NVMAddress keyAddress;
+    keyAddress.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    keyAddress.SetPhysicalAddress( address );
+    MigrationEntry *entry = migrationMap.Find( GetAddressKey( keyAddress ) );
+
+    if( entry != NULL && entry->state == MIGRATION_DONE )
+        channel = entry->channel;
+
+    return channel;
+}
+
+
 void Migrator::CreateCheckpoint( std::string dir )
 {
     std::stringstream cpt_file;
@@ -248,12 +289,16 @@ void Migrator::CreateCheckpoint( std::string dir )
          *  In-flight requests are not checkpointed (i.e., migrations). 
          *  Therefore, we assume requests have completed (i.e., there is some 
          *  draining process) and only checkpoint addresses and not state.
+         *  Pages that are still moving keep their original channel.
          */
-        std::map<uint64_t, uint64_t>::iterator it;
-        for( it = migrationMap.begin(); it != migrationMap.end(); it++ )
+        PageHashMap<MigrationEntry>::iterator it;
+        for( it = migrationMap.begin(); it != migrationMap.end(); ++it )
         {
-            cpt_handle.write( (const char*)&(it->first), sizeof(uint64_t) );
-            cpt_handle.write( (const char*)&(it->second), sizeof(uint64_t) );
+            if( it->value.state != MIGRATION_DONE )
+                continue;
+
+            cpt_handle.write( (const char*)&(it->key), sizeof(uint64_t) );
+            cpt_handle.write( (const char*)&(it->value.channel), sizeof(uint64_t) );
         }
 
         cpt_handle.close( );
@@ -320,8 +365,13 @@ void Migrator::RestoreCheckpoint( std::string dir )
             cpt_handle.read( (char*)(&address), sizeof(uint64_t) );
             cpt_handle.read( (char*)(&channel), sizeof(uint64_t) );
 
-            std::pair<uint64_t, uint64_t> migration( address, channel );
-            migrationMap.insert( migration );
+            /* Keep the first mapping if a page appears twice. */
+            if( !migrationMap.Contains( address ) )
+            {
+                MigrationEntry& entry = migrationMap[address];
+                entry.channel = channel;
+                entry.state = MIGRATION_DONE;
+            }
         }
 
         cpt_handle.close( );
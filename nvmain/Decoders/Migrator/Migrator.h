@@ -36,7 +36,11 @@
 
 #include "src/AddressTranslator.h"
 #include "src/Config.h"
+#include "include/MigrationListener.h"
 #include "include/NVMAddress.h"
+#include "include/PageHashMap.h"
+
+#include <vector>
 
 namespace NVM
 {
@@ -52,7 +56,7 @@ enum MigratorState
 };
 
 
-class Migrator : public AddressTranslator
+class Migrator : public AddressTranslator, public MigrationNotifier
 {
   public:
     Migrator();
@@ -63,31 +67,50 @@ class Migrator : public AddressTranslator
     virtual void Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank, 
                             uint64_t *rank, uint64_t *channel, uint64_t *subarray );
     using AddressTranslator::Translate;
+    uint64_t GetChannel( uint64_t address );
 
     void StartMigration( NVMAddress& promotee, NVMAddress& demotee );
     void SetMigrationState( NVMAddress& address, MigratorState newState );
     bool Migrating( );
+    ncounter_t MigrationsInFlight( );
     bool IsBuffered( NVMAddress& address );
     bool IsMigrated( NVMAddress& address );
 
+    /* Unique key of the page (row) an address belongs to. */
+    uint64_t GetAddressKey( NVMAddress& address );
+
     void RegisterStats( );
 
     void CreateCheckpoint( std::string dir );
     void RestoreCheckpoint( std::string dir );
 
   private:
-    std::map<uint64_t, uint64_t> migrationMap;
-    std::map<uint64_t, MigratorState> migrationState;
+    /* New channel and migration state of each page that was ever moved. */
+    struct MigrationEntry
+    {
+        MigrationEntry( ) : channel(0), state(MIGRATION_UNKNOWN) { }
+
+        uint64_t channel;
+        MigratorState state;
+    };
+
+    PageHashMap<MigrationEntry> migrationMap;
 
     uint64_t numChannels, numBanks, numRanks, numSubarrays;
 
     /* Pages being swapped in and swapped out. */
-    bool migrating;
-    uint64_t inputPage, outputPage;
+    struct MigrationPair
+    {
+        uint64_t inputPage, outputPage;
+        uint64_t inputAddress, outputAddress;
+        uint64_t inputChannel, outputChannel;
+    };
+
+    std::vector<MigrationPair> inFlight;
 
     ncounter_t migratedAccesses;
 
-    uint64_t GetAddressKey( NVMAddress& address );
+    bool PageInFlight( uint64_t key );
 
 };
 
@@ -118,8 +118,9 @@ ncycles_t BitModel::Write( NVMainRequest *request, NVMDataBlock& oldData )
     NVMAddress& address = request->address;
 
     /*
-     *  The default life map is an stl map< uint64_t, uint64_t >. 
-     *  You may map row and col to this map_key however you want.
+     *  The default life map is a sparse table of uint64_t, where keys
+     *  close together share storage. You may map row and col to this
+     *  map_key however you want.
      *  It is up to you to ensure there are no collisions here.
      */
     uint64_t row;
@@ -0,0 +1,574 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "MemControl/FRFCFS-RPWD/FRFCFS-RPWD.h"
+#include "src/EventQueue.h"
+#include "src/Params.h"
+#include "include/NVMHelpers.h"
+
+#include <cassert>
+#include <cmath>
+
+using namespace NVM;
+
+FRFCFS_RPWD::FRFCFS_RPWD( ) : readQueueId(0), writeQueueId(1)
+{
+    std::cout << "Created a read priority write drain First Ready First Come "
+        << "First Serve memory controller!" << std::endl;
+
+    InitQueues( 2 );
+
+    readQueue = &(transactionQueues[readQueueId]);
+    writeQueue = &(transactionQueues[writeQueueId]);
+
+    /* Memory controller options. */
+    readQueueSize = 32;
+    writeQueueSize = 32;
+    starvationThreshold = 4;
+    HighWaterMark = 24;
+    LowWaterMark = 8;
+    ReadPressureThreshold = 4;
+    MaxBankWrites = 2;
+    ReadLatencyBucket = 50;
+
+    rankCount = 0;
+    bankCount = 0;
+
+    m_draining = false;
+    force_drain = false;
+    m_drain_start_cycle = 0;
+
+    /* Memory controller statistics. */
+    averageLatency = 0.0;
+    averageQueueLatency = 0.0;
+    averageTotalLatency = 0.0;
+    measuredLatencies = 0;
+    measuredQueueLatencies = 0;
+    measuredTotalLatencies = 0;
+    starvation_precharges = 0;
+
+    mem_reads = 0;
+    mem_writes = 0;
+    rq_rb_hits = 0;
+    rq_rb_miss = 0;
+    wq_rb_hits = 0;
+    wq_rb_miss = 0;
+    write_pauses = 0;
+    requeued_writes = 0;
+    forced_writes = 0;
+    idle_writes = 0;
+    pressure_reads = 0;
+    total_drains = 0;
+    total_drain_cycles = 0;
+    average_drain_cycles = 0.0;
+
+    measuredReadLatencies = 0;
+    averageReadLatency = 0.0;
+    readLatencyP50 = 0;
+    readLatencyP90 = 0;
+    readLatencyP99 = 0;
+    readLatencyP999 = 0;
+    readLatencyMax = 0;
+    readLatencyHisto = "";
+}
+
+FRFCFS_RPWD::~FRFCFS_RPWD( )
+{
+}
+
+void FRFCFS_RPWD::SetConfig( Config *conf, bool createChildren )
+{
+    if( conf->KeyExists( "StarvationThreshold" ) )
+        starvationThreshold = static_cast<unsigned int>( 
+                conf->GetValue( "StarvationThreshold" ) );
+
+    if( conf->KeyExists( "ReadQueueSize" ) )
+        readQueueSize = static_cast<unsigned int>( 
+              conf->GetValue( "ReadQueueSize" ) );
+
+    if( conf->KeyExists( "WriteQueueSize" ) )
+        writeQueueSize = static_cast<unsigned int>( 
+                conf->GetValue( "WriteQueueSize" ) );
+
+    /*
+     *  A drain starts once HighWaterMark writes are buffered and runs until
+     *  no more than LowWaterMark remain, unless ReadPressureThreshold reads
+     *  are waiting, in which case the reads go first.
+     */
+    if( conf->KeyExists( "HighWaterMark" ) )
+        HighWaterMark = static_cast<unsigned int>( 
+                conf->GetValue( "HighWaterMark" ) );
+
+    if( conf->KeyExists( "LowWaterMark" ) )
+        LowWaterMark = static_cast<unsigned int>( 
+                conf->GetValue( "LowWaterMark" ) );
+
+    if( conf->KeyExists( "ReadPressureThreshold" ) )
+        ReadPressureThreshold = static_cast<unsigned int>( 
+                conf->GetValue( "ReadPressureThreshold" ) );
+
+    /* Maximum number of writes issued to one bank at a time, 0 for no limit. */
+    if( conf->KeyExists( "MaxBankWrites" ) )
+        MaxBankWrites = static_cast<unsigned int>( 
+                conf->GetValue( "MaxBankWrites" ) );
+
+    if( conf->KeyExists( "ReadLatencyBucket" ) )
+        ReadLatencyBucket = static_cast<ncycle_t>( 
+                conf->GetValue( "ReadLatencyBucket" ) );
+
+    /* sanity check */
+    if( HighWaterMark > writeQueueSize )
+    {
+        HighWaterMark = writeQueueSize;
+        std::cout << "NVMain Warning: high watermark can NOT be larger than write "
+            << "queue size. Has reset it to equal." << std::endl;
+    }
+
+    if( LowWaterMark > HighWaterMark )
+    {
+        LowWaterMark = 0;
+        std::cout << "NVMain Warning: low watermark can NOT be larger than high "
+            << "watermark. Has reset it to 0." << std::endl;
+    }
+
+    if( ReadPressureThreshold == 0 )
+        ReadPressureThreshold = 1;
+
+    if( ReadLatencyBucket == 0 )
+        ReadLatencyBucket = 1;
+
+    MemoryController::SetConfig( conf, createChildren );
+
+    rankCount = p->RANKS;
+    bankCount = p->BANKS;
+    queuedReads.assign( rankCount * bankCount, 0 );
+    writesInFlight.assign( rankCount * bankCount, 0 );
+
+    SetDebugName( "FRFCFS-RPWD", conf );
+}
+
+void FRFCFS_RPWD::RegisterStats( )
+{
+    AddStat(mem_reads);
+    AddStat(mem_writes);
+    AddStat(rq_rb_hits);
+    AddStat(rq_rb_miss);
+    AddStat(wq_rb_hits);
+    AddStat(wq_rb_miss);
+    AddStat(starvation_precharges);
+
+    AddStat(write_pauses);
+    AddStat(requeued_writes);
+    AddStat(forced_writes);
+    AddStat(idle_writes);
+    AddStat(pressure_reads);
+
+    AddStat(total_drains);
+    AddStat(total_drain_cycles);
+    AddStat(average_drain_cycles);
+
+    AddStat(averageLatency);
+    AddStat(averageQueueLatency);
+    AddStat(averageTotalLatency);
+    AddStat(measuredLatencies);
+    AddStat(measuredQueueLatencies);
+    AddStat(measuredTotalLatencies);
+
+    AddStat(measuredReadLatencies);
+    AddStat(averageReadLatency);
+    AddStat(readLatencyP50);
+    AddStat(readLatencyP90);
+    AddStat(readLatencyP99);
+    AddStat(readLatencyP999);
+    AddStat(readLatencyMax);
+    AddStat(readLatencyHisto);
+
+    MemoryController::RegisterStats( );
+}
+
+ncounter_t FRFCFS_RPWD::BankIndex( NVMainRequest *request )
+{
+    ncounter_t rank, bank;
+
+    request->address.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+
+    assert( rank < rankCount && bank < bankCount );
+
+    return rank * bankCount + bank;
+}
+
+bool FRFCFS_RPWD::WriteThrottlePredicate::operator() ( NVMainRequest *request )
+{
+    ncounter_t bankIdx = memControl->BankIndex( request );
+
+    if( memControl->MaxBankWrites != 0 
+        && memControl->writesInFlight[bankIdx] >= memControl->MaxBankWrites )
+        return false;
+
+    /* Outside of a drain, stay out of the way of banks that have reads. */
+    if( idleBanksOnly && memControl->queuedReads[bankIdx] != 0 )
+        return false;
+
+    return true;
+}
+
+bool FRFCFS_RPWD::IsIssuable( NVMainRequest *request, FailReason * /*fail*/ )
+{
+    bool rv = true;
+
+    /* 
+     *  No new writes are accepted during a drain, otherwise the write queue
+     *  refills as fast as it drains and the drain never ends.
+     */
+    if( (request->type == READ  && readQueue->size()  >= readQueueSize) 
+            || (request->type == WRITE && ( writeQueue->size() >= writeQueueSize 
+                    || force_drain == true || m_draining == true ) ) )
+    {
+        rv = false;
+    }
+
+    return rv;
+}
+
+bool FRFCFS_RPWD::IssueCommand( NVMainRequest *request )
+{
+    if( !IsIssuable( request ) )
+    {
+        return false;
+    }
+
+    request->arrivalCycle = GetEventQueue()->GetCurrentCycle();
+
+    if( request->type == READ )
+    {
+        Enqueue( readQueueId, request );
+        queuedReads[BankIndex( request )]++;
+
+        mem_reads++;
+    }
+    else if( request->type == WRITE )
+    {
+        Enqueue( writeQueueId, request );
+
+        mem_writes++;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void FRFCFS_RPWD::RecordReadLatency( NVMainRequest *request )
+{
+    ncycle_t latency = request->completionCycle - request->arrivalCycle;
+
+    averageReadLatency = ((averageReadLatency 
+                           * static_cast<double>(measuredReadLatencies))
+                           + static_cast<double>(latency))
+                       / static_cast<double>(measuredReadLatencies+1);
+    measuredReadLatencies += 1;
+
+    readLatencyMap[latency]++;
+
+    if( latency > readLatencyMax )
+        readLatencyMax = latency;
+}
+
+bool FRFCFS_RPWD::RequestComplete( NVMainRequest * request )
+{
+    if( request->type == WRITE || request->type == WRITE_PRECHARGE )
+    {
+        ncounter_t bankIdx = BankIndex( request );
+
+        assert( writesInFlight[bankIdx] > 0 );
+        writesInFlight[bankIdx]--;
+
+        /* 
+         *  Put cancelled and paused writes back at the head of the write 
+         *  queue to be resumed later.
+         */
+        if( request->flags & NVMainRequest::FLAG_CANCELLED 
+            || request->flags & NVMainRequest::FLAG_PAUSED )
+        {
+            Prequeue( writeQueueId, request );
+            requeued_writes++;
+
+            return true;
+        }
+    }
+
+    if( request->type == READ 
+        || request->type == READ_PRECHARGE 
+        || request->type == WRITE 
+        || request->type == WRITE_PRECHARGE )
+    {
+        request->status = MEM_REQUEST_COMPLETE; 
+        request->completionCycle = GetEventQueue()->GetCurrentCycle();
+
+        averageLatency = ((averageLatency 
+                           * static_cast<double>(measuredLatencies))
+                           + static_cast<double>(request->completionCycle)
+                           - static_cast<double>(request->issueCycle))
+                       / static_cast<double>(measuredLatencies+1);
+        measuredLatencies += 1;
+
+        averageQueueLatency = ((averageQueueLatency 
+                                * static_cast<double>(measuredQueueLatencies))
+                                + static_cast<double>(request->issueCycle)
+                                - static_cast<double>(request->arrivalCycle))
+                            / static_cast<double>(measuredQueueLatencies+1);
+        measuredQueueLatencies += 1;
+
+        averageTotalLatency = ((averageTotalLatency * static_cast<double>(measuredTotalLatencies))
+                                + static_cast<double>(request->completionCycle)
+                                - static_cast<double>(request->arrivalCycle))
+                            / static_cast<double>(measuredTotalLatencies+1);
+        measuredTotalLatencies += 1;
+
+        if( request->type == READ || request->type == READ_PRECHARGE )
+            RecordReadLatency( request );
+    }
+
+    return MemoryController::RequestComplete( request );
+}
+
+void FRFCFS_RPWD::UpdateDrainState( )
+{
+    if( m_draining == false && writeQueue->size() >= HighWaterMark )
+    {
+        m_drain_start_cycle = GetEventQueue()->GetCurrentCycle();
+        m_draining = true;
+        total_drains++;
+    }
+    else if( m_draining == true && writeQueue->size() <= LowWaterMark )
+    {
+        total_drain_cycles += GetEventQueue()->GetCurrentCycle() 
+                            - m_drain_start_cycle;
+        m_draining = false;
+    }
+}
+
+/*
+ *  Returns true if a read was found, or if a read is waiting for a write in
+ *  its subarray to pause, in which case nothing else should be scheduled.
+ */
+bool FRFCFS_RPWD::ScheduleRead( NVMainRequest **nextRequest )
+{
+    if( FindStarvedRequest( *readQueue, nextRequest ) )
+    {
+        rq_rb_miss++;
+        starvation_precharges++;
+    }
+    else if( FindRowBufferHit( *readQueue, nextRequest ) )
+    {
+        rq_rb_hits++;
+    }
+    else if( FindCachedAddress( *readQueue, nextRequest ) )
+    {
+    }
+    else if( FindWriteStalledRead( *readQueue, nextRequest ) )
+    {
+        if( *nextRequest != NULL )
+            write_pauses++;
+    }
+    else if( FindOldestReadyRequest( *readQueue, nextRequest ) )
+    {
+        rq_rb_miss++;
+    }
+    else if( FindClosedBankRequest( *readQueue, nextRequest ) )
+    {
+        rq_rb_miss++;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool FRFCFS_RPWD::ScheduleWrite( NVMainRequest **nextRequest, bool idleBanksOnly )
+{
+    WriteThrottlePredicate pred( this, idleBanksOnly );
+
+    if( FindStarvedRequest( *writeQueue, nextRequest, pred ) )
+    {
+        wq_rb_miss++;
+        starvation_precharges++;
+    }
+    else if( FindRowBufferHit( *writeQueue, nextRequest, pred ) )
+    {
+        wq_rb_hits++;
+    }
+    else if( FindCachedAddress( *writeQueue, nextRequest, pred ) )
+    {
+    }
+    else if( FindOldestReadyRequest( *writeQueue, nextRequest, pred ) )
+    {
+        wq_rb_miss++;
+    }
+    else if( FindClosedBankRequest( *writeQueue, nextRequest, pred ) )
+    {
+        wq_rb_miss++;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void FRFCFS_RPWD::Cycle( ncycle_t steps )
+{
+    UpdateDrainState( );
+
+    /*
+     *  Reads have priority unless we are draining and the read queue is 
+     *  below the pressure threshold. A full write queue drains regardless,
+     *  since new writes (and everything behind them) are being turned away.
+     *  Reads still fill in when no write can be issued.
+     *
+     *  Writes issued under read pressure can be paused or cancelled by the
+     *  reads behind them, other writes issued by a drain can not.
+     */
+    NVMainRequest *nextRequest = NULL;
+    bool readPressure = (readQueue->size() >= ReadPressureThreshold);
+    bool writesFirst = !writeQueue->empty()
+                    && ((force_drain == true && readQueue->empty())
+                        || (m_draining == true 
+                            && (!readPressure || writeQueue->size() >= writeQueueSize)));
+    bool forceWrites = writesFirst && !readPressure;
+
+    bool scheduled = false;
+
+    if( writesFirst )
+        scheduled = ScheduleWrite( &nextRequest, false );
+
+    if( !scheduled && ScheduleRead( &nextRequest ) )
+    {
+        scheduled = true;
+
+        if( nextRequest != NULL && m_draining == true && !writesFirst )
+            pressure_reads++;
+    }
+
+    if( !scheduled && !writesFirst )
+    {
+        if( m_draining == true || force_drain == true )
+            ScheduleWrite( &nextRequest, false );
+        else if( ScheduleWrite( &nextRequest, !readQueue->empty() ) )
+            idle_writes++;
+    }
+
+    if( nextRequest != NULL )
+    {
+        ncounter_t bankIdx = BankIndex( nextRequest );
+
+        if( nextRequest->type == READ )
+        {
+            assert( queuedReads[bankIdx] > 0 );
+            queuedReads[bankIdx]--;
+        }
+        else if( nextRequest->type == WRITE 
+                 || nextRequest->type == WRITE_PRECHARGE )
+        {
+            writesInFlight[bankIdx]++;
+
+            if( forceWrites )
+            {
+                nextRequest->flags |= NVMainRequest::FLAG_FORCED;
+                forced_writes++;
+            }
+        }
+
+        IssueMemoryCommands( nextRequest );
+    }
+
+    CycleCommandQueues( );
+
+    MemoryController::Cycle( steps );
+}
+
+ncycle_t FRFCFS_RPWD::ReadLatencyPercentile( double fraction )
+{
+    uint64_t target = static_cast<uint64_t>( 
+            std::ceil( fraction * static_cast<double>(measuredReadLatencies) ) );
+    uint64_t seen = 0;
+    std::map<ncycle_t, uint64_t>::iterator it;
+
+    if( target == 0 )
+        target = 1;
+
+    for( it = readLatencyMap.begin(); it != readLatencyMap.end(); ++it )
+    {
+        seen += it->second;
+
+        if( seen >= target )
+            return it->first;
+    }
+
+    return readLatencyMax;
+}
+
+void FRFCFS_RPWD::CalculateStats( )
+{
+    if( total_drains > 0 )
+        average_drain_cycles = static_cast<double>(total_drain_cycles) / static_cast<double>(total_drains);
+    else
+        average_drain_cycles = 0.0;
+
+    if( measuredReadLatencies > 0 )
+    {
+        readLatencyP50 = ReadLatencyPercentile( 0.50 );
+        readLatencyP90 = ReadLatencyPercentile( 0.90 );
+        readLatencyP99 = ReadLatencyPercentile( 0.99 );
+        readLatencyP999 = ReadLatencyPercentile( 0.999 );
+    }
+
+    /* Bucket the latencies so the histogram stays readable. */
+    std::map<ncycle_t, uint64_t> bucketMap;
+    std::map<ncycle_t, uint64_t>::iterator it;
+
+    for( it = readLatencyMap.begin(); it != readLatencyMap.end(); ++it )
+        bucketMap[(it->first / ReadLatencyBucket) * ReadLatencyBucket] += it->second;
+
+    readLatencyHisto = PyDictHistogram<ncycle_t, uint64_t>( bucketMap );
+
+    MemoryController::CalculateStats( );
+}
+
+bool FRFCFS_RPWD::Drain( )
+{
+    force_drain = true;
+
+    return true;
+}
@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __FRFCFS_RPWD_H__
+#define __FRFCFS_RPWD_H__
+
+#include "src/MemoryController.h"
+
+#include <map>
+#include <vector>
+
+namespace NVM {
+
+/*
+ *  First-ready first-come first-serve with separate read and write queues.
+ *  Reads always go first. Writes are buffered and drained between a high
+ *  and low watermark, but a drain yields to reads once the read queue
+ *  reaches ReadPressureThreshold. Writes issued under read pressure can be
+ *  paused or cancelled by the reads behind them (requires WritePausing),
+ *  and no bank may have more than MaxBankWrites writes in flight.
+ */
+class FRFCFS_RPWD : public MemoryController
+{
+  public:
+    FRFCFS_RPWD( );
+    ~FRFCFS_RPWD( );
+
+    bool IssueCommand( NVMainRequest *request );
+    bool IsIssuable( NVMainRequest *request, FailReason *fail = NULL );
+    bool RequestComplete( NVMainRequest *request );
+
+    void SetConfig( Config *conf, bool createChildren = true );
+
+    void Cycle( ncycle_t steps );
+    bool Drain( );
+
+    void RegisterStats( );
+    void CalculateStats( );
+
+  private:
+    /* Only schedules writes to banks below the in-flight write limit. */
+    class WriteThrottlePredicate : public SchedulingPredicate
+    {
+      private:
+        FRFCFS_RPWD *memControl;
+        bool idleBanksOnly;
+
+      public:
+        WriteThrottlePredicate( FRFCFS_RPWD *_memControl, bool _idleBanksOnly ) 
+            : memControl(_memControl), idleBanksOnly(_idleBanksOnly) { }
+
+        bool operator() (NVMainRequest *request);
+    };
+
+    NVMTransactionQueue *readQueue;
+    NVMTransactionQueue *writeQueue;
+
+    const int readQueueId;
+    const int writeQueueId;
+
+    /* Cached Configuration Variables*/
+    uint64_t readQueueSize;
+    uint64_t writeQueueSize;
+    uint64_t HighWaterMark;
+    uint64_t LowWaterMark;
+    uint64_t ReadPressureThreshold;
+    uint64_t MaxBankWrites;
+    ncycle_t ReadLatencyBucket;
+
+    /* Per-bank bookkeeping for throttling. */
+    ncounter_t rankCount, bankCount;
+    std::vector<ncounter_t> queuedReads;
+    std::vector<ncounter_t> writesInFlight;
+
+    bool m_draining;
+    bool force_drain;
+    ncycle_t m_drain_start_cycle;
+
+    ncounter_t BankIndex( NVMainRequest *request );
+    bool ScheduleRead( NVMainRequest **nextRequest );
+    bool ScheduleWrite( NVMainRequest **nextRequest, bool idleBanksOnly );
+    void UpdateDrainState( );
+    void RecordReadLatency( NVMainRequest *request );
+
+    /* Stats */
+    uint64_t measuredLatencies, measuredQueueLatencies, measuredTotalLatencies;
+    double   averageLatency, averageQueueLatency, averageTotalLatency;
+    uint64_t mem_reads, mem_writes;
+    uint64_t starvation_precharges;
+    uint64_t rq_rb_hits, rq_rb_miss;
+    uint64_t wq_rb_hits, wq_rb_miss;
+    uint64_t write_pauses;
+    uint64_t requeued_writes;
+    uint64_t forced_writes;
+    uint64_t idle_writes;
+    uint64_t pressure_reads;
+    uint64_t total_drains;
+    uint64_t total_drain_cycles;
+    double   average_drain_cycles;
+
+    /* Read latency distribution, measured from arrival to completion. */
+    std::map<ncycle_t, uint64_t> readLatencyMap;
+    uint64_t measuredReadLatencies;
+    double   averageReadLatency;
+    ncycle_t readLatencyP50;
+    ncycle_t readLatencyP90;
+    ncycle_t readLatencyP99;
+    ncycle_t readLatencyP999;
+    ncycle_t readLatencyMax;
+    std::string readLatencyHisto;
+
+    ncycle_t ReadLatencyPercentile( double fraction );
+};
+
+};
+
+#endif
@@ -576,7 +576,7 @@ void LO_Cache::CreateCheckpoint( std::string dir )
         }
     }
 
-    NVMObject::CreateCheckpoint( dir );
+    MemoryController::CreateCheckpoint( dir );
 }
 
 void LO_Cache::RestoreCheckpoint( std::string dir )
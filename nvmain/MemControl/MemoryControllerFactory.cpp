@@ -35,6 +35,7 @@
 #include "MemControl/FCFS/FCFS.h"
 #include "MemControl/FRFCFS/FRFCFS.h"
 #include "MemControl/FRFCFS-WQF/FRFCFS-WQF.h"
+#include "MemControl/FRFCFS-RPWD/FRFCFS-RPWD.h"
 #include "MemControl/PerfectMemory/PerfectMemory.h"
 #include "MemControl/DRAMCache/DRAMCache.h"
 #include "MemControl/LH-Cache/LH-Cache.h"
@@ -58,6 +59,8 @@ MemoryController *MemoryControllerFactory::CreateNewController( std::string cont
         memoryController = new FRFCFS( );
     else if( controller == "FRFCFS-WQF" || controller == "FRFCFS_WQF" )
         memoryController = new FRFCFS_WQF( );
+    else if( controller == "FRFCFS-RPWD" || controller == "FRFCFS_RPWD" )
+        memoryController = new FRFCFS_RPWD( );
     else if( controller == "PerfectMemory" )
         memoryController = new PerfectMemory( );
     else if( controller == "DRC" )
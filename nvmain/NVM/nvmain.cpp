@@ -37,6 +37,7 @@
 #include "src/Interconnect.h"
 #include "src/SimInterface.h"
 #include "src/EventQueue.h"
+#include "src/ParallelChannels.h"
 #include "Interconnect/InterconnectFactory.h"
 #include "MemControl/MemoryControllerFactory.h"
 #include "traceWriter/TraceWriterFactory.h"
@@ -47,7 +48,11 @@
 #include "Prefetchers/PrefetcherFactory.h"
 
 #include <sstream>
+#include <fstream>
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <thread>
 
 using namespace NVM;
 
@@ -66,6 +71,10 @@ NVMain::NVMain( )
     prefetcher = NULL;
     successfulPrefetches = 0;
     unsuccessfulPrefetches = 0;
+
+    intervalStream = NULL;
+
+    parallelChannels = NULL;
 }
 
 NVMain::~NVMain( )
@@ -84,9 +93,20 @@ NVMain::~NVMain( )
         delete [] memoryControllers;
     }
 
+    /* Stops the worker threads. */
+    if( parallelChannels )
+        delete parallelChannels;
+
+    for( size_t i = 0; i < channelQueues.size( ); i++ )
+        delete channelQueues[i];
+
     if( translator )
         delete translator;
 
+    /* Some trace writers only complete their trace when destroyed. */
+    if( preTracer )
+        delete preTracer;
+
     if( channelConfig )
     {
         for( unsigned int i = 0; i < numChannels; i++ )
@@ -103,6 +123,18 @@ Config *NVMain::GetConfig( )
     return config;
 }
 
+Config *NVMain::GetChannelConfig( ncounter_t channel )
+{
+    assert( channel < numChannels );
+
+    return channelConfig[channel];
+}
+
+ncounter_t NVMain::GetNumChannels( )
+{
+    return numChannels;
+}
+
 void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildren )
 {
     TranslationMethod *method;
@@ -187,6 +219,13 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
 
                 channelConfig[i]->Read( channelConfigFile );
             }
+        }
+
+        CreateParallelChannels( channels );
+
+        for( int i = 0; i < channels; i++ )
+        {
+            std::stringstream confString;
 
             /* Initialize memory controller */
             memoryControllers[i] = 
@@ -203,6 +242,10 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
             AddChild( memoryControllers[i] );
             memoryControllers[i]->SetParent( this );
 
+            /* Each parallel channel schedules into its own event queue. */
+            if( parallelChannels != NULL )
+                memoryControllers[i]->SetEventQueue( channelQueues[i] );
+
             /* Set Config recursively. */
             memoryControllers[i]->SetConfig( channelConfig[i], createChildren );
 
@@ -210,6 +253,8 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
             memoryControllers[i]->RegisterStats( );
         }
 
+        if( parallelChannels != NULL )
+            parallelChannels->Start( );
     }
 
     if( p->MemoryPrefetcher != "none" )
@@ -242,6 +287,9 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
         else
             preTracer = TraceWriterFactory::CreateNewTraceWriter( config->GetString( "PreTraceWriter" ) );
 
+        if( preTracer != NULL )
+            preTracer->Init( config );
+
         if( p->PrintPreTrace )
             preTracer->SetTraceFile( pretraceFile );
         if( p->EchoPreTrace )
@@ -251,6 +299,93 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
     RegisterStats( );
 }
 
+/*
+ *  Channels only share this object, so with ParallelChannels each one can
+ *  run its own event queue on a worker thread. This needs a global event
+ *  queue to synchronize the channels, and is left off where channels reach
+ *  outside of themselves: the DRAM cache controllers issue to another
+ *  memory system, and hooks are called from every module. Completions are
+ *  also held until the end of a window, so anything acting on them, such
+ *  as the page migrators or the prefetch buffer, would see them late.
+ */
+void NVMain::CreateParallelChannels( int channels )
+{
+    if( !config->KeyExists( "ParallelChannels" ) || !config->GetBool( "ParallelChannels" ) )
+        return;
+
+    std::string reason = "";
+
+    if( channels < 2 )
+        reason = "there is only one channel";
+    else if( GetGlobalEventQueue( ) == NULL )
+        reason = "there is no global event queue";
+
+    std::vector<std::string>& hookList = config->GetHooks( );
+
+    if( !hookList.empty( ) )
+        reason = "the " + hookList[0] + " hook is enabled";
+    else if( p->MemoryPrefetcher != "none" )
+        reason = "the " + p->MemoryPrefetcher + " prefetcher is enabled";
+
+    /* Default to the shortest read latency of any channel. */
+    ncycle_t lookahead = std::numeric_limits<ncycle_t>::max( );
+
+    for( int i = 0; i < channels; i++ )
+    {
+        std::string controller = channelConfig[i]->GetString( "MEM_CTL" );
+
+        if( controller == "DRC" || controller == "LH_Cache" 
+            || controller == "LO_Cache" || controller == "PredictorDRC" )
+            reason = controller + " channels are not independent";
+
+        if( channelConfig[i]->KeyExists( "tCAS" ) )
+            lookahead = std::min( lookahead, 
+                    static_cast<ncycle_t>(channelConfig[i]->GetValue( "tCAS" )) );
+    }
+
+    if( config->KeyExists( "ParallelLookahead" ) )
+        lookahead = static_cast<ncycle_t>(config->GetValue( "ParallelLookahead" ));
+    else if( lookahead == std::numeric_limits<ncycle_t>::max( ) )
+        lookahead = 1;
+
+    unsigned int threads = std::thread::hardware_concurrency( );
+
+    if( config->KeyExists( "ParallelThreads" ) )
+        threads = static_cast<unsigned int>(config->GetValue( "ParallelThreads" ));
+
+    threads = std::min( threads, static_cast<unsigned int>(channels) );
+
+    if( reason == "" && threads < 2 )
+        reason = "there is only one thread";
+
+    if( reason != "" )
+    {
+        std::cout << "NVMain: Running channels serially since " << reason 
+                  << "." << std::endl;
+        return;
+    }
+
+    parallelChannels = new ParallelChannels( this, lookahead, threads );
+
+    for( int i = 0; i < channels; i++ )
+    {
+        EventQueue *queue = new EventQueue( );
+
+        queue->SetFrequency( GetEventQueue( )->GetFrequency( ) );
+        queue->SetCurrentCycle( GetEventQueue( )->GetCurrentCycle( ) );
+
+        channelQueues.push_back( queue );
+        parallelChannels->AddQueue( queue );
+    }
+
+    GetGlobalEventQueue( )->AddChannels( parallelChannels, 
+                                         GetEventQueue( )->GetFrequency( ) );
+
+    std::cout << "NVMain: Running " << channels << " channels on " << threads
+              << " threads with a lookahead of " << lookahead << " cycles." 
+              << std::endl;
+}
+
 bool NVMain::IsIssuable( NVMainRequest *request, FailReason *reason )
 {
     uint64_t channel, rank, bank, row, col, subarray;
@@ -513,6 +648,119 @@ void NVMain::Cycle( ncycle_t /*steps*/ )
 {
 }
 
+/* True unless this NVMain is nested below another, e.g. in a DRAM cache. */
+bool NVMain::IsOutermost( )
+{
+    NVMObject_hook *ancestor = GetParent( );
+
+    while( ancestor != NULL )
+    {
+        if( dynamic_cast<NVMain *>( ancestor->GetTrampoline( ) ) != NULL )
+            return false;
+
+        ancestor = ancestor->GetTrampoline( )->GetParent( );
+    }
+
+    return true;
+}
+
+/*
+ *  Hooks are shared with every module below the memory, so only the
+ *  outermost NVMain saves them. Hooks registered for both issue types
+ *  are listed once.
+ */
+std::vector<NVMObject *> NVMain::CheckpointHooks( )
+{
+    std::vector<NVMObject *> hookList;
+
+    if( !IsOutermost( ) )
+        return hookList;
+
+    for( int h = 0; h < static_cast<int>(NVMHOOK_COUNT); h++ )
+    {
+        std::vector<NVMObject *>& hooks = GetHooks( static_cast<HookType>(h) );
+
+        for( size_t i = 0; i < hooks.size( ); i++ )
+        {
+            if( std::find( hookList.begin( ), hookList.end( ), hooks[i] ) == hookList.end( ) )
+                hookList.push_back( hooks[i] );
+        }
+    }
+
+    return hookList;
+}
+
+/*
+ *  Saves the functional data, hooks, translator and every module below
+ *  into dir. Requests still queued are not saved, so the memory should be
+ *  drained first. Cycle counts are not saved either and restart at zero.
+ */
+void NVMain::CreateCheckpoint( std::string dir )
+{
+    if( !MakeDirectory( dir ) )
+    {
+        std::cout << StatName( ) << ": Warning: Could not create checkpoint "
+                  << "directory: " << dir << std::endl;
+        return;
+    }
+
+    std::string cpt_file = dir + "/" + StatName( );
+
+    /* The functional data is shared through the outermost memory's config. */
+    if( IsOutermost( ) && config->GetSimInterface( ) != NULL )
+        config->GetSimInterface( )->WriteCheckpoint( cpt_file + ".data" );
+
+    std::vector<NVMObject *> hookList = CheckpointHooks( );
+
+    for( size_t i = 0; i < hookList.size( ); i++ )
+        hookList[i]->CreateCheckpoint( dir );
+
+    NVMObject::CreateCheckpoint( dir );
+
+    /* Written last so a partial checkpoint is not mistaken for a full one. */
+    std::ofstream cpt_handle;
+    std::string cpt_info = cpt_file + ".json";
+
+    cpt_handle.open( cpt_info.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << StatName( ) << ": Warning: Could not open checkpoint " 
+                  << "info file: " << cpt_info << std::endl;
+    }
+    else
+    {
+        std::string cpt_info_str = "{\n\t\"Version\": 1\n}";
+        cpt_handle.write( cpt_info_str.c_str(), cpt_info_str.length() ); 
+
+        cpt_handle.close();
+    }
+}
+
+void NVMain::RestoreCheckpoint( std::string dir )
+{
+    std::string cpt_file = dir + "/" + StatName( );
+    std::string cpt_info = cpt_file + ".json";
+
+    std::ifstream cpt_handle( cpt_info.c_str() );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << StatName( ) << ": Warning: No complete checkpoint in "
+                  << dir << ". Restoring whatever is there." << std::endl;
+    }
+
+    if( IsOutermost( ) && config->GetSimInterface( ) != NULL )
+        config->GetSimInterface( )->ReadCheckpoint( cpt_file + ".data" );
+
+    std::vector<NVMObject *> hookList = CheckpointHooks( );
+
+    for( size_t i = 0; i < hookList.size( ); i++ )
+        hookList[i]->RestoreCheckpoint( dir );
+
+    NVMObject::RestoreCheckpoint( dir );
+}
+
 void NVMain::RegisterStats( )
 {
     AddStat(totalReadRequests);
@@ -527,6 +775,73 @@ void NVMain::CalculateStats( )
         memoryControllers[i]->CalculateStats( );
 }
 
+void NVMain::PrintStats( std::ostream& stream )
+{
+    CalculateStats( );
+    GetStats( )->PrintAll( stream );
+}
+
+/*
+ *  Returns every stat to its initial value, like gem5's stats reset. Modules
+ *  which scale by elapsed time (e.g., power) restart their time base too.
+ */
+void NVMain::ResetAllStats( )
+{
+    GetStats( )->ResetAll( );
+    ResetStats( );
+}
+
+/*
+ *  Dumps stats every PeriodicStatsInterval cycles to the given stream, or as
+ *  CSV rows to PeriodicStatsFile if it is set. If PeriodicStatsReset is true
+ *  the stats are reset after each dump so every interval stands alone. This
+ *  should be called once on the top level memory after SetConfig.
+ */
+void NVMain::EnableIntervalStats( std::ostream *stream )
+{
+    if( p->PeriodicStatsInterval == 0 )
+        return;
+
+    intervalStream = stream;
+
+    if( config->KeyExists( "PeriodicStatsFile" ) )
+    {
+        intervalFile.open( config->GetString( "PeriodicStatsFile" ).c_str( ),
+                           std::ofstream::out | std::ofstream::trunc );
+
+        if( !intervalFile.is_open( ) )
+        {
+            std::cout << "NVMain: Warning: Could not open periodic stats file "
+                      << config->GetString( "PeriodicStatsFile" ) << std::endl;
+        }
+        else
+        {
+            GetStats( )->PrintIntervalHeader( intervalFile );
+        }
+    }
+
+    GetEventQueue( )->InsertCallback( this, 
+                      (CallbackPtr)&NVMain::IntervalStatsCallback,
+                      GetEventQueue( )->GetCurrentCycle( ) + p->PeriodicStatsInterval );
+}
+
+void NVMain::IntervalStatsCallback( void * /*data*/ )
+{
+    CalculateStats( );
+
+    if( intervalFile.is_open( ) )
+        GetStats( )->PrintInterval( intervalFile, GetEventQueue( )->GetCurrentCycle( ) );
+    else if( intervalStream != NULL )
+        GetStats( )->PrintAll( *intervalStream );
+
+    if( p->PeriodicStatsReset )
+        ResetAllStats( );
+
+    GetEventQueue( )->InsertCallback( this, 
+                      (CallbackPtr)&NVMain::IntervalStatsCallback,
+                      GetEventQueue( )->GetCurrentCycle( ) + p->PeriodicStatsInterval );
+}
+
 void NVMain::EnqueuePendingMemoryRequests( NVMainRequest *req )
 {
     pendingMemoryRequests.push(req);
@@ -53,6 +53,7 @@ class Interconnect;
 class AddressTranslator;
 class SimInterface;
 class NVMainRequest;
+class ParallelChannels;
 
 class NVMain : public NVMObject
 {
@@ -63,6 +64,8 @@ class NVMain : public NVMObject
     void SetConfig( Config *conf, std::string memoryName = "defaultMemory", bool createChildren = true );
 
     Config *GetConfig( );
+    Config *GetChannelConfig( ncounter_t channel );
+    ncounter_t GetNumChannels( );
 
     void IssuePrefetch( NVMainRequest *request );
     bool IssueCommand( NVMainRequest *request );
@@ -76,8 +79,16 @@ class NVMain : public NVMObject
     void RegisterStats( );
     void CalculateStats( );
 
+    void PrintStats( std::ostream& stream = std::cout );
+    void ResetAllStats( );
+    void EnableIntervalStats( std::ostream *stream );
+    void IntervalStatsCallback( void *data );
+
     void Cycle( ncycle_t steps );
 
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
     void EnqueuePendingMemoryRequests( NVMainRequest *request );
 
   private:
@@ -98,9 +109,20 @@ class NVMain : public NVMObject
     std::list<NVMainRequest *> prefetchBuffer;
     std::queue<NVMainRequest *> pendingMemoryRequests;
 
+    /* Channels running on worker threads, NULL when they run serially. */
+    ParallelChannels *parallelChannels;
+    std::vector<EventQueue *> channelQueues;
+
     std::ofstream pretraceOutput;
+
+    /* Stats are dumped to intervalStream, or as CSV rows to intervalFile. */
+    std::ostream *intervalStream;
+    std::ofstream intervalFile;
     GenericTraceWriter *preTracer;
 
+    void CreateParallelChannels( int channels );
+    bool IsOutermost( );
+    std::vector<NVMObject *> CheckpointHooks( );
     void PrintPreTrace( NVMainRequest *request );
     void GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>& prefetchList );
 };
@@ -951,23 +951,30 @@ void StandardRank::CalculateStats( )
     totalPower = backgroundPower = activatePower = burstPower = refreshPower = 0.0;
     reads = writes = 0;
 
-    for( ncounter_t i = 0; i < bankCount; i++ )
+    if( bankStats.empty( ) )
     {
-        StatType bankEstat = GetStat( GetChild(i), "bankEnergy" );
-        StatType actEstat =  GetStat( GetChild(i), "activeEnergy" );
-        StatType bstEstat =  GetStat( GetChild(i), "burstEnergy" );
-        StatType refEstat =  GetStat( GetChild(i), "refreshEnergy" );
+        bankStats.resize( bankCount );
 
-        totalEnergy += CastStat( bankEstat, double );
-        activateEnergy += CastStat( actEstat, double );
-        burstEnergy += CastStat( bstEstat, double );
-        refreshEnergy += CastStat( refEstat, double );
+        for( ncounter_t i = 0; i < bankCount; i++ )
+        {
+            bankStats[i].bankEnergy = GetStat( GetChild(i), "bankEnergy" );
+            bankStats[i].activeEnergy = GetStat( GetChild(i), "activeEnergy" );
+            bankStats[i].burstEnergy = GetStat( GetChild(i), "burstEnergy" );
+            bankStats[i].refreshEnergy = GetStat( GetChild(i), "refreshEnergy" );
+            bankStats[i].reads = GetStat( GetChild(i), "reads" );
+            bankStats[i].writes = GetStat( GetChild(i), "writes" );
+        }
+    }
 
-        StatType readCount = GetStat( GetChild(i), "reads" );
-        StatType writeCount = GetStat( GetChild(i), "writes" );
+    for( ncounter_t i = 0; i < bankCount; i++ )
+    {
+        totalEnergy += CastStat( bankStats[i].bankEnergy, double );
+        activateEnergy += CastStat( bankStats[i].activeEnergy, double );
+        burstEnergy += CastStat( bankStats[i].burstEnergy, double );
+        refreshEnergy += CastStat( bankStats[i].refreshEnergy, double );
 
-        reads += CastStat( readCount, ncounter_t );
-        writes += CastStat( writeCount, ncounter_t );
+        reads += CastStat( bankStats[i].reads, ncounter_t );
+        writes += CastStat( bankStats[i].writes, ncounter_t );
     }
 
 
@@ -1027,6 +1034,8 @@ void StandardRank::CalculateStats( )
 
 void StandardRank::ResetStats( )
 {
+    NVMObject::ResetStats( );
+
     lastReset = GetEventQueue()->GetCurrentCycle();
 }
 
@@ -41,6 +41,7 @@
 
 #include <cstdint>
 #include <list>
+#include <vector>
 #include <iostream>
 
 namespace NVM {
@@ -132,6 +133,14 @@ class StandardRank : public Rank
 
     ncounter_t reads, writes;
 
+    /* Bank stats summed by CalculateStats, looked up once. */
+    struct BankStats
+    {
+        StatType bankEnergy, activeEnergy, burstEnergy, refreshEnergy;
+        StatType reads, writes;
+    };
+    std::vector<BankStats> bankStats;
+
     double totalEnergy, backgroundEnergy, activateEnergy, burstEnergy, refreshEnergy;
     double totalPower, backgroundPower, activatePower, burstPower, refreshPower;
 
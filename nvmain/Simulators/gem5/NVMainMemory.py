@@ -46,6 +46,8 @@ class NVMainMemory(AbstractMemory):
     configparams = Param.String("", "")
     configvalues = Param.String("", "")
     NVMainWarmUp = Param.Bool(False, "Enable to warm up the internal cache in NVMain")
+    tech_map = Param.MemoryTechnologyMap(NULL,
+        "DRAM/NVM classification to populate from the channel configs")
 
 
     def __init__(self, *args, **kwargs):
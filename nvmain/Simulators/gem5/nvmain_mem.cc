@@ -42,6 +42,8 @@
  *
  */
 
+#include <limits>
+
 #include "SimInterface/Gem5Interface/Gem5Interface.h"
 #include "Simulators/gem5/nvmain_mem.hh"
 #include "Utils/HookFactory.h"
@@ -63,10 +65,11 @@ using namespace NVM;
 NVMainMemory *NVMainMemory::masterInstance = NULL;
 
 NVMainMemory::NVMainMemory(const Params *p)
-    : AbstractMemory(p), clockEvent(this), respondEvent(this),
-      drainManager(NULL), lat(p->atomic_latency),
+    : AbstractMemory(p), clockEvent(this), respondEvent(this), retryEvent(this),
+      lat(p->atomic_latency),
       lat_var(p->atomic_variance), nvmain_atomic(p->atomic_mode),
-      NVMainWarmUp(p->NVMainWarmUp), port(name() + ".port", *this)
+      NVMainWarmUp(p->NVMainWarmUp), techMap(p->tech_map),
+      port(name() + ".port", *this)
 {
     char *cfgparams;
     char *cfgvalues;
@@ -74,8 +77,6 @@ NVMainMemory::NVMainMemory(const Params *p)
 
     char *saveptr1, *saveptr2;
 
-    nextEventCycle = 0;
-
     m_nvmainPtr = NULL;
     m_nacked_requests = false;
 
@@ -91,10 +92,10 @@ NVMainMemory::NVMainMemory(const Params *p)
     m_avgAtomicLatency = 100.0f;
     m_numAtomicAccesses = 0;
 
-    retryRead = false;
-    retryWrite = false;
+    retryReq = false;
     retryResp = false;
     m_requests_outstanding = 0;
+    inSync = false;
 
     /*
      * Modified by Tao @ 01/22/2013
@@ -118,6 +119,9 @@ NVMainMemory::NVMainMemory(const Params *p)
    tBURST = m_nvmainConfig->GetValue( "tBURST" );
    RATE = m_nvmainConfig->GetValue( "RATE" );
 
+   ignoreData = m_nvmainConfig->KeyExists( "IgnoreData" )
+             && m_nvmainConfig->GetString( "IgnoreData" ) == "true";
+
    lastWakeup = curTick();
 }
 
@@ -170,10 +174,16 @@ NVMainMemory::init()
         SetStats( m_statsPtr );
         SetTagGenerator( m_tagGenerator );
 
-        m_nvmainGlobalEventQueue->SetFrequency( m_nvmainConfig->GetEnergy( "CPUFreq" ) * 1000000.0 );
-        SetGlobalEventQueue( m_nvmainGlobalEventQueue );
+        /* One global cycle is one period of this memory's gem5 clock. */
+        double memoryFrequency = static_cast<double>(SimClock::Frequency) / clock;
 
-        // TODO: Confirm global event queue frequency is the same as this SimObject's clock.
+        fatal_if(m_nvmainConfig->GetEnergy( "CLK" ) * 1000000.0 > memoryFrequency,
+                 "NVMain CLK (%f MHz) is faster than the clock of %s (%f MHz)\n",
+                 m_nvmainConfig->GetEnergy( "CLK" ), name(),
+                 memoryFrequency / 1000000.0);
+
+        m_nvmainGlobalEventQueue->SetFrequency( memoryFrequency );
+        SetGlobalEventQueue( m_nvmainGlobalEventQueue );
 
         /*  Add any specified hooks */
         std::vector<std::string>& hookList = m_nvmainConfig->GetHooks( );
@@ -203,30 +213,134 @@ NVMainMemory::init()
         m_nvmainGlobalEventQueue->AddSystem( m_nvmainPtr, m_nvmainConfig );
         m_nvmainPtr->SetConfig( m_nvmainConfig );
 
+        /* PeriodicStatsInterval dumps go where gem5 stat dumps go. */
+        std::ostream& refStream = (statPrinter.statStream.is_open())
+                                ? statPrinter.statStream : std::cout;
+        m_nvmainPtr->EnableIntervalStats( &refStream );
+
         masterInstance->allInstances.push_back(this);
+
+        /* Pages moved by a migrating decoder (Migrator or MQMigrator) change technology. */
+        MigrationNotifier *migrator = dynamic_cast<MigrationNotifier *>( m_nvmainPtr->GetDecoder( ) );
+        if( migrator != NULL )
+            migrator->SetListener( this );
     }
     else
     {
         masterInstance->allInstances.push_back(this);
         masterInstance->otherInstance = this;
     }
+
+    if( techMap != NULL )
+        populateTechMap( );
 }
 
 
-void NVMainMemory::startup()
+void
+NVMainMemory::populateTechMap( )
 {
-    DPRINTF(NVMain, "NVMainMemory: startup() called.\n");
-    DPRINTF(NVMainMin, "NVMainMemory: startup() called.\n");
+    NVM::NVMain *nvmainPtr = masterInstance->m_nvmainPtr;
 
     /*
-     *  Schedule the initial event. Needed for warmup and timing mode.
-     *  If we are in atomic/fast-forward, wakeup will be disabled upon
-     *  the first atomic request receieved in recvAtomic().
+     *  Channels declare their technology with the MemoryTechnology key. Older
+     *  channel configs lack it, in which case refresh tells DRAM from NVM.
      */
-    if (!masterInstance->clockEvent.scheduled())
-        schedule(masterInstance->clockEvent, curTick() + clock);
+    nvmChannels.resize( nvmainPtr->GetNumChannels( ) );
+    for( size_t i = 0; i < nvmChannels.size( ); i++ )
+    {
+        Config *channelConfig = nvmainPtr->GetChannelConfig( i );
+
+        if( channelConfig->KeyExists( "MemoryTechnology" ) )
+        {
+            std::string tech = channelConfig->GetString( "MemoryTechnology" );
+
+            fatal_if(tech != "DRAM" && tech != "NVM",
+                     "Unknown MemoryTechnology `%s' for channel %d\n",
+                     tech, i);
+            nvmChannels[i] = (tech == "NVM");
+        }
+        else
+        {
+            nvmChannels[i] = !channelConfig->GetBool( "UseRefresh" );
+        }
+
+        DPRINTF(NVMain, "Channel %d is %s\n", i,
+                nvmChannels[i] ? "NVM" : "DRAM");
+    }
+
+    /* Ask the decoder which channel serves each page of this instance. */
+    AddressTranslator *decoder = nvmainPtr->GetDecoder( );
+    const AddrRange range = getAddrRange( );
+    const uint64_t addressFixUp = AddressFixUp( );
+
+    for( Addr addr = range.start( ); addr <= range.end( ) && addr >= range.start( );
+         addr += techMap->pageSize( ) )
+    {
+        techMap->setNVM( addr, nvmChannels[decoder->GetChannel( addr - addressFixUp )] );
+    }
+}
+
+
+void
+NVMainMemory::PageMigrated( uint64_t address, uint64_t channel )
+{
+    DPRINTF(NVMain, "Page %#x migrated to channel %d\n", address, channel);
+
+    /* NVMain addresses are linear, find the instance holding the page. */
+    for( auto it = allInstances.begin(); it != allInstances.end(); it++ )
+    {
+        NVMainMemory *instance = *it;
+        Addr addr = address + instance->AddressFixUp( );
+
+        if( instance->techMap == NULL || !instance->getAddrRange( ).contains( addr ) )
+            continue;
+
+        assert( channel < instance->nvmChannels.size( ) );
+        instance->techMap->setNVM( addr, instance->nvmChannels[channel] );
+    }
+}
+
+
+/*
+ *  NVMain expects linear addresses, so hack: If we are not the master
+ *  instance, assume there are two channels because 3GB-4GB is skipped
+ *  in X86 and subtract 1GB.
+ *
+ *  TODO: Have each channel communicate it's address range to determine
+ *  this fix up value.
+ */
+uint64_t
+NVMainMemory::AddressFixUp( ) const
+{
+    uint64_t addressFixUp = 0;
+#if THE_ISA == X86_ISA
+    if( masterInstance != this )
+    {
+        addressFixUp = 0x40000000;
+    }
+#elif THE_ISA == ARM_ISA
+    /* 
+     *  ARM regions are 2GB - 4GB followed by 34 GB - 64 GB. Work for up to
+     *  34 GB of memory. Further regions from 512 GB - 992 GB.
+     */
+    addressFixUp = (masterInstance == this) ? 0x80000000 : 0x800000000;
+#endif
+
+    return addressFixUp;
+}
+
+
+void NVMainMemory::startup()
+{
+    DPRINTF(NVMain, "NVMainMemory: startup() called.\n");
+    DPRINTF(NVMainMin, "NVMainMemory: startup() called.\n");
 
+    /* NVMain's global cycle zero is the tick the simulation starts at. */
     lastWakeup = curTick();
+
+    /* Schedule the first wakeup, if NVMain has anything pending yet. */
+    if( masterInstance == this )
+        ScheduleWakeup( );
 }
 
 
@@ -235,9 +349,8 @@ void NVMainMemory::wakeup()
     DPRINTF(NVMain, "NVMainMemory: wakeup() called.\n");
     DPRINTF(NVMainMin, "NVMainMemory: wakeup() called.\n");
 
-    schedule(masterInstance->clockEvent, clockEdge());
-
-    lastWakeup = curTick();
+    masterInstance->Sync( );
+    masterInstance->ScheduleWakeup( );
 }
 
 
@@ -256,10 +369,9 @@ void NVMainMemory::NVMainStatPrinter::process()
 {
     assert(nvmainPtr != NULL);
 
-    assert(curTick() >= memory->lastWakeup);
-    Tick stepCycles = (curTick() - memory->lastWakeup) / memory->clock;
-
-    memory->m_nvmainGlobalEventQueue->Cycle( stepCycles );
+    /* Bring NVMain up to the current tick before printing. */
+    memory->Sync( );
+    memory->ScheduleWakeup( );
 
     nvmainPtr->CalculateStats();
     std::ostream& refStream = (statStream.is_open()) ? statStream : std::cout;
@@ -291,57 +403,92 @@ AddrRangeList NVMainMemory::MemoryPort::getAddrRanges() const
 }
 
 
+/*
+ *  Fill the data blocks of a pooled request, reusing their buffers. Each
+ *  block is copied once, straight from the backing store or the packet;
+ *  oldData holds the contents of memory before the access.
+ */
 void
 NVMainMemory::SetRequestData(NVMainRequest *request, PacketPtr pkt)
 {
-    uint8_t *hostAddr;
+    if( ignoreData )
+        return;
+
+    unsigned int size = pkt->getSize();
 
-    request->data.SetSize( pkt->getSize() );
-    request->oldData.SetSize( pkt->getSize() );
+    request->oldData.SetSize( size );
+    request->data.SetSize( size );
 
-    if (pkt->isRead())
+    if( pmemAddr != NULL )
     {
-        Request *dataReq = new Request(pkt->getAddr(), pkt->getSize(), 0, Request::funcMasterId);
-        Packet *dataPkt = new Packet(dataReq, MemCmd::ReadReq);
-        dataPkt->allocate();
-        doFunctionalAccess(dataPkt);
+        const uint8_t *hostAddr = pmemAddr + pkt->getAddr() - range.start();
 
-        hostAddr = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddr, dataPkt->getPtr<uint8_t>(), pkt->getSize() );
+        memcpy( request->oldData.rawData, hostAddr, size );
 
-        for(int i = 0; i < pkt->getSize(); i++ )
-        {
-            request->oldData.SetByte(i, *(hostAddr + i));
-            request->data.SetByte(i, *(hostAddr + i));
-        }
+        if( pkt->isRead() )
+            memcpy( request->data.rawData, hostAddr, size );
+    }
+    else
+    {
+        memset( request->oldData.rawData, 0, size );
 
-        delete dataPkt;
-        delete dataReq;
-        delete [] hostAddr;
+        if( pkt->isRead() )
+            memset( request->data.rawData, 0, size );
+    }
+
+    if( !pkt->isRead() )
+        memcpy( request->data.rawData, pkt->getConstPtr<uint8_t>(), size );
+}
+
+
+/*
+ *  Requests and their completion context come from the master instance,
+ *  which is where NVMain completes them.
+ */
+NVMainMemory::NVMainMemoryRequest *
+NVMainMemory::AllocateRequest( )
+{
+    NVMainMemoryRequest *memRequest;
+
+    if( freeMemRequests.empty() )
+    {
+        memRequest = new NVMainMemoryRequest;
     }
     else
     {
-        Request *dataReq = new Request(pkt->getAddr(), pkt->getSize(), 0, Request::funcMasterId);
-        Packet *dataPkt = new Packet(dataReq, MemCmd::ReadReq);
-        dataPkt->allocate();
-        doFunctionalAccess(dataPkt);
+        memRequest = freeMemRequests.back();
+        freeMemRequests.pop_back();
+    }
 
-        uint8_t *hostAddrT = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddrT, dataPkt->getPtr<uint8_t>(), pkt->getSize() );
+    memRequest->request = requestPool.Allocate( );
+    memRequest->request->reqInfo = memRequest;
+    memRequest->packet = NULL;
+    memRequest->issueTick = curTick();
+    memRequest->atomic = false;
 
-        hostAddr = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddr, pkt->getPtr<uint8_t>(), pkt->getSize() );
+    m_requests_outstanding++;
+
+    return memRequest;
+}
 
-        for(int i = 0; i < pkt->getSize(); i++ )
-        {
-            request->oldData.SetByte(i, *(hostAddrT + i));
-            request->data.SetByte(i, *(hostAddr + i));
-        }
 
-        delete dataPkt;
-        delete dataReq;
-        delete [] hostAddrT;
-        delete [] hostAddr;
+void
+NVMainMemory::ReleaseRequest( NVMainMemoryRequest *memRequest )
+{
+    requestPool.Release( memRequest->request );
+    memRequest->request = NULL;
+    memRequest->packet = NULL;
+
+    freeMemRequests.push_back( memRequest );
+
+    assert( m_requests_outstanding > 0 );
+    m_requests_outstanding--;
+
+    /* Every instance waits on the requests of all of them. */
+    if( m_requests_outstanding == 0 )
+    {
+        for( auto it = allInstances.begin(); it != allInstances.end(); it++ )
+            (*it)->CheckDrainState( );
     }
 }
 
@@ -363,19 +510,14 @@ NVMainMemory::MemoryPort::recvAtomic(PacketPtr pkt)
     /*
      *  if NVMain also needs the packet to warm up the inline cache, create the request
      */
-    if( memory.NVMainWarmUp )
+    if( memory.NVMainWarmUp && (pkt->isRead() || pkt->isWrite()) )
     {
-        NVMainRequest *request = new NVMainRequest( );
+        NVMainMemoryRequest *memRequest = memory.masterInstance->AllocateRequest( );
+        NVMainRequest *request = memRequest->request;
 
+        memRequest->atomic = true;
         memory.SetRequestData( request, pkt );
 
-        if( !pkt->isRead() && !pkt->isWrite() )
-        {
-            // if it is neither read nor write, just return
-            // well, speed may suffer a little bit...
-            return latency;
-        }
-
         /* initialize the request so that NVMain can correctly serve it */
         request->access = UNKNOWN_ACCESS;
         request->address.SetPhysicalAddress(pkt->req->getPaddr());
@@ -390,7 +532,7 @@ NVMainMemory::MemoryPort::recvAtomic(PacketPtr pkt)
          */
         memory.masterInstance->m_nvmainPtr->IssueAtomic(request);
 
-        delete request;
+        memory.masterInstance->ReleaseRequest( memRequest );
     }
 
     /*
@@ -421,14 +563,8 @@ bool
 NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
     /* added by Tao @ 01/24/2013, just copy the code from SimpleMemory */
-    /// @todo temporary hack to deal with memory corruption issues until
-    /// 4-phase transactions are complete
-    for (int x = 0; x < memory.pendingDelete.size(); x++)
-        delete memory.pendingDelete[x];
-    memory.pendingDelete.clear();
-
     if (pkt->cacheResponding()) {
-        memory.pendingDelete.push_back(pkt);
+        memory.pendingDelete.reset(pkt);
         return true;
     }
 
@@ -448,14 +584,14 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
 
             memory.ScheduleResponse( );
         } else {
-            memory.pendingDelete.push_back(pkt);
+            memory.pendingDelete.reset(pkt);
         }
 
         return true;
     }
 
 
-    if (memory.retryRead || memory.retryWrite)
+    if (memory.retryReq)
     {
         DPRINTF(NVMain, "nvmain_mem.cc: Received request while waiting for retry!\n");
         DPRINTF(NVMainMin, "nvmain_mem.cc: Received request while waiting for retry!\n");
@@ -465,33 +601,17 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
     // Bus latency is modeled in NVMain.
     pkt->headerDelay = pkt->payloadDelay = 0;
 
-    NVMainRequest *request = new NVMainRequest( );
+    NVMainMemoryRequest *memRequest = memory.masterInstance->AllocateRequest( );
+    NVMainRequest *request = memRequest->request;
 
     bool canQueue, enqueued = false;
 
     memory.SetRequestData( request, pkt );
 
-    /*
-     *  NVMain expects linear addresses, so hack: If we are not the master
-     *  instance, assume there are two channels because 3GB-4GB is skipped
-     *  in X86 and subtract 1GB.
-     *
-     *  TODO: Have each channel communicate it's address range to determine
-     *  this fix up value.
-     */
-    uint64_t addressFixUp = 0;
-#if THE_ISA == X86_ISA
-    if( masterInstance != &memory )
-    {
-        addressFixUp = 0x40000000;
-    }
-#elif THE_ISA == ARM_ISA
-    /* 
-     *  ARM regions are 2GB - 4GB followed by 34 GB - 64 GB. Work for up to
-     *  34 GB of memory. Further regions from 512 GB - 992 GB.
-     */
-    addressFixUp = (masterInstance == &memory) ? 0x80000000 : 0x800000000;
-#endif
+    uint64_t addressFixUp = memory.AddressFixUp( );
+
+    /* Bring NVMain up to the arrival time of this request. */
+    memory.masterInstance->Sync( );
 
     request->access = UNKNOWN_ACCESS;
     request->address.SetPhysicalAddress(pkt->req->getPaddr() - addressFixUp);
@@ -521,75 +641,34 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
         enqueued = memory.masterInstance->GetChild( )->IssueCommand(request);
         assert( enqueued == true );
 
-        NVMainMemoryRequest *memRequest = new NVMainMemoryRequest;
-
-        memRequest->request = request;
         memRequest->packet = pkt;
-        memRequest->issueTick = curTick();
-        memRequest->atomic = false;
 
         DPRINTF(NVMain, "nvmain_mem.cc: Enqueued Mem request for 0x%x of type %s\n", request->address.GetPhysicalAddress( ), ((pkt->isRead()) ? "READ" : "WRITE") );
 
-        /* See if we need to reschedule the wakeup event sooner. */
-        ncycle_t nextEvent = memory.masterInstance->m_nvmainGlobalEventQueue->GetNextEvent(NULL);
-        DPRINTF(NVMain, "NVMainMemory: Next event after issue is %d\n", nextEvent);
-        if( nextEvent < memory.nextEventCycle && masterInstance->clockEvent.scheduled() )
-        {
-            ncycle_t currentCycle = memory.masterInstance->m_nvmainGlobalEventQueue->GetCurrentCycle();
-
-            //assert(nextEvent >= currentCycle);
-            ncycle_t stepCycles;
-            if( nextEvent > currentCycle )
-                stepCycles = nextEvent - currentCycle;
-            else
-                stepCycles = 1;
-
-            Tick nextWake = curTick() + memory.clock * static_cast<Tick>(stepCycles);
-
-            DPRINTF(NVMain, "NVMainMemory: Next event: %d CurrentCycle: %d\n", nextEvent, currentCycle);
-            DPRINTF(NVMain, "NVMainMemory: Rescheduled wake at %d after %d cycles\n", nextWake, stepCycles);
-
-            memory.nextEventCycle = nextEvent;
-            memory.ScheduleClockEvent( nextWake );
-        }
-        else if( !masterInstance->clockEvent.scheduled() )
-        {
-            ncycle_t currentCycle = memory.masterInstance->m_nvmainGlobalEventQueue->GetCurrentCycle();
-
-            //assert(nextEvent >= currentCycle);
-            ncycle_t stepCycles = nextEvent - currentCycle;
-            if( stepCycles == 0 || nextEvent < currentCycle )
-                stepCycles = 1;
-
-            Tick nextWake = curTick() + memory.clock * static_cast<Tick>(stepCycles);
-
-            memory.nextEventCycle = nextEvent;
-            memory.ScheduleClockEvent( nextWake );
-        }
-
-        memory.masterInstance->m_request_map.insert( std::pair<NVMainRequest *, NVMainMemoryRequest *>( request, memRequest ) );
-        memory.m_requests_outstanding++;
+        /* The new request may need NVMain earlier than the pending wakeup. */
+        memory.masterInstance->ScheduleWakeup( );
 
         /*
-         *  It seems gem5 will block until the packet gets a response, so create a copy of the request, so
-         *  the memory controller has it, then delete the original copy to respond to the packet.
+         *  It seems gem5 will block until the packet gets a response, so respond
+         *  to writes now. The memory controller keeps the request until it is
+         *  written, at which point it completes without a packet.
          */
         if( request->type == WRITE )
         {
-            NVMainMemoryRequest *requestCopy = new NVMainMemoryRequest( );
-
-            requestCopy->request = new NVMainRequest( );
-            *(requestCopy->request) = *request;
-            requestCopy->packet = pkt;
-            requestCopy->issueTick = curTick();
-            requestCopy->atomic = false;
+            bool needsResponse = pkt->needsResponse();
 
             memRequest->packet = NULL;
+            memory.access(pkt);
 
-            memory.masterInstance->m_request_map.insert( std::pair<NVMainRequest *, NVMainMemoryRequest *>( requestCopy->request, requestCopy ) );
-            memory.m_requests_outstanding++;
-
-            memory.RequestComplete( requestCopy->request );
+            if( needsResponse )
+            {
+                memory.responseQueue.push_back(pkt);
+                memory.ScheduleResponse( );
+            }
+            else
+            {
+                memory.pendingDelete.reset(pkt);
+            }
         }
 
         /* Call post-issue hooks. */
@@ -607,16 +686,10 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
         DPRINTF(NVMain, "nvmain_mem.cc: Can not enqueue Mem request for 0x%x of type %s\n", request->address.GetPhysicalAddress( ), ((pkt->isRead()) ? "READ" : "WRITE") );
         DPRINTF(NVMainMin, "nvmain_mem.cc: Can not enqueue Mem request for 0x%x of type %s\n", request->address.GetPhysicalAddress( ), ((pkt->isRead()) ? "READ" : "WRITE") );
 
-        if (pkt->isRead())
-        {
-            memory.retryRead = true;
-        }
-        else
-        {
-            memory.retryWrite = true;
-        }
+        /* Rejecting the same packet again still owes the port one retry. */
+        memory.retryReq = true;
 
-        delete request;
+        memory.masterInstance->ReleaseRequest( memRequest );
         request = NULL;
     }
 
@@ -639,16 +712,27 @@ void NVMainMemory::doFunctionalAccess(PacketPtr pkt)
 }
 
 
+/*
+ *  Requests inside NVMain are not part of a checkpoint, so draining waits
+ *  for every request handed to NVMain to complete and for the responses
+ *  and retries owed to this port to be sent.
+ */
 DrainState NVMainMemory::drain()
 {
-    if( !masterInstance->m_request_map.empty() )
-    {
-        return DrainState::Draining;
-    }
-    else
-    {
+    if( IsDrained( ) )
         return DrainState::Drained;
-    }
+
+    DPRINTF(NVMain, "NVMainMemory: Draining %d outstanding requests.\n",
+            masterInstance->m_requests_outstanding);
+
+    return DrainState::Draining;
+}
+
+
+bool NVMainMemory::IsDrained( ) const
+{
+    return masterInstance->m_requests_outstanding == 0
+           && responseQueue.empty( ) && !retryReq;
 }
 
 
@@ -677,7 +761,6 @@ void NVMainMemory::recvRetry( )
 bool NVMainMemory::RequestComplete(NVM::NVMainRequest *req)
 {
     bool isRead = (req->type == READ || req->type == READ_PRECHARGE);
-    bool isWrite = (req->type == WRITE || req->type == WRITE_PRECHARGE);
 
     /* Ignore bus read/write requests generated by the banks. */
     if( req->type == BUS_WRITE || req->type == BUS_READ )
@@ -686,13 +769,10 @@ bool NVMainMemory::RequestComplete(NVM::NVMainRequest *req)
         return true;
     }
 
-    NVMainMemoryRequest *memRequest;
-    std::map<NVMainRequest *, NVMainMemoryRequest *>::iterator iter;
+    NVMainMemoryRequest *memRequest =
+        static_cast<NVMainMemoryRequest *>( req->reqInfo );
 
-    // Find the mem request pointer in the map.
-    assert(masterInstance->m_request_map.count(req) != 0);
-    iter = masterInstance->m_request_map.find(req);
-    memRequest = iter->second;
+    assert( memRequest != NULL && memRequest->request == req );
 
     if(!memRequest->atomic)
     {
@@ -707,52 +787,21 @@ bool NVMainMemory::RequestComplete(NVM::NVMainRequest *req)
             ownerInstance->access(memRequest->packet);
         }
 
-        for( auto retryIter = masterInstance->allInstances.begin(); 
-             retryIter != masterInstance->allInstances.end(); retryIter++ )
-        {
-            if( (*retryIter)->retryRead && (isRead || isWrite) )
-            {
-                (*retryIter)->retryRead = false;
-                (*retryIter)->port.sendRetryReq();
-            }
-            if( (*retryIter)->retryWrite && (isRead || isWrite) )
-            {
-                (*retryIter)->retryWrite = false;
-                (*retryIter)->port.sendRetryReq();
-            }
-        }
-
         DPRINTF(NVMain, "Completed Mem request for 0x%x of type %s\n", req->address.GetPhysicalAddress( ), (isRead ? "READ" : "WRITE"));
 
         if(respond)
         {
             ownerInstance->responseQueue.push_back(memRequest->packet);
             ownerInstance->ScheduleResponse( );
-
-            delete req;
-            delete memRequest;
         }
         else
         {
             if( memRequest->packet )
-                ownerInstance->pendingDelete.push_back(memRequest->packet);
-
-            CheckDrainState( );
-
-            delete req;
-            delete memRequest;
+                ownerInstance->pendingDelete.reset(memRequest->packet);
         }
     }
-    else
-    {
-        delete req;
-        delete memRequest;
-    }
-
 
-    masterInstance->m_request_map.erase(iter);
-    //assert(m_requests_outstanding > 0);
-    m_requests_outstanding--;
+    masterInstance->ReleaseRequest( memRequest );
 
     return true;
 }
@@ -789,13 +838,12 @@ void NVMainMemory::SendResponses( )
 
 void NVMainMemory::CheckDrainState( )
 {
-    if( drainManager != NULL && masterInstance->m_request_map.empty() )
+    if( drainState( ) == DrainState::Draining && IsDrained( ) )
     {
         DPRINTF(NVMain, "NVMainMemory: Drain completed.\n");
         DPRINTF(NVMainMin, "NVMainMemory: Drain completed.\n");
 
-        drainManager->signalDrainDone( );
-        drainManager = NULL;
+        signalDrainDone( );
     }
 }
 
@@ -807,89 +855,167 @@ void NVMainMemory::ScheduleResponse( )
 }
 
 
-void NVMainMemory::ScheduleClockEvent( Tick nextWake )
+/*
+ *  NVMain has run, so queue slots may have freed. Retry every port that
+ *  was turned away, from an event of its own so that retried requests do
+ *  not issue while NVMain is running or another request is being received.
+ */
+void NVMainMemory::ScheduleRetries( )
 {
-    if( !masterInstance->clockEvent.scheduled() )
-        schedule(masterInstance->clockEvent, nextWake);
-    else
-        reschedule(masterInstance->clockEvent, nextWake);
+    assert( masterInstance == this );
+
+    for( auto it = allInstances.begin(); it != allInstances.end(); it++ )
+    {
+        if( (*it)->retryReq )
+        {
+            if( !retryEvent.scheduled( ) )
+                schedule(retryEvent, curTick());
+            return;
+        }
+    }
 }
 
 
-void NVMainMemory::serialize(CheckpointOut &cp) const
+void NVMainMemory::SendRetries( )
 {
-    if (masterInstance != this)
-        return;
-
-    std::string nvmain_chkpt_dir = "";
-
-    if( m_nvmainConfig->KeyExists( "CheckpointDirectory" ) )
-        nvmain_chkpt_dir = m_nvmainConfig->GetString( "CheckpointDirectory" );
+    assert( masterInstance == this );
 
-    if( nvmain_chkpt_dir != "" )
+    for( auto it = allInstances.begin(); it != allInstances.end(); it++ )
     {
-        std::cout << "NVMainMemory: Writing to checkpoint directory " << nvmain_chkpt_dir << std::endl;
+        if( (*it)->retryReq )
+        {
+            DPRINTF(NVMain, "NVMainMemory: Sending retry to %s.\n", (*it)->name());
 
-        m_nvmainPtr->CreateCheckpoint( nvmain_chkpt_dir );
+            /* A request rejected again sets the flag for a later retry. */
+            (*it)->retryReq = false;
+            (*it)->port.sendRetryReq();
+            (*it)->CheckDrainState( );
+        }
     }
 }
 
 
-void NVMainMemory::unserialize(CheckpointIn &cp)
+/*
+ *  Wake up when NVMain has its next event, rather than every memory cycle.
+ *  With nothing pending the event stays unscheduled until a request arrives.
+ */
+void NVMainMemory::ScheduleWakeup( )
 {
-    if (masterInstance != this)
+    assert( masterInstance == this );
+
+    ncycle_t nextEvent = m_nvmainGlobalEventQueue->GetNextEvent( NULL );
+
+    if( nextEvent == std::numeric_limits<ncycle_t>::max() )
+    {
+        if( clockEvent.scheduled() )
+            deschedule( clockEvent );
         return;
+    }
 
-    std::string nvmain_chkpt_dir = "";
+    /* Events already due were issued after the last Sync(), run them next edge. */
+    ncycle_t currentCycle = m_nvmainGlobalEventQueue->GetCurrentCycle( );
+    ncycle_t stepCycles = (nextEvent > currentCycle) ? nextEvent - currentCycle : 1;
 
-    if( m_nvmainConfig->KeyExists( "CheckpointDirectory" ) )
-        nvmain_chkpt_dir = m_nvmainConfig->GetString( "CheckpointDirectory" );
+    Tick nextWake = lastWakeup + clock * static_cast<Tick>(stepCycles);
 
-    if( nvmain_chkpt_dir != "" )
-    {
-        std::cout << "NVMainMemory: Reading from checkpoint directory " << nvmain_chkpt_dir << std::endl;
+    DPRINTF(NVMain, "NVMainMemory: Next event: %d CurrentCycle: %d\n", nextEvent, currentCycle);
+    DPRINTF(NVMain, "NVMainMemory: Schedule wake for %d\n", nextWake);
 
-        m_nvmainPtr->RestoreCheckpoint( nvmain_chkpt_dir );
-    }
+    reschedule( clockEvent, nextWake, true );
 }
 
 
-void NVMainMemory::tick( )
+/*
+ *  Run NVMain up to the last memory clock edge at or before the current
+ *  tick. Part of a period that has not passed yet is left for next time.
+ */
+void NVMainMemory::Sync( )
 {
-    // Cycle memory controller
-    if (masterInstance == this)
-    {
-        /* Keep NVMain in sync with gem5. */
-        assert(curTick() >= lastWakeup);
-        ncycle_t stepCycles = (curTick() - lastWakeup) / clock;
+    assert( masterInstance == this );
+    assert( curTick() >= lastWakeup );
 
-        DPRINTF(NVMain, "NVMainMemory: Stepping %d cycles\n", stepCycles);
-        m_nvmainGlobalEventQueue->Cycle( stepCycles );
+    /* Retries are sent from their own event, so nothing issues from inside. */
+    assert( !inSync );
 
-        lastWakeup = curTick();
+    ncycle_t stepCycles = (curTick() - lastWakeup) / clock;
 
-        ncycle_t nextEvent;
+    DPRINTF(NVMain, "NVMainMemory: Stepping %d cycles\n", stepCycles);
 
-        nextEvent = m_nvmainGlobalEventQueue->GetNextEvent(NULL);
-        if( nextEvent != std::numeric_limits<ncycle_t>::max() )
-        {
-            ncycle_t currentCycle = m_nvmainGlobalEventQueue->GetCurrentCycle();
+    /* Zero steps still runs anything issued for the current cycle. */
+    inSync = true;
+    m_nvmainGlobalEventQueue->Cycle( stepCycles );
+    inSync = false;
 
-            assert(nextEvent >= currentCycle);
-            stepCycles = nextEvent - currentCycle;
+    lastWakeup += clock * static_cast<Tick>(stepCycles);
 
-            Tick nextWake = curTick() + clock * static_cast<Tick>(stepCycles);
+    /* Retried requests Sync() again without moving time, which must not retry. */
+    if( stepCycles > 0 )
+        ScheduleRetries( );
+}
 
-            DPRINTF(NVMain, "NVMainMemory: Next event: %d CurrentCycle: %d\n", nextEvent, currentCycle);
-            DPRINTF(NVMain, "NVMainMemory: Schedule wake for %d\n", nextWake);
 
-            nextEventCycle = nextEvent;
-            ScheduleClockEvent( nextWake );
-        }
+/*
+ *  NVMain's state goes to a directory of its own inside the gem5 checkpoint
+ *  unless CheckpointDirectory says otherwise. The memory must be drained,
+ *  since queued requests and bank timing are not saved.
+ */
+std::string NVMainMemory::CheckpointDirectory( const std::string& cptDir ) const
+{
+    if( m_nvmainConfig->KeyExists( "CheckpointDirectory" ) )
+        return m_nvmainConfig->GetString( "CheckpointDirectory" );
+
+    return cptDir + "/" + name() + ".nvmain";
+}
+
+
+void NVMainMemory::serialize(CheckpointOut &cp) const
+{
+    if (masterInstance != this)
+        return;
+
+    assert( m_requests_outstanding == 0 );
+
+    std::string nvmain_chkpt_dir = CheckpointDirectory( CheckpointIn::dir() );
+
+    std::cout << "NVMainMemory: Writing to checkpoint directory " << nvmain_chkpt_dir << std::endl;
+
+    m_nvmainPtr->CreateCheckpoint( nvmain_chkpt_dir );
+}
+
+
+/*
+ *  NVMain restarts idle at cycle zero. startup() runs after this and puts
+ *  cycle zero at the restored tick before scheduling the first wakeup.
+ */
+void NVMainMemory::unserialize(CheckpointIn &cp)
+{
+    if (masterInstance != this)
+        return;
+
+    std::string nvmain_chkpt_dir = CheckpointDirectory( cp.cptDir );
+
+    std::cout << "NVMainMemory: Reading from checkpoint directory " << nvmain_chkpt_dir << std::endl;
+
+    m_nvmainPtr->RestoreCheckpoint( nvmain_chkpt_dir );
+
+    /* Restored migrations move pages between technologies. */
+    for( auto it = allInstances.begin(); it != allInstances.end(); it++ )
+    {
+        if( (*it)->techMap != NULL )
+            (*it)->populateTechMap( );
     }
 }
 
 
+void NVMainMemory::tick( )
+{
+    // Cycle memory controller
+    Sync( );
+    ScheduleRetries( );
+    ScheduleWakeup( );
+}
+
+
 NVMainMemory *
 NVMainMemoryParams::create()
 {
@@ -47,13 +47,17 @@
 
 
 #include <fstream>
+#include <memory>
 #include <ostream>
 
 #include "NVM/nvmain.h"
 #include "base/callback.hh"
+#include "include/MigrationListener.h"
 #include "include/NVMTypes.h"
 #include "include/NVMainRequest.h"
+#include "include/NVMainRequestPool.h"
 #include "mem/abstract_mem.hh"
+#include "mem/mem_tech_map.hh"
 #include "mem/tport.hh"
 #include "params/NVMainMemory.hh"
 #include "sim/eventq.hh"
@@ -64,7 +68,8 @@
 #include "src/SimInterface.h"
 #include "src/TagGenerator.h"
 
-class NVMainMemory : public AbstractMemory, public NVM::NVMObject
+class NVMainMemory : public AbstractMemory, public NVM::NVMObject,
+                     public NVM::MigrationListener
 {
   private:
 
@@ -96,12 +101,17 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
 
     void tick();
     void SendResponses( );
+    void SendRetries( );
     EventWrapper<NVMainMemory, &NVMainMemory::tick> clockEvent;
     EventWrapper<NVMainMemory, &NVMainMemory::SendResponses> respondEvent;
+    EventWrapper<NVMainMemory, &NVMainMemory::SendRetries> retryEvent;
 
     void CheckDrainState( );
+    bool IsDrained( ) const;
     void ScheduleResponse( );
-    void ScheduleClockEvent( Tick );
+    void ScheduleRetries( );
+    void ScheduleWakeup( );
+    void Sync( );
     void SetRequestData(NVM::NVMainRequest *request, PacketPtr pkt);
 
     class NVMainStatPrinter : public Callback
@@ -126,6 +136,7 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
         NVM::NVMain *nvmainPtr;
     };
 
+    /** Completion context, reached from the request through reqInfo. */
     struct NVMainMemoryRequest
     {
         PacketPtr packet;
@@ -134,8 +145,6 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
         bool atomic;
     };
 
-    DrainManager *drainManager;
-
     NVM::NVMain *m_nvmainPtr;
     NVM::Stats *m_statsPtr;
     NVM::EventQueue *m_nvmainEventQueue;
@@ -148,7 +157,6 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
     bool m_nacked_requests;
     float m_avgAtomicLatency;
     uint64_t m_numAtomicAccesses;
-    NVM::ncycle_t nextEventCycle;
 
     Tick clock;
     Tick lat;
@@ -159,14 +167,45 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
     uint64_t tBURST;
     uint64_t RATE;
 
+    /** Without data-aware modules the request data is never looked at. */
+    bool ignoreData;
+
     bool NVMainWarmUp;
 
     NVMainStatPrinter statPrinter;
     NVMainStatReseter statReseter;
+
+    /** Tick of the memory clock edge NVMain has been run up to. */
     Tick lastWakeup;
 
+    /** Set while Sync() runs NVMain, which must not be re-entered. */
+    bool inSync;
+
+    /** Requests taken from the pool and not yet released. */
     uint64_t m_requests_outstanding;
 
+    /** Requests are recycled rather than allocated per packet. */
+    NVM::NVMainRequestPool requestPool;
+    std::vector<NVMainMemoryRequest *> freeMemRequests;
+
+    NVMainMemoryRequest *AllocateRequest( );
+    void ReleaseRequest( NVMainMemoryRequest *memRequest );
+
+    /** DRAM/NVM classification kept in sync with the channels, may be null. */
+    MemoryTechnologyMap *techMap;
+
+    /** Technology of each NVMain channel, true for NVM. */
+    std::vector<bool> nvmChannels;
+
+    /** Classify every page of this instance according to its channel. */
+    void populateTechMap( );
+
+    /** Offset between gem5 addresses of this instance and NVMain's. */
+    uint64_t AddressFixUp( ) const;
+
+    /** Where NVMain's own checkpoint files go for a gem5 checkpoint in cptDir. */
+    std::string CheckpointDirectory( const std::string& cptDir ) const;
+
   public:
 
     typedef NVMainMemoryParams Params;
@@ -190,6 +229,8 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
 
     void Cycle(NVM::ncycle_t) { }
 
+    void PageMigrated( uint64_t address, uint64_t channel );
+
     DrainState drain() override;
 
     void serialize(CheckpointOut &cp) const override;
@@ -199,10 +240,17 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
     static NVMainMemory *masterInstance;
     NVMainMemory *otherInstance;
     std::vector<NVMainMemory *> allInstances;
-    bool retryRead, retryWrite, retryResp;
+    /**
+     * A request was rejected and the port is owed a retry. One flag is
+     * enough: after a rejection gem5 sends nothing more on the port until
+     * the retry, so a read and a write can never be waiting at once.
+     */
+    bool retryReq;
+    bool retryResp;
     std::deque<PacketPtr> responseQueue;
-    std::vector<PacketPtr> pendingDelete;
-    std::map<NVM::NVMainRequest *, NVMainMemoryRequest *> m_request_map;
+
+    /** Packet without a response, freed when the next one arrives. */
+    std::unique_ptr<Packet> pendingDelete;
 
   protected:
 
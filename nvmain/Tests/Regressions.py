@@ -75,8 +75,12 @@ for trace in testdata["traces"]:
         # Reset log each time for correct stat comparison
         testlog = open(options.tempfile, 'w')
 
-        command = [nvmainexec, testdata["tests"][idx]["config"], trace, testdata["tests"][idx]["cycles"]]
-        command.extend(testdata["tests"][idx]["overrides"].split(" "))
+        # Tests of a special mode give its arguments instead of a simulation
+        if "args" in testdata["tests"][idx]:
+            command = [nvmainexec] + testdata["tests"][idx]["args"].split(" ")
+        else:
+            command = [nvmainexec, testdata["tests"][idx]["config"], trace, testdata["tests"][idx]["cycles"]]
+            command.extend(testdata["tests"][idx]["overrides"].split(" "))
         sys.stdout.write("Testing " + testdata["tests"][idx]["name"] + " with " + trace + " ... ")
         sys.stdout.flush()
 
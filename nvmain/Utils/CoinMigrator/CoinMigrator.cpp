@@ -38,6 +38,8 @@
 #include "src/EventQueue.h"
 #include "include/NVMHelpers.h"
 
+#include <fstream>
+
 using namespace NVM;
 
 CoinMigrator::CoinMigrator( )
@@ -182,22 +184,10 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
                 promoRequest->tag = MIG_WRITE_TAG;
 
                 /* Try to issue these now, otherwise we can try later. */
-                bool demoIssued, promoIssued;
-
-                demoIssued = savedParent->GetChild( demoRequest )->IssueCommand( demoRequest );
-                promoIssued = savedParent->GetChild( promoRequest )->IssueCommand( promoRequest );
-
-                if( demoIssued )
-                {
-                    migratorTranslator->SetMigrationState( demoRequest->address, MIGRATION_WRITING );
-                }
-                if( promoIssued )
-                {
-                    migratorTranslator->SetMigrationState( promoRequest->address, MIGRATION_WRITING );
-                }
+                demoBuffered = true;
+                promoBuffered = true;
 
-                promoBuffered = !promoIssued;
-                demoBuffered = !demoIssued;
+                IssueBufferedWrites( savedParent );
             }
         }
         /* A write completed. */
@@ -211,19 +201,8 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
         /* Some other request completed, see if we can ninja issue some migration writes that did not queue. */
         else if( promoBuffered || demoBuffered )
         {
-            bool demoIssued, promoIssued;
-
-            if( promoBuffered )
-            {
-                promoIssued = parent->GetTrampoline( )->GetChild( promoRequest )->IssueCommand( promoRequest );
-                promoBuffered = !promoIssued;
-            }
-
-            if( demoBuffered )
-            {
-                demoIssued = parent->GetTrampoline( )->GetChild( demoRequest )->IssueCommand( demoRequest );
-                demoBuffered = !demoIssued;
-            }
+            /* As above, IssueCommand may change our parent. */
+            IssueBufferedWrites( parent->GetTrampoline( ) );
         }
     }
 
@@ -231,6 +210,30 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
 }
 
 
+/*
+ *  Issue the migration writes still waiting for queue space to the saved
+ *  NVMain. Each write is tried once; the ones that do not queue stay
+ *  buffered until another request completes.
+ */
+void CoinMigrator::IssueBufferedWrites( NVMObject *savedParent )
+{
+    Migrator *migratorTranslator = dynamic_cast<Migrator *>(savedParent->GetDecoder( ));
+    assert( migratorTranslator != NULL );
+
+    if( demoBuffered && savedParent->GetChild( demoRequest )->IssueCommand( demoRequest ) )
+    {
+        migratorTranslator->SetMigrationState( demoRequest->address, MIGRATION_WRITING );
+        demoBuffered = false;
+    }
+
+    if( promoBuffered && savedParent->GetChild( promoRequest )->IssueCommand( promoRequest ) )
+    {
+        migratorTranslator->SetMigrationState( promoRequest->address, MIGRATION_WRITING );
+        promoBuffered = false;
+    }
+}
+
+
 bool CoinMigrator::CheckIssuable( NVMAddress address, OpType type )
 {
     NVMainRequest request;
@@ -391,7 +394,6 @@ void CoinMigrator::ChooseVictim( Migrator *at, NVMAddress& /*promotee*/, NVMAddr
         promotionChannelParams = p;
 
         totalPromotionPages = p->RANKS * p->BANKS * p->ROWS;
-        currentPromotionPage = 0;
 
         if( p->COLS != numCols )
         {
@@ -433,3 +435,60 @@ void CoinMigrator::Cycle( ncycle_t /*steps*/ )
 
 }
 
+
+/*
+ *  The coin toss seed and the next victim page decide every future
+ *  migration, so both are saved. The migrated pages themselves are saved
+ *  by the Migrator translator.
+ */
+void CoinMigrator::CreateCheckpoint( std::string dir )
+{
+    std::string cpt_file = dir + "/CoinMigrator";
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( cpt_file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << "CoinMigrator: Warning: Could not open checkpoint file: "
+                  << cpt_file << std::endl;
+        return;
+    }
+
+    uint64_t cpt_seed = seed;
+    uint64_t cpt_page = currentPromotionPage;
+
+    cpt_handle.write( (const char*)&cpt_seed, sizeof(uint64_t) );
+    cpt_handle.write( (const char*)&cpt_page, sizeof(uint64_t) );
+
+    cpt_handle.close( );
+}
+
+
+void CoinMigrator::RestoreCheckpoint( std::string dir )
+{
+    std::string cpt_file = dir + "/CoinMigrator";
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( cpt_file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << "CoinMigrator: Warning: Could not open checkpoint file: "
+                  << cpt_file << std::endl;
+        return;
+    }
+
+    uint64_t cpt_seed, cpt_page;
+
+    cpt_handle.read( (char*)&cpt_seed, sizeof(uint64_t) );
+    cpt_handle.read( (char*)&cpt_page, sizeof(uint64_t) );
+
+    if( cpt_handle )
+    {
+        seed = static_cast<unsigned int>(cpt_seed);
+        currentPromotionPage = cpt_page;
+    }
+
+    cpt_handle.close( );
+}
@@ -59,6 +59,9 @@ class CoinMigrator : public NVMObject
 
     void Cycle( ncycle_t steps );
 
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
   private:
     bool promoBuffered, demoBuffered; 
     NVMAddress demotee, promotee; 
@@ -82,6 +85,7 @@ class CoinMigrator : public NVMObject
     bool CheckIssuable( NVMAddress address, OpType type );
     bool TryMigration( NVMainRequest *request, bool atomic );
     void ChooseVictim( Migrator *at, NVMAddress& promo, NVMAddress& victim );
+    void IssueBufferedWrites( NVMObject *savedParent );
 };
 
 };
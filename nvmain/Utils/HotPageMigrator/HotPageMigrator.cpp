@@ -0,0 +1,836 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "Utils/HotPageMigrator/HotPageMigrator.h"
+#include "Decoders/Migrator/Migrator.h"
+#include "NVM/nvmain.h"
+#include "src/SubArray.h"
+#include "src/EventQueue.h"
+#include "include/NVMHelpers.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <utility>
+
+using namespace NVM;
+
+HotPageMigrator::HotPageMigrator( )
+{
+    /*
+     *  Migration requests are injected after the original request is issued
+     *  so the original request does not fail because the migration filled up
+     *  the transaction queue. See CoinMigrator.
+     */
+    SetHookType( NVMHOOK_BOTHISSUE );
+
+    queriedMemory = false;
+    promotionChannelParams = NULL;
+
+    currentEpoch = 0;
+    epochBase = 0;
+
+    budgetTokens = 0.0;
+    budgetCap = 0.0;
+    migrationCost = 0.0;
+    lastRefill = 0;
+
+    migrationCount = 0;
+    queueWaits = 0;
+    bufferedReads = 0;
+    budgetStalls = 0;
+    victimMisses = 0;
+    batches = 0;
+    candidatesQueued = 0;
+}
+
+
+HotPageMigrator::~HotPageMigrator( )
+{
+    for( size_t idx = 0; idx < slots.size( ); idx++ )
+    {
+        /* Writes that never made it into a queue are still ours. */
+        if( slots[idx].promoBuffered )
+            delete slots[idx].promoRequest;
+        if( slots[idx].demoBuffered )
+            delete slots[idx].demoRequest;
+    }
+}
+
+
+void HotPageMigrator::Init( Config *config )
+{
+    /* Specifies which channel is the "fast" memory. */
+    promotionChannel = 0;
+    config->GetValueUL( "HotPagePromotionChannel", promotionChannel );
+
+    /* Access counts are halved and a new batch is chosen every epoch. */
+    epochLength = 100000;
+    config->GetValueUL( "HotPageEpoch", epochLength );
+
+    /* Writes to the slow memory cost more, so they count more towards hotness. */
+    writeWeight = 4;
+    config->GetValueUL( "HotPageWriteWeight", writeWeight );
+
+    /* Minimum decayed score before a page is considered for promotion. */
+    migrationThreshold = 8;
+    config->GetValueUL( "HotPageMigrationThreshold", migrationThreshold );
+
+    /* Maximum number of pages queued for migration per epoch. */
+    batchSize = 16;
+    config->GetValueUL( "HotPageBatchSize", batchSize );
+
+    /* Number of page swaps which may be in progress at once. */
+    maxOutstanding = 4;
+    config->GetValueUL( "HotPageMaxOutstanding", maxOutstanding );
+
+    /* Fraction of the fast channel's bus cycles migration may consume. */
+    bandwidthShare = 0.1;
+    config->GetEnergy( "HotPageBandwidthShare", bandwidthShare );
+
+    /* If we want to simulate additional latency serving buffered requests. */
+    bufferReadLatency = 4;
+    config->GetValueUL( "MigrationBufferReadLatency", bufferReadLatency );
+
+    if( epochLength == 0 )
+        epochLength = 1;
+
+    if( maxOutstanding == 0 )
+        maxOutstanding = 1;
+
+    /* 
+     *  We migrate entire rows between banks, so the column count needs to
+     *  match across all channels for valid results.
+     */
+    numCols = config->GetValue( "COLS" );
+
+    MigrationSlot emptySlot;
+
+    emptySlot.active = false;
+    emptySlot.promoKey = emptySlot.demoKey = 0;
+    emptySlot.promoRequest = emptySlot.demoRequest = NULL;
+    emptySlot.promoBuffered = emptySlot.demoBuffered = false;
+    emptySlot.writesDone = 0;
+
+    slots.assign( maxOutstanding, emptySlot );
+
+    AddStat(migrationCount);
+    AddStat(queueWaits);
+    AddStat(bufferedReads);
+    AddStat(budgetStalls);
+    AddStat(victimMisses);
+    AddStat(batches);
+    AddStat(candidatesQueued);
+}
+
+
+bool HotPageMigrator::IssueAtomic( NVMainRequest *request )
+{
+    /* For atomic mode, we just swap the pages instantly. */
+    return TryMigration( request, true );
+}
+
+
+bool HotPageMigrator::IssueCommand( NVMainRequest *request )
+{
+    return TryMigration( request, false );
+}
+
+
+bool HotPageMigrator::RequestComplete( NVMainRequest *request )
+{
+    if( NVMTypeMatches(NVMain) && GetCurrentHookType( ) == NVMHOOK_PREISSUE )
+    {
+        /* Ensure the Migrator translator is used. */
+        Migrator *migratorTranslator = dynamic_cast<Migrator *>(parent->GetTrampoline( )->GetDecoder( ));
+        assert( migratorTranslator != NULL );
+
+        /* 
+         *  Once IssueCommand is called this hook may receive a different
+         *  parent, so remember the NVMain class we are issuing requests to.
+         */
+        NVMObject *savedParent = parent->GetTrampoline( );
+
+        if( request->owner == savedParent && request->tag == MIG_READ_TAG )
+        {
+            MigrationSlot *slot = FindSlot( request );
+            assert( slot != NULL );
+
+            /* A migration read completed, update state. */
+            migratorTranslator->SetMigrationState( request->address, MIGRATION_BUFFERED ); 
+
+            /* If both requests are buffered, we can attempt to write. */
+            bool bufferComplete = false;
+
+            if( (request == slot->promoRequest 
+                 && migratorTranslator->IsBuffered( slot->demotee ))
+                || (request == slot->demoRequest
+                 && migratorTranslator->IsBuffered( slot->promotee )) )
+            {
+                bufferComplete = true;
+            }
+
+            /* Make a new request to issue for write. Parent will delete current pointer. */
+            if( request == slot->promoRequest )
+            {
+                slot->promoRequest = new NVMainRequest( );
+                *slot->promoRequest = *request;
+            }
+            else
+            {
+                slot->demoRequest = new NVMainRequest( );
+                *slot->demoRequest = *request;
+            }
+
+            /* Swap the address and set type to write. */
+            if( bufferComplete )
+            {
+                NVMainRequest *promoRequest = slot->promoRequest;
+                NVMainRequest *demoRequest = slot->demoRequest;
+
+                NVMAddress tempAddress = promoRequest->address;
+                promoRequest->address = demoRequest->address;
+                demoRequest->address = tempAddress;
+
+                demoRequest->type = WRITE;
+                promoRequest->type = WRITE;
+
+                demoRequest->tag = MIG_WRITE_TAG;
+                promoRequest->tag = MIG_WRITE_TAG;
+
+                /* Try to issue these now, otherwise we can try later. */
+                bool demoIssued, promoIssued;
+
+                demoIssued = savedParent->GetChild( demoRequest )->IssueCommand( demoRequest );
+                promoIssued = savedParent->GetChild( promoRequest )->IssueCommand( promoRequest );
+
+                if( demoIssued )
+                {
+                    migratorTranslator->SetMigrationState( demoRequest->address, MIGRATION_WRITING );
+                }
+                if( promoIssued )
+                {
+                    migratorTranslator->SetMigrationState( promoRequest->address, MIGRATION_WRITING );
+                }
+
+                slot->promoBuffered = !promoIssued;
+                slot->demoBuffered = !demoIssued;
+            }
+        }
+        /* A write completed. */
+        else if( request->owner == savedParent && request->tag == MIG_WRITE_TAG )
+        {
+            MigrationSlot *slot = FindSlot( request );
+            assert( slot != NULL );
+
+            // Note: request should be deleted by parent
+            migratorTranslator->SetMigrationState( request->address, MIGRATION_DONE );
+
+            if( request == slot->promoRequest )
+                slot->promoRequest = NULL;
+            else
+                slot->demoRequest = NULL;
+
+            /* Both pages written, this slot may be used by the next migration. */
+            if( ++slot->writesDone == 2 )
+            {
+                pendingPages.Erase( slot->promoKey );
+                pendingPages.Erase( slot->demoKey );
+
+                slot->active = false;
+                slot->writesDone = 0;
+
+                migrationCount++;
+            }
+        }
+        /* Some other request completed, see if we can issue migration writes that did not queue. */
+        else
+        {
+            RetryBufferedWrites( savedParent );
+        }
+    }
+
+    return true;
+}
+
+
+bool HotPageMigrator::CheckIssuable( NVMObject *memory, NVMAddress address, OpType type )
+{
+    NVMainRequest request;
+
+    request.address = address;
+    request.type = type;
+
+    return memory->GetChild( &request )->IsIssuable( &request );
+}
+
+
+bool HotPageMigrator::TryMigration( NVMainRequest *request, bool atomic )
+{
+    bool rv = true;
+
+    if( NVMTypeMatches(NVMain) )
+    {
+        /* Ensure the Migrator translator is used. */
+        Migrator *migratorTranslator = dynamic_cast<Migrator *>(parent->GetTrampoline( )->GetDecoder( ));
+        assert( migratorTranslator != NULL );
+
+        /* Migrations in progress must be served from the buffers during migration. */
+        if( GetCurrentHookType( ) == NVMHOOK_PREISSUE && migratorTranslator->IsBuffered( request->address ) )
+        {
+            /* Short circuit this request so it is not queued. */
+            rv = false;
+
+            /* Complete the request, adding some buffer read latency. */
+            GetEventQueue( )->InsertEvent( EventResponse, parent->GetTrampoline( ), request,
+                              GetEventQueue()->GetCurrentCycle()+bufferReadLatency );
+
+            bufferedReads++;
+
+            return rv;
+        }
+
+        /* Don't inject results before the original is issued to prevent deadlock */
+        if( GetCurrentHookType( ) != NVMHOOK_POSTISSUE )
+        {
+            return rv;
+        }
+
+        /* Our own migration requests do not count towards hotness. */
+        if( request->tag == MIG_READ_TAG || request->tag == MIG_WRITE_TAG )
+        {
+            return rv;
+        }
+
+        if( !queriedMemory )
+        {
+            QueryMemory( parent->GetTrampoline( ) );
+        }
+
+        RecordAccess( migratorTranslator, request );
+
+        ncounter_t epoch = GetEventQueue( )->GetCurrentCycle( ) / epochLength + epochBase;
+
+        if( epoch != currentEpoch )
+        {
+            currentEpoch = epoch;
+            AdvanceEpoch( migratorTranslator );
+        }
+
+        if( !migrationQueue.empty( ) )
+        {
+            StartMigrations( migratorTranslator, atomic );
+        }
+    }
+
+    return rv;
+}
+
+
+void HotPageMigrator::QueryMemory( NVMObject *memory )
+{
+    /*
+     *  Find the parameters of the fast memory by routing a dummy request to
+     *  the promotion channel and grabbing the subarray's config pointer.
+     */
+    NVMainRequest queryRequest;
+
+    queryRequest.address.SetTranslatedAddress( 0, 0, 0, 0, promotionChannel, 0 );
+    queryRequest.address.SetPhysicalAddress( 0 );
+    queryRequest.type = READ;
+    queryRequest.owner = this;
+
+    NVMObject *curObject = NULL;
+    FindModuleChildType( &queryRequest, SubArray, curObject, memory );
+
+    SubArray *promotionChannelSubarray = NULL;
+    promotionChannelSubarray = dynamic_cast<SubArray *>( curObject );
+
+    assert( promotionChannelSubarray != NULL );
+    promotionChannelParams = promotionChannelSubarray->GetParams( );
+
+    if( promotionChannelParams->COLS != numCols )
+    {
+        std::cout << "Warning: Page size of fast and slow memory differs." << std::endl;
+    }
+
+    /* 
+     *  Each migration reads and writes one full page on the fast channel's
+     *  bus. Allow enough tokens to build up to fill every migration slot.
+     */
+    migrationCost = static_cast<double>( 2 * numCols * promotionChannelParams->tBURST );
+    budgetCap = migrationCost * static_cast<double>( maxOutstanding );
+    lastRefill = GetEventQueue( )->GetCurrentCycle( );
+
+    queriedMemory = true;
+}
+
+
+void HotPageMigrator::RecordAccess( Migrator *at, NVMainRequest *request )
+{
+    uint64_t key = at->GetAddressKey( request->address );
+    PageStats *stats = pageStats.Find( key );
+
+    if( stats == NULL )
+    {
+        stats = &pageStats[key];
+
+        stats->reads = 0;
+        stats->writes = 0;
+        stats->epoch = currentEpoch;
+        stats->candidate = false;
+    }
+
+    if( request->type == WRITE || request->type == WRITE_PRECHARGE )
+        stats->writes++;
+    else
+        stats->reads++;
+
+    /* Only pages which have not moved yet and live in slow memory may be promoted. */
+    if( stats->candidate 
+        || request->address.GetChannel( ) == promotionChannel
+        || pendingPages.Contains( key )
+        || at->IsMigrated( request->address ) 
+        || PageScore( *stats ) < migrationThreshold )
+    {
+        return;
+    }
+
+    uint64_t row, bank, rank, channel, subarray;
+    request->address.GetTranslatedAddress( &row, NULL, &bank, &rank, &channel, &subarray );
+
+    stats->address.SetTranslatedAddress( row, 0, bank, rank, channel, subarray );
+    stats->address.SetPhysicalAddress( at->ReverseTranslate( row, 0, bank, rank, channel, subarray ) );
+    stats->candidate = true;
+
+    candidates.push_back( key );
+}
+
+
+/*
+ *  Returns the hotness of a page, first halving the counts for each epoch
+ *  that has passed since the page was last seen.
+ */
+ncounter_t HotPageMigrator::PageScore( PageStats& stats )
+{
+    ncounter_t elapsed = currentEpoch - stats.epoch;
+
+    if( elapsed >= 64 )
+    {
+        stats.reads = 0;
+        stats.writes = 0;
+    }
+    else if( elapsed > 0 )
+    {
+        stats.reads >>= elapsed;
+        stats.writes >>= elapsed;
+    }
+
+    stats.epoch = currentEpoch;
+
+    return stats.reads + writeWeight * stats.writes;
+}
+
+
+void HotPageMigrator::AdvanceEpoch( Migrator *at )
+{
+    /* Rank this epoch's candidates, hottest first. */
+    std::vector<std::pair<ncounter_t, uint64_t> > ranked;
+
+    ranked.reserve( candidates.size( ) );
+
+    for( size_t idx = 0; idx < candidates.size( ); idx++ )
+    {
+        PageStats *stats = pageStats.Find( candidates[idx] );
+        assert( stats != NULL );
+
+        stats->candidate = false;
+
+        ncounter_t score = PageScore( *stats );
+
+        if( score >= migrationThreshold && !at->IsMigrated( stats->address ) )
+        {
+            ranked.push_back( std::make_pair( score, candidates[idx] ) );
+        }
+    }
+
+    candidates.clear( );
+
+    std::sort( ranked.begin( ), ranked.end( ), std::greater<std::pair<ncounter_t, uint64_t> >( ) );
+
+    /* Leftovers from the previous batch stay queued ahead of the new batch. */
+    for( size_t idx = 0; idx < ranked.size( ) && migrationQueue.size( ) < batchSize; idx++ )
+    {
+        migrationQueue.push_back( ranked[idx].second );
+        pendingPages[ranked[idx].second] = true;
+
+        candidatesQueued++;
+    }
+
+    batches++;
+}
+
+
+void HotPageMigrator::RefillBudget( )
+{
+    ncycle_t now = GetEventQueue( )->GetCurrentCycle( );
+
+    budgetTokens += static_cast<double>( now - lastRefill ) * bandwidthShare;
+    lastRefill = now;
+
+    if( budgetTokens > budgetCap )
+        budgetTokens = budgetCap;
+}
+
+
+void HotPageMigrator::StartMigrations( Migrator *at, bool atomic )
+{
+    /* 
+     *  Note: once IssueCommand is called, this hook may receive a different
+     *  parent, but fail the NVMTypeMatch check. As a result we need to save
+     *  a pointer to the NVMain class we are issuing requests to.
+     */
+    NVMObject *savedParent = parent->GetTrampoline( );
+
+    RefillBudget( );
+
+    for( size_t idx = 0; idx < slots.size( ) && !migrationQueue.empty( ); idx++ )
+    {
+        MigrationSlot& slot = slots[idx];
+
+        if( slot.active )
+            continue;
+
+        if( budgetTokens < migrationCost )
+        {
+            budgetStalls++;
+            break;
+        }
+
+        /* Drop queued pages which have no suitable victim. */
+        uint64_t promoKey = 0;
+        NVMAddress promotee, demotee;
+        bool victimFound = false;
+
+        while( !victimFound && !migrationQueue.empty( ) )
+        {
+            promoKey = migrationQueue.front( );
+            PageStats *stats = pageStats.Find( promoKey );
+            assert( stats != NULL );
+
+            promotee = stats->address;
+            victimFound = ChooseVictim( at, promotee, demotee );
+
+            if( !victimFound )
+            {
+                migrationQueue.pop_front( );
+                pendingPages.Erase( promoKey );
+
+                victimMisses++;
+            }
+        }
+
+        if( !victimFound )
+            break;
+
+        assert( at->IsMigrated( demotee ) == false );
+        assert( at->IsMigrated( promotee ) == false );
+
+        if( atomic )
+        {
+            migrationQueue.pop_front( );
+            pendingPages.Erase( promoKey );
+
+            at->StartMigration( promotee, demotee );
+            at->SetMigrationState( promotee, MIGRATION_DONE );
+            at->SetMigrationState( demotee, MIGRATION_DONE );
+
+            budgetTokens -= migrationCost;
+            migrationCount++;
+
+            continue;
+        }
+
+        /* Lastly, make sure we can queue the migration requests. */
+        if( !CheckIssuable( savedParent, promotee, READ ) 
+            || !CheckIssuable( savedParent, demotee, READ ) )
+        {
+            queueWaits++;
+            break;
+        }
+
+        migrationQueue.pop_front( );
+
+        at->StartMigration( promotee, demotee );
+
+        slot.active = true;
+        slot.promotee = promotee;
+        slot.demotee = demotee;
+        slot.promoKey = promoKey;
+        slot.demoKey = at->GetAddressKey( demotee );
+        slot.promoBuffered = false;
+        slot.demoBuffered = false;
+        slot.writesDone = 0;
+
+        pendingPages[slot.demoKey] = true;
+
+        slot.promoRequest = new NVMainRequest( ); 
+        slot.demoRequest = new NVMainRequest( );
+
+        slot.promoRequest->address = promotee;
+        slot.promoRequest->type = READ;
+        slot.promoRequest->tag = MIG_READ_TAG;
+        slot.promoRequest->burstCount = numCols;
+        slot.promoRequest->owner = savedParent;
+
+        slot.demoRequest->address = demotee;
+        slot.demoRequest->type = READ;
+        slot.demoRequest->tag = MIG_READ_TAG;
+        slot.demoRequest->burstCount = numCols;
+        slot.demoRequest->owner = savedParent;
+
+        budgetTokens -= migrationCost;
+
+        savedParent->IssueCommand( slot.promoRequest );
+        savedParent->IssueCommand( slot.demoRequest );
+    }
+}
+
+
+bool HotPageMigrator::ChooseVictim( Migrator *at, NVMAddress& promotee, NVMAddress& victim )
+{
+    /* 
+     *  The Migrator only remaps the channel, so the promotee must trade
+     *  places with the fast page at the same row, bank, rank and subarray.
+     */
+    uint64_t row, bank, rank, subarray;
+    promotee.GetTranslatedAddress( &row, NULL, &bank, &rank, NULL, &subarray );
+
+    if( row >= promotionChannelParams->ROWS 
+        || bank >= promotionChannelParams->BANKS
+        || rank >= promotionChannelParams->RANKS )
+    {
+        return false;
+    }
+
+    victim.SetTranslatedAddress( row, 0, bank, rank, promotionChannel, subarray );
+    victim.SetPhysicalAddress( at->ReverseTranslate( row, 0, bank, rank, promotionChannel, subarray ) );
+
+    uint64_t victimKey = at->GetAddressKey( victim );
+
+    if( at->IsMigrated( victim ) || pendingPages.Contains( victimKey ) )
+    {
+        return false;
+    }
+
+    /* Keep the fast page if it is at least as hot as the promotee. */
+    PageStats *promoStats = pageStats.Find( at->GetAddressKey( promotee ) );
+    PageStats *victimStats = pageStats.Find( victimKey );
+
+    if( victimStats != NULL && PageScore( *victimStats ) >= PageScore( *promoStats ) )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+HotPageMigrator::MigrationSlot *HotPageMigrator::FindSlot( NVMainRequest *request )
+{
+    for( size_t idx = 0; idx < slots.size( ); idx++ )
+    {
+        if( slots[idx].active && (slots[idx].promoRequest == request 
+                                  || slots[idx].demoRequest == request) )
+        {
+            return &slots[idx];
+        }
+    }
+
+    return NULL;
+}
+
+
+void HotPageMigrator::RetryBufferedWrites( NVMObject *memory )
+{
+    for( size_t idx = 0; idx < slots.size( ); idx++ )
+    {
+        MigrationSlot& slot = slots[idx];
+
+        if( !slot.active )
+            continue;
+
+        if( slot.promoBuffered )
+        {
+            slot.promoBuffered = !memory->GetChild( slot.promoRequest )->IssueCommand( slot.promoRequest );
+        }
+
+        if( slot.demoBuffered )
+        {
+            slot.demoBuffered = !memory->GetChild( slot.demoRequest )->IssueCommand( slot.demoRequest );
+        }
+    }
+}
+
+
+void HotPageMigrator::Cycle( ncycle_t /*steps*/ )
+{
+
+}
+
+
+/*
+ *  Saves the hotness of every page seen, the pending candidates and batch,
+ *  and the bandwidth budget. Page swaps in flight are not saved, so the
+ *  memory is assumed to be drained. The page mappings themselves are saved
+ *  by the Migrator translator.
+ */
+void HotPageMigrator::CreateCheckpoint( std::string dir )
+{
+    std::string cpt_file = dir + "/HotPageMigrator";
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( cpt_file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << "HotPageMigrator: Warning: Could not open checkpoint file: "
+                  << cpt_file << std::endl;
+        return;
+    }
+
+    uint64_t pageCount = pageStats.size( );
+
+    cpt_handle.write( (const char*)&currentEpoch, sizeof(uint64_t) );
+    cpt_handle.write( (const char*)&budgetTokens, sizeof(double) );
+    cpt_handle.write( (const char*)&pageCount, sizeof(uint64_t) );
+
+    PageHashMap<PageStats>::iterator it;
+    for( it = pageStats.begin(); it != pageStats.end(); ++it )
+    {
+        uint64_t page[11];
+
+        page[0] = it->key;
+        page[1] = it->value.reads;
+        page[2] = it->value.writes;
+        page[3] = it->value.epoch;
+        page[4] = it->value.candidate ? 1 : 0;
+        it->value.address.GetTranslatedAddress( &page[5], NULL, &page[6], &page[7], 
+                                                &page[8], &page[9] );
+        page[10] = it->value.address.GetPhysicalAddress( );
+
+        cpt_handle.write( (const char*)page, sizeof(page) );
+    }
+
+    uint64_t candidateCount = candidates.size( );
+    cpt_handle.write( (const char*)&candidateCount, sizeof(uint64_t) );
+    for( size_t idx = 0; idx < candidates.size( ); idx++ )
+        cpt_handle.write( (const char*)&candidates[idx], sizeof(uint64_t) );
+
+    uint64_t queueCount = migrationQueue.size( );
+    cpt_handle.write( (const char*)&queueCount, sizeof(uint64_t) );
+    for( size_t idx = 0; idx < migrationQueue.size( ); idx++ )
+        cpt_handle.write( (const char*)&migrationQueue[idx], sizeof(uint64_t) );
+
+    cpt_handle.close( );
+}
+
+
+void HotPageMigrator::RestoreCheckpoint( std::string dir )
+{
+    std::string cpt_file = dir + "/HotPageMigrator";
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( cpt_file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << "HotPageMigrator: Warning: Could not open checkpoint file: "
+                  << cpt_file << std::endl;
+        return;
+    }
+
+    uint64_t pageCount = 0;
+
+    cpt_handle.read( (char*)&currentEpoch, sizeof(uint64_t) );
+    cpt_handle.read( (char*)&budgetTokens, sizeof(double) );
+    cpt_handle.read( (char*)&pageCount, sizeof(uint64_t) );
+
+    for( uint64_t idx = 0; idx < pageCount && cpt_handle; idx++ )
+    {
+        uint64_t page[11];
+
+        if( !cpt_handle.read( (char*)page, sizeof(page) ) )
+            break;
+
+        PageStats& stats = pageStats[page[0]];
+
+        stats.reads = page[1];
+        stats.writes = page[2];
+        stats.epoch = page[3];
+        stats.candidate = (page[4] != 0);
+        stats.address.SetTranslatedAddress( page[5], 0, page[6], page[7], page[8], page[9] );
+        stats.address.SetPhysicalAddress( page[10] );
+    }
+
+    uint64_t candidateCount = 0;
+    cpt_handle.read( (char*)&candidateCount, sizeof(uint64_t) );
+    for( uint64_t idx = 0; idx < candidateCount && cpt_handle; idx++ )
+    {
+        uint64_t key;
+
+        if( cpt_handle.read( (char*)&key, sizeof(uint64_t) ) )
+            candidates.push_back( key );
+    }
+
+    uint64_t queueCount = 0;
+    cpt_handle.read( (char*)&queueCount, sizeof(uint64_t) );
+    for( uint64_t idx = 0; idx < queueCount && cpt_handle; idx++ )
+    {
+        uint64_t key;
+
+        if( cpt_handle.read( (char*)&key, sizeof(uint64_t) ) )
+        {
+            migrationQueue.push_back( key );
+            pendingPages[key] = true;
+        }
+    }
+
+    if( !cpt_handle )
+    {
+        std::cout << "HotPageMigrator: Warning: Checkpoint file " << cpt_file
+                  << " is truncated." << std::endl;
+    }
+
+    /* Cycles restart after a restore, so the epoch count continues from here. */
+    epochBase = currentEpoch - GetEventQueue( )->GetCurrentCycle( ) / epochLength;
+    lastRefill = GetEventQueue( )->GetCurrentCycle( );
+
+    cpt_handle.close( );
+}
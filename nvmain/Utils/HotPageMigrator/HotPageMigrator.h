@@ -0,0 +1,153 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NVMAIN_UTILS_HOTPAGEMIGRATOR_H__
+#define __NVMAIN_UTILS_HOTPAGEMIGRATOR_H__
+
+#include "src/NVMObject.h"
+#include "src/Params.h"
+#include "include/NVMainRequest.h"
+#include "include/PageHashMap.h"
+
+#include <deque>
+#include <vector>
+
+namespace NVM {
+
+#define MIG_READ_TAG GetTagGenerator( )->CreateTag("MIGREAD")
+#define MIG_WRITE_TAG GetTagGenerator( )->CreateTag("MIGWRITE")
+
+class Migrator;
+
+/*
+ *  Promotes the hottest pages of the slow channels into the fast (promotion)
+ *  channel. Pages are ranked by access counts that halve every epoch, with
+ *  writes weighted more heavily than reads. At each epoch boundary the top
+ *  candidates are queued as a batch, and up to HotPageMaxOutstanding page
+ *  swaps may be in flight at once. Migration traffic is limited to a share
+ *  of the promotion channel's bus bandwidth using a token bucket.
+ *
+ *  A slow page is swapped with the fast page at the same row, bank, rank
+ *  and subarray, since the Migrator decoder only remaps the channel. The
+ *  swap is skipped if that fast page is at least as hot as the promotee.
+ */
+class HotPageMigrator : public NVMObject
+{
+  public:
+    HotPageMigrator( );
+    ~HotPageMigrator( );
+
+    void Init( Config *config );
+
+    bool IssueAtomic( NVMainRequest *request );
+    bool IssueCommand( NVMainRequest *request );
+    bool RequestComplete( NVMainRequest *request );
+
+    void Cycle( ncycle_t steps );
+
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
+  private:
+    struct PageStats
+    {
+        NVMAddress address;
+        ncounter_t reads, writes;
+        ncounter_t epoch;
+        bool candidate;
+    };
+
+    struct MigrationSlot
+    {
+        bool active;
+        NVMAddress promotee, demotee;
+        uint64_t promoKey, demoKey;
+        NVMainRequest *promoRequest;
+        NVMainRequest *demoRequest;
+        bool promoBuffered, demoBuffered;
+        ncounter_t writesDone;
+    };
+
+    /* Configuration. */
+    ncounter_t promotionChannel;
+    ncycle_t epochLength;
+    ncounter_t writeWeight;
+    ncounter_t migrationThreshold;
+    ncounter_t batchSize;
+    ncounter_t maxOutstanding;
+    double bandwidthShare;
+    ncounter_t numCols;
+    ncycle_t bufferReadLatency;
+
+    /* Fast memory geometry, queried on first use. */
+    bool queriedMemory;
+    Params *promotionChannelParams;
+
+    /* Hotness tracking. Epochs continue from epochBase after a restore. */
+    ncounter_t currentEpoch;
+    ncounter_t epochBase;
+    PageHashMap<PageStats> pageStats;
+    std::vector<uint64_t> candidates;
+    std::deque<uint64_t> migrationQueue;
+    PageHashMap<bool> pendingPages;
+
+    /* Outstanding page swaps. */
+    std::vector<MigrationSlot> slots;
+
+    /* Bandwidth budget, in promotion channel bus cycles. */
+    double budgetTokens;
+    double budgetCap;
+    double migrationCost;
+    ncycle_t lastRefill;
+
+    ncounter_t migrationCount;
+    ncounter_t queueWaits;
+    ncounter_t bufferedReads;
+    ncounter_t budgetStalls;
+    ncounter_t victimMisses;
+    ncounter_t batches;
+    ncounter_t candidatesQueued;
+
+    bool CheckIssuable( NVMObject *memory, NVMAddress address, OpType type );
+    bool TryMigration( NVMainRequest *request, bool atomic );
+
+    void QueryMemory( NVMObject *memory );
+    void RecordAccess( Migrator *at, NVMainRequest *request );
+    ncounter_t PageScore( PageStats& stats );
+    void AdvanceEpoch( Migrator *at );
+    void RefillBudget( );
+    void StartMigrations( Migrator *at, bool atomic );
+    bool ChooseVictim( Migrator *at, NVMAddress& promotee, NVMAddress& victim );
+    MigrationSlot *FindSlot( NVMainRequest *request );
+    void RetryBufferedWrites( NVMObject *memory );
+};
+
+};
+
+#endif
@@ -17,6 +17,7 @@ Modified by dliu, based on CoinMigrator.cpp.
 #define LIFE_TIME 4
 //#define THRESHOLD_QUEUE 3
 #define THRESHOLD_QUEUE 4
+#define PAGE_SLAB_SIZE 4096
 
 
 using namespace NVM;
@@ -45,7 +46,13 @@ MultiQueueMigrator::MultiQueueMigrator( )
     currentPromotionPage = 0;
 
 	currentTime = 0;
-	rankingQueues = new std::list<PageType>[QUEUE_NUM];
+	rankingQueues = new RankingQueue[QUEUE_NUM];
+	for( int pos = 0; pos < QUEUE_NUM; pos++ )
+	{
+		rankingQueues[pos].head = NULL;
+		rankingQueues[pos].tail = NULL;
+	}
+	freePages = NULL;
 	file.open("rank-based-page-migration-traces.txt");
 	origin_file.open("no-migration-page-traces.txt");
 	trace_interval = 1000;	//default trace interval
@@ -54,6 +61,11 @@ MultiQueueMigrator::MultiQueueMigrator( )
 
 MultiQueueMigrator::~MultiQueueMigrator( )
 {
+	delete [] rankingQueues;
+
+	for( size_t slab = 0; slab < pageSlabs.size( ); slab++ )
+		delete [] pageSlabs[slab];
+
 	if( file)
 	{
 		file.close();
@@ -87,7 +99,7 @@ void MultiQueueMigrator::Init( Config *config )
     numCols = config->GetValue( "COLS" );
 	file<< "access time statistics of every channel every "<<trace_interval<<" cycles"<<std::endl;
 	origin_file<< "access time statistics of every channel every "<<trace_interval<<" cycles"<<std::endl;
-	for( int i=0 ; i<channel_num ;i++)
+	for( ncounter_t i=0 ; i<channel_num ;i++)
 	{
 		file<<"channel_"<<i<<"  ";
 		origin_file<<"channel_"<<i<<"  ";
@@ -232,17 +244,19 @@ bool MultiQueueMigrator::RequestComplete( NVMainRequest *request )
         /* Some other request completed, see if we can ninja issue some migration writes that did not queue. */
         else if( promoBuffered || demoBuffered )
         {
+            /* Issuing may change our parent, see above. */
+            NVMObject *savedParent = parent->GetTrampoline( );
             bool demoIssued, promoIssued;
 
             if( promoBuffered )
             {
-                promoIssued = parent->GetTrampoline( )->GetChild( promoRequest )->IssueCommand( promoRequest );
+                promoIssued = savedParent->GetChild( promoRequest )->IssueCommand( promoRequest );
                 promoBuffered = !promoIssued;
             }
 
             if( demoBuffered )
             {
-                demoIssued = parent->GetTrampoline( )->GetChild( demoRequest )->IssueCommand( demoRequest );
+                demoIssued = savedParent->GetChild( demoRequest )->IssueCommand( demoRequest );
                 demoBuffered = !demoIssued;
             }
         }
@@ -302,7 +316,7 @@ bool MultiQueueMigrator::TryMigration( NVMainRequest *request, bool atomic )
  		uint64_t channelNo = request->address.GetChannel();
 		if (GetEventQueue()->GetCurrentCycle()%trace_interval==0 )
 		{
-			for( int i=0 ; i<channel_num ; i++)
+			for( ncounter_t i=0 ; i<channel_num ; i++)
 			{
 				file<<migratorTranslator->migrate_access_times[i]<<"   ";
 				origin_file<< migratorTranslator->access_times[i]<<"   ";
@@ -313,26 +327,23 @@ bool MultiQueueMigrator::TryMigration( NVMainRequest *request, bool atomic )
 		//***********************traces end
 	
 		//this request is issued to access dram memory
-		if( channelNo == promotionChannel && !IsInList(DRAMPageList, pageNo) )
+		if( channelNo == promotionChannel )
 		{
-			DRAMPageList.push_back(pageNo);
+			DRAMPageList[pageNo] = true;
 		}       
 		//get ranking queue num for the request
 		int location = LocateQueue(pageNo);
 	
 		if( location == -1 )
 		{
-			PageType page = { pageNo, 1, currentTime + LIFE_TIME, channelNo };
 			//insert the request to queue[0] (LRU)
- 			JoinQueue(page);	
+ 			JoinQueue(pageNo, channelNo);	
 		}	
 		else
 		{
 			AccessPage(location, pageNo);	
 		}	
 
-		Display();
-
         /* See if any migration is possible (i.e., no migration is in progress) */
         bool migrationPossible = false;
 
@@ -463,7 +474,6 @@ void MultiQueueMigrator::ChooseVictim( MQMigrator *at, NVMAddress& /*promotee*/,
         promotionChannelParams = p;
 
         totalPromotionPages = p->RANKS * p->BANKS * p->ROWS;
-        currentPromotionPage = 0;
 
         if( p->COLS != numCols )
         {
@@ -503,7 +513,7 @@ void MultiQueueMigrator::ChooseVictim( MQMigrator *at, NVMAddress& /*promotee*/,
 		pageNo = at->GetAddressKey(victim);
 	
 		currentPromotionPage = (currentPromotionPage + 1) % totalPromotionPages;
-	}while(IsInList(DRAMPageList, pageNo));
+	}while(DRAMPageList.Contains(pageNo));
     
 	//	std::cout<<"\nChooseVictim: "<<std::hex<<victimAddress<<"\n"<<std::endl;
 }
@@ -514,114 +524,148 @@ void MultiQueueMigrator::Cycle( ncycle_t /*steps*/ )
 
 }
 
-void MultiQueueMigrator::JoinQueue(PageType page)
+MultiQueueMigrator::PageType *MultiQueueMigrator::AllocatePage()
 {
-	rankingQueues[0].push_back(page); 
+	if( freePages == NULL )
+	{
+		PageType *slab = new PageType[PAGE_SLAB_SIZE];
+		pageSlabs.push_back(slab);
+
+		for( int i = PAGE_SLAB_SIZE - 1; i >= 0; i-- )
+		{
+			slab[i].next = freePages;
+			freePages = &slab[i];
+		}
+	}
+
+	PageType *page = freePages;
+	freePages = page->next;
+
+	return page;
 }
 
-void MultiQueueMigrator::Upgrade(PageType page)
+void MultiQueueMigrator::ReleasePage(PageType *page)
 {
-	
+	page->next = freePages;
+	freePages = page;
 }
 
-void MultiQueueMigrator::Downgrade(PageType page)
+/* Appends the page at the MRU end of queue pos. */
+void MultiQueueMigrator::LinkPage(int pos, PageType *page)
 {
-	
+	RankingQueue& queue = rankingQueues[pos];
+
+	page->queue = pos;
+	page->prev = queue.tail;
+	page->next = NULL;
+
+	if( queue.tail != NULL )
+		queue.tail->next = page;
+	else
+		queue.head = page;
+
+	queue.tail = page;
 }
 
-int MultiQueueMigrator::LocateQueue(uint64_t pageNo)
+void MultiQueueMigrator::UnlinkPage(PageType *page)
 {
-	std::list<PageType>::iterator iter;
-	for(int pos = 0; pos < QUEUE_NUM; pos++)
-	{
-		for(iter = rankingQueues[pos].begin(); iter !=rankingQueues[pos].end(); iter++)
-		{
-			if((*iter).pageNumber == pageNo)
-			{
-				return pos;
-			}		
-		}
-	}
-	return -1;
+	RankingQueue& queue = rankingQueues[page->queue];
+
+	if( page->prev != NULL )
+		page->prev->next = page->next;
+	else
+		queue.head = page->next;
+
+	if( page->next != NULL )
+		page->next->prev = page->prev;
+	else
+		queue.tail = page->prev;
+
+	page->prev = page->next = NULL;
 }
 
-void MultiQueueMigrator::AccessPage(int pos, uint64_t pageNo)
+void MultiQueueMigrator::MovePage(int pos, PageType *page)
 {
-	std::list<PageType>::iterator iter;
-	for(iter = rankingQueues[pos].begin(); iter != rankingQueues[pos].end(); iter++)
-	{
-		if((*iter).pageNumber == pageNo)
-		{
-			(*iter).referenceCounter += 1;
-			(*iter).expirationTime = currentTime + LIFE_TIME;
-		
-			if((pos < QUEUE_NUM - 1) && (*iter).referenceCounter >= (2 << pos))
-			{
-				rankingQueues[pos+1].push_back(*iter);
-			}
-			else
-			{
-				rankingQueues[pos].push_back(*iter);
-			}
+	UnlinkPage(page);
+	LinkPage(pos, page);
+}
 
-			rankingQueues[pos].erase(iter);
-			
-			return;		
-		}
-	}
+/* Stops tracking the page; it starts over in queue 0 if accessed again. */
+void MultiQueueMigrator::DropPage(PageType *page)
+{
+	UnlinkPage(page);
+	pageTable.Erase(page->pageNumber);
+	ReleasePage(page);
+}
+
+void MultiQueueMigrator::JoinQueue(uint64_t pageNo, uint64_t channelNo)
+{
+	PageType *page = AllocatePage();
+
+	page->pageNumber = pageNo;
+	page->referenceCounter = 1;
+	page->expirationTime = currentTime + LIFE_TIME;
+	page->channelNumber = channelNo;
 
+	LinkPage(0, page);
+	pageTable[pageNo] = page;
 }
 
-void MultiQueueMigrator::Display()
+int MultiQueueMigrator::LocateQueue(uint64_t pageNo)
 {
-//	std::cout<<"\nDisplay:\nDRAMPageList:\n"<<std::endl;
-	
-	std::list<uint64_t>::iterator it;
-//	for(it = DRAMPageList.begin(); it != DRAMPageList.end(); it++)
-//	{
-//		std::cout<<std::hex<<*it<<"\t";
-//	}
-	
-	std::list<PageType>::iterator iter;
-	for(int pos = 0; pos < QUEUE_NUM; pos++)
+	PageType **page = pageTable.Find(pageNo);
+
+	return (page != NULL) ? (*page)->queue : -1;
+}
+
+void MultiQueueMigrator::AccessPage(int pos, uint64_t pageNo)
+{
+	PageType **entry = pageTable.Find(pageNo);
+
+	if( entry == NULL )
+		return;
+
+	PageType *page = *entry;
+
+	page->referenceCounter += 1;
+	page->expirationTime = currentTime + LIFE_TIME;
+
+	if((pos < QUEUE_NUM - 1) && page->referenceCounter >= (2u << pos))
 	{
-//		std::cout<<"\n************  "<<std::dec<<pos<<"  ***********\n"<<std::endl;
-		for(iter = rankingQueues[pos].begin(); iter != rankingQueues[pos].end(); iter++)
-		{
-//			std::cout<<std::hex<<(*iter).pageNumber<<"\t"<<std::dec<<(*iter).referenceCounter<<"\t"<<
-//						std::dec<<(*iter).expirationTime<<std::endl;
-		}
+		MovePage(pos + 1, page);
+	}
+	else
+	{
+		MovePage(pos, page);
 	}
 }
 
 void MultiQueueMigrator::CheckQueue()
 {
-	std::list<PageType>::iterator iter;
 	for(int pos = 0; pos < QUEUE_NUM; pos++)
 	{
-		iter = rankingQueues[pos].begin();
-		if(iter != rankingQueues[pos].end() && currentTime > (*iter).expirationTime)
+		PageType *page = rankingQueues[pos].head;
+
+		if(page != NULL && currentTime > page->expirationTime)
 		{
 			//Exist and expirate.
-			if((*iter).channelNumber == promotionChannel)
+			if(page->channelNumber == promotionChannel)
 			{
 				//DRAM page.
-				bool in = IsInList(demotedDRAMList, (*iter).pageNumber);
-				if(in)
+				if(demotedDRAMList.Contains(page->pageNumber))
 				{
-					rankingQueues[pos].pop_front();
-					RemoveFromList(demotedDRAMList, (*iter).pageNumber);
+					demotedDRAMList.Erase(page->pageNumber);
+					DropPage(page);
 				}
 				else if(pos > 0)
 				{
-					(*iter).expirationTime = currentTime + LIFE_TIME;
-					rankingQueues[pos - 1].push_back(*iter);
-					demotedDRAMList.push_back((*iter).pageNumber);
-					rankingQueues[pos].pop_front();
+					page->expirationTime = currentTime + LIFE_TIME;
+					MovePage(pos - 1, page);
+					demotedDRAMList[page->pageNumber] = true;
 				}
 				else
 				{
-					rankingQueues[pos].pop_front();
+					DropPage(page);
 				}
 			}
 			else
@@ -629,46 +673,18 @@ void MultiQueueMigrator::CheckQueue()
 				//PCM page.
 				if(pos > 0)
 				{
-					(*iter).expirationTime = currentTime + LIFE_TIME;
-					rankingQueues[pos - 1].push_back(*iter);
-					rankingQueues[pos].pop_front();
+					page->expirationTime = currentTime + LIFE_TIME;
+					MovePage(pos - 1, page);
 				}	
 				else
 				{
-					rankingQueues[pos].pop_front();
+					DropPage(page);
 				}
 			}
 		}	
 	}
 }
 
-bool MultiQueueMigrator::IsInList(std::list<uint64_t> list, uint64_t pageNo)
-{
-	std::list<uint64_t>::iterator iter;
-	for(iter = list.begin(); iter != list.end(); iter++)
-	{
-		if(pageNo == *iter)
-		{
-			return true;
-		}
-	}
-	
-	return false;
-}
-
-void MultiQueueMigrator::RemoveFromList(std::list<uint64_t> list, uint64_t pageNo)
-{
-	std::list<uint64_t>::iterator iter;
-	for(iter = list.begin(); iter != list.end(); iter++)
-	{
-		if(pageNo == *iter)
-		{
-			list.erase(iter);
-			return;
-		}
-	}	
-}
-
 uint64_t MultiQueueMigrator::GetPageNumber( MQMigrator *at, NVMAddress address )
 {
 	uint64_t pageNum = at->GetAddressKey(address);
@@ -695,4 +711,129 @@ uint64_t MultiQueueMigrator::GetRealChannel( MQMigrator *at, NVMAddress address
 	return address.GetChannel();
 }
 
+/*
+ *  Saves the ranking queues from LRU to MRU, the pages known to be in
+ *  DRAM and the next victim page. Migrations in flight are not saved, so
+ *  the memory is assumed to be drained. The page mappings themselves are
+ *  saved by the MQMigrator translator.
+ */
+void MultiQueueMigrator::CreateCheckpoint( std::string dir )
+{
+	std::string cpt_file = dir + "/MultiQueueMigrator";
+	std::ofstream cpt_handle;
+
+	cpt_handle.open( cpt_file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
 
+	if( !cpt_handle.is_open() )
+	{
+		std::cout << "MultiQueueMigrator: Warning: Could not open checkpoint file: "
+		          << cpt_file << std::endl;
+		return;
+	}
+
+	uint64_t header[3] = { QUEUE_NUM, currentTime, currentPromotionPage };
+	cpt_handle.write( (const char*)header, sizeof(header) );
+
+	for( int pos = 0; pos < QUEUE_NUM; pos++ )
+	{
+		uint64_t pageCount = 0;
+		for( PageType *page = rankingQueues[pos].head; page != NULL; page = page->next )
+			pageCount++;
+
+		cpt_handle.write( (const char*)&pageCount, sizeof(uint64_t) );
+
+		for( PageType *page = rankingQueues[pos].head; page != NULL; page = page->next )
+		{
+			uint64_t entry[4] = { page->pageNumber, page->referenceCounter,
+			                      page->expirationTime, page->channelNumber };
+			cpt_handle.write( (const char*)entry, sizeof(entry) );
+		}
+	}
+
+	PageHashMap<bool> *lists[2] = { &DRAMPageList, &demotedDRAMList };
+	for( int list = 0; list < 2; list++ )
+	{
+		uint64_t pageCount = lists[list]->size( );
+		cpt_handle.write( (const char*)&pageCount, sizeof(uint64_t) );
+
+		PageHashMap<bool>::iterator it;
+		for( it = lists[list]->begin(); it != lists[list]->end(); ++it )
+			cpt_handle.write( (const char*)&(it->key), sizeof(uint64_t) );
+	}
+
+	cpt_handle.close( );
+}
+
+void MultiQueueMigrator::RestoreCheckpoint( std::string dir )
+{
+	std::string cpt_file = dir + "/MultiQueueMigrator";
+	std::ifstream cpt_handle;
+
+	cpt_handle.open( cpt_file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+	if( !cpt_handle.is_open() )
+	{
+		std::cout << "MultiQueueMigrator: Warning: Could not open checkpoint file: "
+		          << cpt_file << std::endl;
+		return;
+	}
+
+	uint64_t header[3] = { 0, 0, 0 };
+	cpt_handle.read( (char*)header, sizeof(header) );
+
+	if( header[0] != QUEUE_NUM )
+	{
+		std::cout << "MultiQueueMigrator: Warning: Checkpoint file " << cpt_file
+		          << " has " << header[0] << " ranking queues, expected " << QUEUE_NUM
+		          << ". Skipping restore." << std::endl;
+		return;
+	}
+
+	currentTime = header[1];
+	currentPromotionPage = header[2];
+
+	for( int pos = 0; pos < QUEUE_NUM && cpt_handle; pos++ )
+	{
+		uint64_t pageCount = 0;
+		cpt_handle.read( (char*)&pageCount, sizeof(uint64_t) );
+
+		for( uint64_t idx = 0; idx < pageCount && cpt_handle; idx++ )
+		{
+			uint64_t entry[4];
+			if( !cpt_handle.read( (char*)entry, sizeof(entry) ) || pageTable.Contains( entry[0] ) )
+				continue;
+
+			PageType *page = AllocatePage();
+
+			page->pageNumber = entry[0];
+			page->referenceCounter = entry[1];
+			page->expirationTime = entry[2];
+			page->channelNumber = entry[3];
+
+			LinkPage(pos, page);
+			pageTable[page->pageNumber] = page;
+		}
+	}
+
+	PageHashMap<bool> *lists[2] = { &DRAMPageList, &demotedDRAMList };
+	for( int list = 0; list < 2 && cpt_handle; list++ )
+	{
+		uint64_t pageCount = 0;
+		cpt_handle.read( (char*)&pageCount, sizeof(uint64_t) );
+
+		for( uint64_t idx = 0; idx < pageCount && cpt_handle; idx++ )
+		{
+			uint64_t pageNo;
+			if( cpt_handle.read( (char*)&pageNo, sizeof(uint64_t) ) )
+				(*lists[list])[pageNo] = true;
+		}
+	}
+
+	if( !cpt_handle )
+	{
+		std::cout << "MultiQueueMigrator: Warning: Checkpoint file " << cpt_file
+		          << " is truncated." << std::endl;
+	}
+
+	cpt_handle.close( );
+}
@@ -11,6 +11,11 @@ Modified by dliu, based on CoinMigrator.h.
 #include "src/NVMObject.h"
 #include "src/Params.h"
 #include "include/NVMainRequest.h"
+#include "include/PageHashMap.h"
+
+#include <fstream>
+#include <vector>
+
 namespace NVM {
 
 #define MIG_READ_TAG GetTagGenerator( )->CreateTag("MIGREAD")
@@ -32,6 +37,9 @@ class MultiQueueMigrator : public NVMObject
 
     void Cycle( ncycle_t steps );
 
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
   private:
     bool promoBuffered, demoBuffered; 
     NVMAddress demotee, promotee; 
@@ -55,29 +63,47 @@ class MultiQueueMigrator : public NVMObject
     bool TryMigration( NVMainRequest *request, bool atomic );
     void ChooseVictim( MQMigrator *at, NVMAddress& promo, NVMAddress& victim );
 	
-	typedef struct
+	/* 
+	 *  A page in one of the ranking queues. Queues are intrusive LRU lists
+	 *  and pages are found through pageTable, so accessing, promoting and
+	 *  expiring a page are all constant time.
+	 */
+	struct PageType
 	{
 		uint64_t pageNumber;	
 		uint64_t referenceCounter;
 		uint64_t expirationTime;
 		uint64_t channelNumber;
-	}PageType;
+		int queue;
+		PageType *prev, *next;
+	};
+
+	struct RankingQueue
+	{
+		PageType *head, *tail;
+	};
 	
 	uint64_t currentTime;
 
-	std::list<PageType> *rankingQueues;
-	std::list<uint64_t> DRAMPageList, demotedDRAMList;	
-	std::map<uint64_t , uint64_t> page_access_times;
+	RankingQueue *rankingQueues;
+	PageHashMap<PageType *> pageTable;
+	PageHashMap<bool> DRAMPageList, demotedDRAMList;	
+
+	/* Pages are carved out of slabs and recycled through a free list. */
+	PageType *freePages;
+	std::vector<PageType *> pageSlabs;
+
+	PageType *AllocatePage();
+	void ReleasePage(PageType *page);
+	void LinkPage(int pos, PageType *page);
+	void UnlinkPage(PageType *page);
+	void MovePage(int pos, PageType *page);
+	void DropPage(PageType *page);
 
-	void JoinQueue(PageType page);
-	void Upgrade(PageType page);
-	void Downgrade(PageType page);
+	void JoinQueue(uint64_t pageNo, uint64_t channelNo);
 	int LocateQueue(uint64_t pageNo);
 	void AccessPage(int pos, uint64_t pageNo);
-	void Display();
 	void CheckQueue();
-	bool IsInList(std::list<uint64_t> list, uint64_t pageNo);
-	void RemoveFromList(std::list<uint64_t> list, uint64_t pageNo);
 	uint64_t GetPageNumber(MQMigrator *at, NVMAddress address);
 	uint64_t GetRealChannel(MQMigrator *at, NVMAddress address);
 	std::ofstream file;
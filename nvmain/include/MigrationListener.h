@@ -0,0 +1,76 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NVMAIN_MIGRATIONLISTENER_H__
+#define __NVMAIN_MIGRATIONLISTENER_H__
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace NVM {
+
+/*
+ *  Interface for objects which need to know where pages live, e.g. a
+ *  simulator-side map of which addresses are backed by DRAM or NVM.
+ */
+class MigrationListener
+{
+  public:
+    virtual ~MigrationListener( ) { }
+
+    /* Called once a page finished moving; address is any address in it. */
+    virtual void PageMigrated( uint64_t address, uint64_t channel ) = 0;
+};
+
+/*
+ *  Implemented by every decoder that moves pages between channels, so a
+ *  listener can be attached without knowing which migrator is in use.
+ */
+class MigrationNotifier
+{
+  public:
+    MigrationNotifier( ) : listener(NULL) { }
+    virtual ~MigrationNotifier( ) { }
+
+    void SetListener( MigrationListener *newListener ) { listener = newListener; }
+
+  protected:
+    void NotifyMigrated( uint64_t address, uint64_t channel )
+    {
+        if( listener != NULL )
+            listener->PageMigrated( address, channel );
+    }
+
+  private:
+    MigrationListener *listener;
+};
+
+};
+
+#endif
@@ -54,8 +54,15 @@ NVMDataBlock::~NVMDataBlock( )
 
 void NVMDataBlock::SetSize( uint64_t s )
 {
-    assert( rawData == NULL );
-    rawData = new uint8_t[s];
+    /* Blocks of recycled requests keep their buffer if the size matches. */
+    if( rawData != NULL && size != s )
+    {
+        delete[] rawData;
+        rawData = NULL;
+    }
+
+    if( rawData == NULL )
+        rawData = new uint8_t[s];
     size = s;
     isValid = true;
 }
@@ -33,8 +33,120 @@
 
 #include "include/NVMHelpers.h"
 
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+
 namespace NVM {
 
+/* Little-endian hosts only, as the rest of the data path assumes. */
+static inline uint64_t LoadWord( const uint8_t *data )
+{
+    uint64_t word;
+
+    memcpy( &word, data, sizeof(word) );
+
+    return word;
+}
+
+/* The last bytes of a block, fewer than a word, zero extended. */
+static inline uint64_t LoadTail( const uint8_t *data, uint64_t bytes )
+{
+    uint64_t word = 0;
+
+    assert( bytes < sizeof(word) );
+    memcpy( &word, data, bytes );
+
+    return word;
+}
+
+/*
+ *  Without a population count instruction __builtin_popcountll becomes a
+ *  library call, which is slower than counting in registers.
+ */
+static inline uint64_t PopCount( uint64_t word )
+{
+#if defined(__POPCNT__)
+    return __builtin_popcountll( word );
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return (word * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+uint64_t CountSetBits( const uint8_t *data, uint64_t bytes )
+{
+    uint64_t count = 0;
+    uint64_t i;
+
+    for( i = 0; i + 8 <= bytes; i += 8 )
+        count += PopCount( LoadWord( data + i ) );
+
+    if( i < bytes )
+        count += PopCount( LoadTail( data + i, bytes - i ) );
+
+    return count;
+}
+
+uint64_t CountChangedBits( const uint8_t *data, const uint8_t *oldData, 
+                           uint64_t bytes )
+{
+    uint64_t count = 0;
+    uint64_t i;
+
+    for( i = 0; i + 8 <= bytes; i += 8 )
+        count += PopCount( LoadWord( data + i ) ^ LoadWord( oldData + i ) );
+
+    if( i < bytes )
+    {
+        count += PopCount( LoadTail( data + i, bytes - i )
+                         ^ LoadTail( oldData + i, bytes - i ) );
+    }
+
+    return count;
+}
+
+/*
+ *  Flip the bits so the level we are looking for reads as "11", then AND
+ *  each even bit with its odd neighbor to find the "11" pairs.
+ */
+static inline uint64_t LevelPairs( uint64_t word, uint64_t toOnes )
+{
+    word ^= toOnes;
+
+    return word & (word >> 1) & 0x5555555555555555ULL;
+}
+
+uint64_t CountCellLevels( uint8_t level, const uint8_t *data, uint64_t bytes )
+{
+    static const uint64_t toOnes[4] = { 0xFFFFFFFFFFFFFFFFULL, 
+                                        0xAAAAAAAAAAAAAAAAULL,
+                                        0x5555555555555555ULL, 
+                                        0x0000000000000000ULL };
+    uint64_t count = 0;
+    uint64_t i;
+
+    assert( level < 4 );
+
+    for( i = 0; i + 8 <= bytes; i += 8 )
+        count += PopCount( LevelPairs( LoadWord( data + i ), toOnes[level] ) );
+
+    /* The zero bytes past the tail would count as cells, mask them out. */
+    if( i < bytes )
+    {
+        uint64_t pairs = LevelPairs( LoadTail( data + i, bytes - i ), toOnes[level] );
+
+        count += PopCount( pairs & ((1ULL << ((bytes - i) * 8)) - 1) );
+    }
+
+    return count;
+}
+
 int mlog2( int num )
 {
     int retVal = -1;
@@ -61,4 +173,23 @@ std::string GetFilePath( std::string file )
     return file.substr( 0, last_sep+1 );
 } 
 
+bool MakeDirectory( std::string dir )
+{
+    size_t sep = 0;
+
+    while( sep != std::string::npos )
+    {
+        sep = dir.find( '/', sep + 1 );
+
+        std::string path = dir.substr( 0, sep );
+
+        if( !path.empty( ) && mkdir( path.c_str( ), 0755 ) != 0 && errno != EEXIST )
+            return false;
+    }
+
+    struct stat info;
+
+    return ( stat( dir.c_str( ), &info ) == 0 && S_ISDIR( info.st_mode ) );
+}
+
 };
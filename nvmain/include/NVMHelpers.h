@@ -43,6 +43,18 @@ namespace NVM {
 
 int mlog2( int num );
 std::string GetFilePath( std::string file );
+/* Create a directory and any missing parents; true if it exists after. */
+bool MakeDirectory( std::string dir );
+
+/*
+ *  Bit counting over raw data blocks. These work a 64-bit word at a time
+ *  and make no assumption about the alignment of data.
+ */
+uint64_t CountSetBits( const uint8_t *data, uint64_t bytes );
+uint64_t CountChangedBits( const uint8_t *data, const uint8_t *oldData, 
+                           uint64_t bytes );
+/* Number of 2-bit MLC cells holding level (0 = 00, 1 = 01, 2 = 10, 3 = 11). */
+uint64_t CountCellLevels( uint8_t level, const uint8_t *data, uint64_t bytes );
 
 template <typename T1, typename T2>
 std::string PyDictHistogram( std::map<T1, T2> iiMap )
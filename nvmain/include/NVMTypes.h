@@ -41,6 +41,7 @@
 namespace NVM {
 
 class NVMainRequest;
+class TransactionQueue;
 
 typedef uint64_t  ncycle_t;
 typedef int64_t   ncycles_t;
@@ -48,7 +49,7 @@ typedef int64_t   ncycles_t;
 typedef uint64_t  ncounter_t;
 typedef int64_t   ncounters_t;
 
-typedef std::list<NVMainRequest *> NVMTransactionQueue;
+typedef TransactionQueue NVMTransactionQueue;
 typedef std::deque<NVMainRequest *> NVMCommandQueue;
 
 };
@@ -0,0 +1,99 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NVMAINREQUESTPOOL_H__
+#define __NVMAINREQUESTPOOL_H__
+
+#include "include/NVMainRequest.h"
+#include <vector>
+
+namespace NVM {
+
+/*
+ *  Recycles the requests of a front end so that issuing a request does not
+ *  go through the allocator. Released requests keep their data buffers,
+ *  which are reused when data of the same size is assigned to them. The
+ *  pool is not thread-safe; requests must be released by their owner once
+ *  they complete, and are only freed when the pool is destroyed.
+ */
+class NVMainRequestPool
+{
+  public:
+    NVMainRequestPool( ) { }
+
+    ~NVMainRequestPool( )
+    {
+        for( size_t i = 0; i < freeRequests.size( ); i++ )
+            delete freeRequests[i];
+    }
+
+    /* Get a request in the same state as a newly constructed one. */
+    NVMainRequest *Allocate( )
+    {
+        if( freeRequests.empty( ) )
+            return new NVMainRequest( );
+
+        NVMainRequest *request = freeRequests.back( );
+        freeRequests.pop_back( );
+
+        request->type = NOP;
+        request->bulkCmd = CMD_NOP;
+        request->threadId = 0;
+        request->data.SetValid( false );
+        request->oldData.SetValid( false );
+        request->tag = 0;
+        request->reqInfo = NULL;
+        request->flags = 0;
+        request->arrivalCycle = 0;
+        request->issueCycle = 0;
+        request->queueCycle = 0;
+        request->completionCycle = 0;
+        request->isPrefetch = false;
+        request->programCounter = 0;
+        request->burstCount = 1;
+        request->writeProgress = 0;
+        request->cancellations = 0;
+        request->owner = NULL;
+
+        return request;
+    }
+
+    /* Give a completed request back to the pool. */
+    void Release( NVMainRequest *request )
+    {
+        freeRequests.push_back( request );
+    }
+
+  private:
+    std::vector<NVMainRequest *> freeRequests;
+};
+
+};
+
+#endif
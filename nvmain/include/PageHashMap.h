@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NVMAIN_PAGEHASHMAP_H__
+#define __NVMAIN_PAGEHASHMAP_H__
+
+#include <cassert>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace NVM {
+
+/*
+ *  Open addressing hash map from page keys (or any 64-bit key) to a small
+ *  value, for bookkeeping that is looked up on every memory access. Linear
+ *  probing keeps a lookup to one or two cache lines, and erasing shifts the
+ *  following entries back instead of leaving tombstones, so lookups stay
+ *  short no matter how many pages come and go. Slots are only allocated
+ *  when the table grows past half full; Reserve() avoids even that.
+ */
+template<typename V>
+class PageHashMap
+{
+  public:
+    struct Slot
+    {
+        Slot( ) : key(0), used(false) { }
+
+        uint64_t key;
+        V value;
+        bool used;
+    };
+
+    class iterator
+    {
+      public:
+        iterator( ) : slots(NULL), index(0), end(0) { }
+        iterator( Slot *_slots, size_t _index, size_t _end ) 
+            : slots(_slots), index(_index), end(_end) 
+        {
+            Skip( );
+        }
+
+        Slot& operator*( ) const { return slots[index]; }
+        Slot *operator->( ) const { return &slots[index]; }
+
+        iterator& operator++( )
+        {
+            index++;
+            Skip( );
+            return *this;
+        }
+
+        bool operator==( const iterator& other ) const { return index == other.index; }
+        bool operator!=( const iterator& other ) const { return index != other.index; }
+
+      private:
+        Slot *slots;
+        size_t index, end;
+
+        void Skip( )
+        {
+            while( index < end && !slots[index].used )
+                index++;
+        }
+    };
+
+    explicit PageHashMap( size_t capacity = 64 ) : count(0)
+    {
+        Rehash( RoundCapacity( capacity ) );
+    }
+
+    size_t size( ) const { return count; }
+    bool empty( ) const { return (count == 0); }
+
+    iterator begin( ) { return iterator( &slots[0], 0, slots.size( ) ); }
+    iterator end( ) { return iterator( &slots[0], slots.size( ), slots.size( ) ); }
+
+    /* Returns the value for key, or NULL if the key is not in the map. */
+    V *Find( uint64_t key )
+    {
+        size_t index = Probe( key );
+
+        return slots[index].used ? &slots[index].value : NULL;
+    }
+
+    bool Contains( uint64_t key ) { return (Find( key ) != NULL); }
+
+    /* Returns the value for key, inserting a default value if needed. */
+    V& operator[]( uint64_t key )
+    {
+        size_t index = Probe( key );
+
+        if( !slots[index].used )
+        {
+            if( (count + 1) * 2 > slots.size( ) )
+            {
+                Rehash( slots.size( ) * 2 );
+                index = Probe( key );
+            }
+
+            slots[index].key = key;
+            slots[index].value = V( );
+            slots[index].used = true;
+            count++;
+        }
+
+        return slots[index].value;
+    }
+
+    bool Erase( uint64_t key )
+    {
+        size_t index = Probe( key );
+
+        if( !slots[index].used )
+            return false;
+
+        /*
+         *  Move later entries of the probe sequence into the hole unless
+         *  they already sit between their home slot and the hole.
+         */
+        size_t mask = slots.size( ) - 1;
+        size_t next = index;
+
+        while( true )
+        {
+            next = (next + 1) & mask;
+
+            if( !slots[next].used )
+                break;
+
+            size_t home = Hash( slots[next].key ) & mask;
+
+            if( ((next - home) & mask) >= ((next - index) & mask) )
+            {
+                slots[index] = slots[next];
+                index = next;
+            }
+        }
+
+        slots[index].used = false;
+        slots[index].value = V( );
+        count--;
+
+        return true;
+    }
+
+    void clear( )
+    {
+        for( size_t i = 0; i < slots.size( ); i++ )
+            slots[i] = Slot( );
+
+        count = 0;
+    }
+
+    void Reserve( size_t entries )
+    {
+        size_t capacity = RoundCapacity( entries * 2 );
+
+        if( capacity > slots.size( ) )
+            Rehash( capacity );
+    }
+
+  private:
+    std::vector<Slot> slots;
+    size_t count;
+
+    static uint64_t Hash( uint64_t key )
+    {
+        /* Page keys are dense, so mix the bits (splitmix64 finalizer). */
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+
+        return key;
+    }
+
+    static size_t RoundCapacity( size_t capacity )
+    {
+        size_t rv = 16;
+
+        while( rv < capacity )
+            rv <<= 1;
+
+        return rv;
+    }
+
+    /* Slot holding key, or the empty slot where it would be inserted. */
+    size_t Probe( uint64_t key ) const
+    {
+        size_t mask = slots.size( ) - 1;
+        size_t index = Hash( key ) & mask;
+
+        while( slots[index].used && slots[index].key != key )
+            index = (index + 1) & mask;
+
+        return index;
+    }
+
+    void Rehash( size_t capacity )
+    {
+        std::vector<Slot> oldSlots;
+
+        oldSlots.swap( slots );
+        slots.assign( capacity, Slot( ) );
+
+        for( size_t i = 0; i < oldSlots.size( ); i++ )
+        {
+            if( oldSlots[i].used )
+                slots[Probe( oldSlots[i].key )] = oldSlots[i];
+        }
+    }
+};
+
+};
+
+#endif
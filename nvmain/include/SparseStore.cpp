@@ -0,0 +1,247 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "include/SparseStore.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace NVM;
+
+SparseStore::SparseStore( size_t _recordBytes, unsigned int _pageBits )
+    : recordBytes(_recordBytes), pageBits(_pageBits), count(0), lastPage(NULL)
+{
+    /* At least one bitmap word per page. */
+    if( pageBits < 6 )
+        pageBits = 6;
+
+    uint64_t entries = 1ULL << pageBits;
+    size_t systemPage = static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+
+    pageMask = entries - 1;
+    bitmapBytes = static_cast<size_t>( entries / 64 ) * sizeof(uint64_t);
+    pageBytes = bitmapBytes + static_cast<size_t>( entries ) * recordBytes;
+    pageBytes = (pageBytes + systemPage - 1) / systemPage * systemPage;
+}
+
+SparseStore::~SparseStore( )
+{
+    clear( );
+}
+
+SparseStore::Page *SparseStore::FindPage( uint64_t number, bool create )
+{
+    if( lastPage != NULL && lastPage->number == number )
+        return lastPage;
+
+    Page **found = pages.Find( number );
+
+    if( found != NULL )
+    {
+        lastPage = *found;
+    }
+    else if( create )
+    {
+        void *memory = mmap( NULL, pageBytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+
+        if( memory == MAP_FAILED )
+        {
+            std::cerr << "NVMain: Could not map " << pageBytes 
+                      << " bytes for sparse storage." << std::endl;
+            exit(1);
+        }
+
+        Page *page = new Page( );
+
+        page->number = number;
+        page->present = static_cast<uint64_t *>( memory );
+        page->records = static_cast<uint8_t *>( memory ) + bitmapBytes;
+
+        pages[number] = page;
+        pageList.push_back( page );
+
+        lastPage = page;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    return lastPage;
+}
+
+void *SparseStore::Find( uint64_t key )
+{
+    Page *page = FindPage( key >> pageBits, false );
+    uint64_t index = key & pageMask;
+
+    if( page == NULL || !(page->present[index / 64] & (1ULL << (index % 64))) )
+        return NULL;
+
+    return page->records + index * recordBytes;
+}
+
+bool SparseStore::Contains( uint64_t key )
+{
+    Page *page = FindPage( key >> pageBits, false );
+    uint64_t index = key & pageMask;
+
+    return (page != NULL && (page->present[index / 64] & (1ULL << (index % 64))));
+}
+
+void *SparseStore::Insert( uint64_t key, bool *inserted )
+{
+    Page *page = FindPage( key >> pageBits, true );
+    uint64_t index = key & pageMask;
+    uint64_t bit = 1ULL << (index % 64);
+    bool isNew = !(page->present[index / 64] & bit);
+
+    if( isNew )
+    {
+        page->present[index / 64] |= bit;
+        count++;
+    }
+
+    if( inserted != NULL )
+        *inserted = isNew;
+
+    return page->records + index * recordBytes;
+}
+
+bool SparseStore::Erase( uint64_t key )
+{
+    Page *page = FindPage( key >> pageBits, false );
+    uint64_t index = key & pageMask;
+    uint64_t bit = 1ULL << (index % 64);
+
+    if( page == NULL || !(page->present[index / 64] & bit) )
+        return false;
+
+    page->present[index / 64] &= ~bit;
+    memset( page->records + index * recordBytes, 0, recordBytes );
+    count--;
+
+    return true;
+}
+
+void SparseStore::clear( )
+{
+    for( size_t i = 0; i < pageList.size( ); i++ )
+    {
+        munmap( pageList[i]->present, pageBytes );
+        delete pageList[i];
+    }
+
+    pages.clear( );
+    pageList.clear( );
+    lastPage = NULL;
+    count = 0;
+}
+
+void SparseStore::WriteCheckpoint( std::ostream& stream )
+{
+    uint64_t header[2] = { recordBytes, count };
+
+    stream.write( reinterpret_cast<const char *>(header), sizeof(header) );
+
+    for( iterator it = begin( ); it != end( ); ++it )
+    {
+        uint64_t key = it.Key( );
+
+        stream.write( reinterpret_cast<const char *>(&key), sizeof(key) );
+        stream.write( static_cast<const char *>(it.Value( )), recordBytes );
+    }
+}
+
+bool SparseStore::ReadCheckpoint( std::istream& stream )
+{
+    uint64_t header[2];
+
+    if( !stream.read( reinterpret_cast<char *>(header), sizeof(header) ) 
+        || header[0] != recordBytes )
+        return false;
+
+    for( uint64_t i = 0; i < header[1]; i++ )
+    {
+        uint64_t key;
+
+        if( !stream.read( reinterpret_cast<char *>(&key), sizeof(key) ) )
+            return false;
+
+        void *record = Insert( key );
+
+        if( !stream.read( static_cast<char *>(record), recordBytes ) )
+            return false;
+    }
+
+    return true;
+}
+
+uint64_t SparseStore::iterator::Key( ) const
+{
+    return (store->pageList[page]->number << store->pageBits) | index;
+}
+
+void *SparseStore::iterator::Value( ) const
+{
+    return store->pageList[page]->records + index * store->recordBytes;
+}
+
+/* Moves to the next present key at or after the current position. */
+void SparseStore::iterator::Skip( )
+{
+    uint64_t entries = store->pageMask + 1;
+
+    while( page < store->pageList.size( ) )
+    {
+        const uint64_t *present = store->pageList[page]->present;
+
+        while( index < entries )
+        {
+            uint64_t bits = present[index / 64] >> (index % 64);
+
+            if( bits != 0 )
+            {
+                index += __builtin_ctzll( bits );
+                return;
+            }
+
+            index += 64 - (index % 64);
+        }
+
+        page++;
+        index = 0;
+    }
+
+    index = 0;
+}
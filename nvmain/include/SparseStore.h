@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NVMAIN_SPARSESTORE_H__
+#define __NVMAIN_SPARSESTORE_H__
+
+#include <cstddef>
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+#include "include/PageHashMap.h"
+
+namespace NVM {
+
+/*
+ *  Sparse table of fixed size records indexed by a 64-bit key, for per-line
+ *  state covering the whole memory (stored data, endurance, flip bits). Keys
+ *  are grouped into pages of 2^pageBits consecutive keys. Each page is one
+ *  anonymous mmap holding a presence bitmap and the records, so the OS only
+ *  backs the parts that are touched, and new records read as zero. Pages are
+ *  found through a hash of the page number, with the last page cached since
+ *  accesses tend to be near each other.
+ *
+ *  Records are raw memory: only store types which are valid when zeroed and
+ *  can be copied with memcpy. A record size of zero gives a set of keys.
+ */
+class SparseStore
+{
+  public:
+    class iterator
+    {
+      public:
+        iterator( ) : store(NULL), page(0), index(0) { }
+        iterator( SparseStore *_store, size_t _page, size_t _index )
+            : store(_store), page(_page), index(_index)
+        {
+            Skip( );
+        }
+
+        uint64_t Key( ) const;
+        void *Value( ) const;
+
+        iterator& operator++( )
+        {
+            index++;
+            Skip( );
+            return *this;
+        }
+
+        bool operator==( const iterator& other ) const 
+        { 
+            return page == other.page && index == other.index; 
+        }
+        bool operator!=( const iterator& other ) const { return !(*this == other); }
+
+      private:
+        SparseStore *store;
+        size_t page, index;
+
+        void Skip( );
+    };
+
+    explicit SparseStore( size_t recordBytes = 0, unsigned int pageBits = 12 );
+    ~SparseStore( );
+
+    /* Returns the record for key, or NULL if the key is not present. */
+    void *Find( uint64_t key );
+    bool Contains( uint64_t key );
+
+    /* Returns the record for key, adding a zeroed record if not present. */
+    void *Insert( uint64_t key, bool *inserted = NULL );
+
+    /* Removes key and zeroes its record. */
+    bool Erase( uint64_t key );
+
+    void clear( );
+
+    /* 
+     *  Write every record with its key, or read records written that way
+     *  back into this store. Reading fails if the record size differs.
+     */
+    void WriteCheckpoint( std::ostream& stream );
+    bool ReadCheckpoint( std::istream& stream );
+
+    size_t size( ) const { return count; }
+    bool empty( ) const { return (count == 0); }
+
+    /* Bytes of address space reserved for pages (not all of it is backed). */
+    size_t ReservedBytes( ) const { return pageList.size( ) * pageBytes; }
+
+    iterator begin( ) { return iterator( this, 0, 0 ); }
+    iterator end( ) { return iterator( this, pageList.size( ), 0 ); }
+
+  private:
+    struct Page
+    {
+        uint64_t number;
+        uint64_t *present;
+        uint8_t *records;
+    };
+
+    size_t recordBytes;
+    unsigned int pageBits;
+    uint64_t pageMask;
+    size_t bitmapBytes;
+    size_t pageBytes;
+    size_t count;
+
+    PageHashMap<Page *> pages;
+    std::vector<Page *> pageList;
+    Page *lastPage;
+
+    Page *FindPage( uint64_t number, bool create );
+
+    SparseStore( const SparseStore& );
+    SparseStore& operator=( const SparseStore& );
+};
+
+/* Typed view of a SparseStore. T must be valid when zeroed. */
+template<typename T>
+class SparseTable : public SparseStore
+{
+  public:
+    explicit SparseTable( unsigned int pageBits = 12 ) 
+        : SparseStore( sizeof(T), pageBits ) { }
+
+    T *Find( uint64_t key ) { return static_cast<T *>( SparseStore::Find( key ) ); }
+    T& operator[]( uint64_t key ) { return *static_cast<T *>( Insert( key ) ); }
+
+    static T& Value( const iterator& it ) { return *static_cast<T *>( it.Value( ) ); }
+};
+
+};
+
+#endif
@@ -318,6 +318,15 @@ uint64_t AddressTranslator::Translate( uint64_t address )
     return rv;
 }
 
+uint64_t AddressTranslator::GetChannel( uint64_t address )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+
+    Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+
+    return channel;
+}
+
 void AddressTranslator::SetDefaultField( TranslationField f )
 {
     defaultField = f;
@@ -78,6 +78,9 @@ class AddressTranslator
 
     virtual uint64_t Translate( uint64_t address );
     virtual uint64_t Translate( NVMainRequest *request );
+
+    /* Channel serving an address, looked up without counting an access. */
+    virtual uint64_t GetChannel( uint64_t address );
     virtual void SetDefaultField( TranslationField f ); 
 
     void SetStats( Stats *stats );
@@ -57,6 +57,10 @@ class DataEncoder : public NVMObject
 
     virtual void PrintStats( ) { }
 
+    /* Encoders keeping per-line state save and restore it in the given file. */
+    virtual void WriteCheckpoint( std::string /*file*/ ) { }
+    virtual void ReadCheckpoint( std::string /*file*/ ) { }
+
     virtual void Cycle( ncycle_t steps );
 
 };
@@ -34,6 +34,7 @@
 #include "src/EnduranceModel.h"
 #include "Endurance/EnduranceDistributionFactory.h"
 #include "src/FaultModel.h"
+#include <fstream>
 #include <iostream>
 #include <limits>
 
@@ -59,13 +60,13 @@ void EnduranceModel::SetConfig( Config *config, bool /*createChildren*/ )
  */
 uint64_t EnduranceModel::GetWorstLife( )
 {
-    std::map<uint64_t, uint64_t>::iterator i;
+    SparseTable<uint64_t>::iterator i;
     uint64_t min = std::numeric_limits< uint64_t >::max( );
 
-    for( i = life.begin( ); i != life.end( ); i++ )
+    for( i = life.begin( ); i != life.end( ); ++i )
     {
-        if( i->second < min )
-            min = i->second;
+        if( life.Value( i ) < min )
+            min = life.Value( i );
     }
 
     return min;
@@ -78,12 +79,12 @@ uint64_t EnduranceModel::GetWorstLife( )
  */
 uint64_t EnduranceModel::GetAverageLife( )
 {
-    std::map<uint64_t, uint64_t>::iterator i;
+    SparseTable<uint64_t>::iterator i;
     uint64_t total = 0;
     uint64_t average = 0;
 
-    for( i = life.begin( ); i != life.end( ); i++ )
-        total += i->second;
+    for( i = life.begin( ); i != life.end( ); ++i )
+        total += life.Value( i );
 
     if( life.size( ) != 0 )
         average = total / life.size( );
@@ -95,20 +96,20 @@ uint64_t EnduranceModel::GetAverageLife( )
 
 bool EnduranceModel::DecrementLife( uint64_t addr )
 {
-    std::map<uint64_t, uint64_t>::iterator i = life.find( addr );
+    uint64_t *i = life.Find( addr );
     bool rv = true;
 
-    if( i == life.end( ) )
+    if( i == NULL )
     {
           /* Generate a random number using the specified distribution */
-          life.insert( std::pair<uint64_t, uint64_t>( addr, enduranceDist->GetEndurance( ) ) );
+          life[addr] = enduranceDist->GetEndurance( );
     }
     else
     {
         /* If the life is 0, leave it at that.  */
-        if( i->second != 0 )
+        if( *i != 0 )
         {
-            i->second = i->second - 1;
+            *i = *i - 1;
         }
         else
         {
@@ -121,10 +122,10 @@ bool EnduranceModel::DecrementLife( uint64_t addr )
 
 bool EnduranceModel::IsDead( uint64_t addr )
 {
-    std::map<uint64_t, uint64_t>::iterator i = life.find( addr );
+    uint64_t *i = life.Find( addr );
     bool rv = false;
 
-    if( i != life.end( ) && i->second == 0 )
+    if( i != NULL && *i == 0 )
     {
         rv = true;
     }
@@ -144,6 +145,56 @@ uint64_t EnduranceModel::GetGranularity( )
 }
 
 
+/*
+ *  Cells never written are not in the life map, so nothing is written for
+ *  a model that has not seen any writes, and a missing file restores to
+ *  that state.
+ */
+void EnduranceModel::WriteCheckpoint( std::string file )
+{
+    if( life.empty( ) )
+        return;
+
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+    {
+        std::cout << "EnduranceModel: Warning: Could not open checkpoint file: " 
+                  << file << "!" << std::endl;
+        return;
+    }
+
+    cpt_handle.write( (const char *)&granularity, sizeof(granularity) );
+    life.WriteCheckpoint( cpt_handle );
+
+    cpt_handle.close( );
+}
+
+void EnduranceModel::ReadCheckpoint( std::string file )
+{
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+        return;
+
+    uint64_t cpt_granularity = 0;
+
+    cpt_handle.read( (char *)&cpt_granularity, sizeof(cpt_granularity) );
+
+    if( cpt_granularity != granularity || !life.ReadCheckpoint( cpt_handle ) )
+    {
+        std::cout << "EnduranceModel: Warning: Checkpoint " << file 
+                  << " does not match this endurance model. Skipping restore." << std::endl;
+        life.clear( );
+    }
+
+    cpt_handle.close( );
+}
+
 void EnduranceModel::Cycle( ncycle_t )
 {
 }
@@ -43,6 +43,7 @@
 #include "src/EnduranceDistribution.h"
 #include "include/NVMDataBlock.h"
 #include "include/NVMAddress.h"
+#include "include/SparseStore.h"
 #include "src/FaultModel.h"
 
 namespace NVM {
@@ -67,11 +68,15 @@ class EnduranceModel : public NVMObject
 
     virtual void PrintStats( ) { }
 
+    /* Save or restore the remaining life of each cell, in the given file. */
+    virtual void WriteCheckpoint( std::string file );
+    virtual void ReadCheckpoint( std::string file );
+
     void Cycle( ncycle_t steps );
 
   protected:
     EnduranceDistribution *enduranceDist;
-    std::map<uint64_t, uint64_t> life;
+    SparseTable<uint64_t> life;
     
     bool DecrementLife( uint64_t addr );
     bool IsDead( uint64_t addr );
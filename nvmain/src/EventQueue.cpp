@@ -34,8 +34,11 @@
 #include "src/EventQueue.h"
 #include "src/NVMObject.h"
 #include "src/Config.h"
+#include "src/ParallelChannels.h"
 #include "NVM/nvmain.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <assert.h>
 
@@ -63,7 +66,14 @@ void Event::SetRecipient( NVMObject *r )
 
 EventQueue::EventQueue( )
 {
-    eventMap.clear( );
+    for( ncycle_t word = 0; word < wheelSize / 64; word++ )
+        wheelOccupied[word] = 0;
+
+    wheelBase = 0;
+    wheelEvents = 0;
+    freeEvents = NULL;
+    schedule = NULL;
+
     lastEventCycle = 0;
     nextEventCycle = std::numeric_limits<ncycle_t>::max();
     currentCycle = 0;
@@ -71,6 +81,45 @@ EventQueue::EventQueue( )
 
 EventQueue::~EventQueue( )
 {
+    /* Events still queued belong to the slabs, so this frees them as well. */
+    std::vector<Event *>::iterator it;
+    for( it = eventSlabs.begin( ); it != eventSlabs.end( ); it++ )
+        delete [] (*it);
+}
+
+Event *EventQueue::CreateEvent( )
+{
+    if( freeEvents == NULL )
+    {
+        Event *slab = new Event[slabSize];
+
+        for( ncounter_t i = 0; i < slabSize; i++ )
+        {
+            slab[i].next = freeEvents;
+            freeEvents = &slab[i];
+        }
+
+        eventSlabs.push_back( slab );
+    }
+
+    Event *event = freeEvents;
+    freeEvents = event->next;
+
+    *event = Event( );
+
+    return event;
+}
+
+void EventQueue::ReleaseEvent( Event *event )
+{
+    event->prev = NULL;
+    event->next = freeEvents;
+    freeEvents = event;
+}
+
+void EventQueue::RecordSchedule( EventSchedule *sched )
+{
+    schedule = sched;
 }
 
 void EventQueue::InsertEvent( EventType type, NVMObject *recipient, ncycle_t when, void *data, int priority )
@@ -123,7 +172,7 @@ void EventQueue::InsertEvent( EventType type, NVMObject *recipient, NVMainReques
 void EventQueue::InsertEvent( EventType type, NVMObject_hook *recipient, NVMainRequest *req, ncycle_t when, void *data, int priority )
 {
     /* Create our event */
-    Event *event = new Event( );
+    Event *event = CreateEvent( );
 
     event->SetType( type );
     event->SetRecipient( recipient );
@@ -138,51 +187,32 @@ void EventQueue::InsertEvent( Event *event, ncycle_t when, int priority )
 {
     event->SetCycle( when );
 
-    /* If this event time is before our previous nextEventCycle, change it. */
-    if( when < nextEventCycle )
+    if( schedule != NULL )
+        schedule->push_back( std::make_pair( currentCycle, when ) );
+
+    /*
+     *  With nothing on the wheel it can jump straight to the current cycle
+     *  rather than sending everything to the overflow map after a long idle.
+     */
+    if( wheelEvents == 0 && currentCycle > wheelBase && !InWheel( when ) )
     {
-        nextEventCycle = when;
+        AdvanceWheel( currentCycle );
     }
 
-    /* If there are no events at this time, create a new mapping. */ 
-    if( eventMap.count( when ) == 0 )
+    /* If this event time is before our previous nextEventCycle, change it. */
+    if( when < nextEventCycle )
     {
-        EventList eventList;
-
-        eventList.push_back( event );
-
-        eventMap.insert( std::pair<ncycle_t, EventList>( when, eventList ) );
+        nextEventCycle = when;
     }
-    /* Otherwise append this event to the event list for this cycle. */
-    else
-    {
-        EventList& eventList = eventMap[when];
-
-        EventList::iterator it;
-        bool inserted = false;
-
-        for( it = eventList.begin(); it != eventList.end(); it++ )
-        {
-            if( (*it)->GetPriority( ) > priority )
-            {
-                eventList.insert( it, event );
-                inserted = true;
-                break;
-            }
-        }
 
-        if( !inserted )
-        {
-            eventList.push_back( event );
-        }
-    }
+    LinkEvent( event, when, priority );
 }
 
 
 void EventQueue::InsertCallback( NVMObject *recipient, CallbackPtr method,
                                  ncycle_t when, void *data, int priority )
 {
-    Event *event = new Event( );
+    Event *event = CreateEvent( );
 
     event->SetType( EventCallback );
     event->SetRecipient( recipient );
@@ -197,44 +227,26 @@ void EventQueue::InsertCallback( NVMObject *recipient, CallbackPtr method,
 
 bool EventQueue::RemoveEvent( Event *event, ncycle_t when )
 {
-    bool rv = false;
+    const EventBucket *bucket = FindBucket( when );
+
+    if( bucket == NULL )
+        return false;
 
-    if( eventMap.count( when ) == 0 )
+    Event *it;
+    for( it = bucket->head; it != NULL; it = it->next )
     {
-        rv = false;
+        if( it == event )
+            break;
     }
-    else
-    {
-        EventList& eventList = eventMap[when];
-
-        EventList::iterator it;
-        for( it = eventList.begin(); it != eventList.end(); it++ )
-        {
-            if( (*it) == event )
-            {
-                eventList.erase( it );
 
-                rv = true;
+    if( it == NULL )
+        return false;
 
-                /* If the list is empty now, we can also erase the map entry. */
-                if( eventList.empty() )
-                    eventMap.erase( when );
+    UnlinkEvent( event, when );
 
-                break;
-            }
-        }
+    nextEventCycle = FirstEvent( );
 
-        if( eventMap.empty() )
-        {
-            nextEventCycle = std::numeric_limits<uint64_t>::max( );
-        }
-        else
-        {
-            nextEventCycle = eventMap.begin()->first;
-        }
-    }
-
-    return rv;
+    return true;
 }
 
 
@@ -263,43 +275,41 @@ Event *EventQueue::FindEvent( EventType type, NVMObject *recipient, NVMainReques
 Event *EventQueue::FindEvent( EventType type, NVMObject_hook *recipient, NVMainRequest *req, ncycle_t when ) const
 {
     Event *rv = NULL;
+    const EventBucket *bucket = FindBucket( when );
 
-    if (eventMap.count(when) == 0) {
-        return rv;
-    } else {
-        const EventList& eventList = eventMap.find(when)->second;
-
-        EventList::const_iterator it;
-        for( it = eventList.begin(); it != eventList.end(); it++ )
+    if( bucket != NULL )
+    {
+        Event *it;
+        for( it = bucket->head; it != NULL; it = it->next )
         {
-            if( (*it)->GetType( ) == type && (*it)->GetRecipient( ) == recipient
-                && (*it)->GetRequest( ) == req )
+            if( it->GetType( ) == type && it->GetRecipient( ) == recipient
+                && it->GetRequest( ) == req )
             {
-                rv = (*it);
+                rv = it;
             }
         }
-        return rv;
     }
+
+    return rv;
 }
 
 
 Event *EventQueue::FindCallback( NVMObject *recipient, CallbackPtr method, ncycle_t when, void *data, int priority ) const
 {
     Event *rv = NULL;
+    const EventBucket *bucket = FindBucket( when );
 
-    if( eventMap.count(when) != 0 )
+    if( bucket != NULL )
     {
-        const EventList& eventList = eventMap.find(when)->second;
-
-        EventList::const_iterator it;
-        for( it = eventList.begin(); it != eventList.end(); it++ )
+        Event *it;
+        for( it = bucket->head; it != NULL; it = it->next )
         {
-            if( (*it)->GetRecipient()->GetTrampoline() == recipient
-                && (*it)->GetCallback() == method
-                && (*it)->GetData() == data 
-                && (*it)->GetPriority() == priority )
+            if( it->GetRecipient()->GetTrampoline() == recipient
+                && it->GetCallback() == method
+                && it->GetData() == data 
+                && it->GetPriority() == priority )
             {
-                rv = (*it);
+                rv = it;
                 break;
             }
         }
@@ -358,17 +368,28 @@ void EventQueue::Loop( ncycle_t steps )
 void EventQueue::Process( )
 {
     /* Process all the events at the next cycle, and figure out the next next cycle. */
-    assert( eventMap.count( nextEventCycle ) );
+    ncycle_t when = nextEventCycle;
+
+    if( when > wheelBase )
+        AdvanceWheel( when );
 
-    EventList& eventList = eventMap[nextEventCycle];
-    EventList::iterator it;
+    /* 
+     *  Take events from the head of the bucket one at a time, so that events
+     *  inserted for this cycle by the handlers below are processed as well.
+     */
+    const EventBucket *bucket = FindBucket( when );
+    assert( bucket != NULL );
 
-    for( it = eventList.begin( ); it != eventList.end( ); it++ )
+    while( bucket != NULL && bucket->head != NULL )
     {
-        switch( (*it)->GetType( ) )
+        Event *event = bucket->head;
+
+        UnlinkEvent( event, when );
+
+        switch( event->GetType( ) )
         {
             case EventCycle:
-                (*it)->GetRecipient( )->Cycle( nextEventCycle - lastEventCycle );
+                event->GetRecipient( )->Cycle( when - lastEventCycle );
                 break;
 
             case EventIdle:
@@ -380,14 +401,14 @@ void EventQueue::Process( )
                 break;
 
             case EventResponse:
-                (*it)->GetRecipient( )->RequestComplete( (*it)->GetRequest( ) );
+                event->GetRecipient( )->RequestComplete( event->GetRequest( ) );
                 break;
 
             case EventCallback:
             {
-                CallbackPtr cb = (*it)->GetCallback( );
-                NVMObject *thisPtr = (*it)->GetRecipient( )->GetTrampoline( );
-                (*thisPtr.*cb)( (*it)->GetData() );
+                CallbackPtr cb = event->GetCallback( );
+                NVMObject *thisPtr = event->GetRecipient( )->GetTrampoline( );
+                (*thisPtr.*cb)( event->GetData() );
                 break;
             }
 
@@ -398,25 +419,181 @@ void EventQueue::Process( )
         }
 
         /* Free event data */
-        delete (*it);
-    }
+        ReleaseEvent( event );
 
-    eventMap.erase( nextEventCycle );
+        /* Overflow buckets are erased once empty, so look it up again. */
+        bucket = FindBucket( when );
+    }
 
     /* Figure out the next cycle. */
-    if( eventMap.empty( ) )
+    lastEventCycle = when;
+    nextEventCycle = FirstEvent( );
+}
+
+const EventQueue::EventBucket *EventQueue::FindBucket( ncycle_t when ) const
+{
+    if( InWheel( when ) )
+    {
+        const EventBucket *bucket = &wheel[when & (wheelSize - 1)];
+
+        return (bucket->head != NULL) ? bucket : NULL;
+    }
+
+    std::map<ncycle_t, EventBucket>::const_iterator it = overflow.find( when );
+
+    return (it != overflow.end( )) ? &(it->second) : NULL;
+}
+
+void EventQueue::LinkEvent( Event *event, ncycle_t when, int priority )
+{
+    EventBucket *bucket;
+
+    if( InWheel( when ) )
+    {
+        ncycle_t slot = when & (wheelSize - 1);
+
+        bucket = &wheel[slot];
+        wheelOccupied[slot / 64] |= (1ULL << (slot % 64));
+        wheelEvents++;
+    }
+    else
+    {
+        bucket = &overflow[when];
+    }
+
+    /* Events go before the first event with a greater priority. */
+    Event *it;
+    for( it = bucket->head; it != NULL; it = it->next )
+    {
+        if( it->GetPriority( ) > priority )
+            break;
+    }
+
+    event->next = it;
+    event->prev = (it != NULL) ? it->prev : bucket->tail;
+
+    if( event->prev != NULL )
+        event->prev->next = event;
+    else
+        bucket->head = event;
+
+    if( it != NULL )
+        it->prev = event;
+    else
+        bucket->tail = event;
+}
+
+void EventQueue::UnlinkEvent( Event *event, ncycle_t when )
+{
+    bool wheelBucket = InWheel( when );
+    EventBucket *bucket;
+    std::map<ncycle_t, EventBucket>::iterator overflowIt;
+
+    if( wheelBucket )
     {
-        lastEventCycle = nextEventCycle;
-        nextEventCycle = std::numeric_limits<ncycle_t>::max();
+        bucket = &wheel[when & (wheelSize - 1)];
     }
     else
     {
-        lastEventCycle = nextEventCycle;
-        /* map is sorted by keys, so this works out. */
-        nextEventCycle = eventMap.begin()->first; 
+        overflowIt = overflow.find( when );
+        assert( overflowIt != overflow.end( ) );
+        bucket = &(overflowIt->second);
+    }
+
+    if( event->prev != NULL )
+        event->prev->next = event->next;
+    else
+        bucket->head = event->next;
+
+    if( event->next != NULL )
+        event->next->prev = event->prev;
+    else
+        bucket->tail = event->prev;
+
+    event->next = event->prev = NULL;
+
+    if( wheelBucket )
+    {
+        ncycle_t slot = when & (wheelSize - 1);
+
+        wheelEvents--;
+        if( bucket->head == NULL )
+            wheelOccupied[slot / 64] &= ~(1ULL << (slot % 64));
+    }
+    else if( bucket->head == NULL )
+    {
+        overflow.erase( overflowIt );
     }
 }
 
+/*
+ *  Moves the start of the wheel forward to base. There must be no events on
+ *  the wheel before base, so the buckets now covering [old end, base + size)
+ *  are empty and overflow buckets in that range can be moved in whole.
+ */
+void EventQueue::AdvanceWheel( ncycle_t base )
+{
+    assert( base >= wheelBase );
+
+    wheelBase = base;
+
+    std::map<ncycle_t, EventBucket>::iterator it = overflow.lower_bound( base );
+
+    while( it != overflow.end( ) && InWheel( it->first ) )
+    {
+        ncycle_t slot = it->first & (wheelSize - 1);
+
+        assert( wheel[slot].head == NULL );
+        wheel[slot] = it->second;
+        wheelOccupied[slot / 64] |= (1ULL << (slot % 64));
+
+        for( Event *event = it->second.head; event != NULL; event = event->next )
+            wheelEvents++;
+
+        overflow.erase( it++ );
+    }
+}
+
+/* Returns the first cycle at or after from with an event on the wheel. */
+ncycle_t EventQueue::NextWheelEvent( ncycle_t from ) const
+{
+    ncycle_t end = wheelBase + wheelSize;
+
+    if( wheelEvents == 0 )
+        return std::numeric_limits<ncycle_t>::max( );
+
+    if( from < wheelBase )
+        from = wheelBase;
+
+    while( from < end )
+    {
+        ncycle_t slot = from & (wheelSize - 1);
+        uint64_t bits = wheelOccupied[slot / 64] >> (slot % 64);
+
+        if( bits != 0 )
+        {
+            ncycle_t found = from + __builtin_ctzll( bits );
+
+            return (found < end) ? found : std::numeric_limits<ncycle_t>::max( );
+        }
+
+        from += 64 - (slot % 64);
+    }
+
+    return std::numeric_limits<ncycle_t>::max( );
+}
+
+ncycle_t EventQueue::FirstEvent( ) const
+{
+    ncycle_t first = NextWheelEvent( wheelBase );
+
+    /* The overflow map may hold events before the wheel as well as after. */
+    if( !overflow.empty( ) && overflow.begin( )->first < first )
+        first = overflow.begin( )->first;
+
+    return first;
+}
+
 void EventQueue::SetFrequency( double freq )
 {
     frequency = freq;
@@ -446,6 +623,9 @@ void EventQueue::SetCurrentCycle( ncycle_t curCycle )
 GlobalEventQueue::GlobalEventQueue( )
 {
     currentCycle = 0;
+    channelGroup = NULL;
+    channelFrequency = 0.0;
+    channelMultiplier = 1.0;
 }
 
 GlobalEventQueue::~GlobalEventQueue( )
@@ -465,7 +645,13 @@ void GlobalEventQueue::AddSystem( NVMain *subSystem, Config *config )
      *  We aren't doing and checks here to make sure the input side (i.e. CPUFreq) is
      *  corrent since we don't know what it should be.
      */
-    eventQueues.insert( std::pair<EventQueue*, double>(queue, subSystemFrequency) );
+    SubSystemQueue subSystemQueue;
+
+    subSystemQueue.queue = queue;
+    subSystemQueue.frequency = subSystemFrequency;
+    subSystemQueue.multiplier = frequency / subSystemFrequency;
+
+    eventQueues.push_back( subSystemQueue );
     queue->SetFrequency( subSystemFrequency );
 
     std::cout << "NVMain: GlobalEventQueue: Added a memory subsystem running at "
@@ -473,6 +659,19 @@ void GlobalEventQueue::AddSystem( NVMain *subSystem, Config *config )
               << (frequency / 1000000.0) << "MHz." << std::endl;
 }
 
+/*
+ *  Channels with their own event queues, run together on worker threads.
+ *  Only one memory system may register its channels.
+ */
+void GlobalEventQueue::AddChannels( ParallelChannels *channels, double frequency )
+{
+    assert( channelGroup == NULL );
+
+    channelGroup = channels;
+    channelFrequency = frequency;
+    channelMultiplier = this->frequency / frequency;
+}
+
 void GlobalEventQueue::Cycle( ncycle_t steps )
 {
     EventQueue *nextEventQueue;
@@ -496,6 +695,18 @@ void GlobalEventQueue::Cycle( ncycle_t steps )
             break;
         }
 
+        /* The parallel channels are next, run a whole window of them. */
+        if( nextEventQueue == NULL )
+        {
+            ncycle_t windowSteps = RunChannels( steps - iterationSteps );
+
+            currentCycle += windowSteps;
+            iterationSteps += windowSteps;
+
+            Sync( );
+            continue;
+        }
+
         ncycle_t localQueueSteps = nextEventQueue->GetNextEvent( ) - nextEventQueue->GetCurrentCycle( );
         nextEventQueue->Loop( localQueueSteps );
 
@@ -510,6 +721,15 @@ void GlobalEventQueue::Cycle( ncycle_t steps )
 void GlobalEventQueue::SetFrequency( double freq )
 {
     frequency = freq;
+
+    std::vector<SubSystemQueue>::iterator iter;
+    for( iter = eventQueues.begin( ); iter != eventQueues.end( ); iter++ )
+    {
+        iter->multiplier = frequency / iter->frequency;
+    }
+
+    if( channelGroup != NULL )
+        channelMultiplier = frequency / channelFrequency;
 }
 
 double GlobalEventQueue::GetFrequency( )
@@ -519,7 +739,35 @@ double GlobalEventQueue::GetFrequency( )
 
 ncycle_t GlobalEventQueue::GetNextEvent( EventQueue **eq )
 {
-    std::map<EventQueue *, double>::const_iterator iter;
+    ncycle_t nextEventCycle = GetNextSerialEvent( eq );
+
+    /* 
+     *  The parallel channels are reported with a NULL queue. On a tie the
+     *  serial queues go first, as the channels catch up in Sync( ) anyway.
+     */
+    if( channelGroup != NULL )
+    {
+        ncycle_t channelEventCycle = channelGroup->GetNextEvent( );
+
+        if( channelEventCycle != std::numeric_limits<ncycle_t>::max( ) )
+        {
+            double globalEventCycle = channelEventCycle * channelMultiplier;
+
+            if( static_cast<ncycle_t>(globalEventCycle) < nextEventCycle )
+            {
+                nextEventCycle = static_cast<ncycle_t>(globalEventCycle);
+                if( eq != NULL )
+                    *eq = NULL;
+            }
+        }
+    }
+
+    return nextEventCycle;
+}
+
+ncycle_t GlobalEventQueue::GetNextSerialEvent( EventQueue **eq )
+{
+    std::vector<SubSystemQueue>::const_iterator iter;
     ncycle_t nextEventCycle = std::numeric_limits<ncycle_t>::max( );
 
     if( eq != NULL )
@@ -527,21 +775,22 @@ ncycle_t GlobalEventQueue::GetNextEvent( EventQueue **eq )
 
     for( iter = eventQueues.begin( ); iter != eventQueues.end( ); iter++ )
     {
+        ncycle_t queueEventCycle = iter->queue->GetNextEvent( );
+
         /* 
          *  If there is no event, we must skip frequency alignment to prevent
          *  underflow causing an invalid nextEventCycle.
          */
-        if( iter->first->GetNextEvent( ) == std::numeric_limits<ncycle_t>::max( ) )
+        if( queueEventCycle == std::numeric_limits<ncycle_t>::max( ) )
             continue;
 
-        double frequencyMultiplier = frequency / iter->second;
-        double globalEventCycle = iter->first->GetNextEvent( ) * frequencyMultiplier;
+        double globalEventCycle = queueEventCycle * iter->multiplier;
 
         if( static_cast<ncycle_t>(globalEventCycle) < nextEventCycle )
         {
             nextEventCycle = static_cast<ncycle_t>(globalEventCycle);
             if( eq != NULL )
-                *eq = iter->first;
+                *eq = iter->queue;
         }
     }
 
@@ -553,20 +802,64 @@ ncycle_t GlobalEventQueue::GetCurrentCycle( )
     return currentCycle;
 }
 
+/*
+ *  Run the parallel channels from their next event through the lookahead,
+ *  stopping before the next event of any other queue and at the end of
+ *  this step. Returns the global cycles covered.
+ */
+ncycle_t GlobalEventQueue::RunChannels( ncycle_t steps )
+{
+    ncycle_t firstEvent = channelGroup->GetNextEvent( );
+    ncycle_t windowEnd = firstEvent + channelGroup->GetLookahead( ) - 1;
+    ncycle_t lastCycle = static_cast<ncycle_t>(
+            static_cast<double>(currentCycle + steps) / channelMultiplier );
+    ncycle_t serialEvent = GetNextSerialEvent( NULL );
+
+    windowEnd = std::min( windowEnd, lastCycle );
+
+    if( serialEvent != std::numeric_limits<ncycle_t>::max( ) )
+    {
+        ncycle_t serialCycle = static_cast<ncycle_t>(
+                std::ceil( static_cast<double>(serialEvent) / channelMultiplier ) );
+
+        if( serialCycle > 0 )
+            windowEnd = std::min( windowEnd, serialCycle - 1 );
+    }
+
+    windowEnd = std::max( windowEnd, firstEvent );
+
+    channelGroup->Run( windowEnd );
+
+    ncycle_t endCycle = static_cast<ncycle_t>(windowEnd * channelMultiplier);
+
+    endCycle = std::max( endCycle, currentCycle );
+    endCycle = std::min( endCycle, currentCycle + steps );
+
+    return endCycle - currentCycle;
+}
+
 void GlobalEventQueue::Sync( )
 {
-    std::map<EventQueue *, double>::const_iterator iter;
+    std::vector<SubSystemQueue>::const_iterator iter;
     for( iter = eventQueues.begin( ); iter != eventQueues.end( ); iter++ )
     {
-        double frequencyMultiplier = frequency / iter->second;
-        double setCycle = static_cast<double>(currentCycle) / frequencyMultiplier;
-        ncycle_t stepCount = static_cast<ncycle_t>(setCycle) - iter->first->GetCurrentCycle( );
+        double setCycle = static_cast<double>(currentCycle) / iter->multiplier;
+        ncycle_t stepCount = static_cast<ncycle_t>(setCycle) - iter->queue->GetCurrentCycle( );
 
-        if( static_cast<ncycle_t>(setCycle) > iter->first->GetCurrentCycle( ) )
+        if( static_cast<ncycle_t>(setCycle) > iter->queue->GetCurrentCycle( ) )
         {
-            iter->first->Loop( stepCount );
+            iter->queue->Loop( stepCount );
         }
     }
-}
 
+    if( channelGroup != NULL )
+    {
+        double setCycle = static_cast<double>(currentCycle) / channelMultiplier;
+
+        if( static_cast<ncycle_t>(setCycle) > channelGroup->GetCurrentCycle( ) )
+            channelGroup->Run( static_cast<ncycle_t>(setCycle) );
 
+        /* Hand requests the channels completed to their owner. */
+        channelGroup->Flush( );
+    }
+}
@@ -36,6 +36,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 #include "include/NVMTypes.h"
 #include "include/NVMainRequest.h"
 
@@ -45,9 +46,12 @@ class Event;
 class NVMObject_hook;
 class Config;
 class NVMain;
+class ParallelChannels;
 
 typedef std::list<Event *> EventList;
 typedef void (NVMObject::*CallbackPtr)(void*);
+/* (cycle scheduled at, cycle scheduled for) of each inserted event. */
+typedef std::vector<std::pair<ncycle_t, ncycle_t> > EventSchedule;
 
 enum EventType { EventUnknown,
                  EventCycle,
@@ -60,7 +64,8 @@ enum EventType { EventUnknown,
 class Event
 {
   public:
-    Event() : type(EventUnknown), recipient(NULL), request(NULL), data(NULL), cycle(0), priority(0) {}
+    Event() : type(EventUnknown), recipient(NULL), request(NULL), data(NULL), cycle(0), priority(0),
+              method(NULL), next(NULL), prev(NULL) {}
     ~Event() {}
 
     void SetType( EventType e ) { type = e; }
@@ -88,9 +93,23 @@ class Event
     ncycle_t cycle;
     int priority;
     CallbackPtr method;
+
+    /* Links within the event queue bucket or free list holding this event. */
+    friend class EventQueue;
+    Event *next;
+    Event *prev;
 };
 
 
+
+/*
+ *  Events are kept in a calendar queue: a wheel of wheelSize buckets holds
+ *  the events of the next wheelSize cycles, one cycle per bucket, and events
+ *  further out (or in the past) wait in an overflow map until the wheel
+ *  reaches them. Each bucket is an intrusive list ordered by priority, and
+ *  Event objects are recycled through a free list, so scheduling an event
+ *  normally allocates nothing.
+ */
 class EventQueue
 {
   public:
@@ -112,6 +131,12 @@ class EventQueue
 
     bool RemoveEvent( Event *event, ncycle_t when );
 
+    /* Events passed to InsertEvent( Event * ) should come from here. */
+    Event *CreateEvent( );
+    void ReleaseEvent( Event *event );
+
+    void RecordSchedule( EventSchedule *schedule );
+
     void Process( );
     void Loop( );
     void Loop( ncycle_t steps );
@@ -129,7 +154,39 @@ class EventQueue
     ncycle_t currentCycle; 
     double frequency;
 
-    std::map< ncycle_t, EventList> eventMap; 
+    struct EventBucket
+    {
+        EventBucket( ) : head(NULL), tail(NULL) {}
+
+        Event *head;
+        Event *tail;
+    };
+
+    static const ncycle_t wheelSize = 2048;
+    static const ncounter_t slabSize = 256;
+
+    EventBucket wheel[wheelSize];
+    uint64_t wheelOccupied[wheelSize / 64];
+    ncycle_t wheelBase;
+    ncounter_t wheelEvents;
+    std::map<ncycle_t, EventBucket> overflow;
+
+    Event *freeEvents;
+    std::vector<Event *> eventSlabs;
+
+    EventSchedule *schedule;
+
+    bool InWheel( ncycle_t when ) const
+    {
+        return (when >= wheelBase && when - wheelBase < wheelSize);
+    }
+
+    const EventBucket *FindBucket( ncycle_t when ) const;
+    void LinkEvent( Event *event, ncycle_t when, int priority );
+    void UnlinkEvent( Event *event, ncycle_t when );
+    void AdvanceWheel( ncycle_t base );
+    ncycle_t NextWheelEvent( ncycle_t from ) const;
+    ncycle_t FirstEvent( ) const;
 };
 
 
@@ -140,6 +197,7 @@ class GlobalEventQueue
     ~GlobalEventQueue();
 
     void AddSystem( NVMain *subSystem, Config *config );
+    void AddChannels( ParallelChannels *channels, double channelFrequency );
     void Cycle( ncycle_t steps );
 
     void SetFrequency( double freq );
@@ -152,8 +210,22 @@ class GlobalEventQueue
     ncycle_t currentCycle;
     double frequency;
 
-    std::map<EventQueue *, double> eventQueues;
+    struct SubSystemQueue
+    {
+        EventQueue *queue;
+        double frequency;
+        double multiplier;  /* Global cycles per subsystem cycle. */
+    };
+
+    std::vector<SubSystemQueue> eventQueues;
+
+    /* Channels run on worker threads, NULL if there are none. */
+    ParallelChannels *channelGroup;
+    double channelFrequency;
+    double channelMultiplier;
 
+    ncycle_t GetNextSerialEvent( EventQueue **eq );
+    ncycle_t RunChannels( ncycle_t steps );
     void Sync( );
 
 };
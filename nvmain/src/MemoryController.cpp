@@ -212,16 +212,10 @@ bool MemoryController::TransactionAvailable( ncounter_t queueId )
 
     for( ncounter_t queueIdx = 0; queueIdx < transactionQueueCount; queueIdx++ )
     {
-        std::list<NVMainRequest *>::iterator it;
-
-        for( it = transactionQueues[queueIdx].begin( );
-             it != transactionQueues[queueIdx].end( ); it++ )
+        if( transactionQueues[queueIdx].HasCommandQueue( queueId ) )
         {
-            if( GetCommandQueueId( (*it)->address ) == queueId )
-            {
-                rv = true;
-                break;
-            }
+            rv = true;
+            break;
         }
     }
 
@@ -445,6 +439,9 @@ void MemoryController::SetConfig( Config *conf, bool createChildren )
     std::cout << "Creating " << commandQueueCount << " command queues." << std::endl;
     
     commandQueues = new std::deque<NVMainRequest *> [commandQueueCount];
+
+    for( ncounter_t queueIdx = 0; queueIdx < transactionQueueCount; queueIdx++ )
+        transactionQueues[queueIdx].Init( this, p->RANKS, p->BANKS, commandQueueCount );
     activateQueued = new bool * [p->RANKS];
     refreshQueued = new bool * [p->RANKS];
     starvationCounter = new ncounter_t ** [p->RANKS];
@@ -1062,7 +1059,7 @@ NVMainRequest *MemoryController::MakePowerupRequest( const ncounter_t rank )
     return powerupRequest;
 }
 
-bool MemoryController::IsLastRequest( std::list<NVMainRequest *>& transactionQueue,
+bool MemoryController::IsLastRequest( NVMTransactionQueue& transactionQueue,
                                       NVMainRequest *request )
 {
     bool rv = true;
@@ -1075,27 +1072,39 @@ bool MemoryController::IsLastRequest( std::list<NVMainRequest *>& transactionQue
     {
         ncounter_t mRank, mBank, mRow, mSubArray;
         request->address.GetTranslatedAddress( &mRow, NULL, &mBank, &mRank, NULL, &mSubArray );
-        std::list<NVMainRequest *>::iterator it;
-
-        for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
-        {
-            ncounter_t rank, bank, row, subarray;
-
-            (*it)->address.GetTranslatedAddress( &row, NULL, &bank, &rank, NULL, &subarray );
 
-            /* if a request that has row buffer hit is found, return false */ 
-            if( rank == mRank && bank == mBank && row == mRow && subarray == mSubArray )
-            {
-                rv = false;
-                break;
-            }
-        }
+        /* if a request that has row buffer hit is found, return false */ 
+        if( transactionQueue.FindRow( mRank, mBank, mSubArray, mRow ) != NULL )
+            rv = false;
     }
 
     return rv;
 }
 
-bool MemoryController::FindStarvedRequest( std::list<NVMainRequest *>& transactionQueue, 
+/*
+ *  Removes a scheduled request from the transaction queue and marks whether
+ *  it is the last one queued for its row.
+ */
+NVMainRequest *MemoryController::TakeRequest( NVMTransactionQueue& transactionQueue, 
+                                              TransactionQueue::Entry *entry )
+{
+    NVMainRequest *request = transactionQueue.Erase( entry );
+
+    /* Different row buffer management policy has different behavior */ 
+
+    /* 
+     * if Relaxed Close-Page row buffer management policy is applied,
+     * we check whether there is another request has row buffer hit.
+     * if not, this request is the last request and we can close the
+     * row.
+     */
+    if( IsLastRequest( transactionQueue, request ) )
+        request->flags |= NVMainRequest::FLAG_LAST_REQUEST;
+
+    return request;
+}
+
+bool MemoryController::FindStarvedRequest( NVMTransactionQueue& transactionQueue, 
                                            NVMainRequest **starvedRequest )
 {
     DummyPredicate pred;
@@ -1103,65 +1112,65 @@ bool MemoryController::FindStarvedRequest( std::list<NVMainRequest *>& transacti
     return FindStarvedRequest( transactionQueue, starvedRequest, pred );
 }
 
-bool MemoryController::FindStarvedRequest( std::list<NVMainRequest *>& transactionQueue, 
+/*
+ *  The searches below return the first request in queue order that can be
+ *  scheduled. Banks that can not take the request are skipped as a whole,
+ *  and a bank is only searched while its requests are older than the best
+ *  candidate found so far.
+ */
+bool MemoryController::FindStarvedRequest( NVMTransactionQueue& transactionQueue, 
                                            NVMainRequest **starvedRequest, 
                                            SchedulingPredicate& pred )
 {
-    bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::BankQueue *bankQueue;
+    TransactionQueue::Entry *found = NULL;
+    ncycle_t currentCycle = GetEventQueue()->GetCurrentCycle();
 
     *starvedRequest = NULL;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( bankQueue = transactionQueue.FirstBank( ); bankQueue != NULL;
+         bankQueue = bankQueue->nextActive )
     {
-        ncounter_t rank, bank, row, subarray, col;
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
+        TransactionQueue::Entry *it = bankQueue->head;
+        ncounter_t rank = it->rank, bank = it->bank;
 
-        if( !commandQueues[queueId].empty() ) continue;
-
-        (*it)->address.GetTranslatedAddress( &row, &col, &bank, &rank, NULL, &subarray );
-        
-        /* By design, mux level can only be a subset of the selected columns. */
-        ncounter_t muxLevel = static_cast<ncounter_t>(col / p->RBSize);
+        if( !activateQueued[rank][bank]
+            || bankNeedRefresh[rank][bank]                      /* The bank is not waiting for a refresh */
+            || refreshQueued[rank][bank] )                      /* Don't interrupt refreshes queued on bank group head. */
+            continue;
 
-        if( activateQueued[rank][bank] 
-            && ( !activeSubArray[rank][bank][subarray]          /* The subarray is inactive */
-                || effectiveRow[rank][bank][subarray] != row    /* Row buffer miss */
-                || effectiveMuxedRow[rank][bank][subarray] != muxLevel )  /* Subset of row buffer is not at the sense amps */
-            && !bankNeedRefresh[rank][bank]                     /* The bank is not waiting for a refresh */
-            && !refreshQueued[rank][bank]                       /* Don't interrupt refreshes queued on bank group head. */
-            && starvationCounter[rank][bank][subarray] 
-                >= starvationThreshold                          /* This subarray has reached starvation threshold */
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && commandQueues[queueId].empty()                   /* The request queue is empty */
-            && pred( (*it) ) )                                  /* User-defined predicate is true */
+        for( ; it != NULL && (found == NULL || it->order < found->order); it = it->bankNext )
         {
-            *starvedRequest = (*it);
-            transactionQueue.erase( it );
-
-            /* Different row buffer management policy has different behavior */ 
+            ncounter_t subarray = it->subarray;
 
-            /* 
-             * if Relaxed Close-Page row buffer management policy is applied,
-             * we check whether there is another request has row buffer hit.
-             * if not, this request is the last request and we can close the
-             * row.
-             */
-            if(  IsLastRequest( transactionQueue, (*starvedRequest) ) )
-                (*starvedRequest)->flags |= NVMainRequest::FLAG_LAST_REQUEST;
+            /* By design, mux level can only be a subset of the selected columns. */
+            ncounter_t muxLevel = static_cast<ncounter_t>(it->col / p->RBSize);
 
-            rv = true;
-            break;
+            if( ( !activeSubArray[rank][bank][subarray]          /* The subarray is inactive */
+                || effectiveRow[rank][bank][subarray] != it->row    /* Row buffer miss */
+                || effectiveMuxedRow[rank][bank][subarray] != muxLevel )  /* Subset of row buffer is not at the sense amps */
+                && starvationCounter[rank][bank][subarray] 
+                    >= starvationThreshold                      /* This subarray has reached starvation threshold */
+                && it->request->arrivalCycle != currentCycle
+                && commandQueues[it->queueId].empty()           /* The request queue is empty */
+                && pred( it->request ) )                        /* User-defined predicate is true */
+            {
+                found = it;
+                break;
+            }
         }
     }
 
-    return rv;
+    if( found != NULL )
+        *starvedRequest = TakeRequest( transactionQueue, found );
+
+    return (found != NULL);
 }
 
 /*
  *  Find any requests that can be serviced without going through a normal activation cycle.
  */
-bool MemoryController::FindCachedAddress( std::list<NVMainRequest *>& transactionQueue,
+bool MemoryController::FindCachedAddress( NVMTransactionQueue& transactionQueue,
                                               NVMainRequest **accessibleRequest )
 {
     DummyPredicate pred;
@@ -1172,41 +1181,48 @@ bool MemoryController::FindCachedAddress( std::list<NVMainRequest *>& transactio
 /*
  *  Find any requests that can be serviced without going through a normal activation cycle.
  */
-bool MemoryController::FindCachedAddress( std::list<NVMainRequest *>& transactionQueue,
+bool MemoryController::FindCachedAddress( NVMTransactionQueue& transactionQueue,
                                               NVMainRequest **accessibleRequest, 
                                               SchedulingPredicate& pred )
 {
-    bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::BankQueue *bankQueue;
+    TransactionQueue::Entry *found = NULL;
+    ncycle_t currentCycle = GetEventQueue()->GetCurrentCycle();
 
     *accessibleRequest = NULL;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( bankQueue = transactionQueue.FirstBank( ); bankQueue != NULL;
+         bankQueue = bankQueue->nextActive )
     {
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
-        NVMainRequest *cachedRequest = MakeCachedRequest( (*it) );
-        
-        if( commandQueues[queueId].empty() 
-            && GetChild( )->IsIssuable( cachedRequest )
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && pred( (*it ) ) )
+        TransactionQueue::Entry *it;
+
+        for( it = bankQueue->head; it != NULL && (found == NULL || it->order < found->order);
+             it = it->bankNext )
         {
-            *accessibleRequest = (*it);
-            transactionQueue.erase( it );
+            if( !commandQueues[it->queueId].empty() 
+                || it->request->arrivalCycle == currentCycle )
+                continue;
+
+            NVMainRequest *cachedRequest = MakeCachedRequest( it->request );
+            bool issuable = GetChild( )->IsIssuable( cachedRequest );
 
             delete cachedRequest;
 
-            rv = true;
-            break;
+            if( issuable && pred( it->request ) )
+            {
+                found = it;
+                break;
+            }
         }
-
-        delete cachedRequest;
     }
 
-    return rv;
+    if( found != NULL )
+        *accessibleRequest = transactionQueue.Erase( found );
+
+    return (found != NULL);
 }
 
-bool MemoryController::FindWriteStalledRead( std::list<NVMainRequest *>& transactionQueue,
+bool MemoryController::FindWriteStalledRead( NVMTransactionQueue& transactionQueue,
                                              NVMainRequest **hitRequest )
 {
     DummyPredicate pred;
@@ -1214,47 +1230,48 @@ bool MemoryController::FindWriteStalledRead( std::list<NVMainRequest *>& transac
     return FindWriteStalledRead( transactionQueue, hitRequest, pred );
 }
 
-bool MemoryController::FindWriteStalledRead( std::list<NVMainRequest *>& transactionQueue, 
+/*
+ *  Stalling the scheduler depends on the first request that could pause a
+ *  write, so this one still walks the whole queue in order.
+ */
+bool MemoryController::FindWriteStalledRead( NVMTransactionQueue& transactionQueue, 
                                              NVMainRequest **hitRequest, SchedulingPredicate& pred )
 {
     bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::Entry *it;
 
     *hitRequest = NULL;
 
     if( !p->WritePausing )
         return false;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( it = transactionQueue.Front( ); it != NULL; it = it->next )
     {
-        if( (*it)->type != READ )
+        if( it->request->type != READ )
             continue;
 
-        ncounter_t rank, bank, row, subarray, col;
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
+        ncounter_t rank = it->rank, bank = it->bank;
 
-        if( !commandQueues[queueId].empty() ) continue;
-
-        (*it)->address.GetTranslatedAddress( &row, &col, &bank, &rank, NULL, &subarray );
+        if( !commandQueues[it->queueId].empty() ) continue;
 
         /* Find the requests's SubArray destination. */
-        SubArray *writingArray = FindChild( (*it), SubArray );
+        SubArray *writingArray = FindChild( it->request, SubArray );
 
         /* Assume the memory has no subarrays if we don't find the destination. */
         if( writingArray == NULL )
             return false;
 
-        NVMainRequest *testActivate = MakeActivateRequest( (*it) );
+        NVMainRequest *testActivate = MakeActivateRequest( it->request );
         testActivate->flags |= NVMainRequest::FLAG_PRIORITY; 
 
         if( !bankNeedRefresh[rank][bank]                 /* The bank is not waiting for a refresh */
             && !refreshQueued[rank][bank]                /* Don't interrupt refreshes queued on bank group head. */
             && writingArray->IsWriting( )                /* There needs to be a write to cancel. */
-            && ( GetChild( )->IsIssuable( (*it ) )       /* Check for RB hit pause */
+            && ( GetChild( )->IsIssuable( it->request )  /* Check for RB hit pause */
             || GetChild( )->IsIssuable( testActivate ) ) /* See if we can activate to pause. */
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && commandQueues[queueId].empty()            /* The request queue is empty */
-            && pred( (*it) ) )                           /* User-defined predicate is true */
+            && it->request->arrivalCycle != GetEventQueue()->GetCurrentCycle()
+            && commandQueues[it->queueId].empty()        /* The request queue is empty */
+            && pred( it->request ) )                     /* User-defined predicate is true */
         {
             if( !writingArray->BetweenWriteIterations( ) && p->pauseMode == PauseMode_Normal )
             {
@@ -1265,21 +1282,9 @@ bool MemoryController::FindWriteStalledRead( std::list<NVMainRequest *>& transac
                 break;
             }
 
-            *hitRequest = (*it);
-            transactionQueue.erase( it );
-
             delete testActivate;
 
-            /* Different row buffer management policy has different behavior */ 
-
-            /* 
-             * if Relaxed Close-Page row buffer management policy is applied,
-             * we check whether there is another request has row buffer hit.
-             * if not, this request is the last request and we can close the
-             * row.
-             */
-            if( IsLastRequest( transactionQueue, (*hitRequest) ) )
-                (*hitRequest)->flags |= NVMainRequest::FLAG_LAST_REQUEST;
+            *hitRequest = TakeRequest( transactionQueue, it );
 
             rv = true;
 
@@ -1292,7 +1297,7 @@ bool MemoryController::FindWriteStalledRead( std::list<NVMainRequest *>& transac
     return rv;
 }
 
-bool MemoryController::FindRowBufferHit( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindRowBufferHit( NVMTransactionQueue& transactionQueue, 
                                          NVMainRequest **hitRequest )
 {
     DummyPredicate pred;
@@ -1300,60 +1305,84 @@ bool MemoryController::FindRowBufferHit( std::list<NVMainRequest *>& transaction
     return FindRowBufferHit( transactionQueue, hitRequest, pred );
 }
 
-bool MemoryController::FindRowBufferHit( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindRowBufferHit( NVMTransactionQueue& transactionQueue, 
                                          NVMainRequest **hitRequest, SchedulingPredicate& pred )
 {
-    bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::BankQueue *bankQueue;
+    TransactionQueue::Entry *found = NULL;
 
     *hitRequest = NULL;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( bankQueue = transactionQueue.FirstBank( ); bankQueue != NULL;
+         bankQueue = bankQueue->nextActive )
     {
-        ncounter_t rank, bank, row, subarray, col;
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
+        ncounter_t rank = bankQueue->head->rank, bank = bankQueue->head->bank;
 
-        if( !commandQueues[queueId].empty() ) continue;
+        if( (found != NULL && bankQueue->head->order > found->order)
+            || !activateQueued[rank][bank]                /* The bank is active */ 
+            || bankNeedRefresh[rank][bank]                /* The bank is not waiting for a refresh */
+            || refreshQueued[rank][bank] )                /* Don't interrupt refreshes queued on bank group head. */
+            continue;
 
-        (*it)->address.GetTranslatedAddress( &row, &col, &bank, &rank, NULL, &subarray );
+        /* 
+         *  Only requests to the open rows can hit. Look those up directly,
+         *  or check each queued row if there are fewer of those than
+         *  subarrays.
+         */
+        if( bankQueue->rows.size( ) < subArrayNum )
+        {
+            TransactionQueue::RowMap::const_iterator rowIt;
+            for( rowIt = bankQueue->rows.begin( ); rowIt != bankQueue->rows.end( ); rowIt++ )
+            {
+                const TransactionQueue::Entry *rowHead = rowIt->second.head;
 
-        /* By design, mux level can only be a subset of the selected columns. */
-        ncounter_t muxLevel = static_cast<ncounter_t>(col / p->RBSize);
-
-        if( activateQueued[rank][bank]                    /* The bank is active */ 
-            && activeSubArray[rank][bank][subarray]       /* The subarray is open */
-            && effectiveRow[rank][bank][subarray] == row  /* The effective row is the row of this request */ 
-            && effectiveMuxedRow[rank][bank][subarray] == muxLevel  /* Subset of row buffer is currently at the sense amps */
-            && !bankNeedRefresh[rank][bank]               /* The bank is not waiting for a refresh */
-            && !refreshQueued[rank][bank]                 /* Don't interrupt refreshes queued on bank group head. */
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && commandQueues[queueId].empty( )            /* The request queue is empty */
-            && pred( (*it) ) )                            /* User-defined predicate is true */
+                if( activeSubArray[rank][bank][rowHead->subarray]
+                    && effectiveRow[rank][bank][rowHead->subarray] == rowHead->row )
+                    FindRowBufferHitInRow( rowHead, &found, pred );
+            }
+        }
+        else
         {
-            *hitRequest = (*it);
-            transactionQueue.erase( it );
+            for( ncounter_t subarray = 0; subarray < subArrayNum; subarray++ )
+            {
+                if( activeSubArray[rank][bank][subarray] )
+                    FindRowBufferHitInRow( transactionQueue.FindRow( rank, bank, subarray,
+                                               effectiveRow[rank][bank][subarray] ), 
+                                           &found, pred );
+            }
+        }
+    }
 
-            /* Different row buffer management policy has different behavior */ 
+    if( found != NULL )
+        *hitRequest = TakeRequest( transactionQueue, found );
 
-            /* 
-             * if Relaxed Close-Page row buffer management policy is applied,
-             * we check whether there is another request has row buffer hit.
-             * if not, this request is the last request and we can close the
-             * row.
-             */
-            if( IsLastRequest( transactionQueue, (*hitRequest) ) )
-                (*hitRequest)->flags |= NVMainRequest::FLAG_LAST_REQUEST;
+    return (found != NULL);
+}
 
-            rv = true;
+/* Looks for a row buffer hit older than *found among the requests to an open row. */
+void MemoryController::FindRowBufferHitInRow( const TransactionQueue::Entry *rowHead,
+                                              TransactionQueue::Entry **found,
+                                              SchedulingPredicate& pred )
+{
+    TransactionQueue::Entry *it = const_cast<TransactionQueue::Entry *>(rowHead);
+
+    for( ; it != NULL && (*found == NULL || it->order < (*found)->order); it = it->rowNext )
+    {
+        /* By design, mux level can only be a subset of the selected columns. */
+        ncounter_t muxLevel = static_cast<ncounter_t>(it->col / p->RBSize);
 
+        if( effectiveMuxedRow[it->rank][it->bank][it->subarray] == muxLevel  /* Subset of row buffer is currently at the sense amps */
+            && it->request->arrivalCycle != GetEventQueue()->GetCurrentCycle()
+            && commandQueues[it->queueId].empty( )  /* The request queue is empty */
+            && pred( it->request ) )                /* User-defined predicate is true */
+        {
+            *found = it;
             break;
         }
     }
-
-    return rv;
 }
 
-bool MemoryController::FindOldestReadyRequest( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindOldestReadyRequest( NVMTransactionQueue& transactionQueue, 
                                                NVMainRequest **oldestRequest )
 {
     DummyPredicate pred;
@@ -1361,54 +1390,46 @@ bool MemoryController::FindOldestReadyRequest( std::list<NVMainRequest *>& trans
     return FindOldestReadyRequest( transactionQueue, oldestRequest, pred );
 }
 
-bool MemoryController::FindOldestReadyRequest( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindOldestReadyRequest( NVMTransactionQueue& transactionQueue, 
                                                NVMainRequest **oldestRequest, 
                                                SchedulingPredicate& pred )
 {
-    bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::BankQueue *bankQueue;
+    TransactionQueue::Entry *found = NULL;
+    ncycle_t currentCycle = GetEventQueue()->GetCurrentCycle();
 
     *oldestRequest = NULL;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( bankQueue = transactionQueue.FirstBank( ); bankQueue != NULL;
+         bankQueue = bankQueue->nextActive )
     {
-        ncounter_t rank, bank;
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
+        TransactionQueue::Entry *it = bankQueue->head;
+        ncounter_t rank = it->rank, bank = it->bank;
 
-        if( !commandQueues[queueId].empty() ) continue;
-
-        (*it)->address.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+        if( !activateQueued[rank][bank]         /* The bank is active */ 
+            || bankNeedRefresh[rank][bank]      /* The bank is not waiting for a refresh */
+            || refreshQueued[rank][bank] )      /* Don't interrupt refreshes queued on bank group head. */
+            continue;
 
-        if( activateQueued[rank][bank]         /* The bank is active */ 
-            && !bankNeedRefresh[rank][bank]    /* The bank is not waiting for a refresh */
-            && !refreshQueued[rank][bank]      /* Don't interrupt refreshes queued on bank group head. */
-            && commandQueues[queueId].empty()  /* The request queue is empty */
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && pred( (*it) ) )                 /* User-defined predicate is true. */
+        for( ; it != NULL && (found == NULL || it->order < found->order); it = it->bankNext )
         {
-            *oldestRequest = (*it);
-            transactionQueue.erase( it );
-            
-            /* Different row buffer management policy has different behavior */ 
-
-            /* 
-             * if Relaxed Close-Page row buffer management policy is applied,
-             * we check whether there is another request has row buffer hit.
-             * if not, this request is the last request and we can close the
-             * row.
-             */
-            if( IsLastRequest( transactionQueue, (*oldestRequest) ) )
-                (*oldestRequest)->flags |= NVMainRequest::FLAG_LAST_REQUEST;
-
-            rv = true;
-            break;
+            if( commandQueues[it->queueId].empty()  /* The request queue is empty */
+                && it->request->arrivalCycle != currentCycle
+                && pred( it->request ) )            /* User-defined predicate is true. */
+            {
+                found = it;
+                break;
+            }
         }
     }
 
-    return rv;
+    if( found != NULL )
+        *oldestRequest = TakeRequest( transactionQueue, found );
+
+    return (found != NULL);
 }
 
-bool MemoryController::FindClosedBankRequest( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindClosedBankRequest( NVMTransactionQueue& transactionQueue, 
                                               NVMainRequest **closedRequest )
 {
     DummyPredicate pred;
@@ -1416,51 +1437,43 @@ bool MemoryController::FindClosedBankRequest( std::list<NVMainRequest *>& transa
     return FindClosedBankRequest( transactionQueue, closedRequest, pred );
 }
 
-bool MemoryController::FindClosedBankRequest( std::list<NVMainRequest *>& transactionQueue, 
+bool MemoryController::FindClosedBankRequest( NVMTransactionQueue& transactionQueue, 
                                               NVMainRequest **closedRequest, 
                                               SchedulingPredicate& pred )
 {
-    bool rv = false;
-    std::list<NVMainRequest *>::iterator it;
+    TransactionQueue::BankQueue *bankQueue;
+    TransactionQueue::Entry *found = NULL;
+    ncycle_t currentCycle = GetEventQueue()->GetCurrentCycle();
 
     *closedRequest = NULL;
 
-    for( it = transactionQueue.begin(); it != transactionQueue.end(); it++ )
+    for( bankQueue = transactionQueue.FirstBank( ); bankQueue != NULL;
+         bankQueue = bankQueue->nextActive )
     {
-        ncounter_t rank, bank;
-        ncounter_t queueId = GetCommandQueueId( (*it)->address );
-
-        if( !commandQueues[queueId].empty() ) continue;
+        TransactionQueue::Entry *it = bankQueue->head;
+        ncounter_t rank = it->rank, bank = it->bank;
 
-        (*it)->address.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+        if( activateQueued[rank][bank]          /* This bank is inactive */
+            || bankNeedRefresh[rank][bank]      /* The bank is not waiting for a refresh */
+            || refreshQueued[rank][bank] )      /* Don't interrupt refreshes queued on bank group head. */
+            continue;
 
-        if( !activateQueued[rank][bank]         /* This bank is inactive */
-            && !bankNeedRefresh[rank][bank]     /* The bank is not waiting for a refresh */
-            && !refreshQueued[rank][bank]       /* Don't interrupt refreshes queued on bank group head. */
-            && commandQueues[queueId].empty()   /* The request queue is empty */
-            && (*it)->arrivalCycle != GetEventQueue()->GetCurrentCycle()
-            && pred( (*it) ) )                  /* User defined predicate is true. */
+        for( ; it != NULL && (found == NULL || it->order < found->order); it = it->bankNext )
         {
-            *closedRequest = (*it);
-            transactionQueue.erase( it );
-            
-            /* Different row buffer management policy has different behavior */ 
-
-            /* 
-             * if Relaxed Close-Page row buffer management policy is applied,
-             * we check whether there is another request has row buffer hit.
-             * if not, this request is the last request and we can close the
-             * row.
-             */
-            if( IsLastRequest( transactionQueue, (*closedRequest) ) )
-                (*closedRequest)->flags |= NVMainRequest::FLAG_LAST_REQUEST;
-
-            rv = true;
-            break;
+            if( commandQueues[it->queueId].empty()  /* The request queue is empty */
+                && it->request->arrivalCycle != currentCycle
+                && pred( it->request ) )            /* User defined predicate is true. */
+            {
+                found = it;
+                break;
+            }
         }
     }
 
-    return rv;
+    if( found != NULL )
+        *closedRequest = TakeRequest( transactionQueue, found );
+
+    return (found != NULL);
 }
 
 bool MemoryController::DummyPredicate::operator() ( NVMainRequest* /*request*/ )
@@ -1872,12 +1885,38 @@ void MemoryController::MoveCurrentQueue( )
     }
 }
 
+/*
+ *  Queued requests are not part of a checkpoint. The memory is expected
+ *  to be drained first, so only warn if requests are left behind.
+ */
+void MemoryController::CreateCheckpoint( std::string dir )
+{
+    ncounter_t queuedRequests = 0;
+
+    for( ncounter_t queueIdx = 0; queueIdx < transactionQueueCount; queueIdx++ )
+        queuedRequests += transactionQueues[queueIdx].size( );
+
+    for( ncounter_t queueIdx = 0; queueIdx < commandQueueCount; queueIdx++ )
+        queuedRequests += commandQueues[queueIdx].size( );
+
+    if( queuedRequests != 0 )
+    {
+        std::cout << StatName( ) << ": Warning: " << queuedRequests
+                  << " queued requests are not saved in the checkpoint." << std::endl;
+    }
+
+    NVMObject::CreateCheckpoint( dir );
+}
+
 void MemoryController::CalculateStats( )
 {
     /* Sync all the child modules to the same cycle before calculating stats. */
     ncycle_t syncCycles = GetEventQueue( )->GetCurrentCycle( ) - lastCommandWake;
     GetChild( )->Cycle( syncCycles );
 
+    /* Stats may be calculated every interval, so don't count these cycles twice. */
+    lastCommandWake = GetEventQueue( )->GetCurrentCycle( );
+
     simulation_cycles = GetEventQueue()->GetCurrentCycle();
 
     GetChild( )->CalculateStats( );
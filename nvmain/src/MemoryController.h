@@ -42,6 +42,7 @@
 #include "src/Config.h"
 #include "src/Interconnect.h"
 #include "src/AddressTranslator.h"
+#include "src/TransactionQueue.h"
 #include "include/NVMainRequest.h"
 #include <deque>
 #include <iostream>
@@ -119,6 +120,8 @@ class MemoryController : public NVMObject
     void RefreshCallback( void *data );
     virtual void Cycle( ncycle_t steps ); 
 
+    virtual void CreateCheckpoint( std::string dir );
+
     virtual void SetConfig( Config *conf, bool createChildren = true );
     void SetMappingScheme( );
     Config *GetConfig( );
@@ -134,13 +137,14 @@ class MemoryController : public NVMObject
     ncounter_t wakeupCount;
     ncycle_t lastIssueCycle;
 
-    std::list<NVMainRequest *> *transactionQueues;
+    NVMTransactionQueue *transactionQueues;
     std::deque<NVMainRequest *> *commandQueues;
     ncounter_t commandQueueCount;
     ncounter_t transactionQueueCount;
     QueueModel queueModel;
 
     ncounter_t GetCommandQueueId( NVMAddress addr );
+    friend class TransactionQueue;
 
     bool **activateQueued;
     bool **refreshQueued;
@@ -179,34 +183,40 @@ class MemoryController : public NVMObject
                                          const ncounter_t rank );
     NVMainRequest *MakePowerupRequest( const ncounter_t rank );
 
-    bool FindStarvedRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **starvedRequest );
-    bool FindCachedAddress( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **accessibleRequest );
-    bool FindRowBufferHit( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **hitRequest );
-    bool FindWriteStalledRead( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **hitRequest );
-    bool FindOldestReadyRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **oldestRequest );
-    bool FindClosedBankRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **closedRequest );
-    bool FindStarvedRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& starvedRequests );
-    bool FindRowBufferHits( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& hitRequests );
-    bool FindOldestReadyRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& oldestRequests );
-    bool FindClosedBankRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& closedRequests );
+    bool FindStarvedRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **starvedRequest );
+    bool FindCachedAddress( NVMTransactionQueue& transactionQueue, NVMainRequest **accessibleRequest );
+    bool FindRowBufferHit( NVMTransactionQueue& transactionQueue, NVMainRequest **hitRequest );
+    bool FindWriteStalledRead( NVMTransactionQueue& transactionQueue, NVMainRequest **hitRequest );
+    bool FindOldestReadyRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **oldestRequest );
+    bool FindClosedBankRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **closedRequest );
+    bool FindStarvedRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& starvedRequests );
+    bool FindRowBufferHits( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& hitRequests );
+    bool FindOldestReadyRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& oldestRequests );
+    bool FindClosedBankRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& closedRequests );
 
 
     bool IssueMemoryCommands( NVMainRequest *req );
     void CycleCommandQueues( );
 
-    bool FindStarvedRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **starvedRequest, NVM::SchedulingPredicate& p );
-    bool FindCachedAddress( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **accessibleRequest, NVM::SchedulingPredicate& p );
-    bool FindRowBufferHit( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **hitRequest, NVM::SchedulingPredicate& p );
-    bool FindWriteStalledRead( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **hitRequest, NVM::SchedulingPredicate& p );
-    bool FindOldestReadyRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **oldestRequest, NVM::SchedulingPredicate& p );
-    bool FindClosedBankRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest **closedRequest, NVM::SchedulingPredicate& p );
-    bool FindStarvedRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& starvedRequests, NVM::SchedulingPredicate& p  );
-    bool FindRowBufferHits( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& hitRequests, NVM::SchedulingPredicate& p  );
-    bool FindOldestReadyRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& oldestRequests, NVM::SchedulingPredicate& p  );
-    bool FindClosedBankRequests( std::list<NVMainRequest *>& transactionQueue, std::vector<NVMainRequest *>& closedRequests, NVM::SchedulingPredicate& p  );
+    NVMainRequest *TakeRequest( NVMTransactionQueue& transactionQueue, 
+                                TransactionQueue::Entry *entry );
+    void FindRowBufferHitInRow( const TransactionQueue::Entry *rowHead,
+                                TransactionQueue::Entry **found,
+                                NVM::SchedulingPredicate& p );
+
+    bool FindStarvedRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **starvedRequest, NVM::SchedulingPredicate& p );
+    bool FindCachedAddress( NVMTransactionQueue& transactionQueue, NVMainRequest **accessibleRequest, NVM::SchedulingPredicate& p );
+    bool FindRowBufferHit( NVMTransactionQueue& transactionQueue, NVMainRequest **hitRequest, NVM::SchedulingPredicate& p );
+    bool FindWriteStalledRead( NVMTransactionQueue& transactionQueue, NVMainRequest **hitRequest, NVM::SchedulingPredicate& p );
+    bool FindOldestReadyRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **oldestRequest, NVM::SchedulingPredicate& p );
+    bool FindClosedBankRequest( NVMTransactionQueue& transactionQueue, NVMainRequest **closedRequest, NVM::SchedulingPredicate& p );
+    bool FindStarvedRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& starvedRequests, NVM::SchedulingPredicate& p  );
+    bool FindRowBufferHits( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& hitRequests, NVM::SchedulingPredicate& p  );
+    bool FindOldestReadyRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& oldestRequests, NVM::SchedulingPredicate& p  );
+    bool FindClosedBankRequests( NVMTransactionQueue& transactionQueue, std::vector<NVMainRequest *>& closedRequests, NVM::SchedulingPredicate& p  );
 
     /* IsLastRequest() tells whether no other request has the row buffer hit in the transaction queue */
-    virtual bool IsLastRequest( std::list<NVMainRequest *>& transactionQueue, NVMainRequest *request); 
+    virtual bool IsLastRequest( NVMTransactionQueue& transactionQueue, NVMainRequest *request); 
     /* curQueue records the starting index for queue round-robin level scheduling */
     ncounter_t curQueue;
     /* MoveCurrentQueue() increment curQueue */
@@ -39,6 +39,7 @@
 #include "src/AddressTranslator.h"
 #include "src/Rank.h"
 #include "src/Debug.h"
+#include "src/ParallelChannels.h"
 
 #include <cassert>
 #include <algorithm>
@@ -178,6 +179,11 @@ void NVMObject_hook::Notify( NVMainRequest *req )
 bool NVMObject_hook::RequestComplete( NVMainRequest *req )
 {
     bool rv;
+
+    /* A parallel channel completing to its owner, delivered after the window. */
+    if( ParallelChannels::Defer( trampoline, req ) )
+        return true;
+
     std::vector<NVMObject *>& preHooks  = trampoline->GetHooks( NVMHOOK_PREISSUE );
     std::vector<NVMObject *>& postHooks = trampoline->GetHooks( NVMHOOK_POSTISSUE );
     std::vector<NVMObject *>::iterator it;
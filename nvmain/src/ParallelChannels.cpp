@@ -0,0 +1,265 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "src/ParallelChannels.h"
+#include "src/EventQueue.h"
+#include "src/NVMObject.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace NVM;
+
+thread_local ParallelChannels *ParallelChannels::currentGroup = NULL;
+thread_local ParallelChannels::Worker *ParallelChannels::currentWorker = NULL;
+thread_local size_t ParallelChannels::currentChannel = 0;
+
+/* Yields before an idle worker goes to sleep. */
+static const unsigned int spinLimit = 4096;
+
+ParallelChannels::ParallelChannels( NVMObject *owner, ncycle_t lookahead,
+                                    unsigned int threads )
+    : owner(owner), lookahead(lookahead), threadCount(threads), windowEnd(0),
+      generation(0), running(0), stopping(false), sleeping(0)
+{
+    if( this->lookahead == 0 )
+        this->lookahead = 1;
+
+    if( threadCount == 0 )
+        threadCount = 1;
+
+    /* Completions are delivered through the owner's hooks, as usual. */
+    ownerHook = new NVMObject_hook( owner );
+}
+
+ParallelChannels::~ParallelChannels( )
+{
+    stopping = true;
+    generation++;
+
+    {
+        std::lock_guard<std::mutex> lock( sleepMutex );
+        wakeup.notify_all( );
+    }
+
+    for( size_t i = 0; i < workers.size( ); i++ )
+    {
+        if( workers[i]->thread.joinable( ) )
+            workers[i]->thread.join( );
+
+        delete workers[i];
+    }
+
+    delete ownerHook;
+}
+
+void ParallelChannels::AddQueue( EventQueue *queue )
+{
+    queues.push_back( queue );
+}
+
+void ParallelChannels::Start( )
+{
+    assert( workers.empty( ) );
+
+    if( threadCount > queues.size( ) )
+        threadCount = static_cast<unsigned int>(queues.size( ));
+
+    /* Deal the channels out round robin, the first share is run in place. */
+    for( unsigned int i = 0; i < threadCount; i++ )
+        workers.push_back( new Worker( ) );
+
+    for( size_t i = 0; i < queues.size( ); i++ )
+        workers[i % threadCount]->channels.push_back( i );
+
+    for( unsigned int i = 1; i < threadCount; i++ )
+        workers[i]->thread = std::thread( &ParallelChannels::RunWorker, this, workers[i] );
+}
+
+ncycle_t ParallelChannels::GetNextEvent( )
+{
+    ncycle_t nextEvent = std::numeric_limits<ncycle_t>::max( );
+
+    for( size_t i = 0; i < queues.size( ); i++ )
+        nextEvent = std::min( nextEvent, queues[i]->GetNextEvent( ) );
+
+    return nextEvent;
+}
+
+ncycle_t ParallelChannels::GetCurrentCycle( )
+{
+    return queues.empty( ) ? 0 : queues[0]->GetCurrentCycle( );
+}
+
+ncycle_t ParallelChannels::GetLookahead( )
+{
+    return lookahead;
+}
+
+void ParallelChannels::Run( ncycle_t cycle )
+{
+    windowEnd = cycle;
+
+    /* 
+     *  Most steps have nothing due, so only wake the workers when some
+     *  channel has an event in the window.
+     */
+    if( GetNextEvent( ) > cycle )
+    {
+        for( size_t i = 0; i < queues.size( ); i++ )
+        {
+            if( cycle > queues[i]->GetCurrentCycle( ) )
+                queues[i]->Loop( cycle - queues[i]->GetCurrentCycle( ) );
+        }
+
+        return;
+    }
+
+    if( workers.size( ) == 1 )
+    {
+        Work( workers[0] );
+        return;
+    }
+
+    running = static_cast<unsigned int>(workers.size( )) - 1;
+    generation++;
+
+    if( sleeping > 0 )
+    {
+        std::lock_guard<std::mutex> lock( sleepMutex );
+        wakeup.notify_all( );
+    }
+
+    Work( workers[0] );
+
+    while( running > 0 )
+        std::this_thread::yield( );
+}
+
+void ParallelChannels::Work( Worker *worker )
+{
+    currentGroup = this;
+    currentWorker = worker;
+
+    for( size_t i = 0; i < worker->channels.size( ); i++ )
+    {
+        EventQueue *queue = queues[worker->channels[i]];
+
+        currentChannel = worker->channels[i];
+
+        if( windowEnd >= queue->GetCurrentCycle( ) )
+            queue->Loop( windowEnd - queue->GetCurrentCycle( ) );
+    }
+
+    currentGroup = NULL;
+    currentWorker = NULL;
+}
+
+void ParallelChannels::RunWorker( Worker *worker )
+{
+    uint64_t seen = 0;
+
+    while( true )
+    {
+        unsigned int spins = 0;
+
+        while( generation == seen && !stopping )
+        {
+            if( ++spins < spinLimit )
+            {
+                std::this_thread::yield( );
+                continue;
+            }
+
+            /* Announce the sleep before checking, so Run( ) cannot miss it. */
+            std::unique_lock<std::mutex> lock( sleepMutex );
+            sleeping++;
+            while( generation == seen && !stopping )
+                wakeup.wait( lock );
+            sleeping--;
+        }
+
+        if( stopping )
+            break;
+
+        seen = generation;
+
+        Work( worker );
+
+        running--;
+    }
+}
+
+bool ParallelChannels::Defer( NVMObject *receiver, NVMainRequest *request )
+{
+    if( currentGroup == NULL || currentGroup->owner != receiver )
+        return false;
+
+    Completion completion;
+
+    completion.cycle = currentGroup->queues[currentChannel]->GetCurrentCycle( );
+    completion.channel = currentChannel;
+    completion.request = request;
+
+    currentWorker->completed.push_back( completion );
+
+    return true;
+}
+
+void ParallelChannels::Flush( )
+{
+    std::vector<Completion> completing;
+
+    for( size_t i = 0; i < workers.size( ); i++ )
+    {
+        completing.insert( completing.end( ), workers[i]->completed.begin( ),
+                           workers[i]->completed.end( ) );
+        workers[i]->completed.clear( );
+    }
+
+    /* 
+     *  Complete by cycle, then channel, so the order does not depend on how
+     *  the channels were dealt out to the threads. The owner may sync the
+     *  queues again while completing, so work from a private list.
+     */
+    std::stable_sort( completing.begin( ), completing.end( ),
+                      []( const Completion& a, const Completion& b )
+                      {
+                          if( a.cycle != b.cycle )
+                              return a.cycle < b.cycle;
+                          return a.channel < b.channel;
+                      } );
+
+    for( size_t i = 0; i < completing.size( ); i++ )
+        ownerHook->RequestComplete( completing[i].request );
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_PARALLELCHANNELS_H__
+#define __NVMAIN_PARALLELCHANNELS_H__
+
+#include "include/NVMTypes.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NVM {
+
+class EventQueue;
+class NVMObject;
+class NVMObject_hook;
+class NVMainRequest;
+
+/*
+ *  Runs the event queues of independent memory channels on worker threads.
+ *
+ *  Channels only interact through the memory system above them, so each
+ *  channel gets its own event queue and the queues are advanced together in
+ *  windows of at most `lookahead' cycles, with the global event queue
+ *  synchronizing everything at the window boundaries. The calling thread
+ *  runs a share of the channels itself and waits for the workers at the end
+ *  of the window.
+ *
+ *  Requests completed inside a window are not handed to the owner right
+ *  away, since the owner and its hooks are shared between channels. Defer( )
+ *  holds them until Flush( ), which completes them on the calling thread in
+ *  the order of the cycle they finished in. A completion can therefore reach
+ *  the owner up to `lookahead' cycles late.
+ */
+class ParallelChannels
+{
+  public:
+    ParallelChannels( NVMObject *owner, ncycle_t lookahead, unsigned int threads );
+    ~ParallelChannels( );
+
+    void AddQueue( EventQueue *queue );
+    void Start( );
+
+    ncycle_t GetNextEvent( );
+    ncycle_t GetCurrentCycle( );
+    ncycle_t GetLookahead( );
+
+    /* Advance every channel up to and including cycle. */
+    void Run( ncycle_t cycle );
+
+    /* 
+     *  Hold a request a channel completes to receiver, if receiver owns the
+     *  window running on this thread. Returns false if the request should be
+     *  completed right away.
+     */
+    static bool Defer( NVMObject *receiver, NVMainRequest *request );
+
+    /* Complete the requests held during the last window. */
+    void Flush( );
+
+  private:
+    struct Completion
+    {
+        ncycle_t cycle;
+        size_t channel;
+        NVMainRequest *request;
+    };
+
+    /* Everything one thread touches while running its channels. */
+    struct Worker
+    {
+        std::vector<size_t> channels;
+        std::vector<Completion> completed;
+        std::thread thread;
+        char pad[64];
+    };
+
+    NVMObject *owner;
+    NVMObject_hook *ownerHook;
+    ncycle_t lookahead;
+    unsigned int threadCount;
+
+    std::vector<EventQueue *> queues;
+    std::vector<Worker *> workers;
+
+    /* Window handed to the workers, bumping generation starts it. */
+    ncycle_t windowEnd;
+    std::atomic<uint64_t> generation;
+    std::atomic<unsigned int> running;
+    std::atomic<bool> stopping;
+
+    /* The group, worker and channel running on this thread in a window. */
+    static thread_local ParallelChannels *currentGroup;
+    static thread_local Worker *currentWorker;
+    static thread_local size_t currentChannel;
+
+    /* Workers idle for long enough sleep here instead of spinning. */
+    std::atomic<unsigned int> sleeping;
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;
+
+    void RunWorker( Worker *worker );
+    void Work( Worker *worker );
+};
+
+};
+
+#endif
@@ -123,6 +123,7 @@ Params::Params( )
     OffChipLatency = 10;
 
     PeriodicStatsInterval = 0;
+    PeriodicStatsReset = false;
 
     ROWS = 65536;
     COLS = 32;
@@ -313,6 +314,8 @@ void Params::SetParams( Config *c )
     c->GetValueUL( "OffChipLatency", OffChipLatency );
 
     c->GetValueUL( "PeriodicStatsInterval", PeriodicStatsInterval );
+    if( c->KeyExists( "PeriodicStatsReset" ) )
+        c->GetBool( "PeriodicStatsReset", PeriodicStatsReset );
 
     c->GetValueUL( "ROWS", ROWS );
     c->GetValueUL( "COLS", COLS );
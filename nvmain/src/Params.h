@@ -124,6 +124,7 @@ class Params
     ncounter_t OffChipLatency;
 
     ncounter_t PeriodicStatsInterval;
+    bool PeriodicStatsReset;
 
     ncounter_t ROWS;
     ncounter_t COLS;
@@ -33,43 +33,265 @@
 
 #include "src/SimInterface.h"
 #include "src/Config.h"
+#include <fstream>
 #include <iostream>
+#include <cstring>
 
 using namespace NVM;
 
-int SimInterface::GetDataAtAddress( uint64_t address, NVMDataBlock *data )
+SimInterface::SimInterface( )
+{
+    lines = NULL;
+    lineBytes = 0;
+    conf = NULL;
+}
+
+SimInterface::~SimInterface( )
 {
-    int retval;
+    std::map< uint64_t, NVMDataBlock* >::iterator it;
+
+    for( it = overflowData.begin( ); it != overflowData.end( ); it++ )
+        delete it->second;
 
-    if( !memoryData.count( address ) )
+    delete lines;
+}
+
+bool SimInterface::UseLines( uint64_t address, uint64_t size )
+{
+    /* The first block written decides the line size, at least 64 bytes. */
+    if( lines == NULL )
     {
-        retval = 0;
+        lineBytes = 64;
+        while( lineBytes < size )
+            lineBytes <<= 1;
+
+        lines = new SparseStore( sizeof(LineHeader) + lineBytes );
     }
-    else
+
+    return ( size <= lineBytes && (address % lineBytes) == 0 );
+}
+
+int SimInterface::GetDataAtAddress( uint64_t address, NVMDataBlock *data )
+{
+    std::lock_guard<std::mutex> lock( dataMutex );
+
+    if( lines != NULL && (address % lineBytes) == 0 )
     {
-        if( data )
-            data = memoryData[ address ];
-        retval = 1;
+        uint8_t *record = static_cast<uint8_t *>( lines->Find( address / lineBytes ) );
+
+        if( record != NULL )
+        {
+            if( data )
+            {
+                LineHeader *header = reinterpret_cast<LineHeader *>( record );
+
+                if( data->rawData != NULL && data->GetSize( ) != header->size )
+                {
+                    delete [] data->rawData;
+                    data->rawData = NULL;
+                }
+
+                if( data->rawData == NULL && header->size != 0 )
+                    data->SetSize( header->size );
+
+                if( header->size != 0 )
+                    memcpy( data->rawData, record + sizeof(LineHeader), header->size );
+                data->SetValid( header->valid != 0 );
+            }
+
+            return 1;
+        }
     }
 
-    return retval;
+    std::map< uint64_t, NVMDataBlock* >::iterator it = overflowData.find( address );
+
+    if( it == overflowData.end( ) )
+        return 0;
+
+    if( data )
+        *data = *(it->second);
+
+    return 1;
 }
 
 void SimInterface::SetDataAtAddress( uint64_t address, NVMDataBlock& data )
 {
-    if( !accessCounts.count( address ) )
+    std::lock_guard<std::mutex> lock( dataMutex );
+
+    if( UseLines( address, data.GetSize( ) ) )
+    {
+        bool inserted;
+        uint8_t *record = static_cast<uint8_t *>( 
+                lines->Insert( address / lineBytes, &inserted ) );
+        LineHeader *header = reinterpret_cast<LineHeader *>( record );
+
+        if( !inserted )
+            header->accessCount++;
+
+        header->size = static_cast<uint32_t>( data.GetSize( ) );
+        header->valid = data.IsValid( ) ? 1 : 0;
+
+        if( data.rawData != NULL )
+            memcpy( record + sizeof(LineHeader), data.rawData, header->size );
+
+        /* Drop any older copy that did not fit the line layout. */
+        if( !overflowData.empty( ) && overflowData.count( address ) )
+        {
+            delete overflowData[ address ];
+            overflowData.erase( address );
+            overflowCounts.erase( address );
+        }
+
+        return;
+    }
+
+    if( lines != NULL && (address % lineBytes) == 0 )
+        lines->Erase( address / lineBytes );
+
+    if( !overflowCounts.count( address ) )
     {
         NVMDataBlock *newData = new NVMDataBlock( );
-        memoryData[ address ] = newData;
+        overflowData[ address ] = newData;
         *newData = data;
-        accessCounts[ address ] = 0;
+        overflowCounts[ address ] = 0;
     }
     else
     {
-        NVMDataBlock *newData = memoryData[ address ];
+        NVMDataBlock *newData = overflowData[ address ];
         *newData = data;
-        accessCounts[ address ]++;
+        overflowCounts[ address ]++;
+    }
+}
+
+/*
+ *  The file holds the line size, the line store when one exists, then
+ *  each overflow block as address, access count, size, valid flag and
+ *  its bytes. Nothing is written when no data was ever stored.
+ */
+void SimInterface::WriteCheckpoint( std::string file )
+{
+    std::lock_guard<std::mutex> lock( dataMutex );
+
+    if( lines == NULL && overflowData.empty( ) )
+        return;
+
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+    {
+        std::cout << "SimInterface: Warning: Could not open checkpoint file: " 
+                  << file << "!" << std::endl;
+        return;
     }
+
+    cpt_handle.write( (const char *)&lineBytes, sizeof(lineBytes) );
+
+    if( lines != NULL )
+        lines->WriteCheckpoint( cpt_handle );
+
+    uint64_t overflowBlocks = overflowData.size( );
+
+    cpt_handle.write( (const char *)&overflowBlocks, sizeof(overflowBlocks) );
+
+    std::map< uint64_t, NVMDataBlock* >::iterator it;
+
+    for( it = overflowData.begin( ); it != overflowData.end( ); it++ )
+    {
+        uint64_t address = it->first;
+        uint64_t accessCount = overflowCounts[ address ];
+        uint64_t size = it->second->GetSize( );
+        uint64_t valid = it->second->IsValid( ) ? 1 : 0;
+
+        cpt_handle.write( (const char *)&address, sizeof(address) );
+        cpt_handle.write( (const char *)&accessCount, sizeof(accessCount) );
+        cpt_handle.write( (const char *)&size, sizeof(size) );
+        cpt_handle.write( (const char *)&valid, sizeof(valid) );
+
+        if( size != 0 )
+            cpt_handle.write( (const char *)it->second->rawData, size );
+    }
+
+    cpt_handle.close( );
+}
+
+void SimInterface::ReadCheckpoint( std::string file )
+{
+    std::lock_guard<std::mutex> lock( dataMutex );
+
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( file.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if( !cpt_handle.is_open( ) )
+        return;
+
+    uint64_t cpt_lineBytes = 0;
+    uint64_t overflowBlocks = 0;
+    bool restored = true;
+
+    cpt_handle.read( (char *)&cpt_lineBytes, sizeof(cpt_lineBytes) );
+
+    if( cpt_lineBytes != 0 )
+    {
+        /* The saved line size wins over whatever this run has seen so far. */
+        if( lines == NULL || lineBytes != cpt_lineBytes )
+        {
+            delete lines;
+            lineBytes = cpt_lineBytes;
+            lines = new SparseStore( sizeof(LineHeader) + lineBytes );
+        }
+
+        restored = lines->ReadCheckpoint( cpt_handle );
+    }
+
+    if( restored && cpt_handle.read( (char *)&overflowBlocks, sizeof(overflowBlocks) ) )
+    {
+        for( uint64_t block = 0; block < overflowBlocks && restored; block++ )
+        {
+            uint64_t address, accessCount, size, valid;
+
+            cpt_handle.read( (char *)&address, sizeof(address) );
+            cpt_handle.read( (char *)&accessCount, sizeof(accessCount) );
+            cpt_handle.read( (char *)&size, sizeof(size) );
+            cpt_handle.read( (char *)&valid, sizeof(valid) );
+
+            NVMDataBlock *newData = new NVMDataBlock( );
+
+            if( size != 0 )
+            {
+                newData->SetSize( size );
+                cpt_handle.read( (char *)newData->rawData, size );
+            }
+            newData->SetValid( valid != 0 );
+
+            if( !cpt_handle )
+            {
+                delete newData;
+                restored = false;
+                break;
+            }
+
+            if( overflowData.count( address ) )
+                delete overflowData[ address ];
+
+            overflowData[ address ] = newData;
+            overflowCounts[ address ] = static_cast<unsigned int>( accessCount );
+        }
+    }
+    else
+    {
+        restored = false;
+    }
+
+    if( !restored )
+    {
+        std::cout << "SimInterface: Warning: Checkpoint " << file 
+                  << " is truncated. Data restore is incomplete." << std::endl;
+    }
+
+    cpt_handle.close( );
 }
 
 void SimInterface::SetConfig( Config *config, bool /*createChildren*/ )
@@ -36,7 +36,10 @@
 
 #include <stdint.h>
 #include <map>
+#include <mutex>
+#include <string>
 #include "include/NVMDataBlock.h"
+#include "include/SparseStore.h"
 
 namespace NVM {
 
@@ -44,8 +47,8 @@ class Config;
 class SimInterface
 {
   public:
-    SimInterface( ) { }
-    virtual ~SimInterface( ) { }
+    SimInterface( );
+    virtual ~SimInterface( );
 
     virtual unsigned int GetInstructionCount( int ) = 0;
     virtual unsigned int GetCacheMisses( int, int ) = 0;
@@ -58,14 +61,39 @@ class SimInterface
     virtual int  GetDataAtAddress( uint64_t address, NVMDataBlock *data );
     virtual void SetDataAtAddress( uint64_t address, NVMDataBlock& data );
 
+    /* Save or restore the functional data, in the given file. */
+    virtual void WriteCheckpoint( std::string file );
+    virtual void ReadCheckpoint( std::string file );
+
     void SetConfig( Config *conf, bool createChildren = true );
     Config *GetConfig( );
 
   private:
-    std::map< uint64_t, NVMDataBlock* > memoryData;
-    std::map< uint64_t, unsigned int > accessCounts;
+    /* Header in front of each line's bytes in the sparse store. */
+    struct LineHeader
+    {
+        uint32_t accessCount;
+        uint32_t size;
+        uint32_t valid;
+        uint32_t reserved;
+    };
+
+    /*
+     *  Aligned blocks that fit in a line live in the sparse store, keyed by
+     *  line number. The line size is fixed by the first write; anything that
+     *  does not fit the layout goes to the overflow map instead.
+     */
+    SparseStore *lines;
+    uint64_t lineBytes;
+    std::map< uint64_t, NVMDataBlock* > overflowData;
+    std::map< uint64_t, unsigned int > overflowCounts;
     Config *conf;
 
+    /* Channels running on worker threads share the data. */
+    std::mutex dataMutex;
+
+    bool UseLines( uint64_t address, uint64_t size );
+
 };
 
 };
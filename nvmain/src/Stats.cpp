@@ -67,6 +67,9 @@ void Stats::addStat( StatType stat, StatType resetValue, std::string statType, s
     sb->SetUnits( units );
 
     statList.push_back( sb );
+
+    /* Keep the first stat registered under a name, as the linear search did. */
+    statIndex.insert( std::make_pair( name, sb ) );
 }
 
 void Stats::removeStat( StatType stat )
@@ -77,11 +80,42 @@ void Stats::removeStat( StatType stat )
     {
         if( (*it)->GetValue( ) == stat )
         {
+            StatBase *sb = *it;
+
+            std::unordered_map<std::string, StatBase *>::iterator indexIt;
+            indexIt = statIndex.find( sb->GetName( ) );
+            if( indexIt != statIndex.end( ) && indexIt->second == sb )
+            {
+                statIndex.erase( indexIt );
+
+                /* Fall back to the next stat registered with this name, if any. */
+                std::vector<StatBase *>::iterator dup;
+                for( dup = statList.begin(); dup != statList.end(); dup++ )
+                {
+                    if( *dup != sb && (*dup)->GetName( ) == sb->GetName( ) )
+                    {
+                        statIndex.insert( std::make_pair( sb->GetName( ), *dup ) );
+                        break;
+                    }
+                }
+            }
+
+            std::vector<StatBase *>::iterator col;
+            for( col = intervalColumns.begin(); col != intervalColumns.end(); col++ )
+            {
+                if( *col == sb )
+                {
+                    /* Keep the column so rows still line up with the header. */
+                    *col = NULL;
+                }
+            }
+
             /* Free reset value memory. */
-            uint8_t *rval = static_cast<uint8_t *>((*it)->GetResetValue( ));
+            uint8_t *rval = static_cast<uint8_t *>(sb->GetResetValue( ));
             delete[] rval; 
 
             statList.erase( it );
+            delete sb;
             break;
         }
     }
@@ -89,19 +123,9 @@ void Stats::removeStat( StatType stat )
 
 StatType Stats::getStat( std::string name )
 {
-    StatType rv = NULL;
-    std::vector<StatBase *>::iterator it;
+    std::unordered_map<std::string, StatBase *>::iterator it = statIndex.find( name );
 
-    for( it = statList.begin(); it != statList.end(); it++ )
-    {
-        if( (*it)->GetName( ) == name )
-        {
-            rv = (*it)->GetValue( );
-            break;
-        }
-    }
-
-    return rv;
+    return (it != statIndex.end( )) ? it->second->GetValue( ) : NULL;
 }
 
 void Stats::PrintAll( std::ostream& stream )
@@ -127,26 +151,96 @@ void Stats::ResetAll( )
 }
 
 
+/*
+ *  Writes a header row naming the numeric stats. Each later call to
+ *  PrintInterval writes one row of their values, so a run's stats can be
+ *  loaded as a time series. String stats (e.g., histograms) are left out.
+ */
+void Stats::PrintIntervalHeader( std::ostream& stream )
+{
+    std::vector<StatBase *>::iterator it;
+
+    intervalColumns.clear( );
+
+    stream << "interval,cycle";
+
+    for( it = statList.begin(); it != statList.end(); it++ )
+    {
+        if( (*it)->GetKind( ) != STAT_STRING && (*it)->GetKind( ) != STAT_UNKNOWN )
+        {
+            intervalColumns.push_back( *it );
+            stream << "," << (*it)->GetName( );
+        }
+    }
+
+    stream << std::endl;
+}
+
+void Stats::PrintInterval( std::ostream& stream, ncycle_t cycle )
+{
+    std::vector<StatBase *>::iterator it;
+
+    stream << psInterval << "," << cycle;
+
+    for( it = intervalColumns.begin(); it != intervalColumns.end(); it++ )
+    {
+        stream << ",";
+
+        if( *it != NULL )
+            (*it)->PrintValue( stream );
+    }
+
+    stream << std::endl;
+
+    psInterval++;
+}
+
+
+void StatBase::SetStatType( std::string st, size_t ts )
+{
+    statType = st;
+    typeSize = ts;
+
+    /* ncycle_t and ncycles_t are the same types as ncounter_t and ncounters_t. */
+    if( statType == typeid(int).name() ) kind = STAT_INT;
+    else if( statType == typeid(float).name() ) kind = STAT_FLOAT;
+    else if( statType == typeid(double).name() ) kind = STAT_DOUBLE;
+    else if( statType == typeid(ncounter_t).name() ) kind = STAT_COUNTER;
+    else if( statType == typeid(ncounters_t).name() ) kind = STAT_SCOUNTER;
+    else if( statType == typeid(std::string).name() ) kind = STAT_STRING;
+    else kind = STAT_UNKNOWN;
+}
+
 void StatBase::Reset( )
 {
-    std::memcpy( value, resetValue, typeSize );
+    /* The reset copy of a string is only its bytes, so it can't be copied back. */
+    if( kind == STAT_STRING )
+        static_cast<std::string *>(value)->clear( );
+    else
+        std::memcpy( value, resetValue, typeSize );
 }
 
 void StatBase::Print( std::ostream& stream, ncounter_t psInterval )
 {
     stream << "i" << psInterval << "." << name << " ";
 
-    if( statType == typeid(int).name() ) stream << *(static_cast<int *>(value));
-    else if( statType == typeid(float).name() ) stream << *(static_cast<float *>(value));
-    else if( statType == typeid(double).name() ) stream << *(static_cast<double *>(value));
-    else if( statType == typeid(ncounter_t).name() ) stream << *(static_cast<ncounter_t *>(value));
-    else if( statType == typeid(ncounters_t).name() ) stream << *(static_cast<ncounters_t *>(value));
-    else if( statType == typeid(ncycle_t).name() ) stream << *(static_cast<ncycle_t *>(value));
-    else if( statType == typeid(ncycles_t).name() ) stream << *(static_cast<ncycles_t *>(value));
-    else if( statType == typeid(std::string).name() ) stream << *(static_cast<std::string *>(value));
-    else stream << "?????";
+    PrintValue( stream );
 
     stream << units << std::endl;
 }
 
+void StatBase::PrintValue( std::ostream& stream )
+{
+    switch( kind )
+    {
+        case STAT_INT: stream << *(static_cast<int *>(value)); break;
+        case STAT_FLOAT: stream << *(static_cast<float *>(value)); break;
+        case STAT_DOUBLE: stream << *(static_cast<double *>(value)); break;
+        case STAT_COUNTER: stream << *(static_cast<ncounter_t *>(value)); break;
+        case STAT_SCOUNTER: stream << *(static_cast<ncounters_t *>(value)); break;
+        case STAT_STRING: stream << *(static_cast<std::string *>(value)); break;
+        default: stream << "?????"; break;
+    }
+}
+
 
@@ -57,6 +57,7 @@
 #define RemoveStat(STAT) (this->GetStats()->removeStat(static_cast<StatType>(&STAT)))
 
 // CHLD = NVMObject_hook, STAT = std::string; returns StatType
+// The StatType returned is stable, so look it up once rather than every time stats are calculated.
 #define GetStat(CHLD, STAT) (CHLD->GetStats( )->getStat( CHLD->StatName( ) + "." + STAT ) )
 
 // STAT = StatType, TYPE = any type; returns TYPE
@@ -67,6 +68,7 @@
 #include <ostream>
 #include <typeinfo>
 #include <vector>
+#include <unordered_map>
 #include <cstring>
 
 #include "include/NVMTypes.h"
@@ -76,6 +78,18 @@ namespace NVM {
 
 typedef void * StatType;
 
+/* The value type of a stat, resolved once when the stat is added. */
+enum StatKind
+{
+    STAT_INT,
+    STAT_FLOAT,
+    STAT_DOUBLE,
+    STAT_COUNTER,
+    STAT_SCOUNTER,
+    STAT_STRING,
+    STAT_UNKNOWN
+};
+
 
 class StatBase
 {
@@ -85,6 +99,7 @@ class StatBase
 
     void Reset( );
     void Print( std::ostream& stream, ncounter_t psInterval );
+    void PrintValue( std::ostream& stream );
 
     std::string GetName( ) { return name; }
     void SetName( std::string n ) { name = n; }
@@ -98,12 +113,14 @@ class StatBase
     void SetResetValue( StatType rval ) { resetValue = rval; }
     void *GetResetValue( ) { return resetValue; }
 
-    void SetStatType( std::string st, size_t ts ) { statType = st; typeSize = ts; }
+    void SetStatType( std::string st, size_t ts );
     size_t GetTypeSize( ) { return typeSize; }
     std::string GetTypeName() { return statType; }
+    StatKind GetKind( ) { return kind; }
 
   private:
     std::string name, statType, units;
+    StatKind kind;
     size_t typeSize;
     StatType resetValue;
     StatType value;
@@ -122,8 +139,14 @@ class Stats
     void PrintAll( std::ostream& );
     void ResetAll( );
 
+    /* Columnar output: a header naming each numeric stat, then one row per interval. */
+    void PrintIntervalHeader( std::ostream& );
+    void PrintInterval( std::ostream&, ncycle_t cycle );
+
   private: 
     std::vector<StatBase *> statList;
+    std::unordered_map<std::string, StatBase *> statIndex;
+    std::vector<StatBase *> intervalColumns;
     ncounter_t psInterval;
 };
 
@@ -45,16 +45,7 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
-
-/*
- * Using -O3 in gcc causes the popcount methods to return incorrect values.
- * Disable optimizations in these methods using compiler specific attributes.
- */
-#if defined(__clang__)
-#define NO_OPT __attribute__((optnone))
-#else
-#define NO_OPT __attribute__((optimize("0")))
-#endif
+#include <vector>
 
 using namespace NVM;
 
@@ -541,17 +532,30 @@ bool SubArray::Write( NVMainRequest *request )
         /* Count the number of bits modified. */
         if( !p->WriteAllBits )
         {
-            uint8_t *bitCountData = new uint8_t[request->data.GetSize()];
-
-            for( uint64_t bitCountByte = 0; bitCountByte < request->data.GetSize(); bitCountByte++ )
+            NVMDataBlock& newData = request->data;
+            NVMDataBlock& oldData = request->oldData;
+            ncounter_t bitCountWords = newData.GetSize()/4;
+            ncounter_t numChangedBits;
+
+            /* GetByte reads invalid or short blocks as zero; do the same. */
+            if( newData.IsValid( ) && oldData.IsValid( )
+                && oldData.GetSize( ) >= newData.GetSize( ) )
             {
-                bitCountData[bitCountByte] = request->data.GetByte( bitCountByte )
-                                           ^ request->oldData.GetByte( bitCountByte );
+                numChangedBits = CountChangedBits( newData.rawData, 
+                                                   oldData.rawData, bitCountWords*4 );
             }
+            else
+            {
+                std::vector<uint8_t> bitCountData( bitCountWords*4 );
 
-            ncounter_t bitCountWords = request->data.GetSize()/4;
+                for( uint64_t bitCountByte = 0; bitCountByte < bitCountData.size(); bitCountByte++ )
+                {
+                    bitCountData[bitCountByte] = newData.GetByte( bitCountByte )
+                                               ^ oldData.GetByte( bitCountByte );
+                }
 
-            ncounter_t numChangedBits = CountBitsMLC1( 1, (uint32_t*)bitCountData, bitCountWords );
+                numChangedBits = CountBitsMLC1( 1, bitCountData.data(), bitCountWords );
+            }
 
             assert( request->data.GetSize()*8 >= numChangedBits );
             numUnchangedBits = request->data.GetSize()*8 - numChangedBits;
@@ -668,7 +672,7 @@ bool SubArray::Write( NVMainRequest *request )
 
     assert( hook != NULL );
 
-    writeEvent = new NVM::Event( );
+    writeEvent = GetEventQueue( )->CreateEvent( );
     writeEvent->SetType( EventResponse );
     writeEvent->SetRecipient( hook );
     writeEvent->SetRequest( request );
@@ -898,7 +902,7 @@ void SubArray::CheckWritePausing( )
 
         /* Delete the old event indicating write completion. */
         GetEventQueue( )->RemoveEvent( writeEvent, writeEventTime );
-        delete writeEvent;
+        GetEventQueue( )->ReleaseEvent( writeEvent );
         writeEvent = NULL;
 
         /* Return this write as paused/cancelled. */
@@ -929,7 +933,7 @@ bool SubArray::BetweenWriteIterations( )
 ncycle_t SubArray::WriteCellData( NVMainRequest *request )
 {
     writeIterationStarts.clear( );
-    uint32_t *rawData = reinterpret_cast<uint32_t*>(request->data.rawData);
+    const uint8_t *rawData = request->data.rawData;
     unsigned int memoryWordSize = static_cast<unsigned int>(p->tBURST * p->RATE * p->BusWidth);
     unsigned int writeBytes32 = memoryWordSize / 32;
 
@@ -1480,82 +1484,59 @@ void SubArray::CalculateStats( )
     wpCancelHisto = PyDictHistogram<double, uint64_t>( wpCancelMap );
 }
 
-bool SubArray::Idle( )
-{
-    return ( state == SUBARRAY_CLOSED || state == SUBARRAY_PRECHARGING );
-}
-
-void SubArray::Cycle( ncycle_t )
-{
-}
-
 /*
- *  Count the appearances for "value" for 2-bit MLC where value
- *  can be 0 (binary 00), 1 (binary 01), 2 (binary 10) or 3
- *  (binary 11).
+ *  Cell wear and encoder state live with each sub-array. Row buffer and
+ *  timing state are not saved; the sub-array restarts closed.
  */
-ncounter_t NO_OPT SubArray::Count32MLC2( uint8_t value, uint32_t data )
+void SubArray::CreateCheckpoint( std::string dir )
 {
-    /*
-     *  This method counts the number of 11 pairs, so we need to convert
-     *  the bit pattern we are looking for to be 11.
-     */
-    if( value == 0 )
-        data ^= 0xFFFFFFFF;
-    else if( value == 1 )
-        data ^= 0xAAAAAAAA;
-    else if( value == 2 )
-        data ^= 0x55555555;
+    std::string cpt_file = dir + "/" + StatName( );
 
-    assert( value < 4 );
+    if( endrModel )
+        endrModel->WriteCheckpoint( cpt_file + ".endurance" );
 
-    /* 
-     *  Count number of "11" pairs by ANDing together every-event bit
-     *  with every odd bit. The resulting ANDed value will be 1 if both
-     *  even and odd bit are 1 (i.e. "11") and 0 otherwise.
-     */
-    uint32_t count = (data & 0x55555555) & ((data & 0xAAAAAAAA) >> 1);
+    if( dataEncoder )
+        dataEncoder->WriteCheckpoint( cpt_file + ".encoder" );
 
-    return Count32MLC1(count);
+    NVMObject::CreateCheckpoint( dir );
 }
 
-
-ncounter_t NO_OPT SubArray::CountBitsMLC2( uint8_t value, uint32_t *data, ncounter_t words )
+void SubArray::RestoreCheckpoint( std::string dir )
 {
-    ncounter_t count = 0;
+    std::string cpt_file = dir + "/" + StatName( );
 
-    for( ncounter_t i = 0; i < words; i++ )
-    {
-        count += Count32MLC2( value, data[i] );
-    }
+    if( endrModel )
+        endrModel->ReadCheckpoint( cpt_file + ".endurance" );
 
-    return count;
+    if( dataEncoder )
+        dataEncoder->ReadCheckpoint( cpt_file + ".encoder" );
+
+    NVMObject::RestoreCheckpoint( dir );
 }
 
+bool SubArray::Idle( )
+{
+    return ( state == SUBARRAY_CLOSED || state == SUBARRAY_PRECHARGING );
+}
 
-ncounter_t NO_OPT SubArray::Count32MLC1( uint32_t data )
+void SubArray::Cycle( ncycle_t )
 {
-    /*
-     *  Count the number of ones in this value using some
-     *  bit-manipulation magic.
-     */
-    uint32_t count = data;
-    count = count - ((count >> 1) & 0x55555555);
-    count = (count & 0x33333333) + ((count >> 2) & 0x33333333);
-    count = (((count + (count >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
 
-    return static_cast<ncounter_t>(count);
+/*
+ *  Count the appearances for "value" for 2-bit MLC where value
+ *  can be 0 (binary 00), 1 (binary 01), 2 (binary 10) or 3
+ *  (binary 11).
+ */
+ncounter_t SubArray::CountBitsMLC2( uint8_t value, const uint8_t *data, ncounter_t words )
+{
+    return CountCellLevels( value, data, words*4 );
 }
 
 
-ncounter_t NO_OPT SubArray::CountBitsMLC1( uint8_t value, uint32_t *data, ncounter_t words )
+ncounter_t SubArray::CountBitsMLC1( uint8_t value, const uint8_t *data, ncounter_t words )
 {
-    ncounter_t count = 0;
-
-    for( ncounter_t i = 0; i < words; i++ )
-    {
-        count += Count32MLC1( data[i] );
-    }
+    ncounter_t count = CountSetBits( data, words*4 );
 
     count = (value == 1) ? count : (words*32 - count);
 
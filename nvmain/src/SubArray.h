@@ -116,6 +116,9 @@ class SubArray : public NVMObject
     void RegisterStats( );
     void CalculateStats( );
 
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
     ncounter_t GetId( );
     std::string GetName( );
 
@@ -208,10 +211,8 @@ class SubArray : public NVMObject
 
     ncycle_t UpdateEndurance( NVMainRequest *request );
 
-    ncounter_t Count32MLC2( uint8_t value, uint32_t data );
-    ncounter_t CountBitsMLC2( uint8_t value, uint32_t *data, ncounter_t words );
-    ncounter_t Count32MLC1( uint32_t data );
-    ncounter_t CountBitsMLC1( uint8_t value, uint32_t *data, ncounter_t words );
+    ncounter_t CountBitsMLC2( uint8_t value, const uint8_t *data, ncounter_t words );
+    ncounter_t CountBitsMLC1( uint8_t value, const uint8_t *data, ncounter_t words );
 };
 
 };
@@ -0,0 +1,228 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "src/TransactionQueue.h"
+#include "src/MemoryController.h"
+#include "include/NVMainRequest.h"
+
+#include <cassert>
+
+using namespace NVM;
+
+TransactionQueue::TransactionQueue( )
+{
+    controller = NULL;
+    bankCount = 0;
+
+    head = NULL;
+    tail = NULL;
+    count = 0;
+    frontOrder = -1;
+    backOrder = 0;
+
+    activeBanks = NULL;
+    freeEntries = NULL;
+}
+
+TransactionQueue::~TransactionQueue( )
+{
+    std::vector<Entry *>::iterator it;
+    for( it = allocatedEntries.begin( ); it != allocatedEntries.end( ); it++ )
+        delete (*it);
+}
+
+void TransactionQueue::Init( MemoryController *mc, ncounter_t ranks, 
+                             ncounter_t banks, ncounter_t commandQueues )
+{
+    assert( count == 0 );
+
+    controller = mc;
+    bankCount = banks;
+
+    bankQueues.assign( ranks * banks, BankQueue( ) );
+    queueIdCounts.assign( commandQueues, 0 );
+    activeBanks = NULL;
+}
+
+void TransactionQueue::push_back( NVMainRequest *request )
+{
+    Entry *entry = CreateEntry( request );
+
+    entry->order = backOrder++;
+    Link( entry, false );
+}
+
+void TransactionQueue::push_front( NVMainRequest *request )
+{
+    Entry *entry = CreateEntry( request );
+
+    entry->order = frontOrder--;
+    Link( entry, true );
+}
+
+void TransactionQueue::clear( )
+{
+    while( head != NULL )
+        Erase( head );
+}
+
+TransactionQueue::Entry *TransactionQueue::CreateEntry( NVMainRequest *request )
+{
+    assert( controller != NULL );
+
+    Entry *entry = freeEntries;
+
+    if( entry != NULL )
+    {
+        freeEntries = entry->next;
+    }
+    else
+    {
+        entry = new Entry( );
+        allocatedEntries.push_back( entry );
+    }
+
+    entry->request = request;
+    request->address.GetTranslatedAddress( &entry->row, &entry->col, &entry->bank,
+                                           &entry->rank, NULL, &entry->subarray );
+    entry->queueId = controller->GetCommandQueueId( request->address );
+    entry->bankIdx = entry->rank * bankCount + entry->bank;
+
+    assert( entry->bankIdx < bankQueues.size( ) );
+
+    return entry;
+}
+
+/*
+ *  Requests are only ever added at either end of the queue, so they go at
+ *  the same end of their bank and row lists to keep those in queue order.
+ */
+void TransactionQueue::Link( Entry *entry, bool front )
+{
+    BankQueue& bankQueue = bankQueues[entry->bankIdx];
+    RowList& rowList = bankQueue.rows[RowKey( entry->subarray, entry->row )];
+
+    if( front )
+    {
+        entry->prev = NULL;
+        entry->next = head;
+        entry->bankPrev = NULL;
+        entry->bankNext = bankQueue.head;
+        entry->rowPrev = NULL;
+        entry->rowNext = rowList.head;
+    }
+    else
+    {
+        entry->prev = tail;
+        entry->next = NULL;
+        entry->bankPrev = bankQueue.tail;
+        entry->bankNext = NULL;
+        entry->rowPrev = rowList.tail;
+        entry->rowNext = NULL;
+    }
+
+    if( entry->prev ) entry->prev->next = entry; else head = entry;
+    if( entry->next ) entry->next->prev = entry; else tail = entry;
+    if( entry->bankPrev ) entry->bankPrev->bankNext = entry; else bankQueue.head = entry;
+    if( entry->bankNext ) entry->bankNext->bankPrev = entry; else bankQueue.tail = entry;
+    if( entry->rowPrev ) entry->rowPrev->rowNext = entry; else rowList.head = entry;
+    if( entry->rowNext ) entry->rowNext->rowPrev = entry; else rowList.tail = entry;
+
+    if( bankQueue.count++ == 0 )
+    {
+        bankQueue.prevActive = NULL;
+        bankQueue.nextActive = activeBanks;
+        if( activeBanks != NULL )
+            activeBanks->prevActive = &bankQueue;
+        activeBanks = &bankQueue;
+    }
+
+    queueIdCounts[entry->queueId]++;
+    count++;
+}
+
+NVMainRequest *TransactionQueue::Erase( Entry *entry )
+{
+    BankQueue& bankQueue = bankQueues[entry->bankIdx];
+    RowMap::iterator rowIt = bankQueue.rows.find( RowKey( entry->subarray, entry->row ) );
+
+    assert( rowIt != bankQueue.rows.end( ) );
+
+    RowList& rowList = rowIt->second;
+
+    if( entry->prev ) entry->prev->next = entry->next; else head = entry->next;
+    if( entry->next ) entry->next->prev = entry->prev; else tail = entry->prev;
+    if( entry->bankPrev ) entry->bankPrev->bankNext = entry->bankNext; else bankQueue.head = entry->bankNext;
+    if( entry->bankNext ) entry->bankNext->bankPrev = entry->bankPrev; else bankQueue.tail = entry->bankPrev;
+    if( entry->rowPrev ) entry->rowPrev->rowNext = entry->rowNext; else rowList.head = entry->rowNext;
+    if( entry->rowNext ) entry->rowNext->rowPrev = entry->rowPrev; else rowList.tail = entry->rowPrev;
+
+    if( rowList.head == NULL )
+        bankQueue.rows.erase( rowIt );
+
+    if( --bankQueue.count == 0 )
+    {
+        if( bankQueue.prevActive ) 
+            bankQueue.prevActive->nextActive = bankQueue.nextActive;
+        else
+            activeBanks = bankQueue.nextActive;
+
+        if( bankQueue.nextActive )
+            bankQueue.nextActive->prevActive = bankQueue.prevActive;
+    }
+
+    queueIdCounts[entry->queueId]--;
+    count--;
+
+    NVMainRequest *request = entry->request;
+
+    entry->request = NULL;
+    entry->next = freeEntries;
+    freeEntries = entry;
+
+    return request;
+}
+
+const TransactionQueue::Entry *TransactionQueue::FindRow( ncounter_t rank, ncounter_t bank,
+                                                          ncounter_t subarray, ncounter_t row ) const
+{
+    const BankQueue& bankQueue = bankQueues[rank * bankCount + bank];
+
+    if( bankQueue.count == 0 )
+        return NULL;
+
+    RowMap::const_iterator it = bankQueue.rows.find( RowKey( subarray, row ) );
+
+    return (it != bankQueue.rows.end( )) ? it->second.head : NULL;
+}
+
+bool TransactionQueue::HasCommandQueue( ncounter_t queueId ) const
+{
+    return (queueId < queueIdCounts.size( ) && queueIdCounts[queueId] != 0);
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __SRC_TRANSACTIONQUEUE_H__
+#define __SRC_TRANSACTIONQUEUE_H__
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "include/NVMTypes.h"
+
+namespace NVM {
+
+class NVMainRequest;
+class MemoryController;
+
+/*
+ *  A memory controller transaction queue. Besides the queue order, each
+ *  request is linked into an age ordered list for its bank, and within the
+ *  bank into a list per open-able row, so the schedulers can skip banks that
+ *  can not issue and look up row buffer hits directly instead of scanning
+ *  every queued request.
+ *
+ *  Push order is kept as a sequence number, so the first request in queue
+ *  order among several banks is the one with the smallest number.
+ */
+class TransactionQueue
+{
+  public:
+    struct Entry
+    {
+        NVMainRequest *request;
+        ncounters_t order;
+
+        /* Translated address and command queue, cached on insertion. */
+        ncounter_t row, col, bank, rank, subarray;
+        ncounter_t queueId;
+        ncounter_t bankIdx;
+
+        Entry *prev, *next;          /* Queue order. */
+        Entry *bankPrev, *bankNext;  /* Queue order within the bank. */
+        Entry *rowPrev, *rowNext;    /* Queue order within the row. */
+    };
+
+    struct RowList
+    {
+        RowList( ) : head(NULL), tail(NULL) {}
+
+        Entry *head;
+        Entry *tail;
+    };
+
+    typedef std::unordered_map<uint64_t, RowList> RowMap;
+
+    struct BankQueue
+    {
+        BankQueue( ) : head(NULL), tail(NULL), count(0),
+                       prevActive(NULL), nextActive(NULL) {}
+
+        Entry *head;
+        Entry *tail;
+        ncounter_t count;
+        RowMap rows;
+
+        /* Banks with queued requests are linked together. */
+        BankQueue *prevActive;
+        BankQueue *nextActive;
+    };
+
+    TransactionQueue( );
+    ~TransactionQueue( );
+
+    void Init( MemoryController *controller, ncounter_t ranks, 
+               ncounter_t banks, ncounter_t commandQueues );
+
+    void push_back( NVMainRequest *request );
+    void push_front( NVMainRequest *request );
+    void clear( );
+    ncounter_t size( ) const { return count; }
+    bool empty( ) const { return (count == 0); }
+
+    Entry *Front( ) const { return head; }
+    BankQueue *FirstBank( ) const { return activeBanks; }
+    const Entry *FindRow( ncounter_t rank, ncounter_t bank, 
+                          ncounter_t subarray, ncounter_t row ) const;
+    bool HasCommandQueue( ncounter_t queueId ) const;
+
+    /* Removes the entry and returns its request. */
+    NVMainRequest *Erase( Entry *entry );
+
+    static uint64_t RowKey( ncounter_t subarray, ncounter_t row )
+    {
+        return (static_cast<uint64_t>(subarray) << 32) | row;
+    }
+
+  private:
+    MemoryController *controller;
+    ncounter_t bankCount;
+
+    Entry *head;
+    Entry *tail;
+    ncounter_t count;
+    ncounters_t frontOrder;
+    ncounters_t backOrder;
+
+    std::vector<BankQueue> bankQueues;
+    BankQueue *activeBanks;
+    std::vector<ncounter_t> queueIdCounts;
+
+    Entry *freeEntries;
+    std::vector<Entry *> allocatedEntries;
+
+    Entry *CreateEntry( NVMainRequest *request );
+    void Link( Entry *entry, bool front );
+};
+
+};
+
+#endif
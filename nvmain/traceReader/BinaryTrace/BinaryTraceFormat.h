@@ -0,0 +1,81 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __BINARYTRACEFORMAT_H__
+#define __BINARYTRACEFORMAT_H__
+
+#include <stdint.h>
+
+namespace NVM {
+
+/*
+ *  Layout of the binary NVMain traces, shared by the reader and the writer.
+ *
+ *  A trace is a header followed by fixed-size records, so a trace can be
+ *  mapped in memory and walked without any parsing. Each record holds the
+ *  cycle, address, thread and operation of an access, followed by its new
+ *  and old data when the trace carries data. Addresses may be stored as the
+ *  difference with the address of the previous record, which makes traces
+ *  with strided or local accesses compress much better. Values are stored
+ *  in host (little-endian) byte order.
+ */
+
+const char BinaryTraceMagic[4] = { 'N', 'V', 'M', 'B' };
+const uint16_t BinaryTraceVersion = 1;
+
+/* Addresses are deltas from the previous record's address. */
+const uint16_t BinaryTraceDeltaAddress = 0x1;
+/* Records are followed by the new and the old data blocks. */
+const uint16_t BinaryTraceHasData = 0x2;
+
+struct BinaryTraceHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t dataSize;      /* Bytes in each data block, 0 without data. */
+    uint32_t recordSize;    /* Bytes in each record, data included. */
+    uint64_t recordCount;
+    uint64_t reserved;
+};
+
+struct BinaryTraceRecord
+{
+    uint64_t cycle;
+    uint64_t address;       /* Absolute, or delta modulo 2^64. */
+    uint32_t threadId;
+    uint8_t operation;      /* One of BinaryTraceOp. */
+    uint8_t padding[3];
+};
+
+enum BinaryTraceOp { BinaryTraceRead = 0, BinaryTraceWrite = 1 };
+
+};
+
+#endif
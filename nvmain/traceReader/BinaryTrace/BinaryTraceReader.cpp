@@ -0,0 +1,308 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "traceReader/BinaryTrace/BinaryTraceReader.h"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NVM;
+
+BinaryTraceReader::BinaryTraceReader( )
+{
+    traceFile = "";
+
+    map = NULL;
+    mapSize = 0;
+    stream = NULL;
+    recordCount = 0;
+    nextRecord = 0;
+    lastAddress = 0;
+    failed = false;
+}
+
+BinaryTraceReader::~BinaryTraceReader( )
+{
+    Close( );
+}
+
+void BinaryTraceReader::SetTraceFile( std::string file )
+{
+    Close( );
+
+    traceFile = file;
+    failed = false;
+}
+
+std::string BinaryTraceReader::GetTraceFile( )
+{
+    return traceFile;
+}
+
+bool BinaryTraceReader::Open( )
+{
+    int fd = open( traceFile.c_str( ), O_RDONLY );
+    if( fd < 0 )
+    {
+        std::cerr << "Could not open trace file: " << traceFile << "!" << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 )
+    {
+        std::cerr << "Could not open trace file: " << traceFile << "!" << std::endl;
+        close( fd );
+        return false;
+    }
+
+    if( S_ISREG( st.st_mode ) )
+    {
+        if( st.st_size < (off_t)sizeof(header) )
+        {
+            std::cerr << "BinaryTraceReader: " << traceFile 
+                << " is too short to be a binary trace." << std::endl;
+            close( fd );
+            return false;
+        }
+
+        mapSize = st.st_size;
+        void *addr = mmap( NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+        close( fd );
+
+        if( addr == MAP_FAILED )
+        {
+            std::cerr << "BinaryTraceReader: Could not map " << traceFile 
+                << "!" << std::endl;
+            return false;
+        }
+
+        map = static_cast<const uint8_t *>(addr);
+        madvise( addr, mapSize, MADV_SEQUENTIAL );
+
+        memcpy( &header, map, sizeof(header) );
+    }
+    else
+    {
+        /* Pipes and other streams can't be mapped, read them instead. */
+        stream = fdopen( fd, "rb" );
+        if( stream == NULL || fread( &header, sizeof(header), 1, stream ) != 1 )
+        {
+            std::cerr << "BinaryTraceReader: " << traceFile 
+                << " is too short to be a binary trace." << std::endl;
+            if( stream == NULL )
+                close( fd );
+            Close( );
+            return false;
+        }
+    }
+
+    if( memcmp( header.magic, BinaryTraceMagic, sizeof(header.magic) ) != 0
+        || header.version != BinaryTraceVersion )
+    {
+        std::cerr << "BinaryTraceReader: " << traceFile 
+            << " is not a version " << BinaryTraceVersion 
+            << " binary trace." << std::endl;
+        Close( );
+        return false;
+    }
+
+    uint64_t expectedSize = sizeof(BinaryTraceRecord);
+    if( header.flags & BinaryTraceHasData )
+        expectedSize += 2 * header.dataSize;
+
+    if( header.recordSize != expectedSize )
+    {
+        std::cerr << "BinaryTraceReader: " << traceFile 
+            << " has " << header.recordSize << "-byte records, expected " 
+            << expectedSize << "." << std::endl;
+        Close( );
+        return false;
+    }
+
+    /* 
+     *  The header count is only final once the writer is destroyed, the
+     *  file size is what tells how many records were written.
+     */
+    if( map != NULL )
+        recordCount = (mapSize - sizeof(header)) / header.recordSize;
+    else
+        recordBuffer.resize( header.recordSize );
+
+    /* Traces without data replay zeroed 64-byte blocks. */
+    uint64_t blockSize = (header.flags & BinaryTraceHasData) ? header.dataSize : 64;
+
+    if( dataBlock.rawData == NULL )
+    {
+        dataBlock.SetSize( blockSize );
+        oldDataBlock.SetSize( blockSize );
+    }
+    else
+    {
+        assert( dataBlock.GetSize( ) == blockSize );
+    }
+    memset( dataBlock.rawData, 0, blockSize );
+    memset( oldDataBlock.rawData, 0, blockSize );
+
+    nextRecord = 0;
+    lastAddress = 0;
+
+    return true;
+}
+
+void BinaryTraceReader::Close( )
+{
+    if( map != NULL )
+    {
+        munmap( const_cast<uint8_t *>(map), mapSize );
+        map = NULL;
+    }
+
+    if( stream != NULL )
+    {
+        fclose( stream );
+        stream = NULL;
+    }
+
+    mapSize = 0;
+}
+
+const uint8_t *BinaryTraceReader::NextRecord( )
+{
+    const uint8_t *raw = NULL;
+
+    if( map != NULL && nextRecord < recordCount )
+    {
+        raw = map + sizeof(header) + nextRecord * header.recordSize;
+    }
+    else if( stream != NULL )
+    {
+        if( fread( &recordBuffer[0], header.recordSize, 1, stream ) == 1 )
+            raw = &recordBuffer[0];
+    }
+
+    if( raw != NULL )
+        nextRecord++;
+
+    return raw;
+}
+
+bool BinaryTraceReader::GetNextAccess( TraceLine *nextAccess )
+{
+    /* If there is no trace file, we can't do anything. */
+    if( traceFile == "" )
+    {
+        std::cerr << "No trace file specified!" << std::endl;
+        return false;
+    }
+
+    /* Map the trace on first use, but only try once. */
+    if( map == NULL && stream == NULL && !failed )
+        failed = !Open( );
+
+    const uint8_t *raw = NextRecord( );
+
+    /* There are no more records in the trace... Send back a "dummy" line */
+    if( raw == NULL )
+    {
+        NVMAddress nAddress;
+        NVMDataBlock emptyBlock;
+        NVMDataBlock emptyOldBlock;
+        nAddress.SetPhysicalAddress( 0xDEADC0DEDEADBEEFULL );
+        nextAccess->SetLine( nAddress, NOP, 0, emptyBlock, emptyOldBlock, 0 );
+        if( !failed )
+            std::cout << "BinaryTraceReader: Reached EOF!" << std::endl;
+        return false;
+    }
+
+    BinaryTraceRecord record;
+
+    memcpy( &record, raw, sizeof(record) );
+
+    uint64_t address = record.address;
+    if( header.flags & BinaryTraceDeltaAddress )
+        address += lastAddress;
+    lastAddress = address;
+
+    if( header.flags & BinaryTraceHasData )
+    {
+        raw += sizeof(record);
+        memcpy( dataBlock.rawData, raw, header.dataSize );
+        memcpy( oldDataBlock.rawData, raw + header.dataSize, header.dataSize );
+    }
+
+    OpType operation = READ;
+    if( record.operation == BinaryTraceWrite )
+        operation = WRITE;
+    else if( record.operation != BinaryTraceRead )
+        std::cout << "BinaryTraceReader: Unknown operation " 
+            << (int)record.operation << " in record " << nextRecord - 1 
+            << std::endl;
+
+    NVMAddress nAddress;
+
+    nAddress.SetPhysicalAddress( address );
+
+    nextAccess->SetLine( nAddress, operation, record.cycle, dataBlock, 
+                         oldDataBlock, record.threadId );
+
+    return true;
+}
+
+/* 
+ * Get the next N accesses to main memory. Called GetNextAccess N times and 
+ * places the return values into a vector of TraceLine pointers.
+ */
+int BinaryTraceReader::GetNextNAccesses( unsigned int N, 
+                                   std::vector<TraceLine *> *nextAccesses )
+{
+    int successes = 0;
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        /* We need a new TraceLine so the old values are not overwritten. */
+        TraceLine *nextLine = new TraceLine( );
+
+        if( !GetNextAccess( nextLine ) )
+        {
+            delete nextLine;
+            break;
+        }
+
+        nextAccesses->push_back( nextLine );
+        successes++;
+    }
+
+    return successes;
+}
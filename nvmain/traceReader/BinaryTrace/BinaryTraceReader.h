@@ -0,0 +1,85 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __BINARYTRACEREADER_H__
+#define __BINARYTRACEREADER_H__
+
+#include "traceReader/GenericTraceReader.h"
+#include "traceReader/BinaryTrace/BinaryTraceFormat.h"
+#include <cstdio>
+#include <string>
+
+namespace NVM {
+
+/*
+ *  Reads binary traces (see BinaryTraceFormat.h) by mapping the whole file
+ *  in memory, so the per-access cost is copying a record out of the map.
+ *  Traces which can't be mapped, such as pipes, are read record by record.
+ */
+class BinaryTraceReader : public GenericTraceReader
+{
+  public:
+    BinaryTraceReader( );
+    ~BinaryTraceReader( );
+    
+    void SetTraceFile( std::string file );
+    std::string GetTraceFile( );
+    
+    bool GetNextAccess( TraceLine *nextAccess );
+    int  GetNextNAccesses( unsigned int N, std::vector<TraceLine *> *nextAccess );
+  
+  private:
+    std::string traceFile;
+
+    bool Open( );
+    void Close( );
+    const uint8_t *NextRecord( );
+
+    /* The mapped trace, header included. */
+    const uint8_t *map;
+    uint64_t mapSize;
+
+    /* The trace and a record buffer when it can't be mapped. */
+    FILE *stream;
+    std::vector<uint8_t> recordBuffer;
+
+    BinaryTraceHeader header;
+    uint64_t recordCount;
+    uint64_t nextRecord;
+    uint64_t lastAddress;
+    bool failed;
+
+    /* Reused for every record so that no data block is allocated. */
+    NVMDataBlock dataBlock;
+    NVMDataBlock oldDataBlock;
+};
+
+};
+
+#endif
@@ -99,16 +99,7 @@ bool NVMainTraceReader::GetNextAccess( TraceLine *nextAccess )
     NVMDataBlock oldDataBlock;
     unsigned int threadId = 0;
     
-    /* There are no more lines in the trace... Send back a "dummy" line */
     getline( trace, fullLine );
-    if( trace.eof( ) )
-    {
-        NVMAddress nAddress;
-        nAddress.SetPhysicalAddress( 0xDEADC0DEDEADBEEFULL );
-        nextAccess->SetLine( nAddress, NOP, 0, dataBlock, oldDataBlock, 0 );
-        std::cout << "NVMainTraceReader: Reached EOF!" << std::endl;
-        return false;
-    }
 
     if( !readVersion )
     {
@@ -121,6 +112,19 @@ bool NVMainTraceReader::GetNextAccess( TraceLine *nextAccess )
         readVersion = true;
         getline( trace, fullLine );
     }
+
+    /* 
+     *  There are no more lines in the trace... Send back a "dummy" line.
+     *  Checked after the header, so a trace without accesses has none.
+     */
+    if( trace.eof( ) )
+    {
+        NVMAddress nAddress;
+        nAddress.SetPhysicalAddress( 0xDEADC0DEDEADBEEFULL );
+        nextAccess->SetLine( nAddress, NOP, 0, dataBlock, oldDataBlock, 0 );
+        std::cout << "NVMainTraceReader: Reached EOF!" << std::endl;
+        return false;
+    }
     
     std::istringstream lineStream( fullLine );
     std::string field;
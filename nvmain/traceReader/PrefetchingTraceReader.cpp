@@ -0,0 +1,229 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "traceReader/PrefetchingTraceReader.h"
+#include <iostream>
+#include <sstream>
+
+using namespace NVM;
+
+PrefetchingTraceReader::PrefetchingTraceReader( GenericTraceReader *reader,
+                                                ncounter_t depth )
+    : reader(reader), traceFile(""), pipe(NULL), tail(0), readCount(0),
+      freeLimit(0), finished(false), head(0), consumed(0), available(0),
+      started(false), stopping(false)
+{
+    /* Round the depth up to a power of two holding a few batches. */
+    capacity = 1;
+    if( depth > 0 )
+    {
+        while( capacity < depth || capacity < 4 * batchSize )
+            capacity <<= 1;
+    }
+
+    mask = capacity - 1;
+    lines = new TraceLine[capacity];
+}
+
+PrefetchingTraceReader::~PrefetchingTraceReader( )
+{
+    Stop( );
+
+    /* The reader holds the pipe open, close it before reaping the child. */
+    delete reader;
+    if( pipe != NULL )
+        pclose( pipe );
+
+    delete [] lines;
+}
+
+void PrefetchingTraceReader::SetTraceFile( std::string file )
+{
+    if( traceFile != "" )
+    {
+        std::cerr << "PrefetchingTraceReader: The trace file is already set to "
+            << traceFile << "." << std::endl;
+        return;
+    }
+
+    traceFile = file;
+
+    std::string decompressor = "";
+    if( file.size( ) > 3 && file.compare( file.size( ) - 3, 3, ".gz" ) == 0 )
+        decompressor = "gzip -dc '";
+    else if( file.size( ) > 4 && file.compare( file.size( ) - 4, 4, ".zst" ) == 0 )
+        decompressor = "zstd -dc '";
+
+    if( decompressor == "" )
+    {
+        reader->SetTraceFile( file );
+        return;
+    }
+
+    pipe = popen( (decompressor + file + "'").c_str( ), "r" );
+    if( pipe == NULL )
+    {
+        std::cerr << "PrefetchingTraceReader: Could not decompress " << file 
+            << "!" << std::endl;
+        reader->SetTraceFile( file );
+        return;
+    }
+
+    /* The reader opens the pipe as a regular path. */
+    std::stringstream pipePath;
+    pipePath << "/dev/fd/" << fileno( pipe );
+    reader->SetTraceFile( pipePath.str( ) );
+}
+
+std::string PrefetchingTraceReader::GetTraceFile( )
+{
+    return traceFile;
+}
+
+void PrefetchingTraceReader::Start( )
+{
+    started = true;
+
+    if( capacity > 1 )
+        producer = std::thread( &PrefetchingTraceReader::Produce, this );
+}
+
+void PrefetchingTraceReader::Stop( )
+{
+    stopping.store( true );
+    if( producer.joinable( ) )
+        producer.join( );
+    stopping.store( false );
+}
+
+void PrefetchingTraceReader::Produce( )
+{
+    freeLimit = capacity;
+
+    while( !stopping.load( std::memory_order_relaxed ) )
+    {
+        /* Wait for the simulation to release lines when the ring is full. */
+        if( readCount == freeLimit )
+        {
+            tail.store( readCount, std::memory_order_release );
+            freeLimit = head.load( std::memory_order_acquire ) + capacity;
+            if( readCount == freeLimit )
+                std::this_thread::yield( );
+            continue;
+        }
+
+        if( !reader->GetNextAccess( &lines[readCount & mask] ) )
+            break;
+
+        if( ++readCount % batchSize == 0 )
+            tail.store( readCount, std::memory_order_release );
+    }
+
+    tail.store( readCount, std::memory_order_release );
+    finished.store( true, std::memory_order_release );
+}
+
+TraceLine *PrefetchingTraceReader::NextLine( )
+{
+    /* Without prefetching, read each line as it is asked for. */
+    if( capacity == 1 )
+        return reader->GetNextAccess( &lines[0] ) ? &lines[0] : NULL;
+
+    if( !started )
+        Start( );
+
+    /* All the lines handed out so far are done with. */
+    if( consumed % batchSize == 0 )
+        head.store( consumed, std::memory_order_release );
+
+    while( consumed == available )
+    {
+        /* Check for completion before the tail to not miss the last lines. */
+        bool done = finished.load( std::memory_order_acquire );
+
+        available = tail.load( std::memory_order_acquire );
+        if( consumed < available )
+            break;
+
+        if( done )
+            return NULL;
+
+        head.store( consumed, std::memory_order_release );
+        std::this_thread::yield( );
+    }
+
+    return &lines[consumed++ & mask];
+}
+
+bool PrefetchingTraceReader::GetNextAccess( TraceLine *nextAccess )
+{
+    TraceLine *line = NextLine( );
+
+    if( line == NULL )
+    {
+        NVMAddress nAddress;
+        NVMDataBlock dataBlock;
+        NVMDataBlock oldDataBlock;
+        nAddress.SetPhysicalAddress( 0xDEADC0DEDEADBEEFULL );
+        nextAccess->SetLine( nAddress, NOP, 0, dataBlock, oldDataBlock, 0 );
+        return false;
+    }
+
+    nextAccess->SetLine( line->GetAddress( ), line->GetOperation( ), 
+                         line->GetCycle( ), line->GetData( ), 
+                         line->GetOldData( ), line->GetThreadId( ) );
+
+    return true;
+}
+
+/* 
+ * Get the next N accesses to main memory, copied out of the ring into new 
+ * TraceLines.
+ */
+int PrefetchingTraceReader::GetNextNAccesses( unsigned int N, 
+                                   std::vector<TraceLine *> *nextAccesses )
+{
+    int successes = 0;
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        TraceLine *nextLine = new TraceLine( );
+
+        if( !GetNextAccess( nextLine ) )
+        {
+            delete nextLine;
+            break;
+        }
+
+        nextAccesses->push_back( nextLine );
+        successes++;
+    }
+
+    return successes;
+}
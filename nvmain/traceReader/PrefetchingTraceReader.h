@@ -0,0 +1,111 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __PREFETCHINGTRACEREADER_H__
+#define __PREFETCHINGTRACEREADER_H__
+
+#include "traceReader/GenericTraceReader.h"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace NVM {
+
+/*
+ *  Decodes a trace ahead of the simulation on a background thread.
+ *
+ *  Lines are read with another trace reader into a single-producer,
+ *  single-consumer ring of preallocated lines. Both sides only publish
+ *  their position every batch of lines, so the simulation thread touches
+ *  the shared indices once per batch and NextLine( ) hands out lines in
+ *  place, without copying them. Traces ending in .gz or .zst are
+ *  decompressed on the fly by gzip or zstd through a pipe.
+ *
+ *  With a depth of 0 there is no thread and lines are read on demand.
+ */
+class PrefetchingTraceReader : public GenericTraceReader
+{
+  public:
+    PrefetchingTraceReader( GenericTraceReader *reader, ncounter_t depth );
+    ~PrefetchingTraceReader( );
+
+    void SetTraceFile( std::string file );
+    std::string GetTraceFile( );
+
+    bool GetNextAccess( TraceLine *nextAccess );
+    int  GetNextNAccesses( unsigned int N, std::vector<TraceLine *> *nextAccesses );
+
+    /* 
+     *  Get the next line of the trace, or NULL at the end of the trace. The
+     *  line remains valid until the next call.
+     */
+    TraceLine *NextLine( );
+
+  private:
+    /* Lines published by either side at once. */
+    static const uint64_t batchSize = 64;
+
+    GenericTraceReader *reader;
+    std::string traceFile;
+    FILE *pipe;
+
+    TraceLine *lines;
+    uint64_t capacity;
+    uint64_t mask;
+
+    /* 
+     *  Producer side: lines read and published. Padding keeps each side on
+     *  its own cache lines.
+     */
+    char producerPad[64];
+    std::atomic<uint64_t> tail;
+    uint64_t readCount;
+    uint64_t freeLimit;
+    std::atomic<bool> finished;
+
+    /* Consumer side: lines consumed and released. */
+    char consumerPad[64];
+    std::atomic<uint64_t> head;
+    uint64_t consumed;
+    uint64_t available;
+    bool started;
+
+    char sharedPad[64];
+    std::atomic<bool> stopping;
+    std::thread producer;
+
+    void Start( );
+    void Produce( );
+    void Stop( );
+};
+
+};
+
+#endif
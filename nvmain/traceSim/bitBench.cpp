@@ -0,0 +1,595 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "DataEncoders/FlipNWrite/FlipNWrite.h"
+#include "include/NVMHelpers.h"
+#include "include/NVMainRequest.h"
+#include "include/SparseStore.h"
+#include "src/Config.h"
+#include "src/Stats.h"
+#include "traceSim/bitBench.h"
+
+using namespace NVM;
+
+namespace {
+
+const uint64_t defaultRounds = 20000;
+const uint64_t benchBlocks = 4096;
+const uint64_t benchRepeats = 5;
+
+/* The 32-bit popcount SubArray::CountBitsMLC1 used to call per word. */
+uint64_t Count32MLC1( uint32_t data )
+{
+    uint32_t count = data;
+    count = count - ((count >> 1) & 0x55555555);
+    count = (count & 0x33333333) + ((count >> 2) & 0x33333333);
+    count = (((count + (count >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+
+    return count;
+}
+
+/* The 32-bit MLC level count SubArray::CountBitsMLC2 used to call per word. */
+uint64_t Count32MLC2( uint8_t value, uint32_t data )
+{
+    if( value == 0 )
+        data ^= 0xFFFFFFFF;
+    else if( value == 1 )
+        data ^= 0xAAAAAAAA;
+    else if( value == 2 )
+        data ^= 0x55555555;
+
+    uint32_t count = (data & 0x55555555) & ((data & 0xAAAAAAAA) >> 1);
+
+    return Count32MLC1( count );
+}
+
+uint32_t LoadWord32( const uint8_t *data )
+{
+    uint32_t word;
+
+    memcpy( &word, data, sizeof(word) );
+
+    return word;
+}
+
+/* Ones in whole 32-bit words, as CountBitsMLC1 used to count them. */
+uint64_t CountWords32( const uint8_t *data, uint64_t words )
+{
+    uint64_t count = 0;
+
+    for( uint64_t i = 0; i < words; i++ )
+        count += Count32MLC1( LoadWord32( data + i*4 ) );
+
+    return count;
+}
+
+/* Cells at a level in whole 32-bit words, as CountBitsMLC2 used to count. */
+uint64_t CountLevelWords32( uint8_t value, const uint8_t *data, uint64_t words )
+{
+    uint64_t count = 0;
+
+    for( uint64_t i = 0; i < words; i++ )
+        count += Count32MLC2( value, LoadWord32( data + i*4 ) );
+
+    return count;
+}
+
+/* Ones one bit at a time, for any size. */
+uint64_t CountBitByBit( const uint8_t *data, const uint8_t *oldData, uint64_t bytes )
+{
+    uint64_t count = 0;
+
+    for( uint64_t i = 0; i < bytes * 8; i++ )
+    {
+        uint8_t bit = (data[i / 8] >> (i % 8)) & 0x1;
+        uint8_t oldBit = oldData ? ((oldData[i / 8] >> (i % 8)) & 0x1) : 0;
+
+        if( bit != oldBit )
+            count++;
+    }
+
+    return count;
+}
+
+/* 2-bit cells at a level one cell at a time, for any size. */
+uint64_t CountCellByCell( uint8_t level, const uint8_t *data, uint64_t bytes )
+{
+    uint64_t count = 0;
+
+    for( uint64_t i = 0; i < bytes * 4; i++ )
+    {
+        if( ((data[i / 4] >> (2 * (i % 4))) & 0x3) == level )
+            count++;
+    }
+
+    return count;
+}
+
+/*
+ *  FlipNWrite as it was before partitions were counted a word at a time:
+ *  every bit is compared and inverted on its own. Only the guard against
+ *  bits past the last whole partition is new, as those used to index past
+ *  the end of the counts.
+ */
+class PerBitFlipNWrite
+{
+  public:
+    PerBitFlipNWrite( int granularity, uint64_t word, uint64_t cols )
+        : fpSize(granularity), wordSize(word), COLS(cols),
+          bitsFlipped(0), bitCompareSwapWrites(0) { }
+
+    void Write( NVMDataBlock& newData, NVMDataBlock& oldData,
+                uint64_t row, uint64_t col );
+
+    int fpSize;
+    uint64_t wordSize;
+    uint64_t COLS;
+    SparseStore flippedAddresses;
+    uint64_t bitsFlipped;
+    uint64_t bitCompareSwapWrites;
+
+  private:
+    void InvertData( NVMDataBlock &data, uint64_t startBit, uint64_t endBit );
+};
+
+void PerBitFlipNWrite::InvertData( NVMDataBlock& data, uint64_t startBit, uint64_t endBit )
+{
+    int startByte = (int)(startBit / 8);
+    int endByte = (int)((endBit - 1) / 8);
+
+    for( int i = startByte; i <= endByte; i++ )
+    {
+        uint8_t shiftByte = data.GetByte( i );
+        uint8_t newByte = 0;
+
+        for( int j = 0; j < 8; j++ )
+        {
+            uint64_t currentBit = i * 8 + j;
+           
+            if( currentBit < startBit || currentBit >= endBit )
+            {
+                shiftByte = static_cast<uint8_t>(shiftByte >> 1);
+                continue;
+            }
+
+            if( !(shiftByte & 0x1) )
+            {
+                newByte = static_cast<uint8_t>(newByte | (1 << (7-j)));
+            }
+
+            shiftByte = static_cast<uint8_t>(shiftByte >> 1);
+        }
+
+        data.SetByte( i, newByte );
+    }
+}
+
+void PerBitFlipNWrite::Write( NVMDataBlock& newData, NVMDataBlock& oldData,
+                              uint64_t row, uint64_t col )
+{
+    uint64_t rowPartitions = ( COLS * wordSize * 8 ) / fpSize;
+    uint64_t flipPartitions = ( wordSize * 8 ) / fpSize; 
+    std::vector<int> modifyCount( flipPartitions, 0 );
+
+    for( uint64_t i = 0; i < flipPartitions; i++ )
+    {
+        uint64_t curAddr = row * rowPartitions + col * flipPartitions + i;
+
+        if( flippedAddresses.Contains( curAddr ) )
+            InvertData( oldData, i*fpSize, (i+1)*fpSize );
+    }
+
+    uint64_t currentBit = 0;
+
+    for( uint64_t i = 0; i < wordSize; ++i )
+    {
+        uint8_t oldByte = oldData.GetByte( i );
+        uint8_t newByte = newData.GetByte( i );
+
+        if( oldByte == newByte )
+        {
+            currentBit += 8;
+            continue;
+        }
+
+        for( int j = 0; j < 8; j++ )
+        {
+            uint8_t oldBit = ( oldByte >> j ) & 0x1;
+            uint8_t newBit = ( newByte >> j ) & 0x1;
+
+            if( oldBit != newBit && currentBit / fpSize < flipPartitions )
+                modifyCount[(int)(currentBit/fpSize)]++;
+
+            currentBit++;
+        }
+    }
+
+    for( uint64_t i = 0; i < flipPartitions; i++ )
+    {
+        bitCompareSwapWrites += modifyCount[i];
+
+        uint64_t curAddr = row * rowPartitions + col * flipPartitions + i;
+
+        if( modifyCount[i] > (fpSize / 2) )
+        {
+            InvertData( newData, i*fpSize, (i+1)*fpSize );
+            bitsFlipped += (fpSize - modifyCount[i]);
+            flippedAddresses.Insert( curAddr );
+        }
+        else
+        {
+            flippedAddresses.Erase( curAddr );
+            bitsFlipped += modifyCount[i];
+        }
+    }
+}
+
+void RandomFill( uint8_t *data, uint64_t bytes )
+{
+    for( uint64_t i = 0; i < bytes; i++ )
+        data[i] = static_cast<uint8_t>(rand( ));
+}
+
+/* Flip about one bit in `sparsity` so partitions fall on both sides of half. */
+void RandomFlips( uint8_t *data, uint64_t bytes, int sparsity )
+{
+    for( uint64_t i = 0; i < bytes * 8; i++ )
+    {
+        if( rand( ) % sparsity == 0 )
+            data[i / 8] = static_cast<uint8_t>(data[i / 8] ^ (1 << (i % 8)));
+    }
+}
+
+template<typename F>
+double BestTime( F f )
+{
+    double best = std::numeric_limits<double>::max( );
+
+    for( uint64_t repeat = 0; repeat < benchRepeats; repeat++ )
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+        f( );
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now( ) - start;
+
+        best = std::min( best, elapsed.count( ) );
+    }
+
+    return best;
+}
+
+}
+
+BitBench::BitBench( ) : config(NULL), mismatches(0)
+{
+
+}
+
+BitBench::~BitBench( )
+{
+
+}
+
+void BitBench::Expect( uint64_t value, uint64_t expected, const std::string& what )
+{
+    if( value == expected )
+        return;
+
+    if( mismatches < 10 )
+    {
+        std::cout << "Mismatch in " << what << ": " << value 
+                  << " instead of " << expected << std::endl;
+    }
+
+    mismatches++;
+}
+
+int BitBench::Run( int argc, char *argv[] )
+{
+    uint64_t rounds = (argc > 2) ? strtoull( argv[2], NULL, 10 ) : defaultRounds;
+
+    if( argc < 2 || rounds == 0 )
+    {
+        std::cout << "Usage: nvmain --bench-bits CONFIG_FILE [ROUNDS]" << std::endl;
+        return 1;
+    }
+
+    /* Only the memory word and partition sizes are taken from the bench. */
+    config = new Config( );
+    config->Read( argv[1] );
+    config->SetValue( "BusWidth", "64" );
+    config->SetValue( "tBURST", "4" );
+    config->SetValue( "RATE", "2" );
+
+    srand( 1 );
+
+    CheckCounts( rounds );
+
+    /* Byte aligned, bit aligned and partitions not dividing the word. */
+    int granularities[] = { 8, 12, 16, 32, 64, 512 };
+    for( size_t i = 0; i < sizeof(granularities) / sizeof(granularities[0]); i++ )
+        CheckFlipNWrite( granularities[i], rounds );
+
+    if( mismatches != 0 )
+    {
+        std::cout << mismatches << " mismatches against the reference routines."
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "Bit counting kernels match the reference routines." << std::endl;
+
+    TimeCounts( );
+    TimeFlipNWrite( );
+
+    delete config;
+
+    return 0;
+}
+
+void BitBench::CheckCounts( uint64_t rounds )
+{
+    std::vector<uint8_t> buffer( 256 + 8 ), oldBuffer( 256 + 8 );
+
+    for( uint64_t round = 0; round < rounds; round++ )
+    {
+        /* Odd sizes and every alignment, whole words every other round. */
+        uint64_t bytes = static_cast<uint64_t>(rand( ) % 256) + 1;
+        if( round % 2 )
+            bytes = (bytes + 3) & ~3ULL;
+        const uint8_t *data = buffer.data( ) + rand( ) % 8;
+        const uint8_t *oldData = oldBuffer.data( ) + rand( ) % 8;
+
+        RandomFill( buffer.data( ), buffer.size( ) );
+        RandomFill( oldBuffer.data( ), oldBuffer.size( ) );
+
+        /* Mostly ones or mostly zeros at times, not only balanced data. */
+        if( round % 3 == 1 )
+            memset( buffer.data( ), (round % 2) ? 0xFF : 0x00, buffer.size( ) );
+        if( round % 3 == 2 )
+            memcpy( buffer.data( ), oldBuffer.data( ), buffer.size( ) );
+        RandomFlips( buffer.data( ), buffer.size( ), 64 );
+
+        Expect( CountSetBits( data, bytes ), CountBitByBit( data, NULL, bytes ),
+                "CountSetBits" );
+        Expect( CountChangedBits( data, oldData, bytes ),
+                CountBitByBit( data, oldData, bytes ), "CountChangedBits" );
+
+        for( uint8_t level = 0; level < 4; level++ )
+        {
+            Expect( CountCellLevels( level, data, bytes ),
+                    CountCellByCell( level, data, bytes ), "CountCellLevels" );
+        }
+
+        if( bytes % 4 != 0 )
+            continue;
+
+        Expect( CountSetBits( data, bytes ), CountWords32( data, bytes / 4 ),
+                "CountSetBits against Count32MLC1" );
+
+        for( uint8_t level = 0; level < 4; level++ )
+        {
+            Expect( CountCellLevels( level, data, bytes ),
+                    CountLevelWords32( level, data, bytes / 4 ),
+                    "CountCellLevels against Count32MLC2" );
+        }
+    }
+}
+
+void BitBench::CheckFlipNWrite( int granularity, uint64_t rounds )
+{
+    const uint64_t wordSize = 64;
+    const uint64_t rows = 4, cols = 4;
+    std::stringstream name;
+
+    name << "FlipNWrite with FlipNWriteGranularity=" << granularity;
+
+    Stats *stats = new Stats( );
+    FlipNWrite *encoder = new FlipNWrite( );
+    std::stringstream fpSize;
+
+    fpSize << granularity;
+    config->SetValue( "COLS", "4" );
+    config->SetValue( "FlipNWriteGranularity", fpSize.str( ) );
+
+    encoder->SetConfig( config );
+    encoder->SetStats( stats );
+    encoder->StatName( "flipNWrite" );
+    encoder->RegisterStats( );
+
+    PerBitFlipNWrite reference( granularity, wordSize, cols );
+
+    /* What was last written to each row and column, before encoding. */
+    std::vector<std::vector<uint8_t> > memory( rows * cols );
+
+    for( uint64_t round = 0; round < rounds / 4; round++ )
+    {
+        uint64_t row = rand( ) % rows, col = rand( ) % cols;
+        std::vector<uint8_t>& previous = memory[row * cols + col];
+        std::vector<uint8_t> written( wordSize );
+
+        /* Small and large changes to what is there, or unrelated data. */
+        if( previous.empty( ) || rand( ) % 4 == 0 )
+        {
+            RandomFill( written.data( ), wordSize );
+        }
+        else
+        {
+            written = previous;
+            RandomFlips( written.data( ), wordSize, 1 + rand( ) % 8 );
+        }
+
+        NVMainRequest request;
+        NVMDataBlock newData, oldData;
+
+        request.address.SetTranslatedAddress( row, col, 0, 0, 0, 0 );
+        request.data.SetSize( wordSize );
+        request.oldData.SetSize( wordSize );
+        memcpy( request.data.rawData, written.data( ), wordSize );
+        if( !previous.empty( ) )
+            memcpy( request.oldData.rawData, previous.data( ), wordSize );
+        else
+            memset( request.oldData.rawData, 0, wordSize );
+
+        /* Invalid blocks read as zero and take the per-bit path. */
+        if( rand( ) % 16 == 0 )
+            request.data.SetValid( false );
+        if( rand( ) % 16 == 0 )
+            request.oldData.SetValid( false );
+
+        newData = request.data;
+        oldData = request.oldData;
+
+        encoder->Write( &request );
+        reference.Write( newData, oldData, row, col );
+
+        for( uint64_t i = 0; i < wordSize; i++ )
+        {
+            Expect( request.data.rawData[i], newData.rawData[i], name.str( ) + " data" );
+            Expect( request.oldData.rawData[i], oldData.rawData[i], 
+                    name.str( ) + " old data" );
+        }
+
+        previous = written;
+    }
+
+    Expect( CastStat( GetStat( encoder, "bitsFlipped" ), uint64_t ), 
+            reference.bitsFlipped, name.str( ) + " bitsFlipped" );
+    Expect( CastStat( GetStat( encoder, "bitCompareSwapWrites" ), uint64_t ), 
+            reference.bitCompareSwapWrites, name.str( ) + " bitCompareSwapWrites" );
+
+    delete encoder;
+    delete stats;
+}
+
+void BitBench::TimeCounts( )
+{
+    const uint64_t blockSize = 64;
+    std::vector<uint8_t> blocks( benchBlocks * blockSize );
+    volatile uint64_t sink = 0;
+
+    RandomFill( blocks.data( ), blocks.size( ) );
+
+    double words32 = BestTime( [&]( ) {
+        uint64_t count = 0;
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+            count += CountWords32( &blocks[i * blockSize], blockSize / 4 );
+        sink = count;
+    } );
+    double setBits = BestTime( [&]( ) {
+        uint64_t count = 0;
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+            count += CountSetBits( &blocks[i * blockSize], blockSize );
+        sink = count;
+    } );
+    double levelWords32 = BestTime( [&]( ) {
+        uint64_t count = 0;
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+            count += CountLevelWords32( 2, &blocks[i * blockSize], blockSize / 4 );
+        sink = count;
+    } );
+    double cellLevels = BestTime( [&]( ) {
+        uint64_t count = 0;
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+            count += CountCellLevels( 2, &blocks[i * blockSize], blockSize );
+        sink = count;
+    } );
+
+    double blocksPerNs = static_cast<double>(benchBlocks) / 1e9;
+
+    std::cout << "64-byte blocks, ns/block (32-bit words -> 64-bit words):" << std::endl
+              << "  ones:       " << words32 / blocksPerNs << " -> " 
+              << setBits / blocksPerNs << std::endl
+              << "  MLC levels: " << levelWords32 / blocksPerNs << " -> " 
+              << cellLevels / blocksPerNs << std::endl;
+}
+
+void BitBench::TimeFlipNWrite( )
+{
+    const uint64_t wordSize = 64;
+    const int granularity = 32;
+    std::vector<uint8_t> written( benchBlocks * wordSize );
+    std::vector<uint8_t> previous( benchBlocks * wordSize );
+
+    RandomFill( previous.data( ), previous.size( ) );
+    written = previous;
+    RandomFlips( written.data( ), written.size( ), 3 );
+
+    Stats *stats = new Stats( );
+    FlipNWrite *encoder = new FlipNWrite( );
+
+    config->SetValue( "COLS", "4096" );
+    config->SetValue( "FlipNWriteGranularity", "32" );
+    encoder->SetConfig( config );
+    encoder->SetStats( stats );
+    encoder->StatName( "flipNWrite" );
+    encoder->RegisterStats( );
+
+    PerBitFlipNWrite reference( granularity, wordSize, benchBlocks );
+    NVMainRequest request;
+
+    request.data.SetSize( wordSize );
+    request.oldData.SetSize( wordSize );
+
+    double perBit = BestTime( [&]( ) {
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+        {
+            memcpy( request.data.rawData, &written[i * wordSize], wordSize );
+            memcpy( request.oldData.rawData, &previous[i * wordSize], wordSize );
+            reference.Write( request.data, request.oldData, 0, i );
+        }
+    } );
+    double words = BestTime( [&]( ) {
+        for( uint64_t i = 0; i < benchBlocks; i++ )
+        {
+            memcpy( request.data.rawData, &written[i * wordSize], wordSize );
+            memcpy( request.oldData.rawData, &previous[i * wordSize], wordSize );
+            request.address.SetTranslatedAddress( 0, i, 0, 0, 0, 0 );
+            encoder->Write( &request );
+        }
+    } );
+
+    double blocksPerNs = static_cast<double>(benchBlocks) / 1e9;
+
+    std::cout << "FlipNWrite, 64-byte writes, 32-bit partitions, ns/write "
+              << "(per bit -> per partition):" << std::endl
+              << "  " << perBit / blocksPerNs << " -> " 
+              << words / blocksPerNs << std::endl;
+
+    delete encoder;
+    delete stats;
+}
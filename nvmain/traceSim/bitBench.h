@@ -0,0 +1,74 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __TRACESIM_BITBENCH_H__
+#define __TRACESIM_BITBENCH_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "src/Config.h"
+
+namespace NVM {
+
+/*
+ *  Bit counting check and microbenchmark:
+ *
+ *    nvmain --bench-bits CONFIG_FILE [ROUNDS]
+ *
+ *  CountSetBits, CountChangedBits, CountCellLevels and FlipNWrite are run
+ *  on random data against the 32-bit Count32MLC1/Count32MLC2 routines and
+ *  the per-bit FlipNWrite loop they replaced, including MLC levels, odd
+ *  sizes and unaligned buffers. Any difference fails the run. Both sides
+ *  are then timed on 64-byte blocks. The config file only supplies the
+ *  parameters FlipNWrite needs besides its memory word and partition size.
+ */
+class BitBench
+{
+  public:
+    BitBench( );
+    ~BitBench( );
+
+    int Run( int argc, char *argv[] );
+
+  private:
+    Config *config;
+    uint64_t mismatches;
+
+    void Expect( uint64_t value, uint64_t expected, const std::string& what );
+
+    void CheckCounts( uint64_t rounds );
+    void CheckFlipNWrite( int granularity, uint64_t rounds );
+    void TimeCounts( );
+    void TimeFlipNWrite( );
+};
+
+};
+
+#endif
@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+#include "traceSim/checkpointCheck.h"
+#include "traceSim/parallelCheck.h"
+#include "traceSim/traceMain.h"
+
+using namespace NVM;
+
+CheckpointCheck::CheckpointCheck( )
+{
+
+}
+
+CheckpointCheck::~CheckpointCheck( )
+{
+
+}
+
+int CheckpointCheck::Run( int argc, char *argv[] )
+{
+    uint64_t requests = (argc > 2) ? strtoull( argv[2], NULL, 10 ) : 0;
+
+    if( argc < 3 || requests == 0 )
+    {
+        std::cout << "Usage: nvmain --check-checkpoint CONFIG_FILE REQUESTS [PARAM=value ...]"
+            << std::endl;
+        return 1;
+    }
+
+    char workName[] = "/tmp/nvmain-checkpoint-XXXXXX";
+
+    if( mkdtemp( workName ) == NULL )
+    {
+        std::cout << "Could not create a temporary directory." << std::endl;
+        return 1;
+    }
+
+    std::string workDir = workName;
+    std::string traceFile = workDir + "/trace.nvt";
+    std::string emptyTraceFile = workDir + "/empty.nvt";
+    std::string savedDir = workDir + "/saved";
+    std::string restoredDir = workDir + "/restored";
+
+    ParallelCheck::WriteTrace( traceFile, requests );
+    ParallelCheck::WriteTrace( emptyTraceFile, 0 );
+
+    std::vector<std::string> overrides;
+
+    for( int curArg = 3; curArg < argc; curArg++ )
+        overrides.push_back( argv[curArg] );
+    overrides.push_back( "TraceReader=NVMainTrace" );
+
+    std::vector<std::string> saveRun( overrides ), restoreRun( overrides ), continueRun( overrides );
+
+    saveRun.push_back( "CheckpointDirectory=" + savedDir );
+    restoreRun.push_back( "RestoreCheckpointDirectory=" + savedDir );
+    restoreRun.push_back( "CheckpointDirectory=" + restoredDir );
+    continueRun.push_back( "RestoreCheckpointDirectory=" + savedDir );
+
+    int rv = Simulate( argv[1], traceFile, saveRun );
+
+    if( rv == 0 )
+        rv = Simulate( argv[1], emptyTraceFile, restoreRun );
+
+    if( rv == 0 )
+        rv = Simulate( argv[1], traceFile, continueRun );
+
+    std::vector<std::string> savedFiles, restoredFiles;
+    bool listed = ListFiles( savedDir, savedFiles ) && ListFiles( restoredDir, restoredFiles );
+    uint64_t differences = 0;
+
+    if( rv == 0 && listed )
+    {
+        std::vector<std::string> allFiles;
+
+        std::set_union( savedFiles.begin( ), savedFiles.end( ),
+                        restoredFiles.begin( ), restoredFiles.end( ),
+                        std::back_inserter( allFiles ) );
+
+        for( size_t i = 0; i < allFiles.size( ); i++ )
+        {
+            if( SameContents( savedDir + "/" + allFiles[i], restoredDir + "/" + allFiles[i] ) )
+                continue;
+
+            if( differences < 10 )
+                std::cout << "Differs after restore: " << allFiles[i] << std::endl;
+
+            differences++;
+        }
+    }
+
+    RemoveDirectory( savedDir );
+    RemoveDirectory( restoredDir );
+    RemoveDirectory( workDir );
+
+    if( rv != 0 )
+    {
+        std::cout << "Simulation failed with return code " << rv << "." << std::endl;
+        return rv;
+    }
+
+    if( !listed || savedFiles.empty( ) )
+    {
+        std::cout << "No checkpoint was written." << std::endl;
+        return 1;
+    }
+
+    if( differences != 0 )
+    {
+        std::cout << differences << " checkpoint files differ after a restore." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Checkpoint restores to the same state (" << savedFiles.size( )
+              << " files)." << std::endl;
+
+    return 0;
+}
+
+/*
+ *  Run traceMain with its output captured. Only what it says about the
+ *  checkpoint, such as requests that could not be saved, is passed through.
+ */
+int CheckpointCheck::Simulate( const std::string& configFile, const std::string& traceFile,
+                               const std::vector<std::string>& overrides )
+{
+    std::vector<std::string> args;
+
+    args.push_back( "nvmain" );
+    args.push_back( configFile );
+    args.push_back( traceFile );
+    args.push_back( "0" );
+    args.insert( args.end( ), overrides.begin( ), overrides.end( ) );
+
+    std::vector<char *> argv;
+    for( size_t i = 0; i < args.size( ); i++ )
+        argv.push_back( const_cast<char *>( args[i].c_str( ) ) );
+
+    srand( 1 );
+
+    std::stringstream output;
+    std::streambuf *console = std::cout.rdbuf( output.rdbuf( ) );
+
+    TraceMain *traceRunner = new TraceMain( );
+    int rv = traceRunner->RunTrace( static_cast<int>(argv.size( )), argv.data( ) );
+
+    std::cout.rdbuf( console );
+
+    std::string line;
+    while( std::getline( output, line ) )
+    {
+        if( line.find( "Warning" ) != std::string::npos
+            && line.find( "checkpoint" ) != std::string::npos )
+            std::cout << line << std::endl;
+    }
+
+    return rv;
+}
+
+bool CheckpointCheck::ListFiles( const std::string& dir, std::vector<std::string>& files )
+{
+    DIR *handle = opendir( dir.c_str( ) );
+
+    if( handle == NULL )
+        return false;
+
+    struct dirent *entry;
+    while( (entry = readdir( handle )) != NULL )
+    {
+        std::string name = entry->d_name;
+
+        if( name != "." && name != ".." )
+            files.push_back( name );
+    }
+
+    closedir( handle );
+
+    std::sort( files.begin( ), files.end( ) );
+
+    return true;
+}
+
+bool CheckpointCheck::SameContents( const std::string& file1, const std::string& file2 )
+{
+    std::ifstream handle1( file1.c_str( ), std::ifstream::binary );
+    std::ifstream handle2( file2.c_str( ), std::ifstream::binary );
+
+    if( !handle1.is_open( ) || !handle2.is_open( ) )
+        return false;
+
+    return std::equal( std::istreambuf_iterator<char>( handle1 ),
+                       std::istreambuf_iterator<char>( ),
+                       std::istreambuf_iterator<char>( handle2 ) )
+           && handle2.peek( ) == std::ifstream::traits_type::eof( );
+}
+
+void CheckpointCheck::RemoveDirectory( const std::string& dir )
+{
+    std::vector<std::string> files;
+
+    if( ListFiles( dir, files ) )
+    {
+        for( size_t i = 0; i < files.size( ); i++ )
+            std::remove( (dir + "/" + files[i]).c_str( ) );
+    }
+
+    rmdir( dir.c_str( ) );
+}
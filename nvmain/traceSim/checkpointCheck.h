@@ -0,0 +1,68 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+#ifndef __TRACESIM_CHECKPOINTCHECK_H__
+#define __TRACESIM_CHECKPOINTCHECK_H__
+
+#include <string>
+#include <vector>
+
+namespace NVM {
+
+/*
+ *  Check that a checkpoint restores the state it was saved from:
+ *
+ *    nvmain --check-checkpoint CONFIG_FILE REQUESTS [PARAM=value ...]
+ *
+ *  The synthetic trace of the parallel check is simulated by traceMain and
+ *  the drained memory is checkpointed. A fresh memory restores it and is
+ *  checkpointed again without running anything, which must give the same
+ *  files. Finally the trace is replayed on top of the restored state, so
+ *  that the migrators continue from restored tables.
+ */
+class CheckpointCheck
+{
+  public:
+    CheckpointCheck( );
+    ~CheckpointCheck( );
+
+    int Run( int argc, char *argv[] );
+
+  private:
+    int Simulate( const std::string& configFile, const std::string& traceFile,
+                  const std::vector<std::string>& overrides );
+    bool ListFiles( const std::string& dir, std::vector<std::string>& files );
+    bool SameContents( const std::string& file1, const std::string& file2 );
+    void RemoveDirectory( const std::string& dir );
+};
+
+};
+
+#endif
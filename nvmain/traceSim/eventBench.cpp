@@ -0,0 +1,207 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+
+#include "src/NVMObject.h"
+#include "traceSim/traceMain.h"
+#include "traceSim/eventBench.h"
+
+using namespace NVM;
+
+namespace {
+
+/* Recipient of the replayed events. */
+class EventSink : public NVMObject
+{
+  public:
+    EventSink( ) : cycles(0) { }
+
+    void Cycle( ncycle_t ) { cycles++; }
+
+    ncounter_t cycles;
+};
+
+const ncounter_t replayRepeats = 5;
+
+}
+
+EventBench::EventBench( )
+{
+
+}
+
+EventBench::~EventBench( )
+{
+
+}
+
+int EventBench::Run( int argc, char *argv[] )
+{
+    if( argc < 4 )
+    {
+        std::cout << "Usage: nvmain --bench-events CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]"
+            << std::endl;
+        return 1;
+    }
+
+    TraceMain *traceRunner = new TraceMain( );
+
+    traceRunner->RecordSchedule( &schedule );
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+    int rv = traceRunner->RunTrace( argc, argv );
+    std::chrono::duration<double> simulated = std::chrono::steady_clock::now( ) - start;
+
+    if( rv != 0 )
+        return rv;
+
+    /* Events can not be replayed into the past, so clamp those to now. */
+    ncounter_t nearEvents = 0;
+    EventSchedule::iterator it;
+    for( it = schedule.begin( ); it != schedule.end( ); it++ )
+    {
+        it->second = std::max( it->first, it->second );
+
+        if( it->second - it->first < 2048 )
+            nearEvents++;
+    }
+
+    std::cout << std::endl << "Recorded " << schedule.size( ) << " events in "
+              << simulated.count( ) << " s, "
+              << (schedule.empty( ) ? 0.0 : 100.0 * nearEvents / schedule.size( ))
+              << "% scheduled less than 2048 cycles ahead." << std::endl;
+
+    double queueTime = std::numeric_limits<double>::max( );
+    double mapTime = std::numeric_limits<double>::max( );
+    ncounter_t queueProcessed = 0, mapProcessed = 0;
+
+    for( ncounter_t repeat = 0; repeat < replayRepeats; repeat++ )
+    {
+        queueTime = std::min( queueTime, ReplayEventQueue( queueProcessed ) );
+        mapTime = std::min( mapTime, ReplayEventMap( mapProcessed ) );
+    }
+
+    double events = static_cast<double>(schedule.size( ));
+
+    std::cout << "EventQueue: " << queueProcessed << " events, "
+              << queueTime * 1e9 / events << " ns/event" << std::endl;
+    std::cout << "std::map:   " << mapProcessed << " events, "
+              << mapTime * 1e9 / events << " ns/event" << std::endl;
+    std::cout << "Speedup:    " << mapTime / queueTime << "x" << std::endl;
+
+    return 0;
+}
+
+double EventBench::ReplayEventQueue( ncounter_t& processed )
+{
+    EventSink sink;
+    NVMObject_hook hook( &sink );
+    EventQueue *queue = new EventQueue( );
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+
+    EventSchedule::const_iterator it;
+    for( it = schedule.begin( ); it != schedule.end( ); it++ )
+    {
+        if( it->first > queue->GetCurrentCycle( ) )
+            queue->Loop( it->first - queue->GetCurrentCycle( ) );
+
+        queue->InsertEvent( EventCycle, &hook, it->second );
+    }
+
+    while( queue->GetNextEvent( ) != std::numeric_limits<ncycle_t>::max( ) )
+        queue->Loop( queue->GetNextEvent( ) - queue->GetCurrentCycle( ) );
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now( ) - start;
+
+    delete queue;
+
+    processed = sink.cycles;
+
+    return elapsed.count( );
+}
+
+/* The std::map of event lists EventQueue was originally built on. */
+double EventBench::ReplayEventMap( ncounter_t& processed )
+{
+    EventSink sink;
+    NVMObject_hook hook( &sink );
+    std::map<ncycle_t, EventList> eventMap;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+
+    EventSchedule::const_iterator it = schedule.begin( );
+    while( it != schedule.end( ) || !eventMap.empty( ) )
+    {
+        if( !eventMap.empty( ) && (it == schedule.end( ) 
+            || eventMap.begin( )->first <= it->first) )
+        {
+            EventList& eventList = eventMap.begin( )->second;
+            EventList::iterator eit;
+
+            for( eit = eventList.begin( ); eit != eventList.end( ); eit++ )
+            {
+                (*eit)->GetRecipient( )->Cycle( 1 );
+                delete (*eit);
+            }
+
+            eventMap.erase( eventMap.begin( ) );
+            continue;
+        }
+
+        Event *event = new Event( );
+
+        event->SetType( EventCycle );
+        event->SetRecipient( &hook );
+        event->SetCycle( it->second );
+
+        EventList& eventList = eventMap[it->second];
+        EventList::iterator eit;
+
+        for( eit = eventList.begin( ); eit != eventList.end( ); eit++ )
+        {
+            if( (*eit)->GetPriority( ) > 0 )
+                break;
+        }
+
+        eventList.insert( eit, event );
+        it++;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now( ) - start;
+
+    processed = sink.cycles;
+
+    return elapsed.count( );
+}
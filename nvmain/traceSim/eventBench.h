@@ -0,0 +1,65 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __TRACESIM_EVENTBENCH_H__
+#define __TRACESIM_EVENTBENCH_H__
+
+#include "src/EventQueue.h"
+
+namespace NVM {
+
+/*
+ *  Event queue microbenchmark driven by a real trace:
+ *
+ *    nvmain --bench-events CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]
+ *
+ *  The trace is simulated once as usual while the event queue records when
+ *  each event was scheduled and for which cycle. That schedule is then
+ *  replayed against an empty EventQueue, and against a std::map of event
+ *  lists like the one EventQueue used to be, with handlers that do nothing,
+ *  so only the cost of the queues themselves is measured.
+ */
+class EventBench
+{
+  public:
+    EventBench( );
+    ~EventBench( );
+
+    int Run( int argc, char *argv[] );
+
+  private:
+    EventSchedule schedule;
+
+    double ReplayEventQueue( ncounter_t& processed );
+    double ReplayEventMap( ncounter_t& processed );
+};
+
+};
+
+#endif
@@ -0,0 +1,237 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+#include "include/NVMDataBlock.h"
+#include "traceReader/TraceLine.h"
+#include "traceSim/parallelCheck.h"
+#include "traceSim/traceMain.h"
+#include "traceWriter/NVMainTrace/NVMainTraceWriter.h"
+
+using namespace NVM;
+
+namespace {
+
+/* Requests stay within the smallest memory of the example configs. */
+const uint64_t traceSpan = 256 * 1024 * 1024;
+const uint64_t lineSize = 64;
+
+/* Stats are printed as `i<N>.<name> <value>'. */
+bool IsStatLine( const std::string& line )
+{
+    return line.size( ) > 2 && line[0] == 'i' 
+           && isdigit( static_cast<unsigned char>(line[1]) );
+}
+
+}
+
+ParallelCheck::ParallelCheck( )
+{
+
+}
+
+ParallelCheck::~ParallelCheck( )
+{
+
+}
+
+int ParallelCheck::Run( int argc, char *argv[] )
+{
+    uint64_t requests = (argc > 2) ? strtoull( argv[2], NULL, 10 ) : 0;
+
+    if( argc < 3 || requests == 0 )
+    {
+        std::cout << "Usage: nvmain --check-parallel CONFIG_FILE REQUESTS [PARAM=value ...]"
+            << std::endl;
+        return 1;
+    }
+
+    char traceName[] = "/tmp/nvmain-parallel-XXXXXX";
+    int traceFd = mkstemp( traceName );
+
+    if( traceFd < 0 )
+    {
+        std::cout << "Could not create a temporary trace file." << std::endl;
+        return 1;
+    }
+    close( traceFd );
+
+    WriteTrace( traceName, requests );
+
+    std::vector<std::string> overrides;
+
+    /* Two threads even on one core, so the channels really run in parallel. */
+    overrides.push_back( "ParallelThreads=2" );
+    for( int curArg = 3; curArg < argc; curArg++ )
+        overrides.push_back( argv[curArg] );
+    overrides.push_back( "TraceReader=NVMainTrace" );
+
+    std::vector<std::string> serial, parallel;
+    int rv;
+
+    overrides.push_back( "ParallelChannels=false" );
+    rv = Simulate( argv[1], traceName, overrides, serial );
+
+    if( rv == 0 )
+    {
+        overrides.back( ) = "ParallelChannels=true";
+        rv = Simulate( argv[1], traceName, overrides, parallel );
+    }
+
+    std::remove( traceName );
+
+    if( rv != 0 )
+    {
+        std::cout << "Simulation failed with return code " << rv << "." << std::endl;
+        return rv;
+    }
+
+    uint64_t differences = 0;
+
+    for( size_t i = 0; i < std::max( serial.size( ), parallel.size( ) ); i++ )
+    {
+        std::string serialLine = (i < serial.size( )) ? serial[i] : "(none)";
+        std::string parallelLine = (i < parallel.size( )) ? parallel[i] : "(none)";
+
+        if( serialLine == parallelLine )
+            continue;
+
+        if( differences < 10 )
+        {
+            std::cout << "Serial:   " << serialLine << std::endl
+                      << "Parallel: " << parallelLine << std::endl;
+        }
+
+        differences++;
+    }
+
+    if( differences != 0 || serial.empty( ) )
+    {
+        std::cout << differences << " of " << serial.size( ) 
+                  << " results differ between serial and parallel channels."
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "Serial and parallel channels give identical results ("
+              << serial.size( ) << " stats and end cycle)." << std::endl;
+
+    return 0;
+}
+
+void ParallelCheck::WriteTrace( const std::string& traceFile, uint64_t requests )
+{
+    std::mt19937_64 random( 1 );
+    NVMainTraceWriter writer;
+    NVMDataBlock data, oldData;
+    ncycle_t cycle = 0;
+    uint64_t address = 0;
+
+    writer.SetTraceFile( traceFile );
+    data.SetSize( lineSize );
+    oldData.SetSize( lineSize );
+
+    for( uint64_t i = 0; i < requests; i++ )
+    {
+        /* Sequential runs give row buffer hits, random lines give conflicts. */
+        if( random( ) % 4 == 0 )
+            address = (random( ) % (traceSpan / lineSize)) * lineSize;
+        else
+            address = (address + lineSize) % traceSpan;
+
+        for( uint64_t byte = 0; byte < lineSize; byte++ )
+        {
+            oldData.rawData[byte] = data.rawData[byte];
+            data.rawData[byte] = static_cast<uint8_t>(random( ));
+        }
+
+        /* Bursts back to back, so the queues fill, between quiet gaps. */
+        cycle += (random( ) % 16 == 0) ? random( ) % 200 : random( ) % 4;
+
+        TraceLine line;
+        NVMAddress lineAddress;
+        OpType operation = (random( ) % 3 == 0) ? WRITE : READ;
+
+        lineAddress.SetPhysicalAddress( address );
+        line.SetLine( lineAddress, operation, cycle, data, oldData, 0 );
+
+        writer.SetNextAccess( &line );
+    }
+}
+
+/*
+ *  Run traceMain with its output captured. The stat lines and the line
+ *  with the final cycle are kept, and the line saying how the channels
+ *  are run is passed through.
+ */
+int ParallelCheck::Simulate( const std::string& configFile, const std::string& traceFile,
+                             const std::vector<std::string>& overrides,
+                             std::vector<std::string>& results )
+{
+    std::vector<std::string> args;
+
+    args.push_back( "nvmain" );
+    args.push_back( configFile );
+    args.push_back( traceFile );
+    args.push_back( "0" );
+    args.insert( args.end( ), overrides.begin( ), overrides.end( ) );
+
+    std::vector<char *> argv;
+    for( size_t i = 0; i < args.size( ); i++ )
+        argv.push_back( const_cast<char *>( args[i].c_str( ) ) );
+
+    /* Endurance models draw from rand( ), give both runs the same numbers. */
+    srand( 1 );
+
+    std::stringstream output;
+    std::streambuf *console = std::cout.rdbuf( output.rdbuf( ) );
+
+    TraceMain *traceRunner = new TraceMain( );
+    int rv = traceRunner->RunTrace( static_cast<int>(argv.size( )), argv.data( ) );
+
+    std::cout.rdbuf( console );
+
+    std::string line;
+    while( std::getline( output, line ) )
+    {
+        if( IsStatLine( line ) || line.compare( 0, 16, "Exiting at cycle" ) == 0 )
+            results.push_back( line );
+        else if( line.compare( 0, 15, "NVMain: Running" ) == 0 )
+            std::cout << line << std::endl;
+    }
+
+    return rv;
+}
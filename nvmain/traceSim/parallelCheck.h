@@ -0,0 +1,70 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __TRACESIM_PARALLELCHECK_H__
+#define __TRACESIM_PARALLELCHECK_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace NVM {
+
+/*
+ *  Check that parallel channels do not change the simulation:
+ *
+ *    nvmain --check-parallel CONFIG_FILE REQUESTS [PARAM=value ...]
+ *
+ *  A synthetic trace of REQUESTS reads and writes, mixing sequential runs
+ *  with random lines, is simulated by traceMain once with ParallelChannels
+ *  off and once with it on, on two threads. Every stat and the cycle the
+ *  simulation ends at must be the same in both runs, or the check fails.
+ *  Configs that fall back to serial channels pass trivially; the message
+ *  saying which mode was used is echoed.
+ */
+class ParallelCheck
+{
+  public:
+    ParallelCheck( );
+    ~ParallelCheck( );
+
+    int Run( int argc, char *argv[] );
+
+    /* The synthetic trace, also replayed by the checkpoint check. */
+    static void WriteTrace( const std::string& traceFile, uint64_t requests );
+
+  private:
+    int Simulate( const std::string& configFile, const std::string& traceFile,
+                  const std::vector<std::string>& overrides,
+                  std::vector<std::string>& results );
+};
+
+};
+
+#endif
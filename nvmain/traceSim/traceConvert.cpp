@@ -0,0 +1,116 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <iostream>
+
+#include "src/Config.h"
+#include "traceReader/TraceReaderFactory.h"
+#include "traceWriter/TraceWriterFactory.h"
+#include "traceSim/traceConvert.h"
+
+using namespace NVM;
+
+TraceConvert::TraceConvert( )
+{
+
+}
+
+TraceConvert::~TraceConvert( )
+{
+
+}
+
+int TraceConvert::Convert( int argc, char *argv[] )
+{
+    if( argc < 3 )
+    {
+        std::cout << "Usage: nvmain --convert IN_TRACE OUT_TRACE [PARAM=value ...]" 
+            << std::endl;
+        return 1;
+    }
+
+    Config *config = new Config( );
+
+    config->SetValue( "TraceReader", "NVMainTrace" );
+    config->SetValue( "TraceWriter", "BinaryTrace" );
+
+    for( int curArg = 3; curArg < argc; ++curArg )
+    {
+        std::string clParam, clValue, clPair;
+
+        clPair = argv[curArg];
+        clParam = clPair.substr( 0, clPair.find_first_of("="));
+        clValue = clPair.substr( clPair.find_first_of("=") + 1, std::string::npos );
+
+        config->SetValue( clParam, clValue );
+    }
+
+    GenericTraceReader *reader = TraceReaderFactory::CreateNewTraceReader( 
+            config->GetString( "TraceReader" ) );
+    GenericTraceWriter *writer = TraceWriterFactory::CreateNewTraceWriter( 
+            config->GetString( "TraceWriter" ) );
+
+    if( reader == NULL || writer == NULL )
+    {
+        delete reader;
+        delete writer;
+        delete config;
+        return 1;
+    }
+
+    reader->SetTraceFile( argv[1] );
+    writer->Init( config );
+    writer->SetTraceFile( argv[2] );
+
+    TraceLine *tl = new TraceLine( );
+    uint64_t converted = 0;
+
+    while( reader->GetNextAccess( tl ) )
+    {
+        if( !writer->SetNextAccess( tl ) )
+        {
+            std::cout << "Could not write line " << converted 
+                << " to " << argv[2] << "!" << std::endl;
+            break;
+        }
+
+        converted++;
+    }
+
+    std::cout << "Converted " << converted << " accesses from " << argv[1]
+        << " to " << argv[2] << "." << std::endl;
+
+    /* Writers complete their trace when destroyed. */
+    delete tl;
+    delete writer;
+    delete reader;
+    delete config;
+
+    return 0;
+}
@@ -41,6 +41,7 @@
 #include "src/Config.h"
 #include "src/TranslationMethod.h"
 #include "traceReader/TraceReaderFactory.h"
+#include "traceReader/PrefetchingTraceReader.h"
 #include "src/AddressTranslator.h"
 #include "Decoders/DecoderFactory.h"
 #include "src/MemoryController.h"
@@ -52,11 +53,51 @@
 #include "src/EventQueue.h"
 #include "NVM/nvmain.h"
 #include "traceSim/traceMain.h"
+#include "traceSim/traceConvert.h"
+#include "traceSim/eventBench.h"
+#include "traceSim/bitBench.h"
+#include "traceSim/parallelCheck.h"
+#include "traceSim/checkpointCheck.h"
 
 using namespace NVM;
 
 int main( int argc, char *argv[] )
 {
+    if( argc > 1 && std::string( argv[1] ) == "--convert" )
+    {
+        TraceConvert converter;
+
+        return converter.Convert( argc - 1, argv + 1 );
+    }
+
+    if( argc > 1 && std::string( argv[1] ) == "--bench-events" )
+    {
+        EventBench bench;
+
+        return bench.Run( argc - 1, argv + 1 );
+    }
+
+    if( argc > 1 && std::string( argv[1] ) == "--bench-bits" )
+    {
+        BitBench bench;
+
+        return bench.Run( argc - 1, argv + 1 );
+    }
+
+    if( argc > 1 && std::string( argv[1] ) == "--check-parallel" )
+    {
+        ParallelCheck check;
+
+        return check.Run( argc - 1, argv + 1 );
+    }
+
+    if( argc > 1 && std::string( argv[1] ) == "--check-checkpoint" )
+    {
+        CheckpointCheck check;
+
+        return check.Run( argc - 1, argv + 1 );
+    }
+
     TraceMain *traceRunner = new TraceMain( );
 
     return traceRunner->RunTrace( argc, argv );
@@ -64,7 +105,8 @@ int main( int argc, char *argv[] )
 
 TraceMain::TraceMain( )
 {
-
+    schedule = NULL;
+    outstandingRequests = 0;
 }
 
 TraceMain::~TraceMain( )
@@ -76,21 +118,33 @@ int TraceMain::RunTrace( int argc, char *argv[] )
 {
     Stats *stats = new Stats( );
     Config *config = new Config( );
-    GenericTraceReader *trace = NULL;
-    TraceLine *tl = new TraceLine( );
+    PrefetchingTraceReader *trace = NULL;
+    TraceLine *tl = NULL;
     SimInterface *simInterface = new NullInterface( );
     NVMain *nvmain = new NVMain( );
     EventQueue *mainEventQueue = new EventQueue( );
     GlobalEventQueue *globalEventQueue = new GlobalEventQueue( );
     TagGenerator *tagGenerator = new TagGenerator( 1000 );
     bool IgnoreData = false;
+    bool IgnoreTraceCycle = false;
+    ncounter_t prefetchDepth = 16384;
 
     uint64_t simulateCycles;
     uint64_t currentCycle;
     
     if( argc < 4 )
     {
-        std::cout << "Usage: nvmain CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]" 
+        std::cout << "Usage: nvmain CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]"
+            << std::endl
+            << "       nvmain --convert IN_TRACE OUT_TRACE [PARAM=value ...]"
+            << std::endl
+            << "       nvmain --bench-events CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]"
+            << std::endl
+            << "       nvmain --bench-bits CONFIG_FILE [ROUNDS]"
+            << std::endl
+            << "       nvmain --check-parallel CONFIG_FILE REQUESTS [PARAM=value ...]"
+            << std::endl
+            << "       nvmain --check-checkpoint CONFIG_FILE REQUESTS [PARAM=value ...]"
             << std::endl;
         return 1;
     }
@@ -105,6 +159,7 @@ int TraceMain::RunTrace( int argc, char *argv[] )
 
     config->Read( argv[1] );
     config->SetSimInterface( simInterface );
+    mainEventQueue->RecordSchedule( schedule );
     SetEventQueue( mainEventQueue );
     SetGlobalEventQueue( globalEventQueue );
     SetStats( stats );
@@ -139,6 +194,23 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         IgnoreData = true;
     }
 
+    /* 
+     * If you want to ignore the cycles used in the trace file, set
+     * IgnoreTraceCycle to true and every request is issued as soon as
+     * possible.
+     */
+    if( config->KeyExists( "IgnoreTraceCycle" ) 
+            && config->GetString( "IgnoreTraceCycle" ) == "true" )
+    {
+        IgnoreTraceCycle = true;
+    }
+
+    /* Trace lines decoded ahead on a background thread, 0 to disable. */
+    if( config->KeyExists( "TracePrefetchDepth" ) )
+    {
+        prefetchDepth = config->GetValue( "TracePrefetchDepth" );
+    }
+
     /*  Add any specified hooks */
     std::vector<std::string>& hookList = config->GetHooks( );
 
@@ -170,15 +242,24 @@ int TraceMain::RunTrace( int argc, char *argv[] )
     simInterface->SetConfig( config, true );
     nvmain->SetConfig( config, "defaultMemory", true );
 
+    /* Continue from the state a previous run saved with CheckpointDirectory. */
+    if( config->KeyExists( "RestoreCheckpointDirectory" ) )
+        nvmain->RestoreCheckpoint( config->GetString( "RestoreCheckpointDirectory" ) );
+
+    std::ostream& refStream = (statStream.is_open()) ? statStream : std::cout;
+    nvmain->EnableIntervalStats( &refStream );
+
     std::cout << "traceMain (" << (void*)(this) << ")" << std::endl;
     nvmain->PrintHierarchy( );
 
+    GenericTraceReader *reader = NULL;
     if( config->KeyExists( "TraceReader" ) )
-        trace = TraceReaderFactory::CreateNewTraceReader( 
+        reader = TraceReaderFactory::CreateNewTraceReader( 
                 config->GetString( "TraceReader" ) );
     else
-        trace = TraceReaderFactory::CreateNewTraceReader( "NVMainTrace" );
+        reader = TraceReaderFactory::CreateNewTraceReader( "NVMainTrace" );
 
+    trace = new PrefetchingTraceReader( reader, prefetchDepth );
     trace->SetTraceFile( argv[2] );
 
     if( argc == 3 )
@@ -200,7 +281,8 @@ int TraceMain::RunTrace( int argc, char *argv[] )
     currentCycle = 0;
     while( currentCycle <= simulateCycles || simulateCycles == 0 )
     {
-        if( !trace->GetNextAccess( tl ) )
+        tl = trace->NextLine( );
+        if( tl == NULL )
         {
             /* Force all modules to drain requests. */
             bool draining = Drain( );
@@ -223,7 +305,7 @@ int TraceMain::RunTrace( int argc, char *argv[] )
             break;
         }
 
-        NVMainRequest *request = new NVMainRequest( );
+        NVMainRequest *request = requestPool.Allocate( );
         
         request->address = tl->GetAddress( );
         request->type = tl->GetOperation( );
@@ -234,14 +316,7 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         request->status = MEM_REQUEST_INCOMPLETE;
         request->owner = (NVMObject *)this;
         
-        /* 
-         * If you want to ignore the cycles used in the trace file, just set
-         * the cycle to 0. 
-         */
-        if( config->KeyExists( "IgnoreTraceCycle" ) 
-                && config->GetString( "IgnoreTraceCycle" ) == "true" )
-            tl->SetLine( tl->GetAddress( ), tl->GetOperation( ), 0, 
-                         tl->GetData( ), tl->GetOldData( ), tl->GetThreadId( ) );
+        ncycle_t lineCycle = IgnoreTraceCycle ? 0 : tl->GetCycle( );
 
         if( request->type != READ && request->type != WRITE )
             std::cout << "traceMain: Unknown Operation: " << request->type 
@@ -251,7 +326,7 @@ int TraceMain::RunTrace( int argc, char *argv[] )
          * If the next operation occurs after the requested number of cycles,
          * we can quit. 
          */
-        if( tl->GetCycle( ) > simulateCycles && simulateCycles != 0 )
+        if( lineCycle > simulateCycles && simulateCycles != 0 )
         {
             globalEventQueue->Cycle( simulateCycles - currentCycle );
             currentCycle += simulateCycles - currentCycle;
@@ -266,9 +341,9 @@ int TraceMain::RunTrace( int argc, char *argv[] )
              *  memory *  simulator, so the cycles may not match up. Otherwise, 
              *  we need to wait.
              */
-            if( tl->GetCycle( ) > currentCycle )
+            if( lineCycle > currentCycle )
             {
-                globalEventQueue->Cycle( tl->GetCycle() - currentCycle );
+                globalEventQueue->Cycle( lineCycle - currentCycle );
                 currentCycle = globalEventQueue->GetCurrentCycle( );
 
                 if( currentCycle >= simulateCycles && simulateCycles != 0 )
@@ -296,8 +371,11 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         }
     }       
 
+    /* Requests still in flight are not saved, see NVMain::CreateCheckpoint. */
+    if( config->KeyExists( "CheckpointDirectory" ) )
+        nvmain->CreateCheckpoint( config->GetString( "CheckpointDirectory" ) );
+
     GetChild( )->CalculateStats( );
-    std::ostream& refStream = (statStream.is_open()) ? statStream : std::cout;
     stats->PrintAll( refStream );
 
     std::cout << "Exiting at cycle " << currentCycle << " because simCycles " 
@@ -306,6 +384,7 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         std::cout << "Note: " << outstandingRequests << " requests still in-flight."
                   << std::endl;
 
+    delete trace;
     delete config;
     delete stats;
 
@@ -324,7 +403,7 @@ bool TraceMain::RequestComplete( NVMainRequest* request )
 
     outstandingRequests--;
 
-    delete request;
+    requestPool.Release( request );
 
     return true;
 }
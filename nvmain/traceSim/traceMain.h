@@ -38,6 +38,8 @@
 
 
 #include "src/NVMObject.h"
+#include "src/EventQueue.h"
+#include "include/NVMainRequestPool.h"
 
 
 namespace NVM {
@@ -55,8 +57,12 @@ class TraceMain : public NVMObject
 
     bool RequestComplete( NVMainRequest *request );
 
+    void RecordSchedule( EventSchedule *sched ) { schedule = sched; }
+
   private:
+    EventSchedule *schedule;
     ncounter_t outstandingRequests;
+    NVMainRequestPool requestPool;
 };
 
 
@@ -0,0 +1,196 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "traceWriter/BinaryTrace/BinaryTraceWriter.h"
+#include <cstring>
+
+using namespace NVM;
+
+/* Number of records staged before they are written out. */
+static const uint64_t flushRecords = 16384;
+
+BinaryTraceWriter::BinaryTraceWriter( )
+{
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, BinaryTraceMagic, sizeof(header.magic) );
+    header.version = BinaryTraceVersion;
+    header.flags = BinaryTraceHasData;
+
+    lastAddress = 0;
+    bufferedRecords = 0;
+}
+
+BinaryTraceWriter::~BinaryTraceWriter( )
+{
+    if( trace.is_open( ) )
+    {
+        if( header.recordSize == 0 )
+            SetDataSize( 0 );
+
+        Flush( );
+        WriteHeader( );
+        trace.close( );
+    }
+}
+
+void BinaryTraceWriter::Init( Config *conf )
+{
+    if( conf->KeyExists( "BinaryTraceDeltaAddress" ) 
+        && conf->GetString( "BinaryTraceDeltaAddress" ) == "true" )
+        header.flags |= BinaryTraceDeltaAddress;
+
+    if( conf->KeyExists( "BinaryTraceData" ) 
+        && conf->GetString( "BinaryTraceData" ) == "false" )
+        header.flags &= ~BinaryTraceHasData;
+}
+
+void BinaryTraceWriter::SetTraceFile( std::string file )
+{
+    // Note: This function assumes an absolute path is given, otherwise
+    // the current directory is used. 
+
+    traceFile = file;
+
+    trace.open( traceFile.c_str( ), std::ofstream::out | std::ofstream::binary 
+                                    | std::ofstream::trunc );
+
+    if( !trace.is_open( ) )
+    {
+        std::cout << "Warning: Could not open trace file " << file
+                  << ". Output will be suppressed." << std::endl;
+        return;
+    }
+
+    /* Reserve room for the header, completed on destruction. */
+    WriteHeader( );
+}
+
+std::string BinaryTraceWriter::GetTraceFile( )
+{
+    return traceFile;
+}
+
+void BinaryTraceWriter::WriteHeader( )
+{
+    std::streampos end = trace.tellp( );
+
+    trace.seekp( 0 );
+    trace.write( reinterpret_cast<const char *>(&header), sizeof(header) );
+    if( end > (std::streampos)sizeof(header) )
+        trace.seekp( end );
+}
+
+void BinaryTraceWriter::SetDataSize( uint64_t size )
+{
+    header.recordSize = sizeof(BinaryTraceRecord);
+    if( header.flags & BinaryTraceHasData )
+    {
+        header.dataSize = (size != 0) ? size : 64;
+        header.recordSize += 2 * header.dataSize;
+    }
+}
+
+void BinaryTraceWriter::Flush( )
+{
+    if( buffer.empty( ) )
+        return;
+
+    trace.write( reinterpret_cast<const char *>(&buffer[0]), buffer.size( ) );
+    buffer.clear( );
+    bufferedRecords = 0;
+}
+
+void BinaryTraceWriter::CopyData( uint8_t *dest, NVMDataBlock& data )
+{
+    uint64_t size = data.IsValid( ) ? data.GetSize( ) : 0;
+
+    if( size > header.dataSize )
+        size = header.dataSize;
+
+    if( size > 0 )
+        memcpy( dest, data.rawData, size );
+    memset( dest + size, 0, header.dataSize - size );
+}
+
+bool BinaryTraceWriter::SetNextAccess( TraceLine *nextAccess )
+{
+    /* Only write reads or writes. */
+    if( nextAccess->GetOperation( ) != READ 
+        && nextAccess->GetOperation( ) != WRITE )
+        return false;
+
+    uint64_t address = nextAccess->GetAddress( ).GetPhysicalAddress( );
+
+    if( this->GetEcho( ) )
+    {
+        std::cout << nextAccess->GetCycle( ) << " " 
+                  << (nextAccess->GetOperation( ) == READ ? "R " : "W ")
+                  << std::hex << "0x" << address << std::dec << " " 
+                  << nextAccess->GetThreadId( ) << std::endl;
+    }
+
+    if( !trace.is_open( ) )
+        return this->GetEcho( );
+
+    /* The block size is fixed by the first record. */
+    if( header.recordSize == 0 )
+    {
+        SetDataSize( nextAccess->GetData( ).GetSize( ) );
+        buffer.reserve( flushRecords * header.recordSize );
+    }
+
+    BinaryTraceRecord record;
+
+    memset( &record, 0, sizeof(record) );
+    record.cycle = nextAccess->GetCycle( );
+    record.address = address;
+    if( header.flags & BinaryTraceDeltaAddress )
+        record.address = address - lastAddress;
+    record.threadId = static_cast<uint32_t>(nextAccess->GetThreadId( ));
+    record.operation = (nextAccess->GetOperation( ) == READ) 
+                     ? BinaryTraceRead : BinaryTraceWrite;
+    lastAddress = address;
+
+    size_t offset = buffer.size( );
+    buffer.resize( offset + header.recordSize );
+    memcpy( &buffer[offset], &record, sizeof(record) );
+
+    if( header.flags & BinaryTraceHasData )
+    {
+        uint8_t *data = &buffer[offset + sizeof(record)];
+        CopyData( data, nextAccess->GetData( ) );
+        CopyData( data + header.dataSize, nextAccess->GetOldData( ) );
+    }
+
+    header.recordCount++;
+    if( ++bufferedRecords == flushRecords )
+        Flush( );
+
+    return trace.good( );
+}
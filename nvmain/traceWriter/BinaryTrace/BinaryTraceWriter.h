@@ -0,0 +1,81 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __BINARYTRACEWRITER_H__
+#define __BINARYTRACEWRITER_H__
+
+#include "traceWriter/GenericTraceWriter.h"
+#include "traceReader/BinaryTrace/BinaryTraceFormat.h"
+#include <string>
+#include <iostream>
+#include <fstream>
+
+namespace NVM {
+
+/*
+ *  Writes binary traces (see BinaryTraceFormat.h). Records are staged in a
+ *  buffer and written in large chunks; the header is completed with the
+ *  record count once the writer is destroyed.
+ *
+ *  Configuration keys:
+ *    BinaryTraceDeltaAddress - store address deltas (default false)
+ *    BinaryTraceData         - store data blocks (default true)
+ */
+class BinaryTraceWriter : public GenericTraceWriter
+{
+  public:
+    BinaryTraceWriter( );
+    ~BinaryTraceWriter( );
+
+    void Init( Config *conf );
+    
+    void SetTraceFile( std::string file );
+    std::string GetTraceFile( );
+    
+    bool SetNextAccess( TraceLine *nextAccess );
+  
+  private:
+    std::string traceFile;
+    std::ofstream trace;
+
+    BinaryTraceHeader header;
+    uint64_t lastAddress;
+
+    std::vector<uint8_t> buffer;
+    uint64_t bufferedRecords;
+
+    void SetDataSize( uint64_t size );
+    void Flush( );
+    void WriteHeader( );
+    void CopyData( uint8_t *dest, NVMDataBlock& data );
+};
+
+};
+
+#endif
@@ -43,7 +43,10 @@ from m5.params import *
 from m5.proxy import *
 from MemObject import MemObject
 from Prefetcher import BasePrefetcher
+from ReplacementPolicies import *
 from Tags import *
+from UtilityMonitor import UtilityMonitor
+from WayPartitioner import WayPartitioner
 
 class BaseCache(MemObject):
     type = 'BaseCache'
@@ -70,9 +73,20 @@ class BaseCache(MemObject):
     prefetch_on_access = Param.Bool(False,
          "Notify the hardware prefetcher on every access (not just misses)")
 
-    tags = Param.BaseTags(LRU(), "Tag store (replacement policy)")
+    utility_monitor = Param.UtilityMonitor(NULL,
+        "Shadow-tag utility monitor attached to cache")
+    partitioner = Param.WayPartitioner(NULL,
+        "Way partitioning between masters, set-associative tags only")
+
+    tags = Param.BaseTags(BaseSetAssoc(), "Tag store")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy")
+    tech_map = Param.MemoryTechnologyMap(NULL,
+        "DRAM/NVM classification used by technology-aware policies")
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
+    packed_tags = Param.Bool(False,
+        "Whether to look tags up in packed per-set arrays")
 
     cpu_side = SlavePort("Upstream port closer to the CPU and/or device")
     mem_side = MasterPort("Downstream port closer to memory")
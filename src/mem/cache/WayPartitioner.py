@@ -0,0 +1,48 @@
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+from m5.params import *
+from m5.proxy import *
+from ClockedObject import ClockedObject
+
+class WayPartitioningMode(Enum): vals = ['static_masks', 'ucp']
+
+class WayPartitioner(ClockedObject):
+    type = 'WayPartitioner'
+    cxx_header = "mem/cache/way_partitioner.hh"
+    system = Param.System(Parent.any, "System the cache belongs to")
+
+    # Get the associativity and the utility monitor from the parent (cache)
+    assoc = Param.Unsigned(Parent.assoc, "Associativity of the cache")
+    utility_monitor = Param.UtilityMonitor(Parent.utility_monitor,
+        "Utility monitor driving UCP repartitionings")
+
+    partitions = VectorParam.String(
+        "Master name prefixes of each partition, e.g. 'system.cpu0'")
+    mode = Param.WayPartitioningMode('static_masks',
+        "Keep the given masks or repartition with UCP")
+    way_masks = VectorParam.UInt64([],
+        "Way mask of each partition in static mode, even split if empty")
+    interval = Param.Cycles(5000000, "Cycles between UCP repartitionings")
@@ -49,11 +49,14 @@
 #define __MEM_CACHE_BLK_HH__
 
 #include <list>
+#include <memory>
 
 #include "base/printable.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
+struct ReplacementData;
+
 /**
  * Cache block status bit assignments
  */
@@ -99,15 +102,7 @@ class CacheBlk
 
     /** block state: OR of CacheBlkStatusBit */
     typedef unsigned State;
-	/**
-     * The memory type of the blk data.
-     * 0: DRAM
-     * 1: NVM  
-     */
-    int type;
-   
-    int rrpv;//stx-rrip 
-    int hit_count;//stx进入缓存后其他块的命中数
+
     /** The current status of this block. @sa CacheBlockStatusBits */
     State status;
 
@@ -131,6 +126,9 @@ class CacheBlk
 
     Tick tickInserted;
 
+    /** Replacement data, owned by the tag store's replacement policy. */
+    std::shared_ptr<ReplacementData> replacementData;
+
   protected:
     /**
      * Represents that the indicated thread context has a "lock" on
@@ -177,7 +175,7 @@ class CacheBlk
 
     CacheBlk()
         : task_id(ContextSwitchTaskId::Unknown),
-          asid(-1), tag(0), data(0) ,size(0), type(-1), rrpv(0), hit_count(0), status(0), whenReady(0),
+          asid(-1), tag(0), data(0), size(0), status(0), whenReady(0),
           set(-1), way(-1), isTouched(false), refCount(0),
           srcMasterId(Request::invldMasterId),
           tickInserted(0)
@@ -62,12 +62,14 @@
 #include "mem/cache/blk.hh"
 #include "mem/cache/mshr.hh"
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache/utility_monitor.hh"
 #include "sim/sim_exit.hh"
 
 Cache::Cache(const CacheParams *p)
     : BaseCache(p, p->system->cacheLineSize()),
       tags(p->tags),
       prefetcher(p->prefetcher),
+      utilityMonitor(p->utility_monitor),
       doFastWrites(true),
       prefetchOnAccess(p->prefetch_on_access),
       clusivity(p->clusivity),
@@ -330,6 +332,10 @@ Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
             pkt->getAddr(), pkt->getSize(), pkt->isSecure() ? "s" : "ns",
             blk ? "hit " + blk->print() : "miss");
 
+    // Writebacks and clean evictions are not demand accesses
+    if (utilityMonitor && !pkt->isEviction()) {
+        utilityMonitor->access(pkt);
+    }
 
     if (pkt->isEviction()) {
         // We check for presence of block in above caches before issuing
@@ -387,7 +393,8 @@ Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
 
         if (blk == nullptr) {
             // need to do a replacement
-            blk = allocateBlock(pkt->getAddr(), pkt->isSecure(), writebacks);
+            blk = allocateBlock(pkt->getAddr(), pkt->isSecure(),
+                                pkt->req->masterId(), writebacks);
             if (blk == nullptr) {
                 // no replaceable block available: give up, fwd to next level.
                 incMissCount(pkt);
@@ -1667,9 +1674,10 @@ Cache::invalidateVisitor(CacheBlk &blk)
 }
 
 CacheBlk*
-Cache::allocateBlock(Addr addr, bool is_secure, PacketList &writebacks)
+Cache::allocateBlock(Addr addr, bool is_secure, MasterID master_id,
+                     PacketList &writebacks)
 {
-    CacheBlk *blk = tags->findVictim(addr);
+    CacheBlk *blk = tags->findVictim(addr, master_id);
 
     // It is valid to return nullptr if there is no victim
     if (!blk)
@@ -1748,7 +1756,9 @@ Cache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
 
         // need to do a replacement if allocating, otherwise we stick
         // with the temporary storage
-        blk = allocate ? allocateBlock(addr, is_secure, writebacks) : nullptr;
+        blk = allocate ?
+            allocateBlock(addr, is_secure, pkt->req->masterId(), writebacks) :
+            nullptr;
 
         if (blk == nullptr) {
             // No replaceable block or a mostly exclusive
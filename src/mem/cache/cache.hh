@@ -63,6 +63,7 @@
 
 //Forward decleration
 class BasePrefetcher;
+class UtilityMonitor;
 
 /**
  * A template-policy based cache. The behavior of the cache can be altered by
@@ -194,6 +195,9 @@ class Cache : public BaseCache
     /** Prefetcher */
     BasePrefetcher *prefetcher;
 
+    /** Utility monitor, if any */
+    UtilityMonitor *utilityMonitor;
+
     /** Temporary cache block for occasional transitory use */
     CacheBlk *tempBlock;
 
@@ -289,11 +293,12 @@ class Cache : public BaseCache
     /**
      * Find a block frame for new block at address addr targeting the
      * given security space, assuming that the block is not currently
-     * in the cache.  Append writebacks if any to provided packet
-     * list.  Return free block frame.  May return nullptr if there are
-     * no replaceable blocks at the moment.
+     * in the cache, on behalf of the given master.  Append writebacks
+     * if any to provided packet list.  Return free block frame.  May
+     * return nullptr if there are no replaceable blocks at the moment.
      */
-    CacheBlk *allocateBlock(Addr addr, bool is_secure, PacketList &writebacks);
+    CacheBlk *allocateBlock(Addr addr, bool is_secure, MasterID master_id,
+                            PacketList &writebacks);
 
     /**
      * Invalidate a cache block.
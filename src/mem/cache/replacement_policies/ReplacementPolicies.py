@@ -0,0 +1,145 @@
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+# Layout of the leader sets within each constituency: 'modulo' dedicates the
+# first sets of every constituency, 'spread' strides the leaders over the
+# constituency and rotates them from one constituency to the next.
+class SetDuelingSelection(Enum): vals = ['modulo', 'spread']
+
+class SetDueling(SimObject):
+    type = 'SetDueling'
+    cxx_class = 'SetDueling'
+    cxx_header = "mem/cache/replacement_policies/set_dueling.hh"
+    num_policies = Param.Unsigned(2, "Number of competing policies")
+    num_cores = Param.Unsigned(1,
+        "Number of cores with their own leader sets and selectors")
+    constituency_size = Param.Unsigned(32,
+        "Sets holding one leader per policy and core")
+    selection = Param.SetDuelingSelection('modulo',
+        "Layout of the leader sets within a constituency")
+    selector_bits = Param.Unsigned(10,
+        "Width of the saturating policy selectors")
+
+class BaseReplacementPolicy(SimObject):
+    type = 'BaseReplacementPolicy'
+    abstract = True
+    cxx_header = "mem/cache/replacement_policies/base.hh"
+
+class LRURP(BaseReplacementPolicy):
+    type = 'LRURP'
+    cxx_class = 'LRURP'
+    cxx_header = "mem/cache/replacement_policies/lru_rp.hh"
+
+class LFURP(BaseReplacementPolicy):
+    type = 'LFURP'
+    cxx_class = 'LFURP'
+    cxx_header = "mem/cache/replacement_policies/lfu_rp.hh"
+
+class TreePLRURP(BaseReplacementPolicy):
+    type = 'TreePLRURP'
+    cxx_class = 'TreePLRURP'
+    cxx_header = "mem/cache/replacement_policies/tree_plru_rp.hh"
+    assoc = Param.Unsigned(Parent.assoc, "Number of ways per set")
+
+class AgeLRURP(BaseReplacementPolicy):
+    type = 'AgeLRURP'
+    cxx_class = 'AgeLRURP'
+    cxx_header = "mem/cache/replacement_policies/age_lru_rp.hh"
+    assoc = Param.Unsigned(Parent.assoc, "Number of ways per set")
+
+class RandomRP(BaseReplacementPolicy):
+    type = 'RandomRP'
+    cxx_class = 'RandomRP'
+    cxx_header = "mem/cache/replacement_policies/random_rp.hh"
+
+class RRIPRP(BaseReplacementPolicy):
+    type = 'RRIPRP'
+    cxx_class = 'RRIPRP'
+    cxx_header = "mem/cache/replacement_policies/rrip_rp.hh"
+    assoc = Param.Unsigned(Parent.assoc, "Number of ways per set")
+    num_bits = Param.Unsigned(3, "Number of bits per re-reference prediction")
+    dram_hit_promotion = Param.Unsigned(3,
+        "RRPV decrement on a hit to a DRAM-backed block")
+    nvm_hit_promotion = Param.Unsigned(7,
+        "RRPV decrement on a hit to an NVM-backed block")
+    prefer_clean = Param.Bool(True,
+        "Break victim ties in favour of clean blocks")
+
+class TRRIPRP(RRIPRP):
+    type = 'TRRIPRP'
+    cxx_class = 'TRRIPRP'
+    cxx_header = "mem/cache/replacement_policies/rrip_rp.hh"
+    bimodal_interval = Param.Unsigned(80,
+        "Set accesses between two near-immediate insertions")
+    prefer_clean = False
+    dueling = Param.SetDueling(NULL,
+        "Duels static (policy 0) against bimodal (policy 1) insertion")
+
+class DRRIPRP(TRRIPRP):
+    type = 'DRRIPRP'
+    cxx_class = 'DRRIPRP'
+    cxx_header = "mem/cache/replacement_policies/rrip_rp.hh"
+    dueling = SetDueling()
+
+class StackRP(BaseReplacementPolicy):
+    type = 'StackRP'
+    abstract = True
+    cxx_class = 'StackRP'
+    cxx_header = "mem/cache/replacement_policies/stack_rp.hh"
+    assoc = Param.Unsigned(Parent.assoc, "Number of ways per set")
+
+class WBARRP(StackRP):
+    type = 'WBARRP'
+    cxx_class = 'WBARRP'
+    cxx_header = "mem/cache/replacement_policies/wbar_rp.hh"
+
+class CostAwareRP(StackRP):
+    type = 'CostAwareRP'
+    cxx_class = 'CostAwareRP'
+    cxx_header = "mem/cache/replacement_policies/cost_rp.hh"
+    # Defaults are the closed-page miss latencies, in ns, of the NVMain
+    # hybrid channel configurations
+    dram_read_cost = Param.Float(36.0, "Cost of refetching a DRAM block")
+    dram_write_cost = Param.Float(40.5, "Cost of writing back a DRAM block")
+    nvm_read_cost = Param.Float(42.0, "Cost of refetching an NVM block")
+    nvm_write_cost = Param.Float(136.4, "Cost of writing back an NVM block")
+
+class TrashRP(StackRP):
+    type = 'TrashRP'
+    cxx_class = 'TrashRP'
+    cxx_header = "mem/cache/replacement_policies/trash_rp.hh"
+    bimodal_interval = Param.Unsigned(23,
+        "Set accesses between two MRU insertions")
+    dueling = Param.SetDueling(NULL,
+        "Duels Trash (policy 0) against MRU (policy 1) insertion")
+
+class LFriendRP(StackRP):
+    type = 'LFriendRP'
+    cxx_class = 'LFriendRP'
+    cxx_header = "mem/cache/replacement_policies/lfriend_rp.hh"
@@ -0,0 +1,128 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of an age counter Least Recently Used replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/age_lru_rp.hh"
+
+#include <cassert>
+
+#include "base/misc.hh"
+
+AgeLRURP::AgeLRURP(const Params *p)
+    : BaseReplacementPolicy(p), assoc(p->assoc), numInstantiated(0)
+{
+    fatal_if(assoc == 0, "Age LRU needs at least one way per set");
+}
+
+void
+AgeLRURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    const AgeLRUReplData &data = getData(replacement_data);
+
+    // Every other way is now more recent than this one
+    data.set->stamps[data.way] = --data.set->oldest;
+}
+
+void
+AgeLRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    const AgeLRUReplData &data = getData(replacement_data);
+
+    // This way is now more recent than every other one
+    data.set->stamps[data.way] = ++data.set->newest;
+}
+
+void
+AgeLRURP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+                const PacketPtr pkt, bool nvm)
+{
+    touch(replacement_data);
+}
+
+CacheBlk*
+AgeLRURP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    const std::vector<int64_t> &stamps = getData(
+        candidates[0]->replacementData).set->stamps;
+
+    // Candidates usually are the whole set, in which case the oldest way
+    // is found from the stamps alone
+    if (candidates.size() == assoc) {
+        // Selects rather than branches, as which way is oldest is random
+        unsigned way = 0;
+        int64_t oldest = stamps[0];
+        for (unsigned i = 1; i < assoc; i++) {
+            const bool older = stamps[i] < oldest;
+            way = older ? i : way;
+            oldest = older ? stamps[i] : oldest;
+        }
+
+        if (getData(candidates[way]->replacementData).way == way)
+            return candidates[way];
+        for (const auto& candidate : candidates) {
+            if (getData(candidate->replacementData).way == way)
+                return candidate;
+        }
+        panic("Age LRU victim way %d is not a candidate", way);
+    }
+
+    CacheBlk* victim = candidates[0];
+    int64_t victim_stamp = stamps[getData(victim->replacementData).way];
+    for (const auto& candidate : candidates) {
+        const int64_t stamp = stamps[getData(candidate->replacementData).way];
+        if (stamp < victim_stamp) {
+            victim = candidate;
+            victim_stamp = stamp;
+        }
+    }
+    return victim;
+}
+
+std::shared_ptr<ReplacementData>
+AgeLRURP::instantiateEntry()
+{
+    // Blocks are instantiated set after set, start a new set every assoc
+    // entries
+    const unsigned way = numInstantiated % assoc;
+    if (way == 0)
+        instantiatedSet = std::make_shared<AgeSet>(assoc);
+    numInstantiated++;
+
+    return std::shared_ptr<ReplacementData>(
+        new AgeLRUReplData(instantiatedSet, way));
+}
+
+AgeLRURP*
+AgeLRURPParams::create()
+{
+    return new AgeLRURP(this);
+}
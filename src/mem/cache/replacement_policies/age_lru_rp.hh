@@ -0,0 +1,129 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of an age counter Least Recently Used replacement policy.
+ *
+ * Each set keeps one age stamp per way in a contiguous array, and two
+ * counters. Touching a way stamps it newer than every other way and
+ * invalidating one stamps it older than every other way, so both are a
+ * single word write whatever the associativity. The LRU candidate is the
+ * one with the oldest stamp; when the candidates are the whole set the
+ * stamps are scanned without going through the blocks.
+ *
+ * Unlike LRURP, which stamps blocks with the current tick, the order is
+ * exact even between accesses made in the same tick. Exact LRU needs more
+ * than log2(assoc!) bits per set, so the state cannot fit in one or two
+ * words beyond a few ways; TreePLRURP is the one word approximation.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_AGE_LRU_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_AGE_LRU_RP_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/AgeLRURP.hh"
+
+class AgeLRURP : public BaseReplacementPolicy
+{
+  protected:
+    /** State shared by all blocks of a set. */
+    struct AgeSet
+    {
+        /** Stamp of the most recently touched way. */
+        int64_t newest;
+
+        /** Stamp of the most recently invalidated way. */
+        int64_t oldest;
+
+        /** Age stamp of each way, higher is more recent. */
+        std::vector<int64_t> stamps;
+
+        AgeSet(unsigned assoc)
+            : newest(assoc - 1), oldest(0), stamps(assoc)
+        {
+            // Initially lower ways count as more recent than higher ones
+            for (unsigned way = 0; way < assoc; way++)
+                stamps[way] = assoc - 1 - way;
+        }
+    };
+
+    /** Age-LRU-specific implementation of replacement data. */
+    struct AgeLRUReplData : ReplacementData
+    {
+        /** The set this block belongs to. */
+        const std::shared_ptr<AgeSet> set;
+
+        /** The way of the block within its set. */
+        const unsigned way;
+
+        AgeLRUReplData(const std::shared_ptr<AgeSet>& _set, unsigned _way)
+            : set(_set), way(_way) {}
+    };
+
+    /** Number of ways per set. */
+    const unsigned assoc;
+
+    /** Number of entries instantiated so far. */
+    unsigned numInstantiated;
+
+    /** Set state handed to the entries being instantiated. */
+    std::shared_ptr<AgeSet> instantiatedSet;
+
+    /** Convenience accessor for the replacement data of a block. */
+    static AgeLRUReplData& getData(
+        const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return *static_cast<AgeLRUReplData*>(replacement_data.get());
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef AgeLRURPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    AgeLRURP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~AgeLRURP() {}
+
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_AGE_LRU_RP_HH__
@@ -0,0 +1,144 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the interface shared by all cache replacement policies.
+ *
+ * A replacement policy owns the per-block state it needs to rank blocks
+ * (recency, re-reference predictions, counters...). Each block of a tag
+ * store holds an opaque handle to that state, created by the policy through
+ * instantiateEntry(), so the tag store itself never has to know which policy
+ * it is composed with.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
+
+#include <memory>
+#include <vector>
+
+#include "mem/cache/blk.hh"
+#include "mem/packet.hh"
+#include "params/BaseReplacementPolicy.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Replacement data of a single block. Each policy derives its own data from
+ * this struct.
+ */
+struct ReplacementData {};
+
+/**
+ * Blocks a victim is picked from. All candidates must have replacement data
+ * instantiated by the same policy.
+ */
+typedef std::vector<CacheBlk*> ReplacementCandidates;
+
+/**
+ * A common base class of cache replacement policy objects.
+ */
+class BaseReplacementPolicy : public SimObject
+{
+  protected:
+    /**
+     * Advance a bimodal insertion throttle, as used by policies inserting
+     * most blocks with a low priority and a few with a high one.
+     *
+     * @param counter Accesses seen since the last high priority insertion.
+     * @param interval Accesses between two high priority insertions.
+     * @return True if this access is due a high priority insertion.
+     */
+    static bool bimodalTick(unsigned &counter, unsigned interval)
+    {
+        if (counter == interval)
+            counter = 0;
+        else
+            counter++;
+        return counter == interval;
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef BaseReplacementPolicyParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    BaseReplacementPolicy(const Params *p) : SimObject(p) {}
+
+    /**
+     * Destructor.
+     */
+    virtual ~BaseReplacementPolicy() {}
+
+    /**
+     * Invalidate replacement data, so that the block is preferred as a
+     * victim over every valid block.
+     *
+     * @param replacement_data Replacement data to be invalidated.
+     */
+    virtual void invalidate(
+        const std::shared_ptr<ReplacementData>& replacement_data) = 0;
+
+    /**
+     * Update replacement data on a hit.
+     *
+     * @param replacement_data Replacement data to be touched.
+     */
+    virtual void touch(
+        const std::shared_ptr<ReplacementData>& replacement_data) = 0;
+
+    /**
+     * Reset replacement data when a new block is inserted.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt The packet that caused the insertion.
+     * @param nvm True if the block is backed by non-volatile memory.
+     */
+    virtual void reset(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt, bool nvm) = 0;
+
+    /**
+     * Find a victim among the candidates. The caller is expected to have
+     * already filtered out invalid blocks.
+     *
+     * @param candidates Replacement candidates, must not be empty.
+     * @return The block to be evicted.
+     */
+    virtual CacheBlk* getVictim(const ReplacementCandidates& candidates) = 0;
+
+    /**
+     * Instantiate the replacement data of a block. Tag stores call this once
+     * per block, in set-major order, so that policies keeping per-set state
+     * can share it between the blocks of a set.
+     *
+     * @return A newly created replacement data.
+     */
+    virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
@@ -0,0 +1,116 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a cost-aware replacement policy for hybrid memories.
+ */
+
+#include "mem/cache/replacement_policies/cost_rp.hh"
+
+#include "mem/cache/blk.hh"
+
+CostAwareRP::CostAwareRP(const Params *p)
+    : StackRP(p),
+      readCost{p->dram_read_cost, p->nvm_read_cost},
+      writeCost{p->dram_write_cost, p->nvm_write_cost}
+{
+}
+
+CacheBlk*
+CostAwareRP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    CacheBlk* victim = nullptr;
+    unsigned victim_pos = 0;
+    double victim_cost = 0;
+    for (const auto& candidate : candidates) {
+        const StackReplData &data = getData(candidate->replacementData);
+        const unsigned pos = data.stack->position(data.way);
+
+        // Invalid blocks cost nothing to evict
+        if (!data.valid) {
+            return candidate;
+        }
+
+        const double cost = evictionCost(data.nvm, candidate->isDirty(), pos);
+        if (!victim || cost < victim_cost ||
+            (cost == victim_cost && pos > victim_pos)) {
+            victim = candidate;
+            victim_pos = pos;
+            victim_cost = cost;
+        }
+    }
+
+    const StackReplData &data = getData(victim->replacementData);
+    evictions[data.nvm]++;
+    evictionCosts[data.nvm] += victim_cost;
+    if (victim->isDirty()) {
+        writebacks[data.nvm]++;
+    }
+
+    return victim;
+}
+
+void
+CostAwareRP::regStats()
+{
+    StackRP::regStats();
+
+    evictions
+        .init(NumTechnologies)
+        .name(name() + ".evictions")
+        .desc("number of evictions per backing technology")
+        .subname(DRAM, "dram")
+        .subname(NVM, "nvm")
+        .flags(Stats::total)
+        ;
+
+    writebacks
+        .init(NumTechnologies)
+        .name(name() + ".writebacks")
+        .desc("number of dirty evictions per backing technology")
+        .subname(DRAM, "dram")
+        .subname(NVM, "nvm")
+        .flags(Stats::total)
+        ;
+
+    evictionCosts
+        .init(NumTechnologies)
+        .name(name() + ".eviction_costs")
+        .desc("expected cost of the evictions per backing technology")
+        .subname(DRAM, "dram")
+        .subname(NVM, "nvm")
+        .flags(Stats::total)
+        ;
+}
+
+CostAwareRP*
+CostAwareRPParams::create()
+{
+    return new CostAwareRP(this);
+}
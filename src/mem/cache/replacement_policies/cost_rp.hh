@@ -0,0 +1,107 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a cost-aware replacement policy for hybrid memories.
+ *
+ * The policy estimates, for every candidate, the cost the memory will pay if
+ * the block is evicted: dirty blocks have to be written back right away, and
+ * any block may have to be fetched again later. The refetch cost is weighted
+ * by a reuse estimate derived from the block position in the recency stack,
+ * so that clean DRAM-backed blocks near the LRU position go first while dirty
+ * NVM-backed blocks, whose writebacks are expensive, tend to stay cached.
+ * Read and write costs of each technology are parameters, usually derived
+ * from the NVMain channel configurations (see configs/common/NVMainCosts.py).
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_COST_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_COST_RP_HH__
+
+#include "base/statistics.hh"
+#include "mem/cache/replacement_policies/stack_rp.hh"
+#include "params/CostAwareRP.hh"
+
+class CostAwareRP : public StackRP
+{
+  protected:
+    /** Memory technologies the costs are given for. */
+    enum Technology { DRAM = 0, NVM = 1, NumTechnologies };
+
+    /** Cost of reading a block from each technology. */
+    const double readCost[NumTechnologies];
+
+    /** Cost of writing a block back to each technology. */
+    const double writeCost[NumTechnologies];
+
+    /**
+     * Expected cost of evicting a block.
+     *
+     * @param nvm Whether the block is backed by NVM.
+     * @param dirty Whether the block has to be written back.
+     * @param pos Position of the block in the recency stack.
+     * @return The writeback cost plus the weighted refetch cost.
+     */
+    double evictionCost(bool nvm, bool dirty, unsigned pos) const
+    {
+        // The reuse estimate decreases linearly from 1 at the MRU position
+        // to 1/assoc at the LRU position
+        const double reuse = double(assoc - pos) / assoc;
+        return (dirty ? writeCost[nvm] : 0) + reuse * readCost[nvm];
+    }
+
+    /** Number of evictions, per technology. */
+    Stats::Vector evictions;
+
+    /** Number of evictions of dirty blocks, per technology. */
+    Stats::Vector writebacks;
+
+    /** Total expected cost of the evictions, per technology. */
+    Stats::Vector evictionCosts;
+
+  public:
+    /** Convenience typedef. */
+    typedef CostAwareRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    CostAwareRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~CostAwareRP() {}
+
+    /**
+     * Evict the candidate with the lowest expected eviction cost, the one
+     * deepest in the stack on ties.
+     */
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+
+    void regStats() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_COST_RP_HH__
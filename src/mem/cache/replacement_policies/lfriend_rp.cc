@@ -0,0 +1,103 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the LFriend replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/lfriend_rp.hh"
+
+#include <algorithm>
+#include <cassert>
+
+LFriendRP::LFriendRP(const Params *p)
+    : StackRP(p), byPosition(p->assoc, nullptr)
+{
+}
+
+void
+LFriendRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    LFriendReplData &data =
+        *std::static_pointer_cast<LFriendReplData>(replacement_data);
+    LFriendStack &set = static_cast<LFriendStack&>(*data.stack);
+
+    // Every other block of the set ages by one hit
+    set.hits++;
+    data.lastHits = set.hits;
+    set.moveToHead(data.way);
+}
+
+void
+LFriendRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+                 const PacketPtr pkt, bool nvm)
+{
+    LFriendReplData &data =
+        *std::static_pointer_cast<LFriendReplData>(replacement_data);
+
+    data.lastHits = static_cast<LFriendStack&>(*data.stack).hits;
+    StackRP::reset(replacement_data, pkt, nvm);
+}
+
+CacheBlk*
+LFriendRP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // Order the candidates by stack position
+    std::fill(byPosition.begin(), byPosition.end(), nullptr);
+    for (const auto& candidate : candidates) {
+        const StackReplData &data = getData(candidate->replacementData);
+        byPosition[data.stack->position(data.way)] = candidate;
+    }
+
+    // Walk up from the bottom of the stack looking for an old enough
+    // block that can leave without costing an NVM write
+    CacheBlk* lru = nullptr;
+    for (int pos = assoc - 1; pos >= 0; --pos) {
+        CacheBlk* candidate = byPosition[pos];
+        if (!candidate)
+            continue;
+        if (!lru)
+            lru = candidate;
+
+        const LFriendReplData &data = *std::static_pointer_cast<
+            LFriendReplData>(candidate->replacementData);
+        const uint64_t age = static_cast<LFriendStack&>(*data.stack).hits -
+                             data.lastHits;
+        if (age + pos >= assoc - 1 && (!data.nvm || !candidate->isDirty()))
+            return candidate;
+    }
+
+    return lru;
+}
+
+LFriendRP*
+LFriendRPParams::create()
+{
+    return new LFriendRP(this);
+}
@@ -0,0 +1,102 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the LFriend replacement policy.
+ *
+ * LFriend is an LRU stack that protects dirty NVM-backed blocks from
+ * eviction, to save NVM writes. A block becomes evictable once its depth in
+ * the stack plus the number of hits the rest of its set received since it
+ * was last touched reaches the bottom of the stack; among those, the deepest
+ * DRAM-backed or clean block is evicted. If there is none, plain LRU applies.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_LFRIEND_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_LFRIEND_RP_HH__
+
+#include "mem/cache/replacement_policies/stack_rp.hh"
+#include "params/LFriendRP.hh"
+
+class LFriendRP : public StackRP
+{
+  protected:
+    /** LFriend-specific per-set state. */
+    class LFriendStack : public RecencyStack
+    {
+      public:
+        /** Hits received by the set so far. */
+        uint64_t hits;
+
+        LFriendStack(unsigned assoc) : RecencyStack(assoc), hits(0) {}
+    };
+
+    /** LFriend-specific implementation of replacement data. */
+    struct LFriendReplData : StackReplData
+    {
+        /** Set hits when the block was last touched. */
+        uint64_t lastHits;
+
+        LFriendReplData(const std::shared_ptr<RecencyStack>& _stack,
+                        unsigned _way)
+            : StackReplData(_stack, _way), lastHits(0) {}
+    };
+
+    /** Scratch buffer mapping stack positions to candidates. */
+    std::vector<CacheBlk*> byPosition;
+
+    RecencyStack* newStack() const override
+    {
+        return new LFriendStack(assoc);
+    }
+
+    StackReplData* newData(const std::shared_ptr<RecencyStack>& stack,
+                           unsigned way) const override
+    {
+        return new LFriendReplData(stack, way);
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef LFriendRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    LFriendRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~LFriendRP() {}
+
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_LFRIEND_RP_HH__
@@ -1,19 +1,4 @@
 /*
- * Copyright (c) 2012-2013 ARM Limited
- * All rights reserved.
- *
- * The license below extends only to copyright in the software and shall
- * not be construed as granting a license to any other intellectual
- * property including but not limited to intellectual property relating
- * to a hardware implementation of the functionality of the software
- * licensed hereunder.  You may use the software subject to the license
- * terms below provided that you ensure that this notice is replicated
- * unmodified and in its entirety in all distributions of the software,
- * modified or unmodified, in source code or in binary form.
- *
- * Copyright (c) 2003-2005,2014 The Regents of The University of Michigan
- * All rights reserved.
- *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are
  * met: redistributions of source code must retain the above copyright
@@ -36,44 +21,54 @@
  * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- *
- * Authors: Erik Hallnor
  */
 
 /**
  * @file
- * Declaration of a LRU tag store.
- * The LRU tags guarantee that the true least-recently-used way in
- * a set will always be evicted.
+ * Declaration of a Least Frequently Used replacement policy.
+ * The victim is chosen using the number of references to each block.
  */
 
-#ifndef __MEM_CACHE_TAGS_LRU_HH__
-#define __MEM_CACHE_TAGS_LRU_HH__
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_LFU_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_LFU_RP_HH__
 
-#include "mem/cache/tags/base_set_assoc.hh"
-#include "params/LRU.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/LFURP.hh"
 
-class LRU : public BaseSetAssoc
+class LFURP : public BaseReplacementPolicy
 {
+  protected:
+    /** LFU-specific implementation of replacement data. */
+    struct LFUReplData : ReplacementData
+    {
+        /** Number of references to this block since it was inserted. */
+        unsigned refCount;
+
+        LFUReplData() : refCount(0) {}
+    };
+
   public:
     /** Convenience typedef. */
-    typedef LRUParams Params;
+    typedef LFURPParams Params;
 
     /**
-     * Construct and initialize this tag store.
+     * Construct and initialize this replacement policy.
      */
-    LRU(const Params *p);
+    LFURP(const Params *p);
 
     /**
-     * Destructor
+     * Destructor.
      */
-    ~LRU() {}
+    ~LFURP() {}
 
-    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat,
-                         int context_src);
-    CacheBlk* findVictim(Addr addr);
-    void insertBlock(PacketPtr pkt, BlkType *blk);
-    void invalidate(CacheBlk *blk);
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
 };
 
-#endif // __MEM_CACHE_TAGS_LRU_HH__
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_LFU_RP_HH__
@@ -1,7 +1,4 @@
 /*
- * Copyright (c) 2014 The Regents of The University of Michigan
- * All rights reserved.
- *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are
  * met: redistributions of source code must retain the above copyright
@@ -24,75 +21,58 @@
  * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- *
- * Authors: Anthony Gutierrez
  */
 
 /**
  * @file
- * Definitions of a random replacement tag store.
+ * Definitions of a random replacement policy.
  */
 
-#include "mem/cache/tags/random_repl.hh"
+#include "mem/cache/replacement_policies/random_rp.hh"
 
-#include "base/random.hh"
-#include "debug/CacheRepl.hh"
-#include "mem/cache/base.hh"
+#include <cassert>
 
-RandomRepl::RandomRepl(const Params *p)
-    : BaseSetAssoc(p)
+#include "base/random.hh"
 
+RandomRP::RandomRP(const Params *p)
+    : BaseReplacementPolicy(p)
 {
 }
 
-CacheBlk*
-RandomRepl::accessBlock(Addr addr, bool is_secure, Cycles &lat, int master_id)
+void
+RandomRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
-    return BaseSetAssoc::accessBlock(addr, is_secure, lat, master_id);
 }
 
-CacheBlk*
-RandomRepl::findVictim(Addr addr)
+void
+RandomRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
 {
-    CacheBlk *blk = BaseSetAssoc::findVictim(addr);
-    unsigned set = extractSet(addr);
-
-    // if all blocks are valid, pick a replacement at random
-    if (blk && blk->isValid()) {
-        // find a random index within the bounds of the set
-        int idx = random_mt.random<int>(0, assoc - 1);
-        blk = sets[set].blks[idx];
-        // Enforce allocation limit
-        while (blk->way >= allocAssoc) {
-            idx = (idx + 1) % assoc;
-            blk = sets[set].blks[idx];
-        }
-
-        assert(idx < assoc);
-        assert(idx >= 0);
-        assert(blk->way < allocAssoc);
-
-        DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
-                blk->set, regenerateBlkAddr(blk->tag, blk->set));
-    }
-
-    return blk;
 }
 
 void
-RandomRepl::insertBlock(PacketPtr pkt, BlkType *blk)
+RandomRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+                const PacketPtr pkt, bool nvm)
 {
-    BaseSetAssoc::insertBlock(pkt, blk);
 }
 
-void
-RandomRepl::invalidate(CacheBlk *blk)
+CacheBlk*
+RandomRP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // Choose one candidate at random
+    return candidates[random_mt.random<unsigned>(0, candidates.size() - 1)];
+}
+
+std::shared_ptr<ReplacementData>
+RandomRP::instantiateEntry()
 {
-    BaseSetAssoc::invalidate(blk);
+    return std::shared_ptr<ReplacementData>(new ReplacementData());
 }
 
-RandomRepl*
-RandomReplParams::create()
+RandomRP*
+RandomRPParams::create()
 {
-    return new RandomRepl(this);
+    return new RandomRP(this);
 }
@@ -1,7 +1,4 @@
 /*
- * Copyright (c) 2014 The Regents of The University of Michigan
- * All rights reserved.
- *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are
  * met: redistributions of source code must retain the above copyright
@@ -24,45 +21,44 @@
  * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- *
- * Authors: Anthony Gutierrez
  */
 
 /**
  * @file
- * Declaration of a random replacement tag store.
- * The RandomRepl tags first try to evict an invalid
- * block. If no invalid blocks are found, a candidate
- * for eviction is found at random.
+ * Declaration of a random replacement policy.
+ * The victim is chosen at random among the candidates.
  */
 
-#ifndef __MEM_CACHE_TAGS_RANDOM_REPL_HH__
-#define __MEM_CACHE_TAGS_RANDOM_REPL_HH__
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_RANDOM_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_RANDOM_RP_HH__
 
-#include "mem/cache/tags/base_set_assoc.hh"
-#include "params/RandomRepl.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/RandomRP.hh"
 
-class RandomRepl : public BaseSetAssoc
+class RandomRP : public BaseReplacementPolicy
 {
   public:
     /** Convenience typedef. */
-    typedef RandomReplParams Params;
+    typedef RandomRPParams Params;
 
     /**
-     * Construct and initiliaze this tag store.
+     * Construct and initialize this replacement policy.
      */
-    RandomRepl(const Params *p);
+    RandomRP(const Params *p);
 
     /**
-     * Destructor
+     * Destructor.
      */
-    ~RandomRepl() {}
+    ~RandomRP() {}
 
-    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat,
-                         int context_src);
-    CacheBlk* findVictim(Addr addr);
-    void insertBlock(PacketPtr pkt, BlkType *blk);
-    void invalidate(CacheBlk *blk);
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
 };
 
-#endif // __MEM_CACHE_TAGS_RANDOM_REPL_HH__
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_RANDOM_RP_HH__
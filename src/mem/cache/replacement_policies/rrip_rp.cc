@@ -0,0 +1,236 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the Re-Reference Interval Prediction replacement policies.
+ */
+
+#include "mem/cache/replacement_policies/rrip_rp.hh"
+
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/misc.hh"
+
+RRIPRP::RRIPRP(const Params *p)
+    : BaseReplacementPolicy(p), maxRRPV((1 << p->num_bits) - 1),
+      dramHitPromotion(p->dram_hit_promotion),
+      nvmHitPromotion(p->nvm_hit_promotion), preferClean(p->prefer_clean),
+      assoc(p->assoc), numInstantiated(0),
+      allWays(p->assoc >= 64 ? ~uint64_t(0) : (uint64_t(1) << p->assoc) - 1),
+      wayCandidates(p->assoc, nullptr)
+{
+    fatal_if(p->num_bits < 2 || p->num_bits > 8,
+             "RRIP needs between 2 and 8 bits per prediction");
+    fatal_if(assoc == 0 || assoc > 64,
+             "RRIP supports between 1 and 64 ways per set");
+}
+
+void
+RRIPRP::setRRPV(RRIPReplData &data, unsigned rrpv)
+{
+    SetState &set = *data.set;
+    const uint64_t way_mask = uint64_t(1) << data.way;
+
+    level(set, getRRPV(data)) &= ~way_mask;
+    level(set, rrpv) |= way_mask;
+
+    data.rrpv = rrpv;
+    data.stamp = set.aged;
+}
+
+void
+RRIPRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    setRRPV(getData(replacement_data), maxRRPV);
+}
+
+void
+RRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    RRIPReplData &data = getData(replacement_data);
+
+    // Predict a nearer re-reference, more so for NVM-backed blocks
+    const unsigned promotion = data.nvm ? nvmHitPromotion : dramHitPromotion;
+    const unsigned rrpv = getRRPV(data);
+    setRRPV(data, rrpv > promotion ? rrpv - promotion : 0);
+}
+
+void
+RRIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+              const PacketPtr pkt, bool nvm)
+{
+    RRIPReplData &data = getData(replacement_data);
+
+    data.nvm = nvm;
+    setRRPV(data, insertionRRPV(replacement_data, pkt));
+}
+
+CacheBlk*
+RRIPRP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // All candidates belong to the same set. When they cover the whole set
+    // there is nothing to gather, otherwise map them by way.
+    SetState &set = *getData(candidates[0]->replacementData).set;
+    const bool whole_set = candidates.size() == assoc;
+    uint64_t candidate_mask = allWays;
+    if (!whole_set) {
+        candidate_mask = 0;
+        for (const auto& candidate : candidates) {
+            const RRIPReplData &data = getData(candidate->replacementData);
+            assert(data.set.get() == &set);
+            wayCandidates[data.way] = candidate;
+            candidate_mask |= uint64_t(1) << data.way;
+        }
+    }
+
+    // The most distant non-empty prediction level holds the victims
+    unsigned victim_rrpv = maxRRPV;
+    while ((level(set, victim_rrpv) & candidate_mask) == 0) {
+        assert(victim_rrpv > 0);
+        victim_rrpv--;
+    }
+    uint64_t victims = level(set, victim_rrpv) & candidate_mask;
+
+    CacheBlk* victim = whole_set ?
+        findCandidate(candidates, findLsbSet(victims)) :
+        wayCandidates[findLsbSet(victims)];
+    if (preferClean && victim->isDirty()) {
+        for (victims &= victims - 1; victims; victims &= victims - 1) {
+            const unsigned way = findLsbSet(victims);
+            CacheBlk* candidate = whole_set ?
+                findCandidate(candidates, way) : wayCandidates[way];
+            if (!candidate->isDirty()) {
+                victim = candidate;
+                break;
+            }
+        }
+    }
+
+    // Age the set at once, as if it had been swept until the victim
+    // reached a distant re-reference prediction. Predictions already past
+    // the victim's saturate at the distant one, and the levels they leave
+    // behind come back around as the nearest ones.
+    const unsigned delta = maxRRPV - victim_rrpv;
+    if (delta > 0) {
+        uint64_t &distant = level(set, victim_rrpv);
+        for (unsigned rrpv = victim_rrpv + 1; rrpv <= maxRRPV; rrpv++) {
+            distant |= level(set, rrpv);
+            level(set, rrpv) = 0;
+        }
+        set.aged += delta;
+    }
+
+    return victim;
+}
+
+CacheBlk*
+RRIPRP::findCandidate(const ReplacementCandidates& candidates,
+                      unsigned way) const
+{
+    if (getData(candidates[way]->replacementData).way == way)
+        return candidates[way];
+
+    for (const auto& candidate : candidates) {
+        if (getData(candidate->replacementData).way == way)
+            return candidate;
+    }
+    panic("RRIP victim way %d is not a candidate", way);
+}
+
+std::shared_ptr<ReplacementData>
+RRIPRP::instantiateEntry()
+{
+    // Blocks are instantiated set after set, start a new set every assoc
+    // entries
+    const unsigned way = numInstantiated % assoc;
+    if (way == 0) {
+        instantiatedSet = std::make_shared<SetState>(
+            numInstantiated / assoc, assoc, maxRRPV);
+    }
+    numInstantiated++;
+
+    return std::shared_ptr<ReplacementData>(
+        new RRIPReplData(instantiatedSet, way, maxRRPV));
+}
+
+TRRIPRP::TRRIPRP(const Params *p)
+    : RRIPRP(p), bimodalInterval(p->bimodal_interval), dueling(p->dueling)
+{
+    fatal_if(dueling && dueling->policies() != 2,
+             "TRRIP duels exactly two insertion policies");
+}
+
+unsigned
+TRRIPRP::insertionRRPV(const std::shared_ptr<ReplacementData>& replacement_data,
+                       const PacketPtr pkt)
+{
+    RRIPReplData &data = getData(replacement_data);
+    SetState &set = *data.set;
+
+    // The throttle advances on every insertion so that switching policy
+    // does not skew the bimodal phase of the set
+    const bool near = bimodalTick(set.bimodalCounter, bimodalInterval);
+
+    if (dueling && dueling->insert(set.index, pkt) == 0)
+        return staticInsertionRRPV(data.nvm);
+    return bimodalInsertionRRPV(data.nvm, near);
+}
+
+void
+TRRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    bimodalTick(getData(replacement_data).set->bimodalCounter,
+                bimodalInterval);
+    RRIPRP::touch(replacement_data);
+}
+
+DRRIPRP::DRRIPRP(const Params *p)
+    : TRRIPRP(p)
+{
+    fatal_if(!dueling, "DRRIP needs a set dueling monitor");
+}
+
+RRIPRP*
+RRIPRPParams::create()
+{
+    return new RRIPRP(this);
+}
+
+TRRIPRP*
+TRRIPRPParams::create()
+{
+    return new TRRIPRP(this);
+}
+
+DRRIPRP*
+DRRIPRPParams::create()
+{
+    return new DRRIPRP(this);
+}
@@ -0,0 +1,287 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the Re-Reference Interval Prediction replacement policies.
+ *
+ * Every block holds a re-reference prediction value (RRPV); the block with
+ * the most distant prediction is evicted and, if no block is predicted to be
+ * re-referenced in the distant future, all predictions are aged until one
+ * is. Blocks backed by NVM are inserted with a nearer prediction and
+ * promoted harder on hits than DRAM-backed ones, as missing on them costs
+ * more.
+ *
+ * Each set keeps one bitmask of ways per RRPV level, so the victim is found
+ * with a find-first-set on the most distant non-empty level, and aging the
+ * whole set rotates which RRPV each level mask stands for. Blocks record
+ * the set's aging count when their RRPV was last written, and catch up
+ * with the aging lazily when their RRPV is read.
+ *
+ * RRIPRP implements static insertion (SRRIP), TRRIPRP bimodal insertion
+ * (BRRIP) and DRRIPRP dynamically picks one of the two by set dueling. A
+ * TRRIPRP given a set dueling monitor behaves as DRRIPRP.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_RRIP_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_RRIP_RP_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/set_dueling.hh"
+#include "params/DRRIPRP.hh"
+#include "params/RRIPRP.hh"
+#include "params/TRRIPRP.hh"
+
+class RRIPRP : public BaseReplacementPolicy
+{
+  protected:
+    /** State shared by all blocks of a set. */
+    struct SetState
+    {
+        /** Index of the set. */
+        const unsigned index;
+
+        /** Accesses to the set since the last bimodal insertion. */
+        unsigned bimodalCounter;
+
+        /** Total amount the set has been aged by. */
+        uint64_t aged;
+
+        /**
+         * Ways of the set holding each RRPV. The masks rotate as the set
+         * ages, see level().
+         */
+        std::vector<uint64_t> levels;
+
+        SetState(unsigned _index, unsigned assoc, unsigned max_rrpv)
+            : index(_index), bimodalCounter(0), aged(0),
+              levels(max_rrpv + 1, 0)
+        {
+            // Every way starts out invalid, i.e. with a distant prediction
+            levels[max_rrpv] = assoc == 64 ? ~uint64_t(0) :
+                                             (uint64_t(1) << assoc) - 1;
+        }
+    };
+
+    /** RRIP-specific implementation of replacement data. */
+    struct RRIPReplData : ReplacementData
+    {
+        /** The set this block belongs to. */
+        const std::shared_ptr<SetState> set;
+
+        /** The way of the block within its set. */
+        const unsigned way;
+
+        /** Re-reference prediction value when last written. */
+        unsigned rrpv;
+
+        /** Aging count of the set when rrpv was last written. */
+        uint64_t stamp;
+
+        /** Whether the block is backed by NVM. */
+        bool nvm;
+
+        RRIPReplData(const std::shared_ptr<SetState>& _set, unsigned _way,
+                     unsigned max_rrpv)
+            : set(_set), way(_way), rrpv(max_rrpv), stamp(0), nvm(false) {}
+    };
+
+    /** Maximum re-reference prediction value, i.e. distant re-reference. */
+    const unsigned maxRRPV;
+
+    /** Amount the RRPV of a DRAM-backed block is lowered by on a hit. */
+    const unsigned dramHitPromotion;
+
+    /** Amount the RRPV of an NVM-backed block is lowered by on a hit. */
+    const unsigned nvmHitPromotion;
+
+    /** Whether victim ties are broken in favour of clean blocks. */
+    const bool preferClean;
+
+    /** Number of ways per set. */
+    const unsigned assoc;
+
+    /** Number of entries instantiated so far. */
+    unsigned numInstantiated;
+
+    /** Set state handed to the entries being instantiated. */
+    std::shared_ptr<SetState> instantiatedSet;
+
+    /** Mask of all the ways of a set. */
+    const uint64_t allWays;
+
+    /** Scratch map from way to candidate, reused on every miss. */
+    std::vector<CacheBlk*> wayCandidates;
+
+    /**
+     * Find the candidate holding a way. Tag stores usually list the
+     * candidates in way order, in which case this is a single lookup.
+     */
+    CacheBlk* findCandidate(const ReplacementCandidates& candidates,
+                            unsigned way) const;
+
+    /**
+     * Convenience accessor for the replacement data of a block. Casts the
+     * raw pointer, as copying the shared pointer would cost two atomic
+     * reference count updates on the miss path.
+     */
+    static RRIPReplData& getData(
+        const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return *static_cast<RRIPReplData*>(replacement_data.get());
+    }
+
+    /** Current RRPV of a block, including the aging it has not seen. */
+    unsigned getRRPV(const RRIPReplData &data) const
+    {
+        const uint64_t aging = data.set->aged - data.stamp;
+        return aging >= maxRRPV - data.rrpv ? maxRRPV : data.rrpv + aging;
+    }
+
+    /**
+     * Mask of the ways of a set holding an RRPV. Aging the set by some
+     * amount moves every level that far up, which is done by rotating
+     * where each RRPV is looked up rather than by moving the masks.
+     */
+    uint64_t& level(SetState &set, unsigned rrpv) const
+    {
+        return set.levels[(rrpv - set.aged) & maxRRPV];
+    }
+
+    /** Write the RRPV of a block, keeping the set's level masks in sync. */
+    void setRRPV(RRIPReplData &data, unsigned rrpv);
+
+    /**
+     * Static insertion prediction: long re-reference interval, one step
+     * nearer for NVM-backed blocks.
+     */
+    unsigned staticInsertionRRPV(bool nvm) const
+    {
+        return maxRRPV - 1 - (nvm ? 1 : 0);
+    }
+
+    /**
+     * Compute the prediction a newly inserted block starts with.
+     *
+     * @param replacement_data Replacement data of the inserted block.
+     * @param pkt The packet that caused the insertion.
+     * @return The insertion RRPV.
+     */
+    virtual unsigned insertionRRPV(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt)
+    {
+        return staticInsertionRRPV(getData(replacement_data).nvm);
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef RRIPRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    RRIPRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~RRIPRP() {}
+
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+class TRRIPRP : public RRIPRP
+{
+  protected:
+    /** Set accesses between two near-immediate insertions. */
+    const unsigned bimodalInterval;
+
+    /**
+     * Picks between static (policy 0) and bimodal (policy 1) insertion,
+     * null to always insert bimodally.
+     */
+    SetDueling *dueling;
+
+    /**
+     * Bimodal insertion prediction: distant re-reference for most blocks
+     * (one step nearer for NVM-backed ones), long re-reference once every
+     * bimodalInterval accesses to the set.
+     */
+    unsigned bimodalInsertionRRPV(bool nvm, bool near) const
+    {
+        return near ? maxRRPV - 2 : maxRRPV - (nvm ? 1 : 0);
+    }
+
+    unsigned insertionRRPV(
+        const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt) override;
+
+  public:
+    /** Convenience typedef. */
+    typedef TRRIPRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    TRRIPRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~TRRIPRP() {}
+
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+};
+
+class DRRIPRP : public TRRIPRP
+{
+  public:
+    /** Convenience typedef. */
+    typedef DRRIPRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    DRRIPRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~DRRIPRP() {}
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_RRIP_RP_HH__
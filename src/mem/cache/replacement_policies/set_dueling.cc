@@ -0,0 +1,152 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the set dueling monitor.
+ */
+
+#include "mem/cache/replacement_policies/set_dueling.hh"
+
+#include "base/misc.hh"
+#include "debug/CacheRepl.hh"
+
+SetDueling::SetDueling(const Params *p)
+    : SimObject(p), numPolicies(p->num_policies), numCores(p->num_cores),
+      constituencySize(p->constituency_size), selection(p->selection),
+      leaderStride(p->constituency_size / (p->num_policies * p->num_cores)),
+      maxSelector((1 << p->selector_bits) - 1),
+      selectors(p->num_policies * p->num_cores, 0),
+      winners(p->num_cores, 0)
+{
+    fatal_if(numPolicies < 2, "Set dueling needs at least two policies");
+    fatal_if(numCores == 0, "Set dueling needs at least one core");
+    fatal_if(leaderStride == 0,
+             "A set dueling constituency of %d sets cannot hold a leader "
+             "for each of %d policies and %d cores", constituencySize,
+             numPolicies, numCores);
+    fatal_if(p->selector_bits < 2 || p->selector_bits > 16,
+             "Set dueling selectors need between 2 and 16 bits");
+}
+
+unsigned
+SetDueling::leaderOf(unsigned set, unsigned &core) const
+{
+    const unsigned num_leaders = numPolicies * numCores;
+    const unsigned offset = set % constituencySize;
+
+    // Leader k of a constituency sits at offset k for modulo selection.
+    // Spread selection strides the leaders over the constituency and
+    // rotates them by the constituency number, so that strided access
+    // patterns do not alias with a single policy's leaders.
+    unsigned slot;
+    if (selection == Enums::modulo) {
+        slot = offset;
+    } else {
+        const unsigned rotation = (set / constituencySize) % constituencySize;
+        const unsigned distance =
+            (offset + constituencySize - rotation) % constituencySize;
+        if (distance % leaderStride != 0)
+            return numPolicies;
+        slot = distance / leaderStride;
+    }
+
+    if (slot >= num_leaders)
+        return numPolicies;
+
+    core = slot / numPolicies;
+    return slot % numPolicies;
+}
+
+unsigned
+SetDueling::insert(unsigned set, const PacketPtr pkt)
+{
+    const unsigned core = coreOf(pkt);
+    unsigned leader_core = 0;
+    const unsigned leader = leaderOf(set, leader_core);
+
+    // Sets leading for other cores are followers as far as this core is
+    // concerned
+    if (leader == numPolicies || leader_core != core) {
+        followerInsertions[winners[core]]++;
+        return winners[core];
+    }
+
+    leaderMisses[leader]++;
+
+    // Count the miss against the leader's policy, halving every selector
+    // of the core when one saturates so that the counts keep tracking
+    // recent behaviour
+    unsigned *core_selectors = &selectors[core * numPolicies];
+    if (++core_selectors[leader] >= maxSelector) {
+        for (unsigned i = 0; i < numPolicies; i++)
+            core_selectors[i] /= 2;
+    }
+
+    unsigned winner = 0;
+    for (unsigned i = 1; i < numPolicies; i++) {
+        if (core_selectors[i] < core_selectors[winner])
+            winner = i;
+    }
+    if (winner != winners[core]) {
+        DPRINTF(CacheRepl, "Set dueling: core %d followers switch from "
+                "policy %d to %d\n", core, winners[core], winner);
+        winners[core] = winner;
+        winnerChanges++;
+    }
+
+    return leader;
+}
+
+void
+SetDueling::regStats()
+{
+    SimObject::regStats();
+
+    leaderMisses
+        .init(numPolicies)
+        .name(name() + ".leader_misses")
+        .desc("misses in the leader sets of each policy")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    followerInsertions
+        .init(numPolicies)
+        .name(name() + ".follower_insertions")
+        .desc("follower set insertions done with each policy")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    winnerChanges
+        .name(name() + ".winner_changes")
+        .desc("number of times followers switched policy")
+        ;
+}
+
+SetDueling*
+SetDuelingParams::create()
+{
+    return new SetDueling(this);
+}
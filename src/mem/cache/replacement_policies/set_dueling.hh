@@ -0,0 +1,136 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a set dueling monitor.
+ *
+ * Set dueling picks, at run time, which of several competing insertion
+ * policies the bulk of a cache should follow. A few leader sets are
+ * dedicated to each policy; misses in those sets are counted in saturating
+ * policy selectors, and the remaining follower sets use whichever policy
+ * currently misses the least. On shared caches the leaders and selectors
+ * may be replicated per core, so that each core adapts to its own
+ * behaviour (thread-aware dueling).
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_SET_DUELING_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_SET_DUELING_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "enums/SetDuelingSelection.hh"
+#include "mem/packet.hh"
+#include "params/SetDueling.hh"
+#include "sim/sim_object.hh"
+
+class SetDueling : public SimObject
+{
+  protected:
+    /** Number of competing policies. */
+    const unsigned numPolicies;
+
+    /** Number of cores with their own leaders and selectors. */
+    const unsigned numCores;
+
+    /** Each constituency holds one leader set per policy and core. */
+    const unsigned constituencySize;
+
+    /** How leader sets are laid out within constituencies. */
+    const Enums::SetDuelingSelection selection;
+
+    /** Distance between two leader sets of a spread constituency. */
+    const unsigned leaderStride;
+
+    /** Saturation value of the policy selectors. */
+    const unsigned maxSelector;
+
+    /** Per core, one miss counter per policy; indexed core-major. */
+    std::vector<unsigned> selectors;
+
+    /** Per core, the policy followers currently use. */
+    std::vector<unsigned> winners;
+
+    /** Number of misses in the leader sets of each policy. */
+    Stats::Vector leaderMisses;
+
+    /** Number of follower insertions done with each policy. */
+    Stats::Vector followerInsertions;
+
+    /** Number of times a core changed the policy its followers use. */
+    Stats::Scalar winnerChanges;
+
+    /**
+     * Find whether a set is a leader and for which policy and core.
+     *
+     * @param set Index of the set.
+     * @param core Set to the core the set leads for, if any.
+     * @return The policy the set leads for, numPolicies for followers.
+     */
+    unsigned leaderOf(unsigned set, unsigned &core) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef SetDuelingParams Params;
+
+    /**
+     * Construct and initialize this set dueling monitor.
+     */
+    SetDueling(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~SetDueling() {}
+
+    void regStats() override;
+
+    /** Number of competing policies. */
+    unsigned policies() const { return numPolicies; }
+
+    /**
+     * Map the requester of a packet to one of the dueling cores. Requests
+     * without a context, such as writebacks, are accounted to core 0.
+     */
+    unsigned coreOf(const PacketPtr pkt) const
+    {
+        if (numCores == 1 || !pkt || !pkt->req->hasContextId())
+            return 0;
+        return pkt->req->contextId() % numCores;
+    }
+
+    /**
+     * Pick the policy an insertion into a set should use, and account the
+     * insertion miss to the leader it happened in, if any.
+     *
+     * @param set Index of the set the block is inserted in.
+     * @param pkt The packet that caused the insertion.
+     * @return Index of the policy to use.
+     */
+    unsigned insert(unsigned set, const PacketPtr pkt);
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_SET_DUELING_HH__
@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a base class for recency-stack replacement policies.
+ */
+
+#include "mem/cache/replacement_policies/stack_rp.hh"
+
+#include <cassert>
+
+#include "base/misc.hh"
+
+StackRP::RecencyStack::RecencyStack(unsigned assoc)
+    : ways(assoc), positions(assoc)
+{
+    for (unsigned i = 0; i < assoc; ++i) {
+        ways[i] = i;
+        positions[i] = i;
+    }
+}
+
+void
+StackRP::RecencyStack::moveToPos(unsigned way, unsigned pos)
+{
+    if (pos >= size())
+        pos = size() - 1;
+
+    unsigned cur = positions[way];
+
+    // Shift the ways in between by one position towards the hole left
+    // behind by the moved way
+    while (cur > pos) {
+        ways[cur] = ways[cur - 1];
+        positions[ways[cur]] = cur;
+        --cur;
+    }
+    while (cur < pos) {
+        ways[cur] = ways[cur + 1];
+        positions[ways[cur]] = cur;
+        ++cur;
+    }
+
+    ways[pos] = way;
+    positions[way] = pos;
+}
+
+void
+StackRP::RecencyStack::promote(unsigned way, unsigned num)
+{
+    const unsigned cur = positions[way];
+    moveToPos(way, cur > num ? cur - num : 0);
+}
+
+StackRP::StackRP(const Params *p)
+    : BaseReplacementPolicy(p), assoc(p->assoc), numInstantiated(0)
+{
+    fatal_if(assoc == 0, "Stack replacement needs a non-zero associativity");
+}
+
+void
+StackRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    StackReplData &data = getData(replacement_data);
+
+    data.valid = false;
+    data.stack->moveToTail(data.way);
+}
+
+void
+StackRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    StackReplData &data = getData(replacement_data);
+
+    data.stack->moveToHead(data.way);
+}
+
+void
+StackRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm)
+{
+    StackReplData &data = getData(replacement_data);
+
+    data.valid = true;
+    data.nvm = nvm;
+    data.stack->moveToHead(data.way);
+}
+
+CacheBlk*
+StackRP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    // Visit all candidates to find the one deepest in the stack
+    CacheBlk* victim = candidates[0];
+    const StackReplData &victim_data = getData(victim->replacementData);
+    unsigned victim_pos = victim_data.stack->position(victim_data.way);
+    for (const auto& candidate : candidates) {
+        const StackReplData &data = getData(candidate->replacementData);
+        const unsigned pos = data.stack->position(data.way);
+        if (pos > victim_pos) {
+            victim = candidate;
+            victim_pos = pos;
+        }
+    }
+
+    return victim;
+}
+
+std::shared_ptr<ReplacementData>
+StackRP::instantiateEntry()
+{
+    // Blocks are instantiated set after set, start a new stack every assoc
+    // entries
+    const unsigned way = numInstantiated % assoc;
+    if (way == 0) {
+        instantiatedStack.reset(newStack());
+    }
+    numInstantiated++;
+
+    return std::shared_ptr<ReplacementData>(
+        newData(instantiatedStack, way));
+}
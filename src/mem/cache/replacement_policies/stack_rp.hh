@@ -0,0 +1,181 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a base class for recency-stack replacement policies.
+ *
+ * These policies keep the blocks of each set in an explicit recency stack,
+ * position 0 being the MRU position, and evict from the bottom of it. They
+ * differ in where blocks are inserted and how far they are promoted on hits,
+ * which is what the derived classes customize.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_STACK_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_STACK_RP_HH__
+
+#include <vector>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/StackRP.hh"
+
+class StackRP : public BaseReplacementPolicy
+{
+  protected:
+    /**
+     * The recency stack of a set, shared by all blocks of the set. Derived
+     * policies extend it with their own per-set state.
+     */
+    class RecencyStack
+    {
+      private:
+        /** Ways of the set, ordered from MRU to LRU. */
+        std::vector<unsigned> ways;
+
+        /** Position of each way in the stack. */
+        std::vector<unsigned> positions;
+
+      public:
+        RecencyStack(unsigned assoc);
+        virtual ~RecencyStack() {}
+
+        /** Number of ways in the stack. */
+        unsigned size() const { return ways.size(); }
+
+        /** Current position of a way, 0 being the MRU position. */
+        unsigned position(unsigned way) const { return positions[way]; }
+
+        /**
+         * Move a way to the given position, shifting the ways in between.
+         * Positions past the bottom of the stack are clamped.
+         */
+        void moveToPos(unsigned way, unsigned pos);
+
+        /** Move a way to the MRU position. */
+        void moveToHead(unsigned way) { moveToPos(way, 0); }
+
+        /** Move a way to the LRU position. */
+        void moveToTail(unsigned way) { moveToPos(way, size() - 1); }
+
+        /** Move a way up by num positions, stopping at the MRU position. */
+        void promote(unsigned way, unsigned num);
+    };
+
+    /** Stack-specific implementation of replacement data. */
+    struct StackReplData : ReplacementData
+    {
+        /** The recency stack of the set this block belongs to. */
+        const std::shared_ptr<RecencyStack> stack;
+
+        /** The way of the block within its set. */
+        const unsigned way;
+
+        /** Whether the block currently holds valid data. */
+        bool valid;
+
+        /** Whether the block is backed by NVM. */
+        bool nvm;
+
+        StackReplData(const std::shared_ptr<RecencyStack>& _stack,
+                      unsigned _way)
+            : stack(_stack), way(_way), valid(false), nvm(false) {}
+    };
+
+    /** Number of ways per set. */
+    const unsigned assoc;
+
+    /** Number of entries instantiated so far. */
+    unsigned numInstantiated;
+
+    /** Stack handed to the entries being instantiated. */
+    std::shared_ptr<RecencyStack> instantiatedStack;
+
+    /**
+     * Create the recency stack of a new set. Derived policies with per-set
+     * state return their extended stack type.
+     */
+    virtual RecencyStack* newStack() const
+    {
+        return new RecencyStack(assoc);
+    }
+
+    /**
+     * Create the replacement data of a block. Derived policies with
+     * per-block state return their extended data type.
+     */
+    virtual StackReplData* newData(
+        const std::shared_ptr<RecencyStack>& stack, unsigned way) const
+    {
+        return new StackReplData(stack, way);
+    }
+
+    /** Convenience accessor for the replacement data of a block. */
+    static StackReplData& getData(
+        const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return *std::static_pointer_cast<StackReplData>(replacement_data);
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef StackRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    StackRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~StackRP() {}
+
+    /**
+     * Invalid blocks go to the bottom of the stack.
+     */
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+
+    /**
+     * Hits move the block to the MRU position.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+
+    /**
+     * New blocks are inserted at the MRU position.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+
+    /**
+     * Evict the candidate closest to the bottom of the stack.
+     */
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_STACK_RP_HH__
@@ -0,0 +1,99 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the Trash replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/trash_rp.hh"
+
+#include <cassert>
+
+#include "base/misc.hh"
+
+TrashRP::TrashRP(const Params *p)
+    : StackRP(p), bimodalInterval(p->bimodal_interval), dueling(p->dueling)
+{
+    fatal_if(dueling && dueling->policies() != 2,
+             "Trash duels exactly two insertion policies");
+}
+
+void
+TrashRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    StackReplData &data = getData(replacement_data);
+    TrashStack &set = static_cast<TrashStack&>(*data.stack);
+
+    if (data.valid && !data.nvm) {
+        assert(set.dramBlocks > 0);
+        set.dramBlocks--;
+    }
+    StackRP::invalidate(replacement_data);
+}
+
+void
+TrashRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    StackReplData &data = getData(replacement_data);
+
+    bimodalTick(static_cast<TrashStack&>(*data.stack).bimodalCounter,
+                bimodalInterval);
+    data.stack->moveToHead(data.way);
+}
+
+void
+TrashRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm)
+{
+    StackReplData &data = getData(replacement_data);
+    TrashStack &set = static_cast<TrashStack&>(*data.stack);
+
+    // Sample the set before the victim leaves it
+    const bool near = bimodalTick(set.bimodalCounter, bimodalInterval);
+    const bool mru = (dueling && dueling->insert(set.index, pkt) == 1) ||
+                     near || (nvm && set.dramBlocks > 0);
+
+    if (data.valid && !data.nvm) {
+        assert(set.dramBlocks > 0);
+        set.dramBlocks--;
+    }
+    if (!nvm)
+        set.dramBlocks++;
+
+    data.valid = true;
+    data.nvm = nvm;
+
+    // Otherwise the block stays where the victim was, i.e. at the bottom
+    // of the stack
+    if (mru)
+        set.moveToHead(data.way);
+}
+
+TrashRP*
+TrashRPParams::create()
+{
+    return new TrashRP(this);
+}
@@ -0,0 +1,101 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the Trash replacement policy.
+ *
+ * Trash is an LRU stack with LRU-position insertion by default. A block is
+ * inserted at the MRU position instead once every bimodalInterval accesses
+ * to its set, or when it is backed by NVM and the set still holds at least
+ * one DRAM-backed block.
+ *
+ * Given a set dueling monitor, Trash duels its insertion (policy 0) against
+ * plain MRU insertion (policy 1) and lets follower sets use the winner.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_TRASH_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_TRASH_RP_HH__
+
+#include "mem/cache/replacement_policies/set_dueling.hh"
+#include "mem/cache/replacement_policies/stack_rp.hh"
+#include "params/TrashRP.hh"
+
+class TrashRP : public StackRP
+{
+  protected:
+    /** Trash-specific per-set state. */
+    class TrashStack : public RecencyStack
+    {
+      public:
+        /** Index of the set. */
+        const unsigned index;
+
+        /** Accesses to the set since the last bimodal insertion. */
+        unsigned bimodalCounter;
+
+        /** Number of valid DRAM-backed blocks in the set. */
+        unsigned dramBlocks;
+
+        TrashStack(unsigned assoc, unsigned _index)
+            : RecencyStack(assoc), index(_index), bimodalCounter(0),
+              dramBlocks(0) {}
+    };
+
+    /** Set accesses between two MRU insertions. */
+    const unsigned bimodalInterval;
+
+    /** Picks between Trash and MRU insertion, may be null. */
+    SetDueling *dueling;
+
+    RecencyStack* newStack() const override
+    {
+        // Called before the first entry of the set is counted
+        return new TrashStack(assoc, numInstantiated / assoc);
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef TrashRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    TrashRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~TrashRP() {}
+
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_TRASH_RP_HH__
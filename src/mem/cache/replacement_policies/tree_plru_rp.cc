@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a tree based pseudo Least Recently Used replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+
+TreePLRURP::TreePLRURP(const Params *p)
+    : BaseReplacementPolicy(p), assoc(p->assoc), depth(floorLog2(p->assoc)),
+      numInstantiated(0)
+{
+    fatal_if(assoc < 2 || assoc > 64 || !isPowerOf2(assoc),
+             "Tree-PLRU needs a power of 2 between 2 and 64 ways per set");
+}
+
+void
+TreePLRURP::point(const TreePLRUReplData &data, bool towards) const
+{
+    uint64_t &nodes = data.tree->nodes;
+
+    // Walk from the root, the way's bits telling the side at each level
+    unsigned node = 0;
+    for (unsigned level = depth; level-- > 0;) {
+        const bool right = (data.way >> level) & 1;
+        if (right == towards)
+            nodes |= uint64_t(1) << node;
+        else
+            nodes &= ~(uint64_t(1) << node);
+        node = 2 * node + 1 + right;
+    }
+}
+
+void
+TreePLRURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    point(getData(replacement_data), true);
+}
+
+void
+TreePLRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    point(getData(replacement_data), false);
+}
+
+void
+TreePLRURP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+                  const PacketPtr pkt, bool nvm)
+{
+    point(getData(replacement_data), false);
+}
+
+CacheBlk*
+TreePLRURP::getVictim(const ReplacementCandidates& candidates)
+{
+    // There must be at least one replacement candidate
+    assert(candidates.size() > 0);
+
+    const uint64_t nodes = getData(candidates[0]->replacementData).tree->nodes;
+
+    // Candidates usually are the whole set, in which case the tree can be
+    // followed blindly
+    const bool whole_set = candidates.size() == assoc;
+    uint64_t candidate_mask = 0;
+    if (!whole_set) {
+        for (const auto& candidate : candidates) {
+            candidate_mask |=
+                uint64_t(1) << getData(candidate->replacementData).way;
+        }
+    }
+
+    unsigned node = 0;
+    unsigned way = 0;
+    for (unsigned level = depth; level-- > 0;) {
+        bool right = (nodes >> node) & 1;
+
+        // Take the other side if the pointed one holds no candidate
+        if (!whole_set) {
+            const unsigned half = 1 << level;
+            const uint64_t side = ((uint64_t(1) << half) - 1) <<
+                ((way << (level + 1)) + (right ? half : 0));
+            if (!(candidate_mask & side))
+                right = !right;
+        }
+
+        way = 2 * way + right;
+        node = 2 * node + 1 + right;
+    }
+
+    if (way < candidates.size() &&
+        getData(candidates[way]->replacementData).way == way)
+        return candidates[way];
+    for (const auto& candidate : candidates) {
+        if (getData(candidate->replacementData).way == way)
+            return candidate;
+    }
+    panic("Tree-PLRU victim way %d is not a candidate", way);
+}
+
+std::shared_ptr<ReplacementData>
+TreePLRURP::instantiateEntry()
+{
+    // Blocks are instantiated set after set, start a new tree every assoc
+    // entries
+    const unsigned way = numInstantiated % assoc;
+    if (way == 0)
+        instantiatedTree = std::make_shared<PLRUTree>();
+    numInstantiated++;
+
+    return std::shared_ptr<ReplacementData>(
+        new TreePLRUReplData(instantiatedTree, way));
+}
+
+TreePLRURP*
+TreePLRURPParams::create()
+{
+    return new TreePLRURP(this);
+}
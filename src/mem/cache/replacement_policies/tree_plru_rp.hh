@@ -0,0 +1,127 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a tree based pseudo Least Recently Used replacement policy.
+ *
+ * The ways of a set are the leaves of a binary tree; every internal node is
+ * one bit telling which of its subtrees holds the pseudo-LRU block. A hit
+ * points the nodes on the path to the block away from it, and the victim is
+ * found by following the nodes from the root. The whole tree of a set is
+ * held in a single 64-bit word, so both take log2(assoc) steps.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
+
+#include <cstdint>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/TreePLRURP.hh"
+
+class TreePLRURP : public BaseReplacementPolicy
+{
+  protected:
+    /** The tree of a set; bit n is set when node n points right. */
+    struct PLRUTree
+    {
+        uint64_t nodes;
+
+        PLRUTree() : nodes(0) {}
+    };
+
+    /** Tree-PLRU-specific implementation of replacement data. */
+    struct TreePLRUReplData : ReplacementData
+    {
+        /** The tree of the set this block belongs to. */
+        const std::shared_ptr<PLRUTree> tree;
+
+        /** The way of the block within its set. */
+        const unsigned way;
+
+        TreePLRUReplData(const std::shared_ptr<PLRUTree>& _tree,
+                         unsigned _way)
+            : tree(_tree), way(_way) {}
+    };
+
+    /** Number of ways per set. */
+    const unsigned assoc;
+
+    /** Depth of the trees, i.e. log2(assoc). */
+    const unsigned depth;
+
+    /** Number of entries instantiated so far. */
+    unsigned numInstantiated;
+
+    /** Tree handed to the entries being instantiated. */
+    std::shared_ptr<PLRUTree> instantiatedTree;
+
+    /** Convenience accessor for the replacement data of a block. */
+    static TreePLRUReplData& getData(
+        const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return *static_cast<TreePLRUReplData*>(replacement_data.get());
+    }
+
+    /**
+     * Point every node on the path to a way towards it, or away from it.
+     *
+     * @param data Replacement data of the block.
+     * @param towards True to make the block the pseudo-LRU one.
+     */
+    void point(const TreePLRUReplData &data, bool towards) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef TreePLRURPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    TreePLRURP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~TreePLRURP() {}
+
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+
+    /**
+     * Follow the tree from its root. When the candidates do not cover the
+     * whole set, subtrees without candidates are skipped.
+     */
+    CacheBlk* getVictim(const ReplacementCandidates& candidates) override;
+
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
@@ -0,0 +1,83 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the Write-Back-Aware Replacement (WBAR) policy.
+ */
+
+#include "mem/cache/replacement_policies/wbar_rp.hh"
+
+WBARRP::WBARRP(const Params *p)
+    : StackRP(p)
+{
+}
+
+void
+WBARRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    StackReplData &data = getData(replacement_data);
+    WBARStack &set = static_cast<WBARStack&>(*data.stack);
+
+    if (data.nvm) {
+        set.moveToHead(data.way);
+    } else {
+        set.promote(data.way, set.counter / 2);
+    }
+}
+
+void
+WBARRP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+              const PacketPtr pkt, bool nvm)
+{
+    StackReplData &data = getData(replacement_data);
+    WBARStack &set = static_cast<WBARStack&>(*data.stack);
+    const int ways = assoc;
+    const int count = set.counter;
+    int pos;
+
+    data.valid = true;
+    data.nvm = nvm;
+
+    if (pkt->isWriteback()) {
+        pos = nvm ? count / 8 : ways - 1 - count / 2;
+    } else if (nvm) {
+        pos = ways - 1 - count / 4;
+        if (set.counter > 0)
+            set.counter--;
+    } else {
+        pos = ways - 1 - count / 8;
+        set.counter++;
+    }
+
+    // The counter is unbounded, clamp to the MRU position
+    set.moveToPos(data.way, pos > 0 ? pos : 0);
+}
+
+WBARRP*
+WBARRPParams::create()
+{
+    return new WBARRP(this);
+}
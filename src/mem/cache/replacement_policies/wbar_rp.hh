@@ -0,0 +1,90 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the Write-Back-Aware Replacement (WBAR) policy.
+ *
+ * WBAR places blocks in the recency stack according to the memory technology
+ * backing them and to whether they are brought in by a writeback. A per-set
+ * counter tracks the recent balance of NVM and DRAM fills: the more NVM
+ * misses the set sees, the closer to the MRU position NVM-backed blocks are
+ * inserted and the less DRAM-backed blocks get promoted on hits.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_WBAR_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_WBAR_RP_HH__
+
+#include "mem/cache/replacement_policies/stack_rp.hh"
+#include "params/WBARRP.hh"
+
+class WBARRP : public StackRP
+{
+  protected:
+    /** WBAR-specific per-set state. */
+    class WBARStack : public RecencyStack
+    {
+      public:
+        /** Fill balance of the set, starts at the associativity. */
+        unsigned counter;
+
+        WBARStack(unsigned assoc) : RecencyStack(assoc), counter(assoc) {}
+    };
+
+    RecencyStack* newStack() const override
+    {
+        return new WBARStack(assoc);
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef WBARRPParams Params;
+
+    /**
+     * Construct and initialize this replacement policy.
+     */
+    WBARRP(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~WBARRP() {}
+
+    /**
+     * NVM-backed blocks move to the MRU position on hits, DRAM-backed ones
+     * are only promoted by half the set counter.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data)
+        override;
+
+    /**
+     * Insert at a position depending on the backing technology, the set
+     * counter and whether the fill is a writeback.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+               const PacketPtr pkt, bool nvm) override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_WBAR_RP_HH__
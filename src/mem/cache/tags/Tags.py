@@ -55,56 +55,24 @@ class BaseTags(ClockedObject):
 
 class BaseSetAssoc(BaseTags):
     type = 'BaseSetAssoc'
-    abstract = True
     cxx_header = "mem/cache/tags/base_set_assoc.hh"
     assoc = Param.Int(Parent.assoc, "associativity")
     sequential_access = Param.Bool(Parent.sequential_access,
         "Whether to access tags and data sequentially")
+    packed_tags = Param.Bool(Parent.packed_tags,
+        "Whether to look tags up in packed per-set arrays")
 
-class LRU(BaseSetAssoc):
-    type = 'LRU'
-    cxx_class = 'LRU'
-    cxx_header = "mem/cache/tags/lru.hh"
-
-class LFU(BaseSetAssoc):
-    type = 'LFU'
-    cxx_class = 'LFU'
-    cxx_header = "mem/cache/tags/lfu.hh"
-
-class WBAR(BaseSetAssoc):
-    type = 'WBAR'
-    cxx_class = 'WBAR'
-    cxx_header = "mem/cache/tags/wbar.hh"
-
-class Trash(BaseSetAssoc):
-    type = 'Trash'
-    cxx_class = 'Trash'
-    cxx_header = "mem/cache/tags/trash.hh"
-
-class LFriend(BaseSetAssoc):
-    type = 'LFriend'
-    cxx_class = 'LFriend'
-    cxx_header = "mem/cache/tags/lfriend.hh"
-
-class RRIP(BaseSetAssoc):
-    type = 'RRIP'
-    cxx_class = 'RRIP'
-    cxx_header = "mem/cache/tags/rrip.hh"
-
-class TRRIP(BaseSetAssoc):
-    type = 'TRRIP'
-    cxx_class = 'TRRIP'
-    cxx_header = "mem/cache/tags/trrip.hh"
+    # Get the replacement policy from the parent (cache)
+    replacement_policy = Param.BaseReplacementPolicy(
+        Parent.replacement_policy, "Replacement policy")
 
-class DRRIP(BaseSetAssoc):
-    type = 'DRRIP'
-    cxx_class = 'DRRIP'
-    cxx_header = "mem/cache/tags/drrip.hh"
+    # Get the DRAM/NVM classification from the parent (cache)
+    tech_map = Param.MemoryTechnologyMap(Parent.tech_map,
+        "DRAM/NVM classification of the address space")
 
-class RandomRepl(BaseSetAssoc):
-    type = 'RandomRepl'
-    cxx_class = 'RandomRepl'
-    cxx_header = "mem/cache/tags/random_repl.hh"
+    # Get the way partitioning from the parent (cache)
+    partitioner = Param.WayPartitioner(Parent.partitioner,
+        "Way partitioning between masters")
 
 class FALRU(BaseTags):
     type = 'FALRU'
@@ -50,6 +50,8 @@
 #include <string>
 
 #include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+#include "debug/CacheTags.hh"
 #include "sim/core.hh"
 
 using namespace std;
@@ -57,7 +59,9 @@ using namespace std;
 BaseSetAssoc::BaseSetAssoc(const Params *p)
     :BaseTags(p), assoc(p->assoc), allocAssoc(p->assoc),
      numSets(p->size / (p->block_size * p->assoc)),
-     sequentialAccess(p->sequential_access)
+     sequentialAccess(p->sequential_access), packedTags(p->packed_tags),
+     replacementPolicy(p->replacement_policy), techMap(p->tech_map),
+     partitioner(p->partitioner)
 {
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
@@ -69,6 +73,9 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
     if (assoc <= 0) {
         fatal("associativity must be greater than zero");
     }
+    fatal_if(!replacementPolicy, "%s needs a replacement policy", name());
+    fatal_if(partitioner && assoc > 64, "%s: at most 64 ways can be "
+             "partitioned", name());
 
     blkMask = blkSize - 1;
     setShift = floorLog2(blkSize);
@@ -77,6 +84,13 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
     /** @todo Make warmup percentage a parameter. */
     warmupBound = numSets * assoc;
 
+    candidates.reserve(assoc);
+    if (packedTags) {
+        tagKeys.assign(numSets * assoc, invalidKey);
+        DPRINTF(CacheTags, "Packed tags matched with the %s kernel\n",
+                TagMatch::name());
+    }
+
     sets = new SetType[numSets];
     blks = new BlkType[numSets * assoc];
     // allocate data storage in one big chunk
@@ -87,9 +101,6 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
     for (unsigned i = 0; i < numSets; ++i) {
         sets[i].assoc = assoc;
 
-	sets[i].counter = assoc;//stx-wbar
-	sets[i].bip_interval = 0;//trash-stx
-	sets[i].lip = 0;//trash-stx
         sets[i].blks = new BlkType*[assoc];
 
         // link in the data blocks
@@ -113,6 +124,9 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
             sets[i].blks[j]=blk;
             blk->set = i;
             blk->way = j;
+
+            // Instantiate replacement data, set after set
+            blk->replacementData = replacementPolicy->instantiateEntry();
         }
     }
 }
@@ -129,7 +143,55 @@ BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
 {
     Addr tag = extractTag(addr);
     unsigned set = extractSet(addr);
-    BlkType *blk = sets[set].findBlk(tag, is_secure);
+    BlkType *blk = findBlk(set, tag, is_secure);
+    return blk;
+}
+
+CacheBlk*
+BaseSetAssoc::findVictim(Addr addr, MasterID master_id)
+{
+    int set = extractSet(addr);
+
+    // ways the master may allocate in, all of them if its partition has
+    // none left within the allocation limit
+    const uint64_t alloc_ways = allocAssoc < 64 ?
+        (1ULL << allocAssoc) - 1 : ~0ULL;
+    uint64_t ways = alloc_ways;
+    if (partitioner) {
+        ways &= partitioner->wayMask(master_id);
+        if (!ways)
+            ways = alloc_ways;
+    }
+    const bool restricted = ways != alloc_ways;
+
+    // prefer to evict an invalid block, which the packed keys tell without
+    // touching the blocks
+    if (packedTags && !restricted) {
+        const unsigned way = TagMatch::find(&tagKeys[set * assoc], allocAssoc,
+                                            invalidKey);
+        if (way < allocAssoc) {
+            assert(!sets[set].blks[way]->isValid());
+            return sets[set].blks[way];
+        }
+    }
+
+    candidates.clear();
+    for (unsigned i = 0; i < allocAssoc; ++i) {
+        if (restricted && !(ways & (1ULL << i)))
+            continue;
+        BlkType *blk = sets[set].blks[i];
+        if (!blk->isValid())
+            return blk;
+        candidates.push_back(blk);
+    }
+
+    // all allocatable ways hold valid data, ask the replacement policy
+    BlkType *blk = replacementPolicy->getVictim(candidates);
+    assert(blk->way < allocAssoc);
+    assert(!restricted || (ways & (1ULL << blk->way)));
+    DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
+            set, regenerateBlkAddr(blk->tag, set));
+
     return blk;
 }
 
@@ -200,3 +262,9 @@ BaseSetAssoc::computeStats()
         }
     }
 }
+
+BaseSetAssoc *
+BaseSetAssocParams::create()
+{
+    return new BaseSetAssoc(this);
+}
@@ -51,11 +51,16 @@
 #include <cassert>
 #include <cstring>
 #include <list>
+#include <vector>
 
 #include "mem/cache/base.hh"
 #include "mem/cache/blk.hh"
+#include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/cacheset.hh"
+#include "mem/cache/tags/tag_match.hh"
+#include "mem/cache/way_partitioner.hh"
+#include "mem/mem_tech_map.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
@@ -63,15 +68,10 @@
  * A BaseSetAssoc cache tag store.
  * @sa  \ref gem5MemorySystem "gem5 Memory System"
  *
- * The BaseSetAssoc tags provide a base, as well as the functionality
- * common to any set associative tags. Any derived class must implement
- * the methods related to the specifics of the actual replacment policy.
- * These are:
- *
- * BlkType* accessBlock();
- * BlkType* findVictim();
- * void insertBlock();
- * void invalidate();
+ * The BaseSetAssoc tags provide the functionality common to any set
+ * associative tags. Which block of a set gets evicted is decided by the
+ * replacement policy the tag store is composed with, so the same tag store
+ * can be used with any policy without being specialised.
  */
 class BaseSetAssoc : public BaseTags
 {
@@ -93,6 +93,8 @@ class BaseSetAssoc : public BaseTags
     const unsigned numSets;
     /** Whether tags and data are accessed sequentially. */
     const bool sequentialAccess;
+    /** Whether lookups go through the packed tag arrays. */
+    const bool packedTags;
 
     /** The cache sets. */
     SetType *sets;
@@ -102,6 +104,62 @@ class BaseSetAssoc : public BaseTags
     /** The data blocks, 1 per cache block. */
     uint8_t *dataBlks;
 
+    /** Replacement policy. */
+    BaseReplacementPolicy *replacementPolicy;
+
+    /**
+     * Packed lookup keys, assoc per set and set after set, so that a
+     * lookup compares consecutive words instead of chasing a block per
+     * way, several ways per instruction on hosts with SIMD support. Only
+     * maintained when packedTags is set.
+     */
+    std::vector<Addr> tagKeys;
+
+    /** Key of the ways holding no valid block. */
+    static const Addr invalidKey = MaxAddr;
+
+    /**
+     * Lookup key of a tag: the tag with the secure bit appended. Tags are
+     * at least one block offset narrower than an address, so a valid key
+     * never equals invalidKey.
+     */
+    static Addr tagKey(Addr tag, bool is_secure)
+    {
+        return (tag << 1) | (is_secure ? 1 : 0);
+    }
+
+    /**
+     * Find a valid block of a set by tag.
+     * @param set The set to look in.
+     * @param tag The tag to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the block if found.
+     */
+    BlkType* findBlk(unsigned set, Addr tag, bool is_secure) const
+    {
+        if (!packedTags)
+            return sets[set].findBlk(tag, is_secure);
+
+        const unsigned way = TagMatch::find(&tagKeys[set * assoc], assoc,
+                                            tagKey(tag, is_secure));
+        if (way == assoc)
+            return nullptr;
+
+        BlkType *blk = &blks[set * assoc + way];
+        assert(blk->tag == tag && blk->isValid() &&
+               blk->isSecure() == is_secure);
+        return blk;
+    }
+
+    /** Scratch list of replacement candidates, reused on every miss. */
+    ReplacementCandidates candidates;
+
+    /** DRAM/NVM classification of the address space, may be null. */
+    const MemoryTechnologyMap *techMap;
+
+    /** Way partitioning between masters, may be null. */
+    const WayPartitioner *partitioner;
+
     /** The amount to shift the address to get the set. */
     int setShift;
     /** The amount to shift the address to get the tag. */
@@ -175,18 +233,21 @@ public:
      */
     CacheBlk *findBlockBySetAndWay(int set, int way) const override;
 
+    /**
+     * Tell whether an address is backed by non-volatile memory, as told by
+     * the technology map. Without a map every address is DRAM.
+     * @param addr The address to classify.
+     * @return True if the address is backed by NVM.
+     */
+    bool isNVM(Addr addr) const
+    {
+        return techMap && techMap->isNVM(addr);
+    }
+
     /**
      * Invalidate the given block.
      * @param blk The block to invalidate.
      */
-
-    bool settype(Addr addr){
-        unsigned bord = 1024*1024*1024;
-        unsigned tag = extractTag(addr);
-        if(tag*blkSize*numSets <= bord) return false;
-        else return true;
-    }//trash-stx
-
     void invalidate(CacheBlk *blk) override
     {
         assert(blk);
@@ -197,8 +258,12 @@ public:
         blk->srcMasterId = Request::invldMasterId;
         blk->task_id = ContextSwitchTaskId::Unknown;
         blk->tickInserted = curTick();
-	blk->type = -1;//stx-wbar
-	blk->rrpv = 0;
+
+        if (packedTags)
+            tagKeys[blk->set * assoc + blk->way] = invalidKey;
+
+        // Decrease the priority of the block in the replacement policy
+        replacementPolicy->invalidate(blk->replacementData);
     }
 
     /**
@@ -217,8 +282,8 @@ public:
     {
         Addr tag = extractTag(addr);
         int set = extractSet(addr);
-        BlkType *blk = sets[set].findBlk(tag, is_secure);
-        lat = accessLatency;;
+        BlkType *blk = findBlk(set, tag, is_secure);
+        lat = accessLatency;
 
         // Access all tags in parallel, hence one in each way.  The data side
         // either accesses all blocks in parallel, or one block sequentially on
@@ -239,6 +304,9 @@ public:
                 lat = cache->ticksToCycles(blk->whenReady - curTick());
             }
             blk->refCount += 1;
+
+            // Update replacement data of accessed block
+            replacementPolicy->touch(blk->replacementData);
         }
 
         return blk;
@@ -255,26 +323,15 @@ public:
     CacheBlk* findBlock(Addr addr, bool is_secure) const override;
 
     /**
-     * Find an invalid block to evict for the address provided.
-     * If there are no invalid blocks, this will return the block
-     * in the least-recently-used position.
+     * Find a block to evict for the address provided. Invalid blocks are
+     * preferred; if there are none, the replacement policy picks the victim
+     * among the ways allocation is allowed in, restricted to the ways of
+     * the master partition if the cache is partitioned.
      * @param addr The addr to a find a replacement candidate for.
+     * @param master_id The master allocating the block.
      * @return The candidate block.
      */
-    CacheBlk* findVictim(Addr addr) override
-    {
-        BlkType *blk = nullptr;
-        int set = extractSet(addr);
-        // prefer to evict an invalid block
-//        for (int i = 0; i < allocAssoc; ++i) {
-        for (int i = 0; i < allocAssoc; i++) {//trash-stx
-            blk = sets[set].blks[i];
-            if (!blk->isValid())
-                break;
-        }
-//	if (i < 0) blk = sets[set].blks[assoc-1];//trash-stx
-        return blk;
-    }
+    CacheBlk* findVictim(Addr addr, MasterID master_id) override;
 
     /**
      * Insert the new block into the cache.
@@ -317,6 +374,9 @@ public:
 
          // Set tag for new block.  Caller is responsible for setting status.
          blk->tag = extractTag(addr);
+         if (packedTags)
+             tagKeys[blk->set * assoc + blk->way] =
+                 tagKey(blk->tag, pkt->isSecure());
 
          // deal with what we are bringing in
          assert(master_id < cache->system->maxMasters());
@@ -325,10 +385,12 @@ public:
          blk->task_id = task_id;
          blk->tickInserted = curTick();
 
-	 blk->type = settype(pkt->getAddr()) ? 0:1;//stx-wbar
          // We only need to write into one tag and one data block.
          tagAccesses += 1;
          dataAccesses += 1;
+
+         // Update replacement policy
+         replacementPolicy->reset(blk->replacementData, pkt, isNVM(addr));
      }
 
     /**
@@ -60,12 +60,9 @@ class CacheSet
     /** The associativity of this set. */
     int assoc;
 
-    int counter;//stx-wbar
-    int bip_interval;//trash-stx
-    int lip;//trash-stx
-    /** Cache blocks in this set, maintained in LRU order 0 = MRU. */
+    /** Cache blocks in this set, indexed by way. */
     Blktype **blks;
- //   int counter;//stx-wbar
+
     /**
      * Find a block matching the tag in this set.
      * @param way_id The id of the way that matches the tag.
@@ -75,23 +72,6 @@ class CacheSet
      */
     Blktype* findBlk(Addr tag, bool is_secure, int& way_id) const ;
     Blktype* findBlk(Addr tag, bool is_secure) const ;
-
-    int getcounter(){
-	return counter;
-    }
-    /**
-     * Move the given block to the head of the list.
-     * @param blk The block to move.
-     */
-    void moveToHead(Blktype *blk);
-    void promote(Blktype *blk, int num);//stx-wbar
-    void moveToPos(Blktype *blk, int pos);//stx-wbar
-    /**
-     * Move the given block to the tail of the list.
-     * @param blk The block to move
-     */
-    void moveToTail(Blktype *blk);
-
 };
 
 template <class Blktype>
@@ -121,90 +101,4 @@ CacheSet<Blktype>::findBlk(Addr tag, bool is_secure) const
     return findBlk(tag, is_secure, ignored_way_id);
 }
 
-template <class Blktype>
-void
-CacheSet<Blktype>::moveToHead(Blktype *blk)
-{
-    // nothing to do if blk is already head
-    if (blks[0] == blk)
-        return;
-
-    // write 'next' block into blks[i], moving up from MRU toward LRU
-    // until we overwrite the block we moved to head.
-
-    // start by setting up to write 'blk' into blks[0]
-    int i = 0;
-    Blktype *next = blk;
-
-    do {
-        assert(i < assoc);
-        std::swap(blks[i], next);
-        ++i;
-    } while (next != blk);
-}
-
-template <class Blktype>
-void
-CacheSet<Blktype>::moveToPos(Blktype *blk , int pos)
-{
-    // nothing to do if blk is already head
-    if (pos < 0) 
-	pos = 0;
-    if (pos >= assoc) 
-	pos = assoc-1;
-    if (blks[pos] == blk)
-        return;
-
-    // write 'next' block into blks[i], moving up from MRU toward LRU
-    // until we overwrite the block we moved to head.
-
-    // start by setting up to write 'blk' into blks[0]
-    int i = pos;
-    moveToHead(blk);//stx
-    Blktype *next = blk;
-    do {
-        assert(i < assoc);
-        std::swap(blks[i], next);
-	 --i;
-    } while (next != blk);
-}//stx-wbar
-
-template <class Blktype>
-void
-CacheSet<Blktype>::promote(Blktype *blk , int num)
-{
-    int tmp=0;
-    int i;
-    for(int j=0;j<assoc;j++){
-	if (blks[j]==blk){
-	  tmp=j;
-	  break;
-	}
-    }    
-    for (i=tmp; i>tmp-num && i >0;i--){
-      std::swap(blks[i],blks[i-1]);
-    }
-}//stx-wbar
-template <class Blktype>
-void
-CacheSet<Blktype>::moveToTail(Blktype *blk)
-{
-    // nothing to do if blk is already tail
-    if (blks[assoc - 1] == blk)
-        return;
-
-    // write 'next' block into blks[i], moving from LRU to MRU
-    // until we overwrite the block we moved to tail.
-
-    // start by setting up to write 'blk' into tail
-    int i = assoc - 1;
-    Blktype *next = blk;
-
-    do {
-        assert(i >= 0);
-        std::swap(blks[i], next);
-        --i;
-    } while (next != blk);
-}
-
 #endif
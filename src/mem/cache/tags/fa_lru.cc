@@ -237,7 +237,7 @@ FALRU::findBlockBySetAndWay(int set, int way) const
 }
 
 CacheBlk*
-FALRU::findVictim(Addr addr)
+FALRU::findVictim(Addr addr, MasterID master_id)
 {
     FALRUBlk * blk = tail;
     assert(blk->inCache == 0);
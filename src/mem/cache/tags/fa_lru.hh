@@ -207,11 +207,13 @@ public:
     CacheBlk* findBlock(Addr addr, bool is_secure) const override;
 
     /**
-     * Find a replacement block for the address provided.
+     * Find a replacement block for the address provided. Way partitioning
+     * does not apply to fully-associative tags, the master is ignored.
      * @param pkt The request to a find a replacement candidate for.
+     * @param master_id The master allocating the block.
      * @return The block to place the replacement in.
      */
-    CacheBlk* findVictim(Addr addr) override;
+    CacheBlk* findVictim(Addr addr, MasterID master_id) override;
 
     void insertBlock(PacketPtr pkt, CacheBlk *blk) override;
 
@@ -0,0 +1,137 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the tag matching kernels.
+ */
+
+#include "mem/cache/tags/tag_match.hh"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "base/bitfield.hh"
+
+namespace TagMatch
+{
+
+unsigned
+scalar(const Addr *keys, unsigned num, Addr key)
+{
+    for (unsigned i = 0; i < num; ++i) {
+        if (keys[i] == key)
+            return i;
+    }
+    return num;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.1")))
+unsigned
+sse4(const Addr *keys, unsigned num, Addr key)
+{
+    const __m128i needle = _mm_set1_epi64x(key);
+
+    // One bit per key of each pair, set for matches
+    unsigned i = 0;
+    for (; i + 2 <= num; i += 2) {
+        const __m128i cmp = _mm_cmpeq_epi64(needle,
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)));
+        const int mask = _mm_movemask_pd(_mm_castsi128_pd(cmp));
+        if (mask)
+            return i + findLsbSet(mask);
+    }
+    return i + scalar(keys + i, num - i, key);
+}
+
+__attribute__((target("avx2")))
+unsigned
+avx2(const Addr *keys, unsigned num, Addr key)
+{
+    const __m256i needle = _mm256_set1_epi64x(key);
+
+    // Up to 8 ways are matched with a mask built from two comparisons,
+    // wider sets stop at the first group of 8 holding a match
+    unsigned i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const __m256i lo = _mm256_cmpeq_epi64(needle,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        const __m256i hi = _mm256_cmpeq_epi64(needle,
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(keys + i + 4)));
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(lo)) |
+            (_mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4);
+        if (mask)
+            return i + findLsbSet(mask);
+    }
+    if (i + 4 <= num) {
+        const __m256i cmp = _mm256_cmpeq_epi64(needle,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(cmp));
+        if (mask)
+            return i + findLsbSet(mask);
+        i += 4;
+    }
+    return i + scalar(keys + i, num - i, key);
+}
+
+#endif
+
+namespace
+{
+
+Kernel
+select()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return avx2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return sse4;
+#endif
+    return scalar;
+}
+
+} // anonymous namespace
+
+const Kernel find = select();
+
+const char *
+name()
+{
+#if defined(__x86_64__)
+    if (find == avx2)
+        return "avx2";
+    if (find == sse4)
+        return "sse4.1";
+#endif
+    return "scalar";
+}
+
+} // namespace TagMatch
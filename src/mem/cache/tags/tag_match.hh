@@ -0,0 +1,74 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the kernels matching a tag against the packed lookup keys
+ * of a set.
+ *
+ * Keys are 64-bit words, one per way. The scalar kernel compares one way at
+ * a time; on x86 hosts the SSE4.1 and AVX2 kernels compare two or four ways
+ * per instruction and turn the comparison into a bit mask of matching ways.
+ * The fastest kernel the host supports is picked once, at start up.
+ */
+
+#ifndef __MEM_CACHE_TAGS_TAG_MATCH_HH__
+#define __MEM_CACHE_TAGS_TAG_MATCH_HH__
+
+#include "base/types.hh"
+
+namespace TagMatch
+{
+
+/**
+ * Find the first key equal to a given key.
+ *
+ * @param keys The keys to search.
+ * @param num Number of keys.
+ * @param key The key to find.
+ * @return Index of the first matching key, num if none matches.
+ */
+typedef unsigned (*Kernel)(const Addr *keys, unsigned num, Addr key);
+
+/** Portable kernel, one key at a time. */
+unsigned scalar(const Addr *keys, unsigned num, Addr key);
+
+#if defined(__x86_64__)
+/** SSE4.1 kernel, two keys per comparison. */
+unsigned sse4(const Addr *keys, unsigned num, Addr key);
+
+/** AVX2 kernel, four keys per comparison. */
+unsigned avx2(const Addr *keys, unsigned num, Addr key);
+#endif
+
+/** The kernel selected for this host. */
+extern const Kernel find;
+
+/** Name of the kernel selected for this host. */
+const char *name();
+
+} // namespace TagMatch
+
+#endif // __MEM_CACHE_TAGS_TAG_MATCH_HH__
@@ -0,0 +1,228 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a sampled utility monitor for set-associative caches.
+ */
+
+#include "mem/cache/utility_monitor.hh"
+
+#include <algorithm>
+#include <numeric>
+
+#include "base/callback.hh"
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "debug/UtilityMonitor.hh"
+#include "sim/system.hh"
+
+UtilityMonitor::UtilityMonitor(const Params *p)
+    : SimObject(p), system(p->system), blkSize(p->block_size),
+      numSets(p->size / (p->block_size * p->assoc)),
+      depth(p->depth ? p->depth : p->assoc),
+      samplingRate(p->sampling_rate), setShift(floorLog2(p->block_size)),
+      setMask(numSets - 1), sampleIndex(numSets, -1), numSampled(0)
+{
+    fatal_if(!isPowerOf2(numSets), "%s: # of sets must be non-zero and a "
+             "power of 2\n", name());
+    fatal_if(samplingRate <= 0 || samplingRate > 1, "%s: sampling rate "
+             "must be in (0, 1]\n", name());
+
+    for (unsigned set = 0; set < numSets; set++) {
+        if (sampled(set)) {
+            sampleIndex[set] = numSampled++;
+        }
+    }
+
+    // Tiny caches may not have any set hashing below the threshold
+    if (numSampled == 0) {
+        sampleIndex[0] = numSampled++;
+    }
+
+    DPRINTF(UtilityMonitor, "Sampling %d of %d sets, %d ways deep\n",
+            numSampled, numSets, depth);
+}
+
+bool
+UtilityMonitor::sampled(unsigned set) const
+{
+    // Spread the set indices over 64 bits with a multiplicative hash and
+    // keep those whose top 24 bits fall below the threshold
+    const uint64_t hash = (set + 1) * 0x9E3779B97F4A7C15ULL;
+    return (hash >> 40) < samplingRate * (1 << 24);
+}
+
+void
+UtilityMonitor::init()
+{
+    SimObject::init();
+
+    const unsigned num_masters = system->maxMasters();
+    shadowTags.resize(num_masters);
+    hitCounts.resize(num_masters);
+    missCounts.resize(num_masters, 0);
+}
+
+void
+UtilityMonitor::access(const PacketPtr pkt)
+{
+    const Addr blk_addr = pkt->getAddr() >> setShift;
+    const int sample = sampleIndex[blk_addr & setMask];
+    if (sample < 0) {
+        return;
+    }
+
+    const MasterID master = pkt->req->masterId();
+    assert(master < shadowTags.size());
+
+    std::vector<Addr> &tags = shadowTags[master];
+    if (tags.empty()) {
+        tags.resize(numSampled * depth, invalidTag);
+        hitCounts[master].resize(depth, 0);
+    }
+
+    // Look the block up in the stack of the set, MRU first
+    Addr *const stack = &tags[sample * depth];
+    Addr *const end = stack + depth;
+    Addr *const pos = std::find(stack, end, blk_addr);
+
+    sampledAccesses[master]++;
+    if (pos != end) {
+        const unsigned way = pos - stack;
+        hitCounts[master][way]++;
+        stackHits[master][way]++;
+        std::copy_backward(stack, pos, pos + 1);
+    } else {
+        missCounts[master]++;
+        std::copy_backward(stack, end - 1, end);
+    }
+    stack[0] = blk_addr;
+}
+
+Counter
+UtilityMonitor::hits(MasterID master, unsigned ways) const
+{
+    assert(ways <= depth);
+    const std::vector<Counter> &counts = hitCounts[master];
+    if (counts.empty()) {
+        return 0;
+    }
+    return std::accumulate(counts.begin(), counts.begin() + ways,
+                           Counter(0));
+}
+
+Counter
+UtilityMonitor::accesses(MasterID master) const
+{
+    return hits(master, depth) + missCounts[master];
+}
+
+void
+UtilityMonitor::decay()
+{
+    for (auto &counts : hitCounts) {
+        for (auto &count : counts) {
+            count /= 2;
+        }
+    }
+    for (auto &count : missCounts) {
+        count /= 2;
+    }
+}
+
+void
+UtilityMonitor::computeStats()
+{
+    const double scale = double(numSets) / numSampled;
+    for (MasterID master = 0; master < system->maxMasters(); master++) {
+        const Counter accesses = sampledAccesses[master].value();
+        Counter misses = accesses;
+        for (unsigned way = 0; way < depth; way++) {
+            misses -= stackHits[master][way].value();
+            missCurve[master][way] = misses * scale;
+        }
+        accessEstimate[master] = accesses * scale;
+    }
+}
+
+void
+UtilityMonitor::regStats()
+{
+    SimObject::regStats();
+
+    const unsigned num_masters = system->maxMasters();
+
+    stackHits
+        .init(num_masters, depth)
+        .name(name() + ".stack_hits")
+        .desc("sampled hits at each LRU stack position per master")
+        .flags(Stats::nozero | Stats::nonan)
+        ;
+
+    sampledAccesses
+        .init(num_masters)
+        .name(name() + ".sampled_accesses")
+        .desc("accesses to the sampled sets per master")
+        .flags(Stats::total | Stats::nozero | Stats::nonan)
+        ;
+
+    missCurve
+        .init(num_masters, depth)
+        .name(name() + ".miss_curve")
+        .desc("estimated misses with 1 to depth ways per master")
+        .flags(Stats::nozero | Stats::nonan)
+        ;
+
+    accessEstimate
+        .init(num_masters)
+        .name(name() + ".access_estimate")
+        .desc("estimated accesses per master")
+        .flags(Stats::total | Stats::nozero | Stats::nonan)
+        ;
+
+    for (int i = 0; i < num_masters; i++) {
+        const std::string &master = system->getMasterName(i);
+        stackHits.subname(i, master);
+        sampledAccesses.subname(i, master);
+        missCurve.subname(i, master);
+        accessEstimate.subname(i, master);
+    }
+
+    for (int way = 0; way < depth; way++) {
+        stackHits.ysubname(way, std::to_string(way));
+        missCurve.ysubname(way, std::to_string(way + 1));
+    }
+
+    Stats::registerDumpCallback(
+        new MakeCallback<UtilityMonitor, &UtilityMonitor::computeStats>(
+            this, true));
+}
+
+UtilityMonitor*
+UtilityMonitorParams::create()
+{
+    return new UtilityMonitor(this);
+}
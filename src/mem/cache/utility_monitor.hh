@@ -0,0 +1,166 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a sampled utility monitor for set-associative caches.
+ *
+ * The monitor keeps LRU shadow tags for a sample of the cache sets, one
+ * private stack per master, and counts the hits at every stack position.
+ * Since LRU has the stack property, the hits at positions below w are the
+ * hits the master would get with w ways, which gives its miss-ratio curve
+ * up to the tracked depth from a single run. Sets are sampled by hashing
+ * their index (as SHARDS does with addresses) so that the sample is spread
+ * evenly over the cache and every access to a sampled set is seen.
+ */
+
+#ifndef __MEM_CACHE_UTILITY_MONITOR_HH__
+#define __MEM_CACHE_UTILITY_MONITOR_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "params/UtilityMonitor.hh"
+#include "sim/sim_object.hh"
+
+class System;
+
+class UtilityMonitor : public SimObject
+{
+  protected:
+    /** Tag of the invalid shadow entries. */
+    static const Addr invalidTag = MaxAddr;
+
+    /** The system, to look the masters up. */
+    System *system;
+
+    /** Block size of the monitored cache. */
+    const unsigned blkSize;
+
+    /** Number of sets of the monitored cache. */
+    const unsigned numSets;
+
+    /** Number of LRU stack positions tracked per master. */
+    const unsigned depth;
+
+    /** Fraction of the sets being sampled. */
+    const double samplingRate;
+
+    /** Shift to get the block address. */
+    const int setShift;
+
+    /** Mask to get the set index from the block address. */
+    const unsigned setMask;
+
+    /** Sample index of each set, -1 for sets which are not sampled. */
+    std::vector<int> sampleIndex;
+
+    /** Number of sampled sets. */
+    unsigned numSampled;
+
+    /**
+     * Shadow tags of each master, allocated on its first access. The stack
+     * of sample s spans entries [s * depth, (s + 1) * depth), MRU first.
+     */
+    std::vector<std::vector<Addr>> shadowTags;
+
+    /** Hits at every stack position, per master, since the last decay. */
+    std::vector<std::vector<Counter>> hitCounts;
+
+    /** Sampled misses, per master, since the last decay. */
+    std::vector<Counter> missCounts;
+
+    /** Sampled hits at every stack position, per master. */
+    Stats::Vector2d stackHits;
+
+    /** Sampled accesses, per master. */
+    Stats::Vector sampledAccesses;
+
+    /**
+     * Estimated misses with 1 to depth ways, per master, scaled up to the
+     * whole cache. Dividing by the accesses gives the miss-ratio curve.
+     */
+    Stats::Vector2d missCurve;
+
+    /** Estimated accesses, per master, scaled up to the whole cache. */
+    Stats::Vector accessEstimate;
+
+    /**
+     * Whether a set is part of the sample.
+     *
+     * @param set The set index.
+     * @return True if the set hashes below the sampling threshold.
+     */
+    bool sampled(unsigned set) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef UtilityMonitorParams Params;
+
+    UtilityMonitor(const Params *p);
+    ~UtilityMonitor() {}
+
+    void init() override;
+    void regStats() override;
+
+    /**
+     * Account for a demand access of the monitored cache. Accesses to sets
+     * out of the sample are ignored.
+     *
+     * @param pkt The access.
+     */
+    void access(const PacketPtr pkt);
+
+    /** Number of stack positions tracked. */
+    unsigned getDepth() const { return depth; }
+
+    /**
+     * Sampled hits a master would have got with the given number of ways,
+     * since the last decay.
+     *
+     * @param master The master.
+     * @param ways Number of ways, at most the tracked depth.
+     * @return The hits in the first ways positions of its stacks.
+     */
+    Counter hits(MasterID master, unsigned ways) const;
+
+    /**
+     * Sampled accesses of a master since the last decay.
+     */
+    Counter accesses(MasterID master) const;
+
+    /**
+     * Halve the counters used for utility estimations, so that they follow
+     * program phases. The statistics are not affected.
+     */
+    void decay();
+
+    /** Compute the miss-ratio curves prior to stats dumps. */
+    void computeStats();
+};
+
+#endif // __MEM_CACHE_UTILITY_MONITOR_HH__
@@ -0,0 +1,213 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a way partitioner for shared set-associative caches.
+ */
+
+#include "mem/cache/way_partitioner.hh"
+
+#include "base/bitfield.hh"
+#include "base/misc.hh"
+#include "debug/WayPartitioner.hh"
+#include "mem/cache/utility_monitor.hh"
+#include "sim/system.hh"
+
+WayPartitioner::WayPartitioner(const Params *p)
+    : ClockedObject(p), system(p->system), assoc(p->assoc),
+      allWays(p->assoc < 64 ? (1ULL << p->assoc) - 1 : ~0ULL),
+      mode(p->mode), prefixes(p->partitions), monitor(p->utility_monitor),
+      interval(p->interval), repartitionEvent(this)
+{
+    const unsigned num_partitions = prefixes.size();
+
+    fatal_if(assoc > 64, "%s: at most 64 ways can be partitioned\n",
+             name());
+    fatal_if(num_partitions == 0, "%s: no partition given\n", name());
+    fatal_if(num_partitions > assoc, "%s: %d partitions do not fit in %d "
+             "ways\n", name(), num_partitions, assoc);
+    fatal_if(mode == Enums::ucp && !monitor, "%s: UCP needs a utility "
+             "monitor on the cache\n", name());
+    fatal_if(mode == Enums::ucp && monitor->getDepth() < assoc, "%s: the "
+             "utility monitor must track at least %d ways\n", name(), assoc);
+
+    // Start from an even split, unless static masks are given
+    if (mode == Enums::static_masks && !p->way_masks.empty()) {
+        fatal_if(p->way_masks.size() != num_partitions, "%s: need one way "
+                 "mask per partition\n", name());
+        for (const auto mask : p->way_masks) {
+            fatal_if(!(mask & allWays), "%s: way mask %#x selects no way\n",
+                     name(), mask);
+            masks.push_back(mask & allWays);
+            allocation.push_back(popCount(mask & allWays));
+        }
+    } else {
+        masks.resize(num_partitions);
+        for (unsigned i = 0; i < num_partitions; i++) {
+            allocation.push_back(assoc / num_partitions +
+                                 (i < assoc % num_partitions));
+        }
+        applyAllocation();
+    }
+}
+
+void
+WayPartitioner::init()
+{
+    ClockedObject::init();
+
+    // Masters belong to the partition of the first prefix matching their
+    // name at a component boundary
+    partitionOf.assign(system->maxMasters(), -1);
+    for (MasterID master = 0; master < partitionOf.size(); master++) {
+        const std::string master_name = system->getMasterName(master);
+        for (int i = 0; i < prefixes.size(); i++) {
+            const std::string &prefix = prefixes[i];
+            if (master_name.compare(0, prefix.size(), prefix) == 0 &&
+                (master_name.size() == prefix.size() ||
+                 master_name[prefix.size()] == '.')) {
+                partitionOf[master] = i;
+                DPRINTF(WayPartitioner, "%s in partition %d\n",
+                        master_name, i);
+                break;
+            }
+        }
+    }
+}
+
+void
+WayPartitioner::startup()
+{
+    if (mode == Enums::ucp) {
+        schedule(repartitionEvent, clockEdge(interval));
+    }
+}
+
+void
+WayPartitioner::applyAllocation()
+{
+    unsigned first = 0;
+    for (unsigned i = 0; i < allocation.size(); i++) {
+        masks[i] = ((allocation[i] < 64 ? (1ULL << allocation[i]) : 0) - 1)
+            << first;
+        first += allocation[i];
+        DPRINTF(WayPartitioner, "Partition %d: %d ways, mask %#x\n", i,
+                allocation[i], masks[i]);
+    }
+    assert(first == assoc);
+}
+
+void
+WayPartitioner::repartition()
+{
+    const unsigned num_partitions = prefixes.size();
+
+    // Utility of each partition with 0 to assoc ways, summed over its
+    // masters
+    std::vector<std::vector<Counter>> utility(
+        num_partitions, std::vector<Counter>(assoc + 1, 0));
+    for (MasterID master = 0; master < partitionOf.size(); master++) {
+        const int partition = partitionOf[master];
+        if (partition < 0)
+            continue;
+        for (unsigned ways = 1; ways <= assoc; ways++) {
+            utility[partition][ways] += monitor->hits(master, ways);
+        }
+    }
+
+    // Lookahead: every partition gets a way, then the remaining ways go,
+    // a batch at a time, to the partition with the highest marginal
+    // utility per way
+    std::vector<unsigned> alloc(num_partitions, 1);
+    unsigned balance = assoc - num_partitions;
+    unsigned next_idle = 0;
+    while (balance > 0) {
+        double best_mu = 0;
+        unsigned best_partition = 0;
+        unsigned best_ways = 0;
+        for (unsigned i = 0; i < num_partitions; i++) {
+            const std::vector<Counter> &u = utility[i];
+            for (unsigned k = 1; k <= balance; k++) {
+                const double mu = double(u[alloc[i] + k] - u[alloc[i]]) / k;
+                if (mu > best_mu) {
+                    best_mu = mu;
+                    best_partition = i;
+                    best_ways = k;
+                }
+            }
+        }
+
+        // Nobody benefits from more ways, hand them out in turn
+        if (best_ways == 0) {
+            best_partition = next_idle++ % num_partitions;
+            best_ways = 1;
+        }
+
+        alloc[best_partition] += best_ways;
+        balance -= best_ways;
+    }
+
+    if (alloc != allocation) {
+        allocation = alloc;
+        applyAllocation();
+        repartitions++;
+    }
+
+    for (unsigned i = 0; i < num_partitions; i++) {
+        allocatedWays[i] = allocation[i];
+    }
+
+    monitor->decay();
+    schedule(repartitionEvent, clockEdge(interval));
+}
+
+void
+WayPartitioner::regStats()
+{
+    ClockedObject::regStats();
+
+    repartitions
+        .name(name() + ".repartitions")
+        .desc("number of repartitionings changing the allocation")
+        ;
+
+    allocatedWays
+        .init(prefixes.size())
+        .name(name() + ".allocated_ways")
+        .desc("average number of ways allocated to each partition")
+        ;
+
+    for (int i = 0; i < prefixes.size(); i++) {
+        allocatedWays.subname(i, prefixes[i]);
+        allocatedWays[i] = allocation[i];
+    }
+}
+
+WayPartitioner*
+WayPartitionerParams::create()
+{
+    return new WayPartitioner(this);
+}
@@ -0,0 +1,134 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a way partitioner for shared set-associative caches.
+ *
+ * The masters of the system are grouped into partitions by name prefix,
+ * typically one partition per core, and each partition is given a mask of
+ * the ways its misses may allocate in. Lookups still search every way, so
+ * repartitioning never loses data: blocks left in ways a partition lost are
+ * simply replaced over time. The masks either stay as configured or are
+ * recomputed periodically from the utility monitor of the cache with the
+ * lookahead algorithm of Utility-based Cache Partitioning (UCP).
+ */
+
+#ifndef __MEM_CACHE_WAY_PARTITIONER_HH__
+#define __MEM_CACHE_WAY_PARTITIONER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "enums/WayPartitioningMode.hh"
+#include "mem/request.hh"
+#include "params/WayPartitioner.hh"
+#include "sim/clocked_object.hh"
+
+class System;
+class UtilityMonitor;
+
+class WayPartitioner : public ClockedObject
+{
+  protected:
+    /** The system, to look the masters up. */
+    System *system;
+
+    /** Number of ways of the cache. */
+    const unsigned assoc;
+
+    /** Mask of all the ways of the cache. */
+    const uint64_t allWays;
+
+    /** How the masks are computed. */
+    const Enums::WayPartitioningMode mode;
+
+    /** Master name prefixes of each partition. */
+    const std::vector<std::string> prefixes;
+
+    /** Utility monitor of the cache, only needed by UCP. */
+    UtilityMonitor *monitor;
+
+    /** Cycles between two repartitionings. */
+    const Cycles interval;
+
+    /** Partition of each master, -1 for masters left unpartitioned. */
+    std::vector<int> partitionOf;
+
+    /** Way mask of each partition. */
+    std::vector<uint64_t> masks;
+
+    /** Number of ways of each partition. */
+    std::vector<unsigned> allocation;
+
+    /** Number of repartitionings which changed the allocation. */
+    Stats::Scalar repartitions;
+
+    /** Ways given to each partition, sampled at every repartitioning. */
+    Stats::AverageVector allocatedWays;
+
+    /**
+     * Give each partition contiguous ways according to the allocation.
+     */
+    void applyAllocation();
+
+    /**
+     * Compute a new allocation with the UCP lookahead algorithm and apply
+     * it, then decay the monitor counters.
+     */
+    void repartition();
+
+    /** Event triggering the periodic repartitioning. */
+    EventWrapper<WayPartitioner, &WayPartitioner::repartition>
+        repartitionEvent;
+
+  public:
+    /** Convenience typedef. */
+    typedef WayPartitionerParams Params;
+
+    WayPartitioner(const Params *p);
+    ~WayPartitioner() {}
+
+    void init() override;
+    void startup() override;
+    void regStats() override;
+
+    /**
+     * Ways a master may allocate in.
+     *
+     * @param master The master missing in the cache.
+     * @return The way mask of its partition, all ways if it has none.
+     */
+    uint64_t wayMask(MasterID master) const
+    {
+        if (master >= partitionOf.size() || partitionOf[master] < 0)
+            return allWays;
+        return masks[partitionOf[master]];
+    }
+};
+
+#endif // __MEM_CACHE_WAY_PARTITIONER_HH__
@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the DRAM/NVM address classification map.
+ */
+
+#include "mem/mem_tech_map.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "debug/MemTechMap.hh"
+
+MemoryTechnologyMap::MemoryTechnologyMap(const Params *p)
+    : SimObject(p), pageShift(floorLog2(p->granularity))
+{
+    fatal_if(!isPowerOf2(p->granularity),
+             "Technology map granularity must be a power of 2");
+
+    if (p->max_addr)
+        cover(p->max_addr);
+
+    for (const auto &range : p->nvm_ranges)
+        setNVM(range, true);
+}
+
+void
+MemoryTechnologyMap::cover(Addr addr)
+{
+    const Addr page = addr >> pageShift;
+    if (page >= nvmPages.size())
+        nvmPages.resize(page + 1, false);
+}
+
+void
+MemoryTechnologyMap::setNVM(Addr addr, bool nvm)
+{
+    // Pages outside the map are DRAM already, no need to grow for them
+    if (!nvm && (addr >> pageShift) >= nvmPages.size())
+        return;
+
+    cover(addr);
+    nvmPages[addr >> pageShift] = nvm;
+
+    DPRINTF(MemTechMap, "Page %#llx classified as %s\n",
+            addr & ~(pageSize() - 1), nvm ? "NVM" : "DRAM");
+}
+
+void
+MemoryTechnologyMap::setNVM(const AddrRange &range, bool nvm)
+{
+    fatal_if(range.interleaved(),
+             "Interleaved ranges are not supported by the technology map");
+
+    if (!range.valid())
+        return;
+
+    if (nvm)
+        cover(range.end());
+
+    const Addr last = range.end() >> pageShift;
+    for (Addr page = range.start() >> pageShift;
+         page <= last && page < nvmPages.size(); ++page)
+        nvmPages[page] = nvm;
+
+    DPRINTF(MemTechMap, "Range %s classified as %s\n", range.to_string(),
+            nvm ? "NVM" : "DRAM");
+}
+
+void
+MemoryTechnologyMap::clear()
+{
+    std::fill(nvmPages.begin(), nvmPages.end(), false);
+}
+
+MemoryTechnologyMap*
+MemoryTechnologyMapParams::create()
+{
+    return new MemoryTechnologyMap(this);
+}
@@ -0,0 +1,92 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a map classifying physical addresses as DRAM or NVM.
+ */
+
+#ifndef __MEM_MEM_TECH_MAP_HH__
+#define __MEM_MEM_TECH_MAP_HH__
+
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+#include "params/MemoryTechnologyMap.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Page-granular classification of the physical address space. Lookups are a
+ * shift and a bit test, so the map can be queried on every cache fill.
+ * Addresses beyond the tracked space are considered DRAM.
+ */
+class MemoryTechnologyMap : public SimObject
+{
+  protected:
+    /** Log2 of the page size tracked by the map. */
+    const unsigned pageShift;
+
+    /** One bit per page, set for NVM pages. */
+    std::vector<bool> nvmPages;
+
+    /** Grow the map so that it covers the given address. */
+    void cover(Addr addr);
+
+  public:
+    typedef MemoryTechnologyMapParams Params;
+    MemoryTechnologyMap(const Params *p);
+
+    /** Size in bytes of the pages tracked by the map. */
+    Addr pageSize() const { return Addr(1) << pageShift; }
+
+    /**
+     * Tell whether an address is backed by NVM.
+     *
+     * @param addr Physical address to classify.
+     * @return True if the page holding addr is NVM.
+     */
+    bool isNVM(Addr addr) const
+    {
+        const Addr page = addr >> pageShift;
+        return page < nvmPages.size() && nvmPages[page];
+    }
+
+    /**
+     * Classify the page holding an address, e.g. after it migrated.
+     *
+     * @param addr Any address in the page.
+     * @param nvm True if the page is now backed by NVM.
+     */
+    void setNVM(Addr addr, bool nvm);
+
+    /** Classify every page overlapping a range. */
+    void setNVM(const AddrRange &range, bool nvm);
+
+    /** Mark the whole tracked space as DRAM. */
+    void clear();
+};
+
+#endif // __MEM_MEM_TECH_MAP_HH__
@@ -0,0 +1,212 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "base/random.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/replacement_policies/age_lru_rp.hh"
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "unittest/unittest.hh"
+
+const unsigned numOps = 100000;
+
+/** Recency order of a set as a list, most recently used way first. */
+class ListLRU
+{
+  private:
+    std::list<unsigned> order;
+
+  public:
+    void touch(unsigned way) { order.remove(way); order.push_front(way); }
+    void invalidate(unsigned way) { order.remove(way); order.push_back(way); }
+
+    unsigned
+    victim(const std::vector<bool> &candidate) const
+    {
+        for (auto way = order.rbegin(); way != order.rend(); ++way) {
+            if (candidate[*way])
+                return *way;
+        }
+        return order.size();
+    }
+};
+
+/**
+ * Tree PLRU written out over ranges of ways, one pointer per node of an
+ * implicit binary tree, true when the node points at its upper half.
+ */
+class RangePLRU
+{
+  private:
+    const unsigned assoc;
+    std::vector<bool> upper;
+
+    void
+    point(unsigned way, bool towards)
+    {
+        unsigned node = 0, lo = 0, hi = assoc;
+        while (hi - lo > 1) {
+            const unsigned mid = (lo + hi) / 2;
+            const bool in_upper = way >= mid;
+            upper[node] = in_upper == towards;
+            node = 2 * node + (in_upper ? 2 : 1);
+            (in_upper ? lo : hi) = mid;
+        }
+    }
+
+  public:
+    RangePLRU(unsigned _assoc) : assoc(_assoc), upper(_assoc, false) {}
+
+    void touch(unsigned way) { point(way, false); }
+    void invalidate(unsigned way) { point(way, true); }
+
+    unsigned
+    victim(const std::vector<bool> &candidate) const
+    {
+        unsigned node = 0, lo = 0, hi = assoc;
+        while (hi - lo > 1) {
+            const unsigned mid = (lo + hi) / 2;
+            bool go_upper = upper[node];
+
+            // Leave the pointed half if it holds no candidate
+            bool any = false;
+            for (unsigned way = go_upper ? mid : lo;
+                 way < (go_upper ? hi : mid); way++) {
+                any = any || candidate[way];
+            }
+            if (!any)
+                go_upper = !go_upper;
+
+            node = 2 * node + (go_upper ? 2 : 1);
+            (go_upper ? lo : hi) = mid;
+        }
+        return lo;
+    }
+};
+
+/**
+ * Drive a policy and its reference with the same random touches,
+ * invalidations and victim selections over whole and partial candidate
+ * lists, and count how often their victims differ.
+ */
+template <class Reference>
+unsigned
+count_mismatches(BaseReplacementPolicy &policy, Reference &reference,
+                 unsigned assoc)
+{
+    std::vector<CacheBlk> blks(assoc);
+    for (unsigned way = 0; way < assoc; way++) {
+        blks[way].replacementData = policy.instantiateEntry();
+        policy.reset(blks[way].replacementData, nullptr, false);
+        reference.touch(way);
+    }
+
+    unsigned mismatches = 0;
+    for (unsigned op = 0; op < numOps; op++) {
+        const unsigned way = random_mt.random<unsigned>(0, assoc - 1);
+        const int kind = random_mt.random<int>(0, 3);
+
+        if (kind == 0) {
+            policy.touch(blks[way].replacementData);
+            reference.touch(way);
+        } else if (kind == 1) {
+            policy.invalidate(blks[way].replacementData);
+            reference.invalidate(way);
+        } else {
+            // Whole set, or a random subset of the ways in random order
+            std::vector<bool> candidate(assoc, kind == 2);
+            ReplacementCandidates candidates;
+            if (kind == 2) {
+                for (auto &blk : blks)
+                    candidates.push_back(&blk);
+            } else {
+                const unsigned count = random_mt.random<unsigned>(1, assoc);
+                for (unsigned i = 0; i < count; i++) {
+                    const unsigned pick =
+                        random_mt.random<unsigned>(0, assoc - 1);
+                    if (!candidate[pick]) {
+                        candidate[pick] = true;
+                        candidates.push_back(&blks[pick]);
+                    }
+                }
+            }
+
+            const unsigned victim = policy.getVictim(candidates) - &blks[0];
+            const unsigned expected = reference.victim(candidate);
+            if (victim != expected)
+                mismatches++;
+
+            policy.reset(blks[expected].replacementData, nullptr, false);
+            reference.touch(expected);
+        }
+    }
+
+    return mismatches;
+}
+
+int
+main()
+{
+    UnitTest::setCase("Age LRU matches a list based LRU");
+    for (unsigned assoc : {1, 2, 3, 4, 8, 16, 33, 64, 128}) {
+        AgeLRURPParams params;
+        params.name = "age";
+        params.eventq_index = 0;
+        params.assoc = assoc;
+        std::unique_ptr<AgeLRURP> age(params.create());
+
+        ListLRU reference;
+        EXPECT_EQ(count_mismatches(*age, reference, assoc), 0);
+    }
+
+    UnitTest::setCase("Tree PLRU matches a range based tree");
+    for (unsigned assoc : {2, 4, 8, 16, 32, 64}) {
+        TreePLRURPParams params;
+        params.name = "tree";
+        params.eventq_index = 0;
+        params.assoc = assoc;
+        std::unique_ptr<TreePLRURP> tree(params.create());
+
+        RangePLRU reference(assoc);
+        EXPECT_EQ(count_mismatches(*tree, reference, assoc), 0);
+    }
+
+    UnitTest::setCase("Tree PLRU is LRU at 2 ways");
+    {
+        TreePLRURPParams params;
+        params.name = "tree";
+        params.eventq_index = 0;
+        params.assoc = 2;
+        std::unique_ptr<TreePLRURP> tree(params.create());
+
+        ListLRU reference;
+        EXPECT_EQ(count_mismatches(*tree, reference, 2), 0);
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,143 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "base/random.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/replacement_policies/rrip_rp.hh"
+#include "unittest/sweep_rrip.hh"
+#include "unittest/unittest.hh"
+
+const unsigned numSets = 3;
+const unsigned numOps = 200000;
+
+/** A tag store worth of blocks whose replacement data one policy owns. */
+struct Blocks
+{
+    BaseReplacementPolicy &policy;
+    std::vector<CacheBlk> blks;
+
+    Blocks(BaseReplacementPolicy &_policy, unsigned count)
+        : policy(_policy), blks(count)
+    {
+        for (auto &blk : blks) {
+            blk.replacementData = policy.instantiateEntry();
+            blk.status = BlkValid;
+        }
+    }
+
+    CacheBlk*
+    victim(unsigned first, unsigned count)
+    {
+        ReplacementCandidates candidates;
+        for (unsigned i = first; i < first + count; i++)
+            candidates.push_back(&blks[i]);
+        return policy.getVictim(candidates);
+    }
+};
+
+/**
+ * Drive the level mask based RRIP and the sweep based reference with the
+ * same random hits, insertions, dirty bits and candidate lists, and check
+ * that they always evict the same way.
+ */
+void
+check_equivalence(unsigned assoc, unsigned num_bits, bool prefer_clean)
+{
+    RRIPRPParams params;
+    params.name = "rrip";
+    params.eventq_index = 0;
+    params.assoc = assoc;
+    params.num_bits = num_bits;
+    params.dram_hit_promotion = 2;
+    params.nvm_hit_promotion = (1 << num_bits) - 1;
+    params.prefer_clean = prefer_clean;
+
+    std::unique_ptr<RRIPRP> rrip(params.create());
+    SweepRRIPRP sweep(&params);
+
+    Blocks levels(*rrip, assoc * numSets), reference(sweep, assoc * numSets);
+
+    for (unsigned i = 0; i < assoc * numSets; i++) {
+        const bool nvm = random_mt.random<int>(0, 1);
+        rrip->reset(levels.blks[i].replacementData, nullptr, nvm);
+        sweep.reset(reference.blks[i].replacementData, nullptr, nvm);
+    }
+
+    unsigned mismatches = 0;
+    for (unsigned op = 0; op < numOps; op++) {
+        const unsigned first = random_mt.random<unsigned>(0, numSets - 1) *
+                               assoc;
+        const unsigned i = first + random_mt.random<unsigned>(0, assoc - 1);
+        const int kind = random_mt.random<int>(0, 9);
+
+        if (kind < 4) {
+            rrip->touch(levels.blks[i].replacementData);
+            sweep.touch(reference.blks[i].replacementData);
+        } else if (kind == 4) {
+            levels.blks[i].status ^= BlkDirty;
+            reference.blks[i].status ^= BlkDirty;
+        } else if (kind == 5) {
+            rrip->invalidate(levels.blks[i].replacementData);
+            sweep.invalidate(reference.blks[i].replacementData);
+        } else {
+            // Whole sets most of the time, a prefix of the ways otherwise
+            const unsigned count = kind == 6 ?
+                random_mt.random<unsigned>(1, assoc) : assoc;
+            const unsigned way = levels.victim(first, count) -
+                                 &levels.blks[first];
+            const unsigned reference_way = reference.victim(first, count) -
+                                           &reference.blks[first];
+            if (way != reference_way)
+                mismatches++;
+
+            const bool nvm = random_mt.random<int>(0, 1);
+            rrip->reset(levels.blks[first + reference_way].replacementData,
+                        nullptr, nvm);
+            sweep.reset(reference.blks[first + reference_way].replacementData,
+                        nullptr, nvm);
+        }
+    }
+
+    EXPECT_EQ(mismatches, 0);
+}
+
+int
+main()
+{
+    UnitTest::setCase("Victims match the sweep based reference");
+    for (unsigned assoc : {1, 2, 4, 16, 63, 64}) {
+        for (unsigned num_bits : {2, 3, 5})
+            check_equivalence(assoc, num_bits, false);
+    }
+
+    UnitTest::setCase("Clean victims are preferred on ties");
+    for (unsigned assoc : {4, 16, 64})
+        check_equivalence(assoc, 3, true);
+
+    return UnitTest::printResults();
+}
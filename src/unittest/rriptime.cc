@@ -0,0 +1,129 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Miss path cost of RRIP victim selection. Times the level mask based
+ * RRIPRP and the sweep based reference through the same replacement
+ * policy interface and workload, for a few associativities.
+ */
+
+#include <csignal>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/replacement_policies/rrip_rp.hh"
+#include "unittest/sweep_rrip.hh"
+
+using namespace std;
+
+volatile int stop = false;
+
+void
+handle_alarm(int signal)
+{
+    stop = true;
+}
+
+void
+do_test(int seconds)
+{
+    stop = false;
+    alarm(seconds);
+}
+
+const unsigned numSets = 64;
+const unsigned numAccesses = 1 << 16;
+const int seconds = 2;
+
+/**
+ * Miss on a random set, replace its victim and hit on some other block of
+ * that set every other miss. The accesses are drawn up front so that only
+ * the policy is timed.
+ */
+void
+time_policy(const string &name, BaseReplacementPolicy &policy, unsigned assoc)
+{
+    vector<CacheBlk> blks(assoc * numSets);
+    vector<ReplacementCandidates> sets(numSets);
+    for (unsigned i = 0; i < blks.size(); i++) {
+        blks[i].status = BlkValid;
+        blks[i].replacementData = policy.instantiateEntry();
+        policy.reset(blks[i].replacementData, nullptr, false);
+        sets[i / assoc].push_back(&blks[i]);
+    }
+
+    vector<unsigned> accesses(numAccesses);
+    for (auto &access : accesses)
+        access = random_mt.random<unsigned>(0, assoc * numSets - 1);
+
+    uint64_t misses = 0;
+
+    do_test(seconds);
+    while (!stop) {
+        const unsigned blk = accesses[misses % numAccesses];
+        CacheBlk *victim = policy.getVictim(sets[blk / assoc]);
+        policy.reset(victim->replacementData, nullptr, false);
+
+        if (misses & 1)
+            policy.touch(blks[blk].replacementData);
+
+        misses++;
+    }
+
+    cprintf("%2d ways, %-12s %12.0f misses/s\n", assoc, name + ":",
+            misses / double(seconds));
+}
+
+int
+main()
+{
+    signal(SIGALRM, handle_alarm);
+
+    for (unsigned assoc : {16, 32, 64}) {
+        RRIPRPParams params;
+        params.name = "rrip";
+        params.eventq_index = 0;
+        params.assoc = assoc;
+        params.num_bits = 3;
+        params.dram_hit_promotion = 7;
+        params.nvm_hit_promotion = 7;
+        params.prefer_clean = false;
+
+        SweepRRIPRP sweep(&params);
+        unique_ptr<RRIPRP> rrip(params.create());
+
+        time_policy("sweep", sweep, assoc);
+        time_policy("level masks", *rrip, assoc);
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * RRIP as it is usually described, used as the reference the level mask
+ * based RRIPRP is checked and timed against. Every block keeps its own RRPV
+ * and a miss ages all the ways of the set one step at a time until a
+ * candidate reaches the distant prediction.
+ */
+
+#ifndef __UNITTEST_SWEEP_RRIP_HH__
+#define __UNITTEST_SWEEP_RRIP_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/RRIPRP.hh"
+
+class SweepRRIPRP : public BaseReplacementPolicy
+{
+  protected:
+    struct SweepReplData : ReplacementData
+    {
+        /** Replacement data of every way of the block's set. */
+        const std::shared_ptr<std::vector<SweepReplData*>> set;
+
+        unsigned rrpv;
+        bool nvm;
+
+        SweepReplData(const std::shared_ptr<std::vector<SweepReplData*>>& _set,
+                      unsigned max_rrpv)
+            : set(_set), rrpv(max_rrpv), nvm(false) {}
+    };
+
+    const unsigned maxRRPV;
+    const unsigned dramHitPromotion;
+    const unsigned nvmHitPromotion;
+    const bool preferClean;
+    const unsigned assoc;
+
+    std::shared_ptr<std::vector<SweepReplData*>> instantiatedSet;
+
+    static SweepReplData& getData(
+        const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return *static_cast<SweepReplData*>(replacement_data.get());
+    }
+
+  public:
+    SweepRRIPRP(const RRIPRPParams *p)
+        : BaseReplacementPolicy(p), maxRRPV((1 << p->num_bits) - 1),
+          dramHitPromotion(p->dram_hit_promotion),
+          nvmHitPromotion(p->nvm_hit_promotion),
+          preferClean(p->prefer_clean), assoc(p->assoc)
+    {
+    }
+
+    void
+    invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+        override
+    {
+        getData(replacement_data).rrpv = maxRRPV;
+    }
+
+    void
+    touch(const std::shared_ptr<ReplacementData>& replacement_data) override
+    {
+        SweepReplData &data = getData(replacement_data);
+        const unsigned promotion =
+            data.nvm ? nvmHitPromotion : dramHitPromotion;
+        data.rrpv = data.rrpv > promotion ? data.rrpv - promotion : 0;
+    }
+
+    void
+    reset(const std::shared_ptr<ReplacementData>& replacement_data,
+          const PacketPtr pkt, bool nvm) override
+    {
+        SweepReplData &data = getData(replacement_data);
+        data.nvm = nvm;
+        data.rrpv = maxRRPV - 1 - (nvm ? 1 : 0);
+    }
+
+    CacheBlk*
+    getVictim(const ReplacementCandidates& candidates) override
+    {
+        assert(candidates.size() > 0);
+
+        std::vector<SweepReplData*> &set =
+            *getData(candidates[0]->replacementData).set;
+
+        // Age every way until a candidate is predicted distant
+        while (true) {
+            CacheBlk* victim = nullptr;
+            for (const auto& candidate : candidates) {
+                if (getData(candidate->replacementData).rrpv != maxRRPV)
+                    continue;
+                if (!victim)
+                    victim = candidate;
+                if (!preferClean || !candidate->isDirty()) {
+                    victim = candidate;
+                    break;
+                }
+            }
+            if (victim)
+                return victim;
+
+            for (auto data : set)
+                data->rrpv = std::min(data->rrpv + 1, maxRRPV);
+        }
+    }
+
+    std::shared_ptr<ReplacementData>
+    instantiateEntry() override
+    {
+        if (!instantiatedSet || instantiatedSet->size() == assoc)
+            instantiatedSet = std::make_shared<std::vector<SweepReplData*>>();
+
+        SweepReplData *data = new SweepReplData(instantiatedSet, maxRRPV);
+        instantiatedSet->push_back(data);
+        return std::shared_ptr<ReplacementData>(data);
+    }
+};
+
+#endif // __UNITTEST_SWEEP_RRIP_HH__
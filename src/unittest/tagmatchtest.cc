@@ -0,0 +1,85 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vector>
+
+#include "base/random.hh"
+#include "mem/cache/tags/tag_match.hh"
+#include "unittest/unittest.hh"
+
+/** Check a kernel against the scalar one for every key position. */
+void
+check_kernel(TagMatch::Kernel kernel)
+{
+    for (unsigned ways : {1, 2, 3, 4, 7, 8, 12, 16, 31, 32, 33}) {
+        std::vector<Addr> keys(ways);
+        for (auto &key : keys)
+            key = random_mt.random<Addr>(0, 1023) << 1;
+
+        // Every way, with duplicates so that the first match must win
+        for (unsigned way = 0; way < ways; way++) {
+            EXPECT_EQ(kernel(keys.data(), ways, keys[way]),
+                      TagMatch::scalar(keys.data(), ways, keys[way]));
+        }
+
+        // No match, including keys differing in the secure bit only
+        EXPECT_EQ(kernel(keys.data(), ways, 1), ways);
+        EXPECT_EQ(kernel(keys.data(), ways, keys[0] | 1), ways);
+
+        // Invalid ways
+        keys[ways - 1] = MaxAddr;
+        EXPECT_EQ(kernel(keys.data(), ways, MaxAddr),
+                  TagMatch::scalar(keys.data(), ways, MaxAddr));
+    }
+}
+
+int
+main()
+{
+    UnitTest::setCase("Scalar kernel");
+    {
+        const Addr keys[] = { 8, 4, 6, 4 };
+        EXPECT_EQ(TagMatch::scalar(keys, 4, 4), 1);
+        EXPECT_EQ(TagMatch::scalar(keys, 4, 5), 4);
+        EXPECT_EQ(TagMatch::scalar(keys, 0, 8), 0);
+    }
+
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.1")) {
+        UnitTest::setCase("SSE4.1 kernel");
+        check_kernel(TagMatch::sse4);
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+        UnitTest::setCase("AVX2 kernel");
+        check_kernel(TagMatch::avx2);
+    }
+#endif
+
+    UnitTest::setCase("Selected kernel");
+    check_kernel(TagMatch::find);
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,162 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+/**
+ * @file
+ * Host cost of cache tag lookups with the block pointer layout of CacheSet
+ * and with the packed key arrays of BaseSetAssoc, on the cache geometries
+ * the SPEC06 configurations use by default.
+ */
+
+#include <csignal>
+#include <unistd.h>
+
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/tags/cacheset.hh"
+#include "mem/cache/tags/tag_match.hh"
+
+using namespace std;
+
+volatile int stop = false;
+
+void
+handle_alarm(int signal)
+{
+    stop = true;
+}
+
+void
+do_test(int seconds)
+{
+    stop = false;
+    alarm(seconds);
+}
+
+const unsigned blkSize = 64;
+const unsigned numLookups = 1 << 20;
+const int seconds = 2;
+
+/** Blocks and keys of a full tag store, laid out as BaseSetAssoc does. */
+struct TagStore
+{
+    const unsigned numSets;
+    const unsigned assoc;
+    vector<CacheBlk> blks;
+    vector<CacheSet<CacheBlk>> sets;
+    vector<Addr> keys;
+
+    TagStore(unsigned size, unsigned _assoc)
+        : numSets(size / blkSize / _assoc), assoc(_assoc),
+          blks(numSets * assoc), sets(numSets), keys(numSets * assoc)
+    {
+        // Every way valid, set s way w holding tag w
+        for (unsigned set = 0; set < numSets; set++) {
+            sets[set].assoc = assoc;
+            sets[set].blks = new CacheBlk*[assoc];
+            for (unsigned way = 0; way < assoc; way++) {
+                CacheBlk &blk = blks[set * assoc + way];
+                blk.status = BlkValid | BlkReadable;
+                blk.tag = way;
+                sets[set].blks[way] = &blk;
+                keys[set * assoc + way] = blk.tag << 1;
+            }
+        }
+    }
+
+    ~TagStore()
+    {
+        for (auto &set : sets)
+            delete [] set.blks;
+    }
+};
+
+/**
+ * Look up random blocks of a footprint the given number of times larger
+ * than the cache, so that one lookup in footprint hits.
+ */
+void
+time_lookups(const char *name, unsigned size, unsigned assoc,
+             unsigned footprint)
+{
+    TagStore tags(size, assoc);
+
+    vector<pair<unsigned, Addr>> lookups(numLookups);
+    for (auto &lookup : lookups) {
+        lookup.first = random_mt.random<unsigned>(0, tags.numSets - 1);
+        lookup.second = random_mt.random<Addr>(0, assoc * footprint - 1);
+    }
+
+    uint64_t pointer = 0, pointer_hits = 0;
+    uint64_t packed = 0, packed_hits = 0;
+
+    do_test(seconds);
+    while (!stop) {
+        const auto &lookup = lookups[pointer % numLookups];
+        if (tags.sets[lookup.first].findBlk(lookup.second, false))
+            pointer_hits++;
+        pointer++;
+    }
+
+    do_test(seconds);
+    while (!stop) {
+        const auto &lookup = lookups[packed % numLookups];
+        if (TagMatch::find(&tags.keys[lookup.first * assoc], assoc,
+                           lookup.second << 1) != assoc) {
+            packed_hits++;
+        }
+        packed++;
+    }
+
+    // The hit rates also keep the lookups from being optimized away
+    cprintf("%-4s %6dkB %2d ways, hits %.2f/%.2f: pointer %10.0f/s, "
+            "packed %10.0f/s, speedup %.2f\n", name, size / 1024, assoc,
+            pointer_hits / double(pointer), packed_hits / double(packed),
+            pointer / double(seconds), packed / double(seconds),
+            packed / double(pointer));
+}
+
+int
+main()
+{
+    signal(SIGALRM, handle_alarm);
+
+    cprintf("Tag match kernel: %s\n", TagMatch::name());
+
+    // Default L1I, L1D, L2 and L3 of configs/common/Options.py
+    for (unsigned footprint : {1, 2}) {
+        time_lookups("l1i", 32 * 1024, 2, footprint);
+        time_lookups("l1d", 64 * 1024, 2, footprint);
+        time_lookups("l2", 2 * 1024 * 1024, 8, footprint);
+        time_lookups("l3", 16 * 1024 * 1024, 16, footprint);
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+# Compare the host speed of gem5 with and without packed cache tags on the
+# SPEC06 configurations of configs/example/se_benchmark_spec06.py. Each
+# benchmark is simulated twice, once per tag layout, and the number of
+# simulated cache accesses per host second is reported for both.
+#
+# Example:
+#   util/tag_lookup_bench.py -b build/X86/gem5.opt -n 100000000 mcf bzip2
+
+import optparse
+import os
+import re
+import subprocess
+import sys
+
+parser = optparse.OptionParser(usage="%prog [options] benchmark...")
+parser.add_option("-b", "--binary", default="build/X86/gem5.opt",
+                  help="gem5 binary to run")
+parser.add_option("-c", "--config",
+                  default="configs/example/se_benchmark_spec06.py",
+                  help="SPEC06 configuration script")
+parser.add_option("-n", "--maxinsts", default="100000000",
+                  help="Instructions to simulate per run")
+parser.add_option("-o", "--outdir", default="tag_lookup_bench",
+                  help="Directory holding the output of every run")
+parser.add_option("--args", default="--caches --l2cache",
+                  help="Extra arguments passed to the configuration script")
+
+(options, benchmarks) = parser.parse_args()
+if not benchmarks:
+    parser.error("no benchmark given")
+
+# Cache accesses of every cache, summed, over the host time they took
+accesses_re = re.compile(r"^system\..*\.overall_accesses::total\s+(\d+)")
+seconds_re = re.compile(r"^host_seconds\s+([\d.]+)")
+
+def run(benchmark, packed):
+    outdir = os.path.join(options.outdir, benchmark,
+                          "packed" if packed else "pointer")
+    cmd = [options.binary, "-d", outdir, options.config,
+           "--benchmark=" + benchmark, "--maxinsts=" + options.maxinsts]
+    cmd += options.args.split()
+    if packed:
+        cmd.append("--packed_tags")
+    if subprocess.call(cmd) != 0:
+        print "Run of %s failed, see %s" % (benchmark, outdir)
+        sys.exit(1)
+
+    accesses = 0
+    seconds = None
+    for line in open(os.path.join(outdir, "stats.txt")):
+        match = accesses_re.match(line)
+        if match:
+            accesses += int(match.group(1))
+        match = seconds_re.match(line)
+        if match and seconds is None:
+            seconds = float(match.group(1))
+    return accesses / seconds
+
+results = []
+for benchmark in benchmarks:
+    results.append((benchmark, run(benchmark, False), run(benchmark, True)))
+
+print "%-16s %16s %16s %8s" % ("benchmark", "pointer acc/s", "packed acc/s",
+                               "speedup")
+for (benchmark, pointer, packed) in results:
+    print "%-16s %16.0f %16.0f %8.3f" % (benchmark, pointer, packed,
+                                         packed / pointer)